@@ -78,6 +78,7 @@ class AIO_Rest : public InputThread  {
 				sysdur pubper 	= Conf::get()->restPubPeriod());
 		bool begin();								/// Start the
 		bool execute();								/// Get the next subscription
+		const char* getThreadName() {return "AIO";};	/// Name used to look up our schedule
 		void setPubFuncMap (PubFuncMap *pubmap);	/// A map of the publish functions to call, by topic
 		int publishNext();							/// call the next function in the _pub function list. Returns the HTTP response code
 		int publishAll();							/// call all of the functions in the _pub function list. Returns the number of functions successfully executed (i.e. 200 series response code)
@@ -185,6 +186,14 @@ class pub_Waypoint : public AIO_Publisher {
 	int pub();
 };
 
+/// Publish the cycle statistics dump requested by the last DumpStats command, if there is one waiting
+class pub_Stats : public AIO_Publisher {
+	public:
+		pub_Stats(BoatState *me, AIO_Rest *rest) :
+			AIO_Publisher(me, rest, "stats") {};
+		int pub();
+};
+
 // Subscriber classes
 // Note that all subscriber classes will manipulate the given BoatState object, as appropriate
 
@@ -131,22 +131,33 @@ class AISBase : public HackerboatState {
 		std::string		device;				/**< Name of the device */
 };
 
-class AISShip : AISBase {
+class AISShip : public AISBase {
 	public:
 		AISShip () = default;
 		AISShip (Value& packet);				/**< Create a ship object from the given packet. */
-		AISShip (const AISShip& s) {this->copy(s);};
+		AISShip (const AISShip& s) = default;
+		AISShip (AISShip&& s) = default;
+		AISShip& operator= (const AISShip& s) = default;
+		AISShip& operator= (AISShip&& s) = default;
 		bool parseGpsdPacket (Value& packet);	/**< Parse an incoming AIS packet. Return true if successful. Will fail is packet is bad or MMSIs do not match. */
+		bool readGpsdPacket (const char *json);	/**< As parseGpsdPacket(), straight from the text of the report */
 		Location project ();					/**< Project the position of the current contact now. */
 		Location project (sysclock t);			/**< Project the position of this contact at time_point. */
-		bool merge (AISShip& other);			/**< Merges two targets with the same MMSI. Returns false if the MMSIs do not match */
+		bool merge (const AISShip& other);		/**< Merges two targets with the same MMSI. Returns false if the MMSIs do not match */
+		bool merge (AISShip&& other);			/**< As above, taking the strings from other rather than copying them */
 		bool prune (Location& current);			/**< Prune AIS targets that are excessively old or far away */
-		bool parse (Value& input);				/**< Populate this object from a given json object */ 
-		Value pack () const;					
+		bool prune (double distance);			/**< As above, with the distance from the current location already known; NaN skips the distance test */
+		bool parse (Value& input) {return (parseFields(fields, this, input) && this->isValid());};	/**< Populate this object from a given json object */ 
+		Value pack () const {return packFields(fields, this);};
+		bool writeJSON (JSONWriter& writer) const {return writeFields(fields, this, writer);};
+		bool readJSON (const char *json) USE_RESULT {return readFields(fields, this, json);};
+		size_t writeRecord (uint8_t *buf, size_t len) const {return encodeRecord(fields, this, buf, len);};
+		bool readRecord (const uint8_t *buf, size_t len) USE_RESULT {return decodeRecord(fields, this, buf, len);};
 		bool isValid () const;
 		int getMMSI () {return this->mmsi;};
 		void copy (const AISShip& c);
-		
+		void clear ();							/**< Return every field to its default, keeping the string buffers for reuse */
+
 		AISNavStatus	status = AISNavStatus::UNDEFINED;	/**< Navigation status of target */
 		double			turn = NAN;				/**< Rate of turn, degrees per minute. */
 		double			speed = NAN;			/**< Speed in knots. */
@@ -161,9 +172,11 @@ class AISShip : AISBase {
 		int				to_port= -1;			/**< Distance from the GNSS receiver to the port, in meters. */
 		int				to_starboard = -1;		/**< Distance from the GNSS receiver to the starboard, in meters. */
 		AISEPFDType		epfd = AISEPFDType::UNDEFINED;		/**< Type of position locating device. */
+		static const FieldDescriptor fields[];	/**< Members written and read by writeJSON() and readJSON() */
 		
 	private:
-		bool coreParse (Value& input);		/**< Pieces of the parsing task shared between parse() and gpsdInputParse() */
+		template <typename Read> bool gpsdPacket (Read read);	/**< Shared by parseGpsdPacket() and readGpsdPacket(); read() fills in gpsdFields */
+		static const FieldDescriptor gpsdFields[];	/**< Members read from a gpsd AIS report */
 		bool removeEntry ();					/**< Remove this entry from the database. Called only from prune() */	
 };
 
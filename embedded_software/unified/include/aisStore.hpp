@@ -0,0 +1,114 @@
+/******************************************************************************
+ * Hackerboat AIS contact store module
+ * aisStore.hpp
+ * This module holds the current AIS contacts, indexed by MMSI, by name, and
+ * by position, and expires them as they age out
+ *
+ * See the Hackerboat documentation for more details
+ * Written by agent, Oct 2026
+ *
+ * Version 0.1: First alpha
+ *
+ ******************************************************************************/
+
+#ifndef AISSTORE_H
+#define AISSTORE_H
+
+#include <inttypes.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <chrono>
+#include "hackerboatRoot.hpp"
+#include "location.hpp"
+#include "ais.hpp"
+
+#define AIS_GRID_CELL_DEG	(0.1)						/**< Size of a spatial index cell in degrees of latitude and longitude; about 11 km north-south */
+#define AIS_WHEEL_SLOTS		(256)						/**< Buckets in the expiry timing wheel */
+#define AIS_WHEEL_TICK		(std::chrono::seconds(1))	/**< Time covered by one bucket of the timing wheel */
+
+/**
+ * @class AISContactStore
+ *
+ * @brief The live AIS contacts, with constant time lookup by MMSI and name, a grid index for range
+ * queries, and a timing wheel that expires contacts aisMaxTime() after their last report.
+ *
+ * Contacts live in slots that are reused once the contact is gone, and never move while they're in
+ * the store, so the pointers handed out stay good until that contact is erased or expired. The grid
+ * is a hash of cells AIS_GRID_CELL_DEG on a side; a range query looks only at the cells the circle
+ * touches and measures the distance to the contacts in them in one batch. The timing wheel has
+ * AIS_WHEEL_SLOTS buckets of AIS_WHEEL_TICK each; a contact is filed under the tick it expires on,
+ * and expire() only visits the buckets for the ticks that have passed since the last call. A contact
+ * whose expiry is more than a lap of the wheel away waits in its bucket for the lap it's due on.
+ *
+ * Reports are merged into the stored contact rather than replacing it, so static data and positions that
+ * arrive in separate messages end up together. A decoder can also claim() a contact and write straight into
+ * it; slots keep their string buffers when they're reused, so once the store has warmed up, updating a
+ * contact doesn't allocate.
+ *
+ * Like the map it replaces, this is owned and written by the GPS input thread without locking.
+ */
+
+class AISContactStore {
+	public:
+		AISContactStore ();
+		AISShip* upsert (const AISShip& ship);		/**< Add a contact, or merge it into the one with the same MMSI. Returns the stored contact, or NULL if it has no MMSI */
+		AISShip* upsert (AISShip&& ship);			/**< As above, moving the strings out of ship rather than copying them */
+		AISShip* claim (int mmsi, bool& added);		/**< The contact with the given MMSI, or a new empty one with that MMSI if there's none, for writing in place; call moved() when done. Returns NULL if the MMSI isn't valid */
+		AISShip* find (int mmsi);					/**< Contact with the given MMSI, or NULL */
+		AISShip* find (const std::string& name);	/**< Most recently named contact with the given ship name, or NULL */
+		bool erase (int mmsi);						/**< Remove a contact. Returns false if there is no such contact */
+		void clear ();
+		size_t size () const {return _byMMSI.size();};
+		size_t within (const Location& center, double radius, std::vector<AISShip*>& out, std::vector<double> *dist = NULL);	/**< Contacts within radius meters of center, in no particular order, with their distances if dist isn't NULL. Returns the number found */
+		size_t ofType (AISShipType type, std::vector<AISShip*>& out);	/**< Contacts of the given ship type. Returns the number found */
+		size_t expire (sysclock now);				/**< Remove contacts that have aged out as of now. Returns the number removed */
+		size_t prune (const Location& here, sysclock now);	/**< Expire contacts, then remove any that are invalid or farther from here than aisMaxDistance(). Returns the number removed */
+		void moved (AISShip *ship);					/**< Re-index a contact after changing its position, name, or time stamp in place */
+
+		template <typename F>
+		void forEach (F fn) {						/**< Call fn with a reference to each contact */
+			for (auto& s : _slots) {
+				if (s.live) fn(s.ship);
+			}
+		};
+
+	private:
+		static const uint32_t NONE = UINT32_MAX;
+
+		struct Slot {
+			AISShip		ship;
+			bool		live = false;
+			int64_t		cell = -1;					/**< Grid cell, or -1 if the contact has no valid position */
+			uint32_t	cellPos = NONE;				/**< Position in the cell's list */
+			int64_t		expiry = 0;					/**< Tick the contact expires on */
+			uint32_t	bucket = NONE;				/**< Timing wheel bucket the contact is filed in */
+			uint32_t	wheelPrev = NONE;			/**< Neighbors in the timing wheel bucket */
+			uint32_t	wheelNext = NONE;
+			std::string	name;						/**< Name the contact is indexed under */
+		};
+
+		static int64_t cellOf (const Location& loc);
+		static int64_t tickOf (sysclock t);
+		uint32_t slotOf (AISShip *ship) const;
+		void index (uint32_t slot);					/**< Bring the grid, name, and timing wheel entries for a slot up to date */
+		void cellRemove (uint32_t slot);
+		void wheelRemove (uint32_t slot);
+		void wheelInsert (uint32_t slot);
+		void remove (uint32_t slot);
+
+		std::deque<Slot>								_slots;			/**< A deque, so slots don't move as it grows */
+		std::vector<uint32_t>							_free;			/**< Slots available for reuse */
+		std::unordered_map<int, uint32_t>				_byMMSI;
+		std::unordered_map<std::string, uint32_t>		_byName;
+		std::unordered_map<int64_t, std::vector<uint32_t>>	_cells;
+		uint32_t										_wheel[AIS_WHEEL_SLOTS];	/**< First slot in each bucket */
+		int64_t											_wheelTick = INT64_MIN;		/**< Last tick expire() processed */
+		std::vector<uint32_t>							_candidates;	/**< Scratch space for range queries and pruning */
+		std::vector<double>								_lat;
+		std::vector<double>								_lon;
+		std::vector<double>								_dist;
+};
+
+#endif /* AISSTORE_H */
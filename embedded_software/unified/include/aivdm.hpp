@@ -0,0 +1,101 @@
+/******************************************************************************
+ * Hackerboat AIVDM module
+ * aivdm.hpp
+ * This module decodes raw AIVDM/AIVDO sentences straight into AIS contacts
+ *
+ * See the Hackerboat documentation for more details
+ * Written by agent, Oct 2026
+ *
+ * Version 0.1: First alpha
+ *
+ ******************************************************************************/
+
+#ifndef AIVDM_H
+#define AIVDM_H
+
+#include <inttypes.h>
+#include <stddef.h>
+#include <string>
+#include "hackerboatRoot.hpp"
+#include "ais.hpp"
+#include "aisStore.hpp"
+
+#define AIVDM_MAX_PAYLOAD	(256)		/**< Longest reassembled payload, in armored characters; a five slot message is 168 */
+#define AIVDM_MAX_PENDING	(4)			/**< Multipart messages that can be in reassembly at once */
+
+enum class AIVDMResult : int {
+	DECODED			= 0,	/**< A complete message was decoded into the contact */
+	PENDING			= 1,	/**< A fragment was stored; the rest of the message is still to come */
+	IGNORED			= 2,	/**< Not an AIVDM or AIVDO sentence, or a message type we don't use */
+	BAD_CHECKSUM	= 3,	/**< The checksum is missing or doesn't match */
+	BAD_FORMAT		= 4,	/**< The sentence or the payload is malformed */
+};
+
+/**
+ * @class AIVDMDecoder
+ *
+ * @brief Decoder for the 6-bit armored AIS payloads in raw AIVDM and AIVDO sentences.
+ *
+ * Message types 1, 2, 3 and 18 (position reports) and 5 and 24 (static data) are decoded straight into
+ * the fields of an AISShip, in the units gpsd uses. Only the values the message actually carries are
+ * written, so decoding into a contact store updates the stored contact in place: a position report
+ * leaves the name alone, and static data leaves the position and its time stamp alone. Messages with no
+ * MMSI are ignored, and our own (AIVDO) reports are kept by the decoder rather than put in the store.
+ * Each sentence has its checksum checked before anything else. Fragments of multipart messages are held,
+ * keyed by channel and sequential message ID, until the last one arrives; a fragment out of order drops
+ * the message it belongs to. Tag blocks in front of the sentence are skipped.
+ *
+ * The decoder keeps all of its buffers between calls, and only writes a string in the contact when it has
+ * changed, so updating a contact already in the store doesn't allocate. It is not thread safe; each input
+ * thread needs its own.
+ */
+
+class AIVDMDecoder {
+	public:
+		AIVDMDecoder () = default;
+		AIVDMResult decode (const char *sentence, size_t len, sysclock now, AISShip& ship);	/**< Decode one sentence. On DECODED, ship holds the message, time stamped now */
+		AIVDMResult decode (const char *sentence, size_t len, sysclock now, AISContactStore& contacts);	/**< Decode one sentence into the contact with its MMSI, adding it if need be */
+		const AISShip* lastShip () const {return _lastShip;};	/**< Contact the last message was decoded into */
+		AISMsgType lastType () const {return _lastType;};	/**< Type of the last message decoded */
+		bool lastOwn () const {return _lastOwn;};			/**< True if the last message decoded was our own (AIVDO) */
+		uint64_t sentences () const {return _sentences;};	/**< Sentences seen */
+		uint64_t messages () const {return _messages;};		/**< Messages decoded */
+		uint64_t errors () const {return _errors;};			/**< Sentences rejected for a bad checksum or format */
+		static bool checksum (const char *sentence, size_t len);	/**< True if the sentence carries a checksum and it matches */
+
+	private:
+		struct Pending {
+			bool		used = false;
+			char		seqId = 0;
+			char		channel = 0;
+			int			count = 0;			/**< Fragments in the message */
+			int			next = 0;			/**< Number of the fragment expected next */
+			size_t		len = 0;			/**< Payload characters so far */
+			char		payload[AIVDM_MAX_PAYLOAD];
+		};
+
+		bool unpack (const char *payload, size_t len, int fill);	/**< Turn an armored payload into bits */
+		uint32_t bits (size_t start, size_t width) const;			/**< Unsigned field */
+		int32_t sbits (size_t start, size_t width) const;			/**< Two's complement field */
+		void text (size_t start, size_t chars, std::string& out) const;	/**< Six bit text field, without the padding */
+		void textField (size_t start, size_t chars, std::string& out);	/**< Write a text field into out, if it isn't blank */
+		bool position (AISShip& ship, size_t speed, size_t lon, size_t lat, size_t course, size_t heading);	/**< Fields common to the position reports, given where each starts. Returns true if the position was available */
+		void dimensions (AISShip& ship, size_t start);	/**< Distances from the GNSS receiver, if they're given */
+		AIVDMResult assemble (const char*& sentence, size_t& len, bool& own);	/**< Check a sentence and put its message together. On DECODED, the whole message is in the bits */
+		AIVDMResult check () const;					/**< Whether the message in the bits is one we can decode */
+		bool decodeMessage (AISShip& ship);			/**< Write the available fields of a checked message. Returns true if it carried a position */
+
+		Pending		_pending[AIVDM_MAX_PENDING];
+		uint8_t		_bits[(AIVDM_MAX_PAYLOAD * 6) / 8];
+		size_t		_nbits = 0;
+		std::string	_text;						/**< Scratch space for text fields */
+		AISShip		_own;						/**< Our own last report, when decoding into a store */
+		const AISShip	*_lastShip = NULL;
+		AISMsgType	_lastType = AISMsgType::UNDEFINED;
+		bool		_lastOwn = false;
+		uint64_t	_sentences = 0;
+		uint64_t	_messages = 0;
+		uint64_t	_errors = 0;
+};
+
+#endif /* AIVDM_H */
@@ -26,6 +26,8 @@ class AutoModeBase : public StateMachineBase<AutoModeEnum, BoatState> {
 		static AutoModeBase* factory(BoatState& state, AutoModeEnum mode);			/**< Create a new object of the given mode */
 		virtual AutoModeBase* execute () = 0;
 		virtual ~AutoModeBase() {};
+		static void* operator new (size_t size);							/**< Take a slot from the auto mode pool */
+		static void operator delete (void *p);
 	protected:
 		AutoModeBase (BoatState& state, AutoModeEnum last, AutoModeEnum thisMode) :	/**< Protected constructor so subclas constructors can call the superclass constructor */
 			StateMachineBase<AutoModeEnum, BoatState> (state, last, thisMode) {};
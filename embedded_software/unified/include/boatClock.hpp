@@ -0,0 +1,45 @@
+/******************************************************************************
+ * Hackerboat boat clock module
+ * boatClock.hpp
+ * This module provides the time used by the control code, so that it can be
+ * driven from a recording instead of the wall clock
+ *
+ * See the Hackerboat documentation for more details
+ * Written by agent, Oct 2026
+ *
+ * Version 0.1: First alpha
+ *
+ ******************************************************************************/
+
+#ifndef BOATCLOCK_H
+#define BOATCLOCK_H
+
+#include <atomic>
+#include <chrono>
+#include <inttypes.h>
+#include "hackerboatRoot.hpp"
+
+/**
+ * @class BoatClock
+ *
+ * @brief Wall and steady time for the modes, the PID and the arm buttons.
+ *
+ * Normally this is just the system and steady clocks. The replay driver sets it to the time of each
+ * recorded frame instead, so that every timeout and PID sample period comes out exactly as it would
+ * have on the water, however fast the replay runs. While it is set, the steady time moves with it.
+ */
+
+class BoatClock {
+	public:
+		static sysclock now ();										/**< Current wall time */
+		static std::chrono::steady_clock::time_point steadyNow ();	/**< Current steady time */
+		static void set (sysclock t);								/**< Stop the clock at t until the next set() or release() */
+		static void release ();										/**< Go back to the system clocks */
+		static bool isSet () {return _set.load(std::memory_order_relaxed);};
+
+	private:
+		static std::atomic<bool>		_set;
+		static std::atomic<int64_t>		_ticks;						/**< Set time, in system_clock ticks since the epoch */
+};
+
+#endif /* BOATCLOCK_H */
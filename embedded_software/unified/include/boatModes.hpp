@@ -27,6 +27,8 @@ class BoatModeBase : public StateMachineBase<BoatModeEnum, BoatState> {
 		static BoatModeBase* factory(BoatState& state, BoatModeEnum mode);	/**< Create a new object of the given mode */
 		virtual BoatModeBase* execute () = 0;
 		virtual ~BoatModeBase() {};
+		static void* operator new (size_t size);							/**< Take a slot from the boat mode pool; self test mode is too big and goes on the heap */
+		static void operator delete (void *p);
 	protected:
 		BoatModeBase (BoatState& state, BoatModeEnum last, BoatModeEnum thisMode) :	/**< Protected constructor so subclas constructors can call the superclass constructor */
 			StateMachineBase<BoatModeEnum, BoatState> (state, last, thisMode) {};
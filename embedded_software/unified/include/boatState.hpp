@@ -34,14 +34,28 @@
 #include "hal/throttle.hpp"
 #include "hal/servo.hpp"
 #include "hal/orientationInput.hpp"
+#include "controlExecutive.hpp"
+#include "pool.hpp"
+#include "csvWriter.hpp"
+#include "navSolution.hpp"
 #include "util.hpp"
 #include "rapidjson/rapidjson.h"
 
 using namespace std;
 using namespace rapidjson;
 
+#define COMMAND_POOL_SIZE		(16)		/**< Commands that can be waiting at once without touching the heap */
+#define COMMAND_ARG_BUFFER		(1024)		/**< Bytes of argument storage inside each command; larger arguments spill to the heap */
+
 class BoatState;	// forward declaration so this compiles
 
+/**
+ * @brief A command from the shore, waiting to be executed by the control loop.
+ *
+ * Commands are allocated from a fixed pool, and each carries its own buffer for its arguments,
+ * so receiving and executing a command does not allocate in the usual case.
+ */
+
 class Command {
 	public:
 		Command (BoatState *state, const string cmd, const Value& args);
@@ -51,12 +65,17 @@ class Command {
 		bool execute ();
 		Value pack () const;
 
+		static void* operator new (size_t size);			/**< Take a slot from the command pool, or the heap if it is empty */
+		static void operator delete (void *p);				/**< Return a slot to the command pool */
+		static size_t poolInUse ();							/**< Number of pool slots currently holding commands */
+
 	private:
 		static const map<std::string, std::function<bool(Value&, BoatState*)>> _funcs;
 		BoatState 		*_state = NULL;
 		std::string 	_cmd;
+		char			_argBuffer[COMMAND_ARG_BUFFER];
+		MemoryPoolAllocator<>	_argAlloc { _argBuffer, sizeof(_argBuffer), COMMAND_ARG_BUFFER };
 		Value 			_args;
-		Document 		root;
 
 		// here begins the functions that implement incoming commands
 		static bool SetMode(Value& args, BoatState *state);
@@ -73,6 +92,7 @@ class Command {
 		static bool FetchWaypoints(Value& args, BoatState *state);
 		static bool PushPath(Value& args, BoatState *state);
 		static bool SetPID(Value& args, BoatState *state);
+		static bool DumpStats(Value& args, BoatState *state);
 };
 
 std::ostream& operator<< (std::ostream& stream, const Command& state);
@@ -87,11 +107,15 @@ class BoatState : public HackerboatState {
 		BoatState ();
 		bool parse (Value& input);
 		Value pack () const;
+		bool writeJSON (JSONWriter& writer) const;					/**< The stored state, then the live pin, servo, relay and command readings, as pack() has them */
+		bool readJSON (const char *json) USE_RESULT {return readFields(fields, this, json);};
+		size_t writeRecord (uint8_t *buf, size_t len) const {return encodeRecord(fields, this, buf, len);};
+		bool readRecord (const uint8_t *buf, size_t len) USE_RESULT {return decodeRecord(fields, this, buf, len);};
 		bool isValid ();
 
-		bool insertFault (const std::string fault);					/**< Add the named fault to the fault string. Returns false if fault string is full */
-		bool removeFault (const std::string fault);					/**< Remove the named fault from the fault string. Returns false if not present */
-		bool hasFault (const std::string fault) const;				/**< Returns true if given fault is present */
+		bool insertFault (const char *fault);						/**< Add the named fault to the fault string. Returns false if fault string is full */
+		bool removeFault (const char *fault);						/**< Remove the named fault from the fault string. Returns false if not present */
+		bool hasFault (const char *fault) const;					/**< Returns true if given fault is present */
 		int faultCount (void) const;								/**< Returns the current number of faults */
  		void clearFaults () {faultString = "";};					/**< Remove all faults */
 		std::string getFaultString() {return faultString;};			/**< Returns the entire fault string */
@@ -110,19 +134,24 @@ class BoatState : public HackerboatState {
 		int commandCnt () const {return cmdvec.size();};			/**< Return the number of commands waiting to be executed */
 		void pushCmd (std::string name, const Value& args);			/**< Add a command to the back of the command queue */
 		void pushCmd (std::string name) {Value m; pushCmd(name, m);};
-		void flushCmds () {cmdvec.clear();};						/**< Empty the command queue */
+		void flushCmds ();											/**< Empty the command queue */
 		int executeCmds (int num = 0);								/**< Execute the given number of commands. 0 executes all available. Returns the number of commands successfully executed. */
-		std::string getCSV();										/**< Export the current state as a line for a CSV file */
-		std::string getCSVheaders();								/**< Generate CSV headers */
+		const char* getCSV();										/**< Export the current state as a line for a CSV file. The line is kept in this object, so it is only valid until the next call */
+		std::string getCSVheaders();								/**< Generate CSV headers, from the same table as getCSV() */
 		ArmButtonStateEnum getArmState ();							/**< Get the current state of the arm & disarm inputs */
 		std::string printCurrentWaypointNum();						/**< Print the current waypoint number, RETURN, ANCHOR, or NONE */
 		Location getCurrentTarget();								/**< Returns the current target location, or an invalid Location if there isn't one right now */
+		Location getLegStart();										/**< Returns the start of the leg to the current waypoint: the one before it, or the launch point */
+		const NavSolution& navTo (const Location& target, const Location& legStart = Location());	/**< Navigation solution from the last fix to target, recomputed only if the fix or the target has changed */
+		const NavSolution& getNav ();								/**< Navigation solution to getCurrentTarget() */
 
 		sysclock				lastContact;		/**< Time of last shore contact */
 		sysclock				lastRC;				/**< Time of the last signal from the RC input */
 		GPSFix					lastFix;			/**< Location of the last GPS fix */
 		Location				launchPoint;		/**< Location of the launch point */
 		Location				anchorPoint;		/**< Location of the anchor point */
+		static const FieldDescriptor fields[];		/**< Members written and read by writeJSON() and readJSON() */
+		static const CSVColumn<BoatState> csvColumns[];	/**< Columns written by getCSV() and named by getCSVheaders() */
 		Waypoints				waypointList;		/**< Waypoints to follow */
 		Dodge*					diversion;			/**< Avoid obstacles! */
 		HealthMonitor*			health;				/**< Current state of the boat's health */
@@ -136,11 +165,16 @@ class BoatState : public HackerboatState {
 		GPSdInput*				gps = 0;			/**< GPS input thread */
 		OrientationInput*		orient = 0;			/**< Orientation input thread */
 		RelayMap*				relays = 0;			/**< Pointer to relay singleton */
+		ControlExecutive*		executive = 0;		/**< Control loop executive, for runtime timing statistics */
 
 		tuple<double, double, double> K;			/**< Steering PID gains. Proportional, integral, and differential, respectively. */
 
 	private:
-		std::list<Command*>	cmdvec;
+		template <typename Handler> bool write (Handler& handler) const;	/**< Shared by writeJSON() and pack() */
+
+		FixedQueue<Command*, COMMAND_POOL_SIZE>	cmdvec;
+		char			_csvLine[CSV_LINE_SIZE];
+		NavSolution		_navSolution;
 		std::string 	faultString = "";
 		BoatModeEnum 	_boat = BoatModeEnum::NONE;
 		NavModeEnum		_nav = NavModeEnum::NONE;
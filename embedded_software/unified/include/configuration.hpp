@@ -31,6 +31,7 @@ using namespace std::chrono;
 
 typedef chrono::system_clock::duration sysdur;
 typedef tuple<string, uint8_t, uint8_t, uint8_t, uint8_t> RelaySpec;
+typedef tuple<string, int, int> ThreadSpec;		/**< Scheduling policy, priority (nice value for Other), and CPU (-1 for any) */
 
 class Conf {
 	public:
@@ -98,12 +99,24 @@ class Conf {
 		inline const sysdur& 		restTimeout () 			{return _restTimeout;};
 		inline const int&  			restMaxBuf () 			{return _restMaxBuf;};
 		inline const int&  			restMaxCount () 		{return _restMaxCount;};
-		inline const string& 		wdFile () 				{return _wdFile;};
+		inline const string& 		heartbeatName () 		{return _heartbeatName;};
 		inline const sysdur& 		wdTimeout () 			{return _wdTimeout;};
+		inline const sysdur& 		wdCheckPeriod () 		{return _wdCheckPeriod;};
 		inline const unsigned int&	RCchannelCount ()		{return _RCchannelCount;};
 		inline const map<string, RelaySpec>& 	relayInit()	{return _relayInit;};
 		inline const unsigned int&	aisMaxDistance ()		{return _aisMaxDistance;};
+		inline const bool&			aisRawNMEA ()			{return _aisRawNMEA;};
+		inline const float&			approxMaxDistance ()	{return _approxMaxDistance;};
 		inline const sysdur&		selfTestDelay ()		{return _selfTestDelay;};
+		inline const sysdur&		controlPeriod ()		{return _controlPeriod;};
+		inline const string&		controlOverrunPolicy ()	{return _controlOverrunPolicy;};
+		inline const string&		inputMode ()			{return _inputMode;};
+		inline const sysdur&		inputEventTimeout ()	{return _inputEventTimeout;};
+		inline const map<string, ThreadSpec>&	threadSchedule () {return _threadSchedule;};
+		inline const bool&			lockMemory ()			{return _lockMemory;};
+		inline const string&		recorderPath ()			{return _recorderPath;};
+		inline const unsigned int&	recorderSlots ()		{return _recorderSlots;};
+		inline const sysdur&		recorderSyncPeriod ()	{return _recorderSyncPeriod;};
 
 	private:
 		Conf ();						
@@ -118,6 +131,7 @@ class Conf {
 		int Fetch(const string& name, float& target);
 		int Fetch(const string& name, int& target);
 		int Fetch(const string& name, sysdur& target);
+		int Fetch(const string& name, bool& target);
 		int Fetch(const string& name, Value& target);
 
 		Document d;
@@ -183,12 +197,24 @@ class Conf {
 		sysdur			_restTimeout;
 		int 			_restMaxBuf;
 		int 			_restMaxCount;
-		string			_wdFile;
+		string			_heartbeatName;
 		sysdur			_wdTimeout;
+		sysdur			_wdCheckPeriod;
 		map<string, RelaySpec>	_relayInit;
 		unsigned int 	_RCchannelCount;
 		unsigned int 	_aisMaxDistance;
+		bool			_aisRawNMEA;
+		float			_approxMaxDistance;
 		sysdur			_selfTestDelay;
+		sysdur			_controlPeriod;
+		string			_controlOverrunPolicy;
+		string			_inputMode;
+		sysdur			_inputEventTimeout;
+		map<string, ThreadSpec>	_threadSchedule;
+		bool			_lockMemory;
+		string			_recorderPath;
+		unsigned int	_recorderSlots;
+		sysdur			_recorderSyncPeriod;
 };
 
 #endif /* CONFIGURATION_H */
\ No newline at end of file
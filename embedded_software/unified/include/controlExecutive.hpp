@@ -0,0 +1,92 @@
+/******************************************************************************
+ * Hackerboat control executive module
+ * controlExecutive.hpp
+ * This module paces the master control loop off the monotonic clock
+ *
+ * See the Hackerboat documentation for more details
+ * Written by agent, Oct 2026
+ *
+ * Version 0.1: First alpha
+ *
+ ******************************************************************************/
+
+#ifndef CONTROLEXECUTIVE_H
+#define CONTROLEXECUTIVE_H
+
+#include <chrono>
+#include <atomic>
+#include <string>
+#include <inttypes.h>
+#include "hackerboatRoot.hpp"
+#include "enumtable.hpp"
+#include "enumdefs.hpp"
+
+using namespace std;
+using namespace std::chrono;
+
+/**
+ * @class ControlExecutive
+ *
+ * @brief Periodic executive for the master control loop.
+ *
+ * Cycles are scheduled on CLOCK_MONOTONIC through a timerfd, so wall clock steps from NTP or
+ * GPS time do not stretch or collapse the loop. If the timerfd cannot be created the executive
+ * falls back to sleeping on steady_clock. When a cycle runs past its deadline, the missed ticks
+ * are either dropped or run back-to-back, depending on the overrun policy.
+ *
+ * The statistics are atomics so that they can be read from other threads while the loop runs.
+ */
+
+class ControlExecutive : public HackerboatState {
+	public:
+		static const EnumNameTable<OverrunPolicyEnum> overrunPolicyNames;
+		static const unsigned int maxCatchUp = 5;						/**< Maximum number of missed cycles we'll run back-to-back */
+
+		ControlExecutive ();											/**< Create an executive with the period and policy from the configuration */
+		ControlExecutive (nanoseconds period, OverrunPolicyEnum policy);
+		~ControlExecutive ();
+		bool parse (Value& input) {return false;};						/**< Statistics are read-only */
+		Value pack () const;
+		bool begin ();													/**< Arm the cycle timer. Returns false if we had to fall back to steady_clock sleeps */
+		bool wait ();													/**< Block until the start of the next cycle. Returns false if the previous cycle overran */
+		void resetStats ();												/**< Zero all counters and extremes */
+
+		nanoseconds getPeriod () const {return _period;};
+		OverrunPolicyEnum getPolicy () const {return _policy;};
+		bool usingTimerFD () const {return (_timerfd >= 0);};
+		uint64_t cycles () const {return _cycles.load();};				/**< Number of cycles started */
+		uint64_t overruns () const {return _overruns.load();};			/**< Number of cycles that ran past their deadline */
+		uint64_t skipped () const {return _skipped.load();};			/**< Number of ticks dropped without running a cycle */
+		uint64_t caughtUp () const {return _caughtUp.load();};			/**< Number of cycles run back-to-back to recover missed ticks */
+		bool timed () const {return _timed;};							/**< True if the last wait() waited for a tick, false if it ran an owed cycle straight away */
+		nanoseconds lastJitter () const {return nanoseconds(_lastJitter.load());};	/**< Wakeup lateness of the last timed cycle */
+		nanoseconds maxJitter () const {return nanoseconds(_maxJitter.load());};	/**< Worst wakeup lateness seen */
+		nanoseconds meanJitter () const;											/**< Mean wakeup lateness */
+		nanoseconds lastExecTime () const {return nanoseconds(_lastExec.load());};	/**< Time spent in the last complete cycle */
+		nanoseconds maxExecTime () const {return nanoseconds(_maxExec.load());};	/**< Longest cycle seen */
+
+	private:
+		uint64_t waitTicks ();											/**< Block until the next tick and return the number of periods that have elapsed */
+
+		nanoseconds					_period;
+		OverrunPolicyEnum			_policy;
+		int							_timerfd = -1;
+		bool						_started = false;
+		bool						_timed = false;						/**< Last cycle started on a tick rather than being caught up */
+		unsigned int				_owed = 0;							/**< Missed cycles still to be run under the catch-up policy */
+		steady_clock::time_point	_next;								/**< Deadline of the next tick */
+		steady_clock::time_point	_cycleStart;						/**< Start time of the cycle in progress */
+
+		atomic<uint64_t>			_cycles {0};
+		atomic<uint64_t>			_overruns {0};
+		atomic<uint64_t>			_skipped {0};
+		atomic<uint64_t>			_caughtUp {0};
+		atomic<uint64_t>			_jitterSamples {0};
+		atomic<int64_t>				_jitterSum {0};
+		atomic<int64_t>				_lastJitter {0};
+		atomic<int64_t>				_maxJitter {0};
+		atomic<int64_t>				_lastExec {0};
+		atomic<int64_t>				_maxExec {0};
+};
+
+#endif /* CONTROLEXECUTIVE_H */
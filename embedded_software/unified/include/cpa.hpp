@@ -0,0 +1,97 @@
+/******************************************************************************
+ * Hackerboat collision risk module
+ * cpa.hpp
+ * This module finds the closest point of approach to every AIS contact
+ * at once and ranks the contacts by how close they will come
+ *
+ * See the Hackerboat documentation for more details
+ * Written by agent, Oct 2026
+ *
+ * Version 0.1: First alpha
+ *
+ ******************************************************************************/
+
+#ifndef CPA_H
+#define CPA_H
+
+#include <inttypes.h>
+#include <vector>
+#include "hackerboatRoot.hpp"
+#include "location.hpp"
+#include "twovector.hpp"
+#include "ais.hpp"
+#include "aisStore.hpp"
+
+#define CPA_HORIZON		(1800.0)		/**< Seconds ahead to look for the closest approach; a later one counts as happening then */
+#define CPA_REPORT_CONTACTS	(8)		/**< Contacts in each published CPAReport */
+
+/**
+ * @brief The closest approach of one contact.
+ *
+ * What it needs of the contact is copied in, so it stays good after the store changes and can be handed
+ * to another thread.
+ */
+struct CPARisk {
+	int			mmsi = -1;					/**< The contact */
+	AISShipType	shiptype = AISShipType::UNAVAILABLE;
+	Location	fix;						/**< Where the contact was last reported */
+	double		range = NAN;				/**< Distance to the contact now, meters */
+	double		bearing = NAN;				/**< Bearing to the contact now, degrees true */
+	double		cpa = NAN;					/**< Distance at the closest approach, meters */
+	double		tcpa = NAN;					/**< Seconds until the closest approach; zero if the contact is already opening */
+	TwoVector	offset;						/**< Position of the contact relative to us at the closest approach, meters north (x) and east (y) */
+};
+
+/**
+ * @brief One assessment, as published by the GPS input thread.
+ */
+struct CPAReport {
+	sysclock				time;			/**< When the assessment was made */
+	size_t					assessed = 0;	/**< Number of contacts looked at */
+	std::vector<CPARisk>	risks;			/**< Up to CPA_REPORT_CONTACTS contacts, nearest approach first */
+};
+
+/**
+ * @class CPAEngine
+ *
+ * @brief Closest point of approach and time to it for every live contact, worked out in one pass.
+ *
+ * Each contact is dead reckoned from its last report to now and laid out, along with its velocity
+ * relative to ours, as separate arrays of north and east components in a plane centered on us, scaled
+ * by the radii of curvature halfway to each contact. Within the range of AIS that keeps the ranges good
+ * to well under a meter, a small fraction of any sensible passing distance. The closest approach is then
+ * solved for all of them at once in the vector lanes of the batched kernels, and the contacts that
+ * come closest within the horizon are returned nearest first.
+ *
+ * Contacts without a speed or course are taken to be stopped, and contacts not heard from in aisMaxTime()
+ * are left out. All of the working space is kept between calls, so once it has grown to the number of
+ * contacts, assess() doesn't allocate.
+ *
+ * The engine reads the store in place, so it must run on the thread that owns the store. GPSdInput runs
+ * it after every fix and publishes the result for the other threads.
+ */
+
+class CPAEngine {
+	public:
+		CPAEngine () = default;
+		size_t assess (const Location& here, double speed, double course, AISContactStore& contacts, sysclock now,
+					   size_t count, double horizon = CPA_HORIZON);	/**< Find the count contacts that come closest to us, going at speed m/s on course degrees true. Returns the number found */
+		const std::vector<CPARisk>& risks () const {return _risks;};	/**< Results of the last assess(), nearest approach first */
+		size_t assessed () const {return _assessed;};	/**< Number of contacts the last assess() looked at */
+
+	private:
+		size_t						_assessed = 0;
+		std::vector<CPARisk>		_risks;
+		std::vector<AISShip*>		_ships;			/**< Working space, one entry per contact */
+		std::vector<float>			_north;
+		std::vector<float>			_east;
+		std::vector<float>			_velNorth;
+		std::vector<float>			_velEast;
+		std::vector<float>			_cpa;
+		std::vector<float>			_tcpa;
+		std::vector<float>			_cpaNorth;
+		std::vector<float>			_cpaEast;
+		std::vector<uint32_t>		_order;
+};
+
+#endif /* CPA_H */
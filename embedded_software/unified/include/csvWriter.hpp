@@ -0,0 +1,114 @@
+/******************************************************************************
+ * Hackerboat CSV writer module
+ * csvWriter.hpp
+ * This module writes CSV lines straight into a caller-supplied buffer, with
+ * the columns and their headers described by a single static table
+ *
+ * See the Hackerboat documentation for more details
+ * Written by agent, Oct 2026
+ *
+ * Version 0.1: First alpha
+ *
+ ******************************************************************************/
+
+#ifndef CSVWRITER_H
+#define CSVWRITER_H
+
+#include <cstddef>
+#include <string>
+#include <chrono>
+#include <inttypes.h>
+
+#define CSV_SHORTEST		(-1)			/**< Precision that gives a short form that reads back as the same double */
+#define CSV_MAX_PRECISION	(9)				/**< Most decimal places a fixed precision column can have */
+#define CSV_NUMBER_SIZE		(32)			/**< Buffer size that holds any number formatDouble() writes, with its terminator */
+#define CSV_LINE_SIZE		(512)			/**< Buffer size that holds any line we write */
+
+/**
+ * @brief Format v into buf, which must hold CSV_NUMBER_SIZE bytes, and return the length.
+ *
+ * With CSV_SHORTEST, v is written with the digits rapidjson's Grisu2 produces, the same ones the json
+ * writer uses. strtod() reads them back as exactly v, and they are usually but not always the fewest
+ * that would. Very large or small values switch to exponent form. Otherwise v is rounded to precision
+ * decimal places (at most CSV_MAX_PRECISION). Non-finite values are written as nan, inf or -inf. Does not
+ * allocate or call printf().
+ */
+
+size_t formatDouble (double v, int precision, char *buf);
+
+/**
+ * @class CSVWriter
+ *
+ * @brief Appends fields to a line in a fixed buffer, adding the separators and quoting as it goes.
+ *
+ * If a field doesn't fit, it and everything after it is dropped and full() becomes true. The line is
+ * always terminated. Nothing here allocates.
+ */
+
+class CSVWriter {
+	public:
+		CSVWriter (char *buf, size_t len);
+		CSVWriter& number (double v, int precision = CSV_SHORTEST);	/**< Write a number, as formatDouble() does */
+		CSVWriter& integer (int64_t v);
+		CSVWriter& text (const char *str, size_t len);					/**< Write a string, quoted if it holds a separator, quote or newline */
+		CSVWriter& text (const char *str);
+		CSVWriter& text (const std::string& str) {return text(str.c_str(), str.size());};
+		CSVWriter& time (std::chrono::system_clock::time_point t);	/**< Write a time as HackerboatState::packTime() does */
+		void clear ();												/**< Start a new line in the same buffer */
+		const char* line () const {return _buf;};
+		size_t size () const {return _used;};
+		bool full () const {return _full;};						/**< True if anything has been dropped since the last clear() */
+
+	private:
+		char* field (size_t len);									/**< Room for a field of len bytes after its separator, or NULL */
+		void commit (char *end);									/**< Close off the field ending at end */
+
+		char		*_buf;
+		size_t		_len;
+		size_t		_used = 0;
+		bool		_full = false;
+		bool		_first = true;
+};
+
+/**
+ * @brief One column of a CSV table. Tables are arrays of these ending with CSV_END.
+ *
+ * The header and the code that writes the column live in the same entry, so the header line and the
+ * data lines always agree.
+ */
+
+template <typename Row>
+struct CSVColumn {
+	const char	*header;											/**< Column header. NULL marks the end of the table */
+	int			precision;											/**< Decimal places for numbers, or CSV_SHORTEST */
+	void		(*write)(Row& row, CSVWriter& out, int precision);	/**< Write this column's field for row */
+};
+
+#define CSV_END		{ NULL, 0, NULL }
+
+/**
+ * @brief Read the field that starts at p into out, undoing the quoting that CSVWriter::text() adds.
+ *
+ * Returns the start of the next field, or end if this was the last one. out keeps its capacity, so
+ * reading a line into the same strings over and over doesn't allocate once they are big enough.
+ */
+
+const char* readCSVField (const char *p, const char *end, std::string& out);
+
+template <typename Row>
+bool writeCSVHeaders (const CSVColumn<Row> *columns, CSVWriter& out) {
+	for (const CSVColumn<Row> *c = columns; c->header; c++) {
+		out.text(c->header);
+	}
+	return !out.full();
+}
+
+template <typename Row>
+bool writeCSVRow (const CSVColumn<Row> *columns, Row& row, CSVWriter& out) {
+	for (const CSVColumn<Row> *c = columns; c->header; c++) {
+		c->write(row, out, c->precision);
+	}
+	return !out.full();
+}
+
+#endif /* CSVWRITER_H */
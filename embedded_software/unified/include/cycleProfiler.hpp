@@ -0,0 +1,116 @@
+/******************************************************************************
+ * Hackerboat cycle profiler module
+ * cycleProfiler.hpp
+ * This module keeps latency histograms for the stages of the control cycle
+ *
+ * See the Hackerboat documentation for more details
+ * Written by agent, Oct 2026
+ *
+ * Version 0.1: First alpha
+ *
+ ******************************************************************************/
+
+#ifndef CYCLEPROFILER_H
+#define CYCLEPROFILER_H
+
+#include <chrono>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <inttypes.h>
+#include "hackerboatRoot.hpp"
+#include "enumtable.hpp"
+#include "enumdefs.hpp"
+#include "controlExecutive.hpp"
+
+using namespace std;
+using namespace std::chrono;
+
+/**
+ * @class LatencyHistogram
+ *
+ * @brief Fixed-bucket, lock-free latency histogram.
+ *
+ * Samples are binned by microsecond in four sub-buckets per power of two, so any reported
+ * percentile is within 25% of the true value. Recording is a handful of relaxed atomic
+ * operations and never allocates, so it is safe to call every cycle from any thread.
+ */
+
+class LatencyHistogram : public HackerboatState {
+	public:
+		static const int subBuckets = 4;								/**< Buckets per power of two */
+		static const int bucketCount = 120;								/**< Covers up to 2^31 us, about 35 minutes */
+
+		LatencyHistogram ();
+		bool parse (Value& input) {return false;};						/**< Histograms are read-only */
+		Value pack () const;											/**< Pack count, mean, p50, p90, p99 and max, all in microseconds */
+		void record (nanoseconds sample);								/**< Add a sample */
+		void reset ();													/**< Discard all samples */
+		uint64_t count () const {return _count.load(memory_order_relaxed);};
+		nanoseconds max () const {return nanoseconds(_max.load(memory_order_relaxed));};
+		nanoseconds mean () const;
+		nanoseconds percentile (double p) const;						/**< Upper bound of the bucket holding the p-th percentile, p in [0,100] */
+
+	private:
+		static int bucketIndex (uint64_t us);
+		static uint64_t bucketUpper (int index);
+
+		atomic<uint32_t>	_buckets[bucketCount];
+		atomic<uint64_t>	_count;
+		atomic<uint64_t>	_sum;										/**< Sum of all samples, ns */
+		atomic<uint64_t>	_max;										/**< Largest sample, ns */
+};
+
+/**
+ * @class CycleProfiler
+ *
+ * @brief Per-stage latency histograms for the master control cycle.
+ *
+ * The stages nest: BOAT_MODE includes NAV_MODE, which includes SUB_MODE, and CYCLE includes everything.
+ * Stats dumps requested by shore command are held here until the AIO publisher picks them up.
+ */
+
+class CycleProfiler : public HackerboatState {
+	public:
+		static const EnumNameTable<CycleStageEnum> stageNames;
+		static CycleProfiler* get () {return _instance;};
+
+		bool parse (Value& input) {return false;};						/**< Statistics are read-only */
+		Value pack () const;											/**< Pack the histograms of all stages */
+		void record (CycleStageEnum stage, nanoseconds sample);			/**< Add a sample to the given stage */
+		LatencyHistogram& stage (CycleStageEnum stage) {return _stages[static_cast<int>(stage)];};
+		void reset ();													/**< Discard all samples for all stages */
+		std::string report (const ControlExecutive* executive = NULL) const;	/**< Stats dump as a JSON string, with executive statistics if given and thread wakeup latencies */
+		void postReply (const std::string& reply);						/**< Queue a stats dump to be sent to the shore */
+		bool takeReply (std::string& reply);							/**< Fetch a queued stats dump, if any. Returns false if none is waiting */
+
+	private:
+		CycleProfiler () = default;
+		CycleProfiler (CycleProfiler const&) = delete;					/**< Hark, a singleton! */
+		CycleProfiler& operator=(CycleProfiler const&) = delete;		/**< Hark, a singleton! */
+		static CycleProfiler *_instance;
+
+		LatencyHistogram	_stages[static_cast<int>(CycleStageEnum::NONE)];
+		std::mutex			_replyLock;
+		std::string			_reply;
+		bool				_replyPending = false;
+};
+
+/**
+ * @class StageTimer
+ *
+ * @brief Times the enclosing scope and records it against the given stage when it goes out of scope.
+ */
+
+class StageTimer {
+	public:
+		StageTimer (CycleStageEnum stage) : _stage(stage), _start(steady_clock::now()) {};
+		~StageTimer () {CycleProfiler::get()->record(_stage, steady_clock::now() - _start);};
+	private:
+		StageTimer (StageTimer const&) = delete;
+		StageTimer& operator=(StageTimer const&) = delete;
+		CycleStageEnum				_stage;
+		steady_clock::time_point	_start;
+};
+
+#endif /* CYCLEPROFILER_H */
@@ -82,4 +82,52 @@ enum class ArmButtonStateEnum : int {
 	INVALID	/**< Button state is invalid, i.e. faulted. */
 };
 
+/**
+ * @brief What the control executive does when a cycle runs past its deadline
+ */
+
+enum class OverrunPolicyEnum : int {
+	SKIP		= 0,		/**< Drop the missed ticks and resume on the next period boundary	*/
+	CATCHUP		= 1,		/**< Run the missed cycles back-to-back until we are back on schedule */
+	NONE		= 2			/**< No policy specified							*/
+};
+
+/**
+ * @brief Stages of the master control cycle that are timed by the cycle profiler
+ */
+
+enum class CycleStageEnum : int {
+	INPUT		= 0,		/**< Copying the GPS fix and other inputs into the boat state	*/
+	HEALTH		= 1,		/**< Reading the health monitor						*/
+	COMMANDS	= 2,		/**< Executing queued shore commands				*/
+	BOAT_MODE	= 3,		/**< Top level boat mode, including all sub-modes	*/
+	NAV_MODE	= 4,		/**< Navigation mode, including its sub-mode		*/
+	SUB_MODE	= 5,		/**< Autonomous or RC sub-mode						*/
+	LOG			= 6,		/**< Generating and logging the CSV line			*/
+	CYCLE		= 7,		/**< The entire cycle, excluding the wait for the next tick */
+	NONE		= 8			/**< Number of stages; not a real stage				*/
+};
+
+/**
+ * @brief How input threads decide when to read their inputs
+ */
+
+enum class InputModeEnum : int {
+	PERIODIC	= 0,		/**< Every input wakes up once per period				*/
+	EVENT		= 1,		/**< Inputs with a file descriptor wait for it to become readable */
+	REACTOR		= 2,		/**< All inputs share one thread, driven by epoll and timerfds */
+	NONE		= 3			/**< No mode specified								*/
+};
+
+/**
+ * @brief Linux scheduling policies that a thread can be given
+ */
+
+enum class SchedPolicyEnum : int {
+	OTHER		= 0,		/**< Normal time-sharing; the priority is used as the nice value */
+	FIFO		= 1,		/**< Real-time, runs until it blocks or something higher-priority wakes */
+	RR			= 2,		/**< Real-time, round-robin among threads of equal priority */
+	NONE		= 3			/**< No policy specified							*/
+};
+
 #endif
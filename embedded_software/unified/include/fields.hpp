@@ -0,0 +1,373 @@
+/******************************************************************************
+ * Hackerboat field descriptor module
+ * fields.hpp
+ * This module describes the members of HackerboatState objects in static
+ * tables, so they can be written to and read from json without building
+ * intermediate rapidjson Values. pack() and parse() go through the same
+ * tables, so each type lists its members once
+ *
+ * See the Hackerboat documentation for more details
+ * Written by agent, Oct 2026
+ *
+ * Version 0.1: First alpha
+ *
+ ******************************************************************************/
+
+#ifndef FIELDS_H
+#define FIELDS_H
+
+#include <chrono>
+#include <string>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <climits>
+#include <inttypes.h>
+#include "rapidjson/rapidjson.h"
+#include "rapidjson/reader.h"
+#include "rapidjson/document.h"
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
+#include "enumtable.hpp"
+#include "jsonScope.hpp"
+
+#define FIELD_MAX_DEPTH		(8)			/**< Deepest nesting of objects that FieldReader will follow */
+#define FIELD_STACK_SIZE	(256)		/**< Bytes of stack a FieldDocument starts with when building a Value */
+#define TIME_STRING_SIZE	(24)		/**< Bytes needed for a packed time, including the terminating NUL */
+
+typedef rapidjson::Writer<rapidjson::StringBuffer> JSONWriter;
+typedef rapidjson::GenericDocument<rapidjson::UTF8<>, rapidjson::MemoryPoolAllocator<>, rapidjson::MemoryPoolAllocator<>> FieldDocument;	/**< SAX handler that builds a Value */
+
+/**
+ * @brief How a field is represented in json.
+ */
+
+enum class FieldKind {
+	DOUBLE,		/**< Number. Non-finite values are written as null */
+	INT,		/**< Integer */
+	BOOL,		/**< true or false */
+	STRING,		/**< String */
+	TIME,		/**< ISO 8601 string, as produced by HackerboatState::packTime() */
+	ENUM,		/**< String taken from an EnumNameTable */
+	OBJECT		/**< Nested object with its own field table */
+};
+
+/**
+ * @brief A single scalar on its way into or out of an object.
+ *
+ * Strings are not copied, so s is only good until the object or the parser buffer it points into changes.
+ * For ENUM fields, get() fills in both the integer value and the name.
+ */
+
+struct FieldValue {
+	enum Type { NONE, BOOL, INT, DOUBLE, STRING };
+
+	FieldValue () : type(NONE) {};
+	explicit FieldValue (bool v) : type(BOOL), b(v) {};
+	explicit FieldValue (int64_t v) : type(INT), i(v) {};
+	explicit FieldValue (double v) : type(DOUBLE), d(v) {};
+	FieldValue (const char *v, size_t n) : type(STRING), s(v), len(n) {};
+	bool isNumber () const {return ((type == INT) || (type == DOUBLE));};
+	double number () const {return (type == INT) ? (double)i : d;};
+
+	Type		type;
+	bool		b = false;
+	int64_t		i = 0;
+	double		d = 0;
+	const char	*s = NULL;
+	size_t		len = 0;
+};
+
+/**
+ * @brief One entry in a type's field table.
+ *
+ * Tables are arrays of these ending with FIELD_END. They are built at compile time with the FIELD() and
+ * ENUM_FIELD() macros, so the table for a type costs nothing to set up and needs no registration.
+ */
+
+struct FieldDescriptor {
+	const char				*name;								/**< json key. NULL marks the end of the table */
+	FieldKind				kind;
+	uint8_t					width;								/**< Bytes the value takes in a binary record. 0 for strings, bools and objects, which are not fixed */
+	FieldValue				(*get)(const void *obj);			/**< Read the member out of obj. NULL for OBJECT fields */
+	bool					(*set)(void *obj, const FieldValue& value);	/**< Store value into obj. Returns false if it is the wrong type */
+	void*					(*child)(void *obj);				/**< OBJECT fields only; the nested object inside obj */
+	const FieldDescriptor	*fields;							/**< OBJECT fields only; the nested object's table */
+	FieldValue				(*lookup)(int64_t value);			/**< ENUM fields only; the value and name for an integer, as get() would give them */
+};
+
+#define FIELD_END							{ NULL, FieldKind::INT, 0, NULL, NULL, NULL, NULL, NULL }
+#define FIELD(codec, name, cls, member)		codec<cls, decltype(&cls::member), &cls::member>::describe(name)
+#define ENUM_FIELD(name, cls, member, names)	EnumField<cls, decltype(&cls::member), &cls::member, &names>::describe(name)
+#define NESTED_FIELD(codec, name, cls, member, inner, field)	NestedField<cls, decltype(&cls::member), &cls::member, codec<inner, decltype(&inner::field), &inner::field>>::describe(name)
+
+template <typename P> struct FieldMember;
+template <typename B, typename T> struct FieldMember<T B::*> {
+	typedef T type;						/**< The type of the member a member pointer refers to */
+};
+
+bool parseFieldTime (const FieldValue& value, std::chrono::system_clock::time_point& t);	/**< Defined in fields.cpp, where HackerboatState::parseTime() is visible */
+size_t packFieldTime (int64_t ms, char *buf, size_t len);	/**< HackerboatState::packTime() of a time in milliseconds since the epoch */
+
+// Codecs. C is the class that owns the table; P and M are the type and value of the member pointer, which
+// may point into a base class of C.
+
+template <typename C, typename P, P M>
+struct DoubleField {
+	static FieldValue get (const void *obj) {return FieldValue(static_cast<const C*>(obj)->*M);};
+	static bool set (void *obj, const FieldValue& v) {
+		if (v.isNumber()) {
+			static_cast<C*>(obj)->*M = v.number();
+		} else if (v.type == FieldValue::NONE) {
+			static_cast<C*>(obj)->*M = NAN;
+		} else return false;
+		return true;
+	};
+	static constexpr FieldDescriptor describe (const char *name) {return { name, FieldKind::DOUBLE, sizeof(double), &get, &set, NULL, NULL, NULL };};
+};
+
+template <typename C, typename P, P M>
+struct IntField {
+	typedef typename FieldMember<P>::type T;
+	static FieldValue get (const void *obj) {return FieldValue((int64_t)(static_cast<const C*>(obj)->*M));};
+	static bool set (void *obj, const FieldValue& v) {
+		if ((v.type != FieldValue::INT) ||
+			(v.i < (int64_t)std::numeric_limits<T>::min()) ||
+			(v.i > (int64_t)std::numeric_limits<T>::max())) return false;
+		static_cast<C*>(obj)->*M = v.i;
+		return true;
+	};
+	static constexpr FieldDescriptor describe (const char *name) {return { name, FieldKind::INT, sizeof(T), &get, &set, NULL, NULL, NULL };};
+};
+
+template <typename C, typename P, P M>
+struct BoolField {
+	static FieldValue get (const void *obj) {return FieldValue((bool)(static_cast<const C*>(obj)->*M));};
+	static bool set (void *obj, const FieldValue& v) {
+		if (v.type != FieldValue::BOOL) return false;
+		static_cast<C*>(obj)->*M = v.b;
+		return true;
+	};
+	static constexpr FieldDescriptor describe (const char *name) {return { name, FieldKind::BOOL, 0, &get, &set, NULL, NULL, NULL };};
+};
+
+template <typename C, typename P, P M>
+struct StringField {
+	static FieldValue get (const void *obj) {
+		const std::string& str = static_cast<const C*>(obj)->*M;
+		return FieldValue(str.c_str(), str.size());
+	};
+	static bool set (void *obj, const FieldValue& v) {
+		if (v.type != FieldValue::STRING) return false;
+		(static_cast<C*>(obj)->*M).assign(v.s, v.len);
+		return true;
+	};
+	static constexpr FieldDescriptor describe (const char *name) {return { name, FieldKind::STRING, 0, &get, &set, NULL, NULL, NULL };};
+};
+
+template <typename C, typename P, P M>
+struct TimeField {
+	static FieldValue get (const void *obj) {			/**< Milliseconds since the epoch */
+		auto t = static_cast<const C*>(obj)->*M;
+		return FieldValue((int64_t)std::chrono::duration_cast<std::chrono::milliseconds>(t.time_since_epoch()).count());
+	};
+	static bool set (void *obj, const FieldValue& v) {return parseFieldTime(v, static_cast<C*>(obj)->*M);};
+	static constexpr FieldDescriptor describe (const char *name) {return { name, FieldKind::TIME, sizeof(int64_t), &get, &set, NULL, NULL, NULL };};
+};
+
+template <typename C, typename P, P M, const EnumNameTable<typename FieldMember<P>::type> *Names>
+struct EnumField {
+	typedef typename FieldMember<P>::type E;
+	static FieldValue get (const void *obj) {return lookup(static_cast<int>(static_cast<const C*>(obj)->*M));};
+	static FieldValue lookup (int64_t i) {
+		FieldValue v(i);
+		if ((i >= INT_MIN) && (i <= INT_MAX) && Names->valid((int)i)) {
+			const std::string& name = Names->get(static_cast<E>(i));
+			v.s = name.c_str();
+			v.len = name.size();
+		}
+		return v;
+	};
+	static bool set (void *obj, const FieldValue& v) {
+		if (v.type == FieldValue::STRING) {
+			return Names->get(std::string(v.s, v.len), &(static_cast<C*>(obj)->*M));
+		} else if ((v.type == FieldValue::INT) && Names->valid((int)v.i)) {
+			static_cast<C*>(obj)->*M = static_cast<E>(v.i);
+			return true;
+		}
+		return false;
+	};
+	static constexpr FieldDescriptor describe (const char *name) {return { name, FieldKind::ENUM, 2, &get, &set, NULL, NULL, &lookup };};
+};
+
+template <typename C, typename P, P M>
+struct EnumIntField {									/**< Enum packed as its integer value rather than a name */
+	typedef typename FieldMember<P>::type E;
+	static FieldValue get (const void *obj) {return FieldValue((int64_t)static_cast<int>(static_cast<const C*>(obj)->*M));};
+	static bool set (void *obj, const FieldValue& v) {
+		if (v.type != FieldValue::INT) return false;
+		static_cast<C*>(obj)->*M = static_cast<E>(v.i);
+		return true;
+	};
+	static constexpr FieldDescriptor describe (const char *name) {return { name, FieldKind::INT, sizeof(E), &get, &set, NULL, NULL, NULL };};
+};
+
+template <typename C, typename P, P M, typename Codec>
+struct NestedField {									/**< A member of one of C's members, read and written as though it were C's own */
+	static FieldValue get (const void *obj) {return Codec::get(&(static_cast<const C*>(obj)->*M));};
+	static bool set (void *obj, const FieldValue& v) {return Codec::set(&(static_cast<C*>(obj)->*M), v);};
+	static constexpr FieldDescriptor describe (const char *name) {
+		return { name, Codec::describe(name).kind, Codec::describe(name).width, &get, &set, NULL, NULL, NULL };
+	};
+};
+
+template <typename C, typename P, P M>
+struct ObjectField {									/**< The member's type must have its own table named fields */
+	typedef typename FieldMember<P>::type T;
+	static void* child (void *obj) {return &(static_cast<C*>(obj)->*M);};
+	static constexpr FieldDescriptor describe (const char *name) {return { name, FieldKind::OBJECT, 0, NULL, NULL, &child, T::fields, NULL };};
+};
+
+/**
+ * @brief Write a single value the way writeFields() would write a field of the given kind.
+ */
+
+template <typename Handler>
+bool writeFieldValue (FieldKind kind, const FieldValue& v, Handler& handler) {
+	switch (kind) {
+		case FieldKind::DOUBLE:
+			if (!std::isfinite(v.d)) return handler.Null();		// strict json has no NaN
+			return handler.Double(v.d);
+		case FieldKind::INT:
+			return handler.Int64(v.i);
+		case FieldKind::BOOL:
+			return handler.Bool(v.b);
+		case FieldKind::TIME: {
+			char t[TIME_STRING_SIZE];
+			size_t len = packFieldTime(v.i, t, sizeof(t));
+			return handler.String(t, len, true);
+		}
+		case FieldKind::STRING:
+		case FieldKind::ENUM:
+			if (!v.s) return handler.Null();						// enum value with no name
+			return handler.String(v.s, v.len, true);
+		default:
+			return false;
+	}
+}
+
+/**
+ * @brief Write the members described by fields as keys and values of an object the caller has opened.
+ *
+ * members is incremented once per member, for the caller to hand to EndObject().
+ */
+
+template <typename Handler>
+bool writeFieldMembers (const FieldDescriptor *fields, const void *obj, Handler& handler, rapidjson::SizeType& members);
+
+/**
+ * @brief Write the object described by fields as a json object, straight to a SAX handler.
+ *
+ * The handler is usually a JSONWriter. A FieldDocument builds a Value instead, as packFields() does.
+ */
+
+template <typename Handler>
+bool writeFields (const FieldDescriptor *fields, const void *obj, Handler& handler) {
+	rapidjson::SizeType members = 0;
+	return (handler.StartObject() && writeFieldMembers(fields, obj, handler, members) && handler.EndObject(members));
+}
+
+template <typename Handler>
+bool writeFieldMembers (const FieldDescriptor *fields, const void *obj, Handler& handler, rapidjson::SizeType& members) {
+	bool result = true;
+	for (const FieldDescriptor *f = fields; f->name && result; f++, members++) {
+		result &= handler.Key(f->name, strlen(f->name), false);
+		if (f->kind == FieldKind::OBJECT) {
+			result &= writeFields(f->fields, f->child(const_cast<void*>(obj)), handler);
+		} else {
+			result &= writeFieldValue(f->kind, f->get(obj), handler);
+		}
+	}
+	return result;
+}
+
+/**
+ * @brief Build a Value in the calling thread's JSONScope by handing write() a FieldDocument as its SAX handler.
+ *
+ * This lets pack() share the code that writes json text. The Value is null if write() returns false.
+ */
+
+template <typename Generator>
+rapidjson::Value buildValue (Generator write) {
+	FieldDocument d(&JSONScope::allocator(), FIELD_STACK_SIZE, &JSONScope::allocator());
+	rapidjson::Value v;
+	v.Swap(d.Populate(write));
+	return v;
+}
+
+/**
+ * @brief Pack the object described by fields into a Value, as writeFields() would write it.
+ */
+
+inline rapidjson::Value packFields (const FieldDescriptor *fields, const void *obj) {
+	return buildValue([fields, obj] (FieldDocument& d) {return writeFields(fields, obj, d);});
+}
+
+/**
+ * @brief Populate the object described by fields from json text.
+ *
+ * Members whose keys are absent are left alone, and unknown keys are skipped. Returns false if the text is
+ * malformed or a known key holds the wrong type.
+ */
+
+bool readFields (const FieldDescriptor *fields, void *obj, const char *json);
+
+/**
+ * @class FieldReader
+ *
+ * @brief rapidjson SAX handler that stores values straight into an object through its field table.
+ *
+ * Nested objects with their own tables are followed down to FIELD_MAX_DEPTH. It keeps no state on the heap.
+ */
+
+class FieldReader : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, FieldReader> {
+	public:
+		FieldReader (const FieldDescriptor *fields, void *obj);
+		bool Null ();
+		bool Bool (bool b);
+		bool Int (int i);
+		bool Uint (unsigned u);
+		bool Int64 (int64_t i);
+		bool Uint64 (uint64_t u);
+		bool Double (double d);
+		bool String (const char *str, rapidjson::SizeType len, bool copy);
+		bool Key (const char *str, rapidjson::SizeType len, bool copy);
+		bool StartObject ();
+		bool EndObject (rapidjson::SizeType members);
+		bool StartArray ();
+		bool EndArray (rapidjson::SizeType elements);
+
+	private:
+		bool value (const FieldValue& v);						/**< Hand a scalar to the field named by the last key */
+
+		struct Frame {
+			const FieldDescriptor	*fields;
+			void					*obj;
+		};
+		Frame					_stack[FIELD_MAX_DEPTH];
+		int						_depth = -1;					/**< Index of the object being filled; -1 before the outermost object opens */
+		const FieldDescriptor	*_pending = NULL;				/**< Field named by the last key, or NULL if it was unknown */
+		int						_skip = 0;						/**< Depth of unknown objects and arrays being passed over */
+};
+
+/**
+ * @brief Populate the object described by fields from a json object, as readFields() does from text.
+ */
+
+inline bool parseFields (const FieldDescriptor *fields, void *obj, const rapidjson::Value& input) {
+	FieldReader reader(fields, obj);
+	return (input.IsObject() && input.Accept(reader));
+}
+
+#endif /* FIELDS_H */
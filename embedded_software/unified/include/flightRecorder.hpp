@@ -0,0 +1,205 @@
+/******************************************************************************
+ * Hackerboat flight recorder module
+ * flightRecorder.hpp
+ * This module records the boat's state every control cycle into a
+ * preallocated, memory mapped ring file that survives crashes and can be
+ * read while it is being written
+ *
+ * See the Hackerboat documentation for more details
+ * Written by agent, Oct 2026
+ *
+ * Version 0.1: First alpha
+ *
+ ******************************************************************************/
+
+#ifndef FLIGHTRECORDER_H
+#define FLIGHTRECORDER_H
+
+#include <cstddef>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <inttypes.h>
+#include "hackerboatRoot.hpp"
+#include "orientation.hpp"
+#include "telemetryRecord.hpp"
+#include "configuration.hpp"
+
+#define RECORDER_MAGIC			"HBFLTREC"		/**< First eight bytes of a recorder file */
+#define RECORDER_VERSION		(1)
+#define RECORDER_HEADER_SIZE	(4096)			/**< Bytes reserved for the file header; the slots start on the next page */
+#define RECORDER_SLOT_SIZE		(1024)			/**< Bytes per frame, including the slot header */
+#define RECORDER_BUSY			(UINT64_MAX)	/**< Slot sequence number while the slot is being written */
+#define RECORDER_RING_SLOTS		(64)			/**< Frames the control thread can get ahead of the copy into the file */
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "The recorder file is shared between processes, so its counters must be lock free");
+
+/**
+ * @brief Header at the front of a recorder file.
+ *
+ * The file is in the writer's byte order, as is the slot header. The records in each frame are little
+ * endian, as telemetryRecord.hpp describes.
+ */
+
+struct RecorderFileHeader {
+	char					magic[8];			/**< RECORDER_MAGIC, without a terminator */
+	uint32_t				version;			/**< RECORDER_VERSION */
+	uint32_t				slotSize;			/**< RECORDER_SLOT_SIZE */
+	uint64_t				slots;				/**< Number of slots in the ring */
+	std::atomic<uint64_t>	next;				/**< Sequence number of the next frame. Frames are numbered from 1 */
+};
+
+/**
+ * @brief Header at the front of each slot, followed by the frame's records.
+ */
+
+struct RecorderSlotHeader {
+	std::atomic<uint64_t>	seq;				/**< Frame in this slot: 0 if never written, RECORDER_BUSY while being written */
+	int64_t					time;				/**< When the frame was begun, in milliseconds since the epoch */
+	uint32_t				length;				/**< Bytes of records following this header */
+	uint32_t				crc;				/**< CRC-32 of time, length and the records */
+};
+
+#define RECORDER_FRAME_SIZE		(RECORDER_SLOT_SIZE - sizeof(RecorderSlotHeader))	/**< Most bytes of records in one frame */
+
+uint32_t recorderCRC (uint32_t crc, const void *data, size_t len);	/**< Standard CRC-32; start with crc = 0 */
+
+/**
+ * @class FlightRecorder
+ *
+ * @brief Writes one frame of binary records per control cycle into a ring file.
+ *
+ * The file is created at its full size when it is opened, so no blocks are allocated while recording.
+ * The control thread writes each frame into a small private ring in memory, and a background thread
+ * copies finished frames into the shared mapping of the file and pushes them out to storage with msync()
+ * every syncPeriod. The control thread never stores to the file's pages itself: once msync() has cleaned a
+ * shared page, the next store to it faults so the kernel can mark it dirty, and that fault can wait on
+ * the filesystem journal or on the page's writeback.
+ *
+ * Every commit wakes the copy, so a frame is normally in the file, where it survives the process dying,
+ * well within a cycle. Everything older than syncPeriod survives the power going out. If the copy falls
+ * more than RECORDER_RING_SLOTS frames behind, the frames it missed read back as CORRUPT and lost()
+ * counts them.
+ *
+ * Reopening an intact file with the same number of slots continues its numbering. A recorder file of any
+ * other shape holds an earlier flight, so it is renamed to the first free path.N rather than overwritten.
+ *
+ * Each slot is published with a sequence number that is stored last, so a reader (even one in another
+ * process) can tell a finished frame from one that is being written or was overwritten.
+ *
+ * The writer side is not thread safe; only the control thread should use it.
+ */
+
+class FlightRecorder {
+	public:
+		FlightRecorder () = default;
+		~FlightRecorder () {close();};
+		bool open (const std::string& path, uint64_t slots, sysdur syncPeriod);	/**< Create or reopen the file and start the sync thread */
+		void close ();												/**< Sync and unmap the file */
+		bool isOpen () const {return (_header != NULL);};
+		bool begin ();												/**< Start a new frame. Returns false if the file is not open */
+		bool append (const HackerboatState& state);				/**< Add a record to the current frame. Returns false if it doesn't fit */
+		bool commit ();												/**< Finish the current frame and make it visible to readers */
+		bool sync ();												/**< Copy every committed frame and write it to storage now. Blocks, so not for the control thread */
+		uint64_t next () const;										/**< Sequence number the next frame will get */
+		uint64_t truncated () const {return _truncated;};			/**< Records that didn't fit in their frame */
+		uint64_t lost () const {return _lost.load(std::memory_order_relaxed);};	/**< Frames overwritten in the ring before they were copied */
+
+	private:
+		FlightRecorder (FlightRecorder const&) = delete;
+		FlightRecorder& operator=(FlightRecorder const&) = delete;
+		void syncThread (sysdur period);
+		void copyFrames ();											/**< Copy committed frames from the ring into the file. Call with _copyLock held */
+
+		int						_fd = -1;
+		size_t					_size = 0;
+		uint8_t					*_base = NULL;
+		RecorderFileHeader		*_header = NULL;
+		std::vector<uint8_t>	_ring;								/**< RECORDER_RING_SLOTS slots the control thread writes */
+		RecorderSlotHeader		*_slot = NULL;						/**< Ring slot being written, or NULL between frames */
+		uint64_t				_seq = 0;
+		uint64_t				_next = 0;							/**< Sequence number of the next frame; control thread only */
+		size_t					_used = 0;
+		uint64_t				_truncated = 0;
+		std::atomic<uint64_t>	_committed {0};						/**< Frames before this are finished in the ring */
+		std::atomic<uint64_t>	_copied {0};						/**< Frames before this are in the file, or lost */
+		std::atomic<uint64_t>	_lost {0};
+		std::mutex				_copyLock;
+		std::thread				_syncer;
+		std::mutex				_syncLock;
+		std::condition_variable	_syncWake;
+		bool					_stopping = false;
+};
+
+/**
+ * @class FlightRecorderReader
+ *
+ * @brief Reads frames out of a recorder file, including one that is still being written.
+ *
+ * To tail a file, read from next() onwards; NOT_YET means the writer hasn't got there, so wait and try
+ * again. Frames older than oldest() have been overwritten.
+ */
+
+class FlightRecorderReader {
+	public:
+		enum class Result {
+			OK,						/**< The frame was copied out */
+			NOT_YET,				/**< The frame hasn't been written */
+			OVERWRITTEN,			/**< The ring has wrapped past the frame */
+			CORRUPT					/**< The frame was torn by a crash or power loss */
+		};
+
+		FlightRecorderReader () = default;
+		~FlightRecorderReader () {close();};
+		bool open (const std::string& path);
+		void close ();
+		bool isOpen () const {return (_header != NULL);};
+		uint64_t next () const;										/**< Sequence number of the next frame the writer will write */
+		uint64_t oldest () const;									/**< Oldest frame still in the file */
+		Result read (uint64_t seq, uint8_t *buf, size_t len, size_t& used, sysclock& time) const;	/**< Copy out the records of a frame. buf should hold RECORDER_FRAME_SIZE bytes */
+
+	private:
+		FlightRecorderReader (FlightRecorderReader const&) = delete;
+		FlightRecorderReader& operator=(FlightRecorderReader const&) = delete;
+
+		int						_fd = -1;
+		size_t					_size = 0;
+		const uint8_t			*_base = NULL;
+		const RecorderFileHeader	*_header = NULL;
+};
+
+/**
+ * @class CycleSample
+ *
+ * @brief Raw inputs and actuator outputs for one control cycle, as recorded alongside the BoatState.
+ */
+
+class BoatState;
+
+class CycleSample : public HackerboatState {
+	public:
+		bool parse (Value& input) {return parseFields(fields, this, input);};
+		Value pack () const {return packFields(fields, this);};
+		bool writeJSON (JSONWriter& writer) const {return writeFields(fields, this, writer);};
+		bool readJSON (const char *json) USE_RESULT {return readFields(fields, this, json);};
+		size_t writeRecord (uint8_t *buf, size_t len) const {return encodeRecord(fields, this, buf, len);};
+		bool readRecord (const uint8_t *buf, size_t len) USE_RESULT {return decodeRecord(fields, this, buf, len);};
+		void capture (BoatState& state, int64_t cycle);			/**< Read everything from the state's devices. Doesn't allocate */
+
+		int64_t			cycle = 0;				/**< Control cycle number */
+		int				rudder = 0;				/**< Rudder command, in microseconds */
+		int				throttle = 0;			/**< Throttle position */
+		int				rcThrottle = 0;			/**< Throttle position from the RC input */
+		double			rcRudder = NAN;			/**< Rudder position from the RC input */
+		double			rcCourse = NAN;			/**< Course command from the RC input, in degrees */
+		Orientation		orientation;			/**< Raw orientation from the IMU */
+		int				motorCurrentRaw = 0;	/**< Raw ADC value of the motor current */
+		int				batteryRaw = 0;			/**< Raw ADC value of the battery monitor */
+		static const FieldDescriptor fields[];	/**< Members written and read by writeJSON() and readJSON() */
+};
+
+#endif /* FLIGHTRECORDER_H */
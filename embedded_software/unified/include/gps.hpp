@@ -45,8 +45,13 @@ class GPSFix : public HackerboatState {
 		GPSFix (Value& packet);					/**< Create a GPS fix from an incoming gpsd TPV */
 		GPSFix (const GPSFix& g) {this->copy(g);};
 		bool parseGpsdPacket (Value& packet);	/**< Parse an incoming TSV into the current object. */
-		bool parse (Value& input);
-		Value pack () const;
+		bool readGpsdPacket (const char *json);	/**< As parseGpsdPacket(), straight from the text of the report */
+		bool parse (Value& input) {return (parseFields(fields, this, input) && this->isValid());};
+		Value pack () const {return packFields(fields, this);};
+		bool writeJSON (JSONWriter& writer) const {return writeFields(fields, this, writer);};
+		bool readJSON (const char *json) USE_RESULT {return readFields(fields, this, json);};
+		size_t writeRecord (uint8_t *buf, size_t len) const {return encodeRecord(fields, this, buf, len);};
+		bool readRecord (const uint8_t *buf, size_t len) USE_RESULT {return decodeRecord(fields, this, buf, len);};
 		bool isValid () const;
 		void copy(const GPSFix* newfix);
 		void copy(const GPSFix& newfix);
@@ -69,9 +74,11 @@ class GPSFix : public HackerboatState {
 		double			epc = 0;		/**< Climb error, 95% confidence, m/s */
 
 		bool 			fixValid = false;	/**< Checks whether this fix is valid or not */				
+		static const FieldDescriptor fields[];	/**< Members written and read by writeJSON() and readJSON() */
 		
 	private:
-		bool coreParse (Value& input);	/**< This is the pieces of the parsing task shared between parse() and parseGpsdPacket() */
+		template <typename Read> bool gpsdPacket (Read read);	/**< Shared by parseGpsdPacket() and readGpsdPacket(); read() fills in gpsdFields */
+		static const FieldDescriptor gpsdFields[];	/**< Members read from a gpsd TPV report */
 };
 
 #endif
@@ -0,0 +1,200 @@
+/******************************************************************************
+ * Hackerboat gpsd simulator module
+ * gpsdSim.hpp
+ * This module stands in for gpsd on a local port, playing back recorded
+ * streams or making up GPS fixes and AIS traffic at a set rate
+ *
+ * See the Hackerboat documentation for more details
+ * Written by agent, Oct 2026
+ *
+ * Version 0.1: First alpha
+ *
+ ******************************************************************************/
+
+#ifndef GPSDSIM_H
+#define GPSDSIM_H
+
+#include <inttypes.h>
+#include <stddef.h>
+#include <atomic>
+#include <thread>
+#include <string>
+#include <vector>
+#include <memory>
+#include <random>
+#include "hackerboatRoot.hpp"
+#include "location.hpp"
+
+#define GPSD_SIM_PORT			(3001)		/**< Same as the default GPSd Port in the configuration */
+#define GPSD_SIM_MAX_CLIENTS	(4)
+#define GPSD_SIM_REPLAY_BURST	(256)		/**< Replayed lines per pass when the replay isn't paced */
+#define GPSD_SIM_SEND_TIMEOUT	(1000)		/**< Milliseconds a client can hold up a send before it's dropped, as gpsd does */
+#define GPSD_SIM_AIS_HISTORY	(65536)		/**< AIS messages whose send times are kept, for measuring latency */
+
+/**
+ * @brief What the simulator sends
+ */
+struct GPSdSimConfig {
+	Location	center {47.592597, -122.382938};	/**< Where our own fixes start and the contacts are scattered around */
+	double		tpvRate = 1.0;				/**< Own position reports per second; zero for none */
+	double		speed = 0;					/**< Our own speed, m/s */
+	double		course = 0;					/**< Our own course, degrees true */
+	int			contacts = 0;				/**< Number of made up AIS contacts */
+	double		contactRadius = 10000;		/**< Contacts start up to this far from the center, meters */
+	double		reportPeriod = 10;			/**< Seconds between position reports from each contact */
+	double		staticPeriod = 360;			/**< Seconds between static data reports from each contact */
+	double		errorRate = 0;				/**< Fraction of lines that are sent damaged */
+	std::string	replayFile;					/**< Recorded gpsd JSON, raw NMEA, or both, to play back */
+	double		replayRate = 10;			/**< Replayed lines per second; zero for as fast as the clients take them */
+	bool		replayLoop = true;			/**< Start the recording over when it runs out */
+	uint32_t	seed = 1;					/**< Seed for the contacts and the damage */
+};
+
+/**
+ * @class GPSdTrafficGenerator
+ *
+ * @brief Makes up the lines gpsd would send, on the schedule it would send them.
+ *
+ * Own position reports go out as TPV reports, time stamped with the moment they're made so the far end can
+ * measure how long they took to arrive. Each contact moves in a straight line from a random start and sends
+ * raw AIVDM position reports (type 1, or type 18 for every fourth contact, which is class B) and static data
+ * (type 5 in two fragments, or both parts of type 24), spread evenly over the report periods.
+ *
+ * Recorded lines are played back alongside; JSON lines are passed to the JSON stream and NMEA and AIVDM to
+ * the NMEA stream. Recorded RMC sentences are also turned into TPV reports, since standing in for gpsd means
+ * doing that part of its job too; the reports carry the time they're sent rather than the recorded time.
+ *
+ * A damaged line has its checksum spoiled, or its closing brace dropped if it's JSON. An AIS message counts
+ * as intact only if all of its fragments are.
+ */
+
+class GPSdTrafficGenerator {
+	public:
+		GPSdTrafficGenerator (const GPSdSimConfig& config, sysclock start);
+		size_t generate (sysclock now, std::string& json, std::string& nmea);	/**< Append every line due by now to the JSON and NMEA streams. Returns the number of lines */
+		bool loadReplay (const std::string& path);	/**< Read the recorded lines to play back. Returns false if the file can't be read */
+		uint64_t lines () const {return _lines;};			/**< Lines made, in both streams */
+		uint64_t damaged () const {return _damaged;};		/**< Lines sent damaged */
+		uint64_t fixes () const {return _fixes;};			/**< Intact TPV reports */
+		uint64_t aisMessages () const {return _aisMessages;};	/**< Intact AIS messages */
+		uint64_t lastAIS () const {return _lastAIS;};		/**< Intact AIS messages in the last call to generate() */
+		static size_t sentence (const char *payload, size_t len, int fill, int count, int number, char seqId, char channel, std::string& out);	/**< Append one AIVDM sentence, with its checksum. Returns its length */
+
+	private:
+		struct Contact {
+			int			mmsi;
+			Location	origin;
+			double		speed;				/**< Knots, as AIS has it */
+			double		course;
+			bool		classB;
+			int			shiptype;
+			std::string	name;
+			std::string	callsign;
+		};
+
+		/**
+		 * @brief Packs fields into the bits of an AIS message and armors them into six bit characters
+		 */
+		struct Bits {
+			uint8_t		data[64] = {0};
+			size_t		len = 0;
+			void put (uint32_t value, size_t width);
+			void text (const std::string& s, size_t chars);
+			size_t armor (char *out, int& fill) const;		/**< Returns the number of characters */
+		};
+
+		void tpv (double t, sysclock now, std::string& json);
+		void position (Contact& c, double t, std::string& nmea);
+		void staticData (Contact& c, std::string& nmea);
+		void emit (const Bits& bits, std::string& nmea, int fragments);		/**< Send one message, split into the given number of sentences */
+		void replay (sysclock now, std::string& json, std::string& nmea);
+		bool rmc (const std::string& line, sysclock now, std::string& json);	/**< Turn a recorded RMC sentence into a TPV report */
+		void fix (const Location& where, double speed, double course, int mode, sysclock now, std::string& json);
+		bool damage ();						/**< True if the next line should be damaged */
+		void finish (std::string& out, size_t start, bool damaged);	/**< Count a line and spoil it if need be */
+
+		GPSdSimConfig				_config;
+		sysclock					_start;
+		std::mt19937				_rng;
+		std::uniform_real_distribution<double>	_uniform {0.0, 1.0};
+		std::vector<Contact>		_contacts;
+		std::vector<std::string>	_replay;
+		size_t						_replayNext = 0;
+		double						_tpvDue = 0;	/**< Seconds after the start when each kind of line is next due */
+		double						_aisDue = 0;
+		double						_staticDue = 0;
+		double						_replayDue = 0;
+		size_t						_nextPosition = 0;	/**< Next contact to report, round robin */
+		size_t						_nextStatic = 0;
+		char						_seqId = 0;
+		bool						_channelB = false;
+		bool						_messageDamaged = false;
+		uint64_t					_lines = 0;
+		uint64_t					_damaged = 0;
+		uint64_t					_fixes = 0;
+		uint64_t					_aisMessages = 0;
+		uint64_t					_lastAIS = 0;
+};
+
+/**
+ * @class GPSdSimServer
+ *
+ * @brief A stand-in for gpsd on a local TCP port, for testing GPSdInput without a receiver.
+ *
+ * It speaks enough of the gpsd protocol for GPSdInput, gpspipe and similar clients: a VERSION banner on connecting,
+ * DEVICES and WATCH replies to ?WATCH, and then the JSON stream, the NMEA stream, or both, as the client asked.
+ * The traffic comes from a GPSdTrafficGenerator run on the server's own thread. Sends block, so a slow
+ * client slows the stream down instead of losing lines, up to GPSD_SIM_SEND_TIMEOUT, after which it's dropped.
+ *
+ * The counters may be read from any thread. The send time of each intact AIS message is kept for the last
+ * GPSD_SIM_AIS_HISTORY of them, so that a client counting the messages it has decoded can tell how long the
+ * latest one took.
+ */
+
+class GPSdSimServer {
+	public:
+		GPSdSimServer (const GPSdSimConfig& config) : _config(config) {};
+		~GPSdSimServer () {stop();};
+		bool start (int port = GPSD_SIM_PORT);		/**< Listen on the loopback interface and start sending; port 0 picks a free one. Returns false if the port can't be had or the replay file can't be read */
+		void stop ();								/**< Disconnect everyone and stop the server thread */
+		bool isRunning () const {return _running.load();};
+		int port () const {return _port;};			/**< Port actually listened on */
+		int clients () const {return _clients.load();};		/**< Clients connected */
+		uint64_t lines () const {return _lines.load();};	/**< Lines sent, counted once however many clients get them */
+		uint64_t bytes () const {return _bytes.load();};	/**< Bytes sent, to all clients */
+		uint64_t damaged () const {return _damaged.load();};	/**< Lines sent damaged */
+		uint64_t fixes () const {return _fixes.load();};	/**< Intact TPV reports sent */
+		uint64_t aisMessages () const {return _aisMessages.load();};	/**< Intact AIS messages sent */
+		bool aisSentAt (uint64_t n, sysclock& t) const;	/**< When intact AIS message n (counting from zero) was sent. False if it hasn't been or is too old */
+
+	private:
+		struct Client {
+			int			fd = -1;
+			bool		json = false;
+			bool		nmea = false;
+			std::string	in;						/**< Partial command */
+		};
+
+		void run ();
+		void accept ();
+		bool command (Client& c);				/**< Answer any complete commands. Returns false if the client has gone */
+		bool send (Client& c, const char *data, size_t len);	/**< Returns false if the client has gone */
+		void drop (size_t i);
+
+		GPSdSimConfig				_config;
+		std::unique_ptr<GPSdTrafficGenerator>	_generator;
+		std::thread					_thread;
+		std::atomic<bool>			_running {false};
+		int							_listen = -1;
+		int							_port = -1;
+		std::vector<Client>			_clientList;
+		std::atomic<int>			_clients {0};
+		std::atomic<uint64_t>		_lines {0};
+		std::atomic<uint64_t>		_bytes {0};
+		std::atomic<uint64_t>		_damaged {0};
+		std::atomic<uint64_t>		_fixes {0};
+		std::atomic<uint64_t>		_aisMessages {0};
+		std::vector<std::atomic<int64_t>>	_aisSent = std::vector<std::atomic<int64_t>>(GPSD_SIM_AIS_HISTORY);	/**< Send times, in system clock ticks, by message number */
+};
+
+#endif /* GPSDSIM_H */
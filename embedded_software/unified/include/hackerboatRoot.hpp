@@ -16,6 +16,7 @@
 #define HACKERBOATROOT_H
  
 #include <stdlib.h>
+#include <string.h>
 #include <inttypes.h>
 #include <chrono>
 #include <string>
@@ -32,6 +33,9 @@
 #include "rapidjson/pointer.h"
 #include "rapidjson/stringbuffer.h"
 #include "rapidjson/writer.h"
+#include "fields.hpp"
+#include "jsonScope.hpp"
+#include "telemetryRecord.hpp"
 #include <ostream>
 
 // namespaces used to make the time functions readable
@@ -67,6 +71,24 @@ class HackerboatState {
 		 */
 		virtual Value pack () const USE_RESULT = 0;
 
+		/** Write the object straight to a SAX writer. Types with a field table override this to skip
+		 * building a Value; the default goes through pack().
+		 */
+		virtual bool writeJSON (JSONWriter& writer) const;
+
+		/** Populate the object straight from json text. Types with a field table override this to skip
+		 * building a Document; the default goes through parse().
+		 */
+		virtual bool readJSON (const char *json) USE_RESULT;
+
+		/** Write the object into buf as a binary telemetry record, as described in telemetryRecord.hpp.
+		 * Returns the number of bytes written, or 0 if the type has no field table or buf is too small.
+		 */
+		virtual size_t writeRecord (uint8_t *buf, size_t len) const {return 0;};
+
+		/** Populate the object from a binary telemetry record written from the same type. */
+		virtual bool readRecord (const uint8_t *buf, size_t len) USE_RESULT {return false;};
+
 		/** Tests whether the current object is in a valid state */
 		virtual bool isValid (void) const {
 			return true;
@@ -82,137 +104,132 @@ class HackerboatState {
 		 *
 		 * @brief Function for packing sysclock objects into ISO 8601 date/time strings
 		 * @param t The time to pack
-		 * @return The time in ISO 8601, UTC, with millisecond precision
+		 * @param buf Where to write the time, terminated with a NUL
+		 * @param len Size of buf; it must be at least TIME_STRING_SIZE
+		 * @return The length of the packed time, or 0 if buf is too small or the year is not between 0 and 9999
 		 *
-		 * This function is based on the implementation described here: 
-		 * http://stackoverflow.com/questions/26895428/how-do-i-parse-an-iso-8601-date-with-optional-milliseconds-to-a-struct-tm-in-c
+		 * The time is written in UTC, with millisecond precision, as YYYY-MM-DD HH:MM:SS.mmm. This does not
+		 * allocate, so it is safe to call from the control loop.
 		 */
 		 
+		static size_t packTime (sysclock t, char *buf, size_t len);
+
+		/** Convenience form of packTime() that returns a string */
 		static std::string packTime (sysclock t) {
-			std::ostringstream output;
-			sys_time<milliseconds> tp = floor<milliseconds>(t);
-			output << tp;
-			return output.str();
+			char buf[TIME_STRING_SIZE];
+			return std::string(buf, packTime(t, buf, sizeof(buf)));
 		};
+
 		/**
 		 * @function parseTime
 		 *
 		 * @brief Function for extracting a sysclock object from an ISO8601 date/time string
 		 * @param in The input string
+		 * @param len Length of the input string
 		 * @param t A reference to a sysclock object where the incoming time will be stored
-		 * @return True is parsing is successful, false otherwise
+		 * @return True is parsing is successful, false otherwise. t is left alone on failure.
+		 *
+		 * Accepts YYYY-MM-DD, then T or a space, then HH:MM:SS with an optional fraction of up to nanosecond
+		 * precision, then an optional Z or +/-HH[:MM] offset. A time with no zone is taken to be UTC. This does
+		 * not allocate.
 		 */
 		 
-		static bool parseTime (std::string in, sysclock& t) {
-			std::istringstream input {in};
-			date::parse(input, "%FT%TZ", t);
-			if (input.fail()){
-				input.clear();
-				input.str(in);
-				date::parse(input, "%FT%T%Ez", t);
-			}
-			if (input.fail()){
-				input.clear();
-				input.str(in);
-				date::parse(input, "%F %TZ", t);
-			}
-			if (input.fail()){
-				input.clear();
-				input.str(in);
-				date::parse(input, "%F %T%Ez", t);
-			}
-			return true;
+		static bool parseTime (const char *in, size_t len, sysclock& t);
+
+		static bool parseTime (const char *in, sysclock& t) {
+			return parseTime(in, strlen(in), t);
+		};
+
+		static bool parseTime (const std::string& in, sysclock& t) {
+			return parseTime(in.c_str(), in.size(), t);
 		};
 
 		// helper functions for getting and setting JSON values
 		bool inline static GetVar(const string name, int& var, Value& d) {
-			Value myvar, default_val;
 			string ptr = "/" + name;
-			myvar = Pointer(ptr.c_str()).GetWithDefault(d, default_val, root.GetAllocator());
-			if (myvar.IsInt()) {
-				var = myvar.GetInt();
+			const Value *myvar = Pointer(ptr.c_str()).Get(d);
+			if (myvar && myvar->IsInt()) {
+				var = myvar->GetInt();
 			} else return false;
 			return true;
 		}
 
 		bool inline static GetVar(const string name, double& var, Value& d) {
-			Value myvar, default_val;
 			string ptr = "/" + name;
-			myvar = Pointer(ptr.c_str()).GetWithDefault(d, default_val, root.GetAllocator());
-			if (myvar.IsDouble()) {
-				var = myvar.GetDouble();
+			const Value *myvar = Pointer(ptr.c_str()).Get(d);
+			if (myvar && myvar->IsDouble()) {
+				var = myvar->GetDouble();
 			} else return false;
 			return true;
 		}
 
 		bool inline static GetVar(const string name, string& var, Value& d) {
-			Value myvar, default_val;
 			string ptr = "/" + name;
-			myvar = Pointer(ptr.c_str()).GetWithDefault(d, default_val, root.GetAllocator());
-			if (myvar.IsString()) {
-				var = myvar.GetString();
+			const Value *myvar = Pointer(ptr.c_str()).Get(d);
+			if (myvar && myvar->IsString()) {
+				var = myvar->GetString();
 			} else return false;
 			return true;
 		}
 
 		bool inline static GetVar(const string name, Value& var, Value &d) {
-			Value default_val;
 			string ptr = "/" + name;
-			var = Pointer(ptr.c_str()).GetWithDefault(d, default_val, root.GetAllocator());
+			Value *myvar = Pointer(ptr.c_str()).Get(d);
+			if (myvar) {
+				var = *myvar;				// moves the member out of d, as rapidjson assignment does
+			} else var.SetNull();
 			return true;
 		}
 
 		bool inline static GetVar(const string name, bool& var, Value &d) {
-			Value myvar, default_val;
 			string ptr = "/" + name;
-			myvar = Pointer(ptr.c_str()).GetWithDefault(d, default_val, root.GetAllocator());
-			if (myvar.IsBool()) {
-				var = myvar.GetBool();
+			const Value *myvar = Pointer(ptr.c_str()).Get(d);
+			if (myvar && myvar->IsBool()) {
+				var = myvar->GetBool();
 			} else return false;
 			return true;
 		}
 
 		int inline static PutVar(const string name, const int& var, Value &d) {
 			string ptr = "/" + name;
-			Pointer(ptr.c_str()).Set(d, var, root.GetAllocator());
+			Pointer(ptr.c_str()).Set(d, var, JSONScope::allocator());
 			return 0;
 		}
 
 		int inline static PutVar(const string name, const double& var, Value &d) {
 			string ptr = "/" + name;
-			Pointer(ptr.c_str()).Set(d, var, root.GetAllocator());
+			Pointer(ptr.c_str()).Set(d, var, JSONScope::allocator());
 			return 0;
 		}
 
 		int inline static PutVar(const string name, const string& var, Value &d) {
 			Value s;
-			s.SetString(var.c_str(), var.size(), root.GetAllocator());
+			s.SetString(var.c_str(), var.size(), JSONScope::allocator());
 			string ptr = "/" + name;
-			Pointer(ptr.c_str()).Set(d, s, root.GetAllocator());
+			Pointer(ptr.c_str()).Set(d, s, JSONScope::allocator());
 			return 0;
 		}
 
 		int inline static PutVar(const string name, const Value& var, Value &d) {
 			string ptr = "/" + name;
-			Pointer(ptr.c_str()).Set(d, var, root.GetAllocator());
+			Pointer(ptr.c_str()).Set(d, var, JSONScope::allocator());
 			return 0;
 		}
 
 		int inline static PutVar(const string name, const bool var, Value &d) {
 			string ptr = "/" + name;
-			Pointer(ptr.c_str()).Set(d, var, root.GetAllocator());
+			Pointer(ptr.c_str()).Set(d, var, JSONScope::allocator());
 			return 0;
 		}
 
 		int inline static PutVar(const string name, Value &d) {
 			string ptr = "/" + name;
-			Pointer(ptr.c_str()).Create(d, root.GetAllocator());
+			Pointer(ptr.c_str()).Create(d, JSONScope::allocator());
 			return 0;
 		}
 
 	protected:
 		HackerboatState(void) {};
-		static Document root;
 };
 
 std::ostream& operator<< (std::ostream& stream, const HackerboatState& state);
@@ -259,7 +276,10 @@ inline std::ostream& operator<< (std::ostream& stream, const Document* d) {
 }
 
 inline std::ostream& operator<< (std::ostream& stream, const HackerboatState& v) {
-	stream << v.pack();
+	StringBuffer buf;
+	JSONWriter writer(buf);
+	v.writeJSON(writer);
+	stream << buf.GetString();
 	return stream;
 }
 
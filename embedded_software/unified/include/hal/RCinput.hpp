@@ -29,6 +29,15 @@
 
 class HalTestHarness;
 
+/**
+ * @brief One decoded S.BUS frame
+ */
+
+struct RCFrame {
+	std::vector<uint16_t>	channels;		/**< Raw channel values */
+	bool					failsafe = false;	/**< Failsafe flag from the frame */
+};
+
 //#define SBUS_STARTBYTE		0x0f
 //#define SBUS_ENDBYTE			0x00
 //#define SBUS_BUF_LEN			25 
@@ -43,14 +52,19 @@ class RCInput : public InputThread {
 		RCModeEnum getMode();				/**< Returns the correct RC mode, given the current state of the inputs */
 		int getChannel (int channel);		/**< Return the raw value of the given channel */
 		bool isValid () {return _valid;};
-		bool isFailSafe () {return failsafe;};	/**< Returns true if in failsafe mode. */
+		bool isFailSafe ();					/**< Returns true if in failsafe mode. */
+		RCFrame getFrame () {return _frame.get();};	/**< Returns a copy of the last frame */
+		uint64_t getContention() {return _frame.contention();};
 		bool begin();
-		bool execute();
+		bool execute();						/**< Read and decode all available frames */
+		int getFD() {return devFD;};		/**< Descriptor of the serial port */
+		const char* getThreadName() {return "RC";};
 		static double map(double x, double in_min, double in_max, double out_min, double out_max);
 		
 		~RCInput();						/**< Explicit destructor to make sure we close out the serial port and kill the thread.	*/
 				
 	private:
+		void decodeFrame (const uint8_t *frame);	/**< Decode one frame into _working */
 		const uint8_t startByte = 0x0f;
 		const uint8_t endByte = 0x00;
 		const uint8_t buflen = 25;
@@ -58,12 +72,11 @@ class RCInput : public InputThread {
 		double _rudder = 0;
 		std::string _path;
 		int devFD = -1;
-		bool failsafe = false;
 		bool _valid = true;
-		std::vector<uint16_t> rawChannels;
+		RCFrame _working;					/**< Frame being decoded, private to the input thread */
+		Snapshot<RCFrame> _frame;			/**< Last good frame, as published to readers */
 		std::string inbuf;
 		int _errorFrames = 0;
 		int _goodFrames = 0;
-		std::thread *myThread;
 };
 #endif
@@ -39,30 +39,35 @@ class ADCInput : public InputThread {
 		bool				init();											/**< Intialize all inputs */
 		bool 				begin();										/**< Start the input thread */
 		bool 				execute();										/**< Gather input	*/
-		map<string, int> 	getRawValues (void) {return _raw;};				/**< Return the raw ADC values, in volts */
+		const char*			getThreadName() {return "ADC";};
+		map<string, int> 	getRawValues (void) {return _values.get();};	/**< Return the raw ADC values, in volts */
 		map<string, double> getScaledValues (void);							/**< Return the scaled ADC values */
+		void				getScaledValues (map<string, double>& out);		/**< Fill in the scaled ADC values; doesn't allocate once out has every channel */
+		int					getRawValue (const string& name);				/**< Return one raw ADC value, or -1 if there is no such channel */
+		double				getScaledValue (const string& name);			/**< Return one scaled ADC value, or NAN if there is no such channel */
 		bool 				setOffsets (std::map<std::string, int> offsets);/**< Set the offsets for all channels. */
 		bool 				setScales (std::map<std::string, double> scales);/**< Set the scaling for all channels. */
 		map<string, int> 	getOffsets() {return _offsets;};				/**< Get the offsets for all channels. */
 		map<string, double> getScales() {return _scales;};					/**< Get the scaling for all channels. */
+		uint64_t			getContention() {return _values.contention();};
 		~ADCInput () {
 			this->kill(); 
-			//if (myThread) delete myThread;
 		}
 		
 		using InputThread::getLastInputTime;
 		
 	private:
+		void				setDefaults();									/**< Fill in every channel with no reading and the default offset & scale */
 		ADC128D818 			upper { Conf::get()->adcUpperAddress(), Conf::get()->adcI2Cbus() };
 		ADC128D818 			lower { Conf::get()->adcLowerAddress(), Conf::get()->adcI2Cbus() };
 		vector<string>		upperChannels = Conf::get()->adcUpperChanList();
 		vector<string>		lowerChannels = Conf::get()->adcLowerChanList();
 		string				batmonPath;
-		map<string, int> 	_raw;
+		map<string, int> 	_raw;											/**< Working copy, private to the input thread */
+		Snapshot<map<string, int> >	_values;								/**< Last raw values, as published to readers */
 		map<string, int> 	_offsets;
 		map<string, double> _scales;
 		bool				inputsValid = false;
-		thread *myThread = NULL;
 };
 
 #endif /* ADCINPUT_H */
@@ -64,6 +64,7 @@ class Pin {
 		bool _dir = false;						
 		bool _state;
 		bool _init = false;
+		bool _simulated = false;				/**< Set by HalTestHarness::simulate(); reads and writes only touch _state */
 };
 
 #endif
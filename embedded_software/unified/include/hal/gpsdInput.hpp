@@ -23,17 +23,48 @@
 #include <tuple>
 #include <map>
 #include <list>
+#include <sys/socket.h>
 #include "hal/config.h"
 #include "gps.hpp"
 #include "ais.hpp"
+#include "aisStore.hpp"
+#include "aivdm.hpp"
+#include "cpa.hpp"
 #include "hal/inputThread.hpp"
-#include "pstream.h"
 #include "location.hpp"
 
+#define GPSD_RECV_BUF			(16384)							/**< Bytes read from gpsd at a time, on top of room for a partial line */
+#define GPSD_CONNECT_TIMEOUT	(std::chrono::seconds(1))		/**< Time allowed for a connection to gpsd to be made before it's given up */
+#define GPSD_RETRY_MIN			(std::chrono::milliseconds(250))	/**< Wait before the first attempt to reconnect to gpsd */
+#define GPSD_RETRY_MAX			(std::chrono::seconds(8))		/**< Longest wait between attempts to reconnect; the wait doubles up to this */
+#define GPSD_PRUNE_PERIOD		(std::chrono::seconds(10))		/**< How often the AIS contacts too far from the last fix are removed */
+
 class HalTestHarness;
 
 using namespace std;
 
+/**
+ * @class GPSdInput
+ *
+ * @brief Reads fixes and AIS traffic from gpsd over its TCP socket.
+ *
+ * On connecting, it asks gpsd for the JSON stream, and for the raw NMEA as well if aisRawNMEA() is set,
+ * so that AIVDM can be decoded here. Everything is read into one buffer that's kept for the life of the
+ * input, and lines are handed to the parser where they lie. A line longer than gpsBufSize() is dropped.
+ * If gpsd goes away, execute() closes the socket, so that getFD() returns -1 for at least one call, and
+ * then tries to reconnect on each call, backing off from GPSD_RETRY_MIN to GPSD_RETRY_MAX.
+ *
+ * Nothing in execute() blocks on the network, except to look the host up again after setHost() or
+ * setPort(); otherwise it's looked up once, by the first connect(). The connection is made without
+ * waiting: getFD() hands out the socket while isConnecting(), to be waited on until it's writable, and
+ * the next execute() finishes the connection or gives it up.
+ *
+ * The AIS contacts belong to the input thread. Each execute() drops the ones that have aged out, and
+ * every GPSD_PRUNE_PERIOD the ones too far from the last fix as well. After every fix it works out the
+ * closest approach of each of them and publishes the nearest few, which is what other threads should
+ * use; getData() hands out the store itself and is only safe while the input thread isn't running.
+ */
+
 class GPSdInput : public InputThread {
 	friend class HalTestHarness;
 	public:
@@ -41,33 +72,75 @@ class GPSdInput : public InputThread {
 		GPSdInput(string host, int port);			/**< Create a gpsd object pointing at the given host & port combination. */
 		bool setHost (string host);					/**< Point the input listener at the given host. */
 		bool setPort (int port);					/**< Point the input listener at the given port */
-		bool connect ();							/**< Connect to the host */
+		bool connect ();							/**< Look up the host if need be and start connecting to it. Returns true if the connection is made or under way */
 		bool disconnect ();							/**< Disconnect from the host. */
-		bool isConnected ();						/**< Returns true if connected. */
+		bool isConnected ();						/**< Returns true if connected, and not just connecting. */
 		bool begin();								/**< Start the input thread */
-		bool execute();								/**< Gather input	*/
-		GPSFix* getFix() {return &_lastFix;};		/**< Returns last GPS fix (TSV report, more or less) */
-		std::map<int, AISShip>* getData();			/**< Returns all AIS contacts */
-		std::map<int, AISShip> getData(AISShipType shiptype);/**< Returns AIS contacts of a particular ship type */
+		bool execute();								/**< Gather all available input	*/
+		int getFD() {return _sock;};				/**< Descriptor of the connection to gpsd, or -1 while it's down */
+		bool isConnecting() {return _connecting;};	/**< True until the connection to gpsd is made */
+		const char* getThreadName() {return "GPS";};
+		GPSFix getFix() {return _fix.get();};		/**< Returns last GPS fix (TSV report, more or less) */
+		uint64_t getFixSequence() {return _fix.sequence();};	/**< Changes whenever a new fix is published */
+		void getRisks(CPAReport& out) {_risks.read(out);};	/**< Copies out the contacts that come closest, as of the last fix */
+		AISContactStore* getData();					/**< Returns all AIS contacts */
+		std::vector<AISShip*> getData(AISShipType shiptype);/**< Returns AIS contacts of a particular ship type */
 		AISShip* getData(int MMSI);					/**< Returns AIS contact for given MMSI, if it exists. It returns a reference to a default (invalid) object if the given MMSI is not present. */
 		AISShip* getData(string name);				/**< Returns AIS contact for given ship name, if it exists. It returns a reference to a default (invalid) object if the given ship name is not present. */
-		int pruneAIS(Location loc);					/**< Call the prune() function of each AIS contact. */
+		size_t getNearby(const Location& center, double radius, std::vector<AISShip*>& out);	/**< Finds the AIS contacts within radius meters of center. Returns the number found */
+		int pruneAIS(Location loc);					/**< Remove AIS contacts that are too old or too far from loc */
 		bool isValid() {return isConnected();};
-		GPSFix getAverageFix();
+		GPSFix getAverageFix() {return _average.get();};	/**< Returns the average position over the last gpsAvgLen fixes */
+		uint64_t getContention() {return _fix.contention() + _average.contention();};
+		uint64_t getLines() {return _lines.load();};			/**< Lines read from gpsd */
+		uint64_t getParseErrors() {return _parseErrors.load();};	/**< Lines that were damaged or failed to parse */
+		uint64_t getAISUpdates() {return _aisUpdates.load();};	/**< AIS reports stored; each is in the store by the time it's counted */
 		~GPSdInput () {
 			this->kill(); 
-			//if (myThread) delete myThread;
+			this->disconnect();
 		}
 		
 	private:
+		void updateAverage();						/**< Recalculate and publish the average fix */
+		bool processLine(const char *line, size_t len);	/**< Parse and process one line from gpsd, which must be terminated */
+		bool processBuffer(size_t fresh);			/**< Process the complete lines in the buffer, given the number of bytes just added, and keep the partial one */
+		void backoff();								/**< Put off the next attempt to connect */
+		bool resolve();								/**< Look up gpsd's addresses, which is the part of connecting that can block */
+		bool startConnect();						/**< Start connecting to the next of gpsd's addresses, without waiting */
+		bool finishConnect();						/**< Check on the connection under way; returns true once it's made, and gives it up if it's taken too long */
+		bool startWatch();							/**< Ask gpsd for its reports once we're connected */
+		void assessRisks();							/**< Run the CPA engine over the contacts from the last fix and publish the result */
 		string 				_host = "127.0.0.1";
 		int 				_port = 3001;
-		GPSFix 				_lastFix;
-		GPSFix				_averageFix;
+		GPSFix 				_lastFix;			/**< Working copy, private to the input thread */
+		GPSFix				_averageFix;		/**< Working copy, private to the input thread */
 		list<GPSFix>		_gpsAvgList;
-		std::map<int, AISShip>	_aisTargets;
-		redi::pstreambuf	gpsdstream;
-		std::thread 		*myThread;
+		Snapshot<GPSFix>	_fix;				/**< Last fix, as published to readers */
+		Snapshot<GPSFix>	_average;			/**< Last average fix, as published to readers */
+		AISContactStore		_aisTargets;
+		sysclock			_pruneAt;			/**< Next time the AIS contacts are pruned against the last fix */
+		AIVDMDecoder		_aivdm;				/**< Decoder for raw AIS sentences */
+		CPAEngine			_cpa;
+		CPAReport			_report;			/**< Working copy, private to the input thread */
+		Snapshot<CPAReport>	_risks;				/**< Last assessment, as published to readers */
+		struct Address {
+			struct sockaddr_storage	addr;
+			socklen_t				len;
+		};
+		vector<Address>		_addrs;				/**< gpsd's addresses, from resolve() */
+		size_t				_nextAddr = 0;		/**< Address to try next; moves on each time one fails */
+		int					_sock = -1;			/**< Connection to gpsd */
+		bool				_connecting = false;	/**< _sock is still connecting */
+		chrono::steady_clock::time_point	_connectBy;	/**< Give up on the connection under way if it isn't made by this time */
+		vector<char>		_rxbuf;				/**< Partial line carried over between calls to execute(), then whatever was just read */
+		size_t				_rxlen = 0;			/**< Bytes in the buffer */
+		bool				_overlong = false;	/**< Dropping the rest of a line that didn't fit */
+		chrono::steady_clock::time_point	_retryAt;	/**< Earliest time to try connecting again */
+		chrono::steady_clock::duration		_retryDelay = GPSD_RETRY_MIN;
+		bool				_simulated = false;	/**< Set by HalTestHarness::simulate(); counts as connected without gpsd */
+		atomic<uint64_t>	_lines {0};
+		atomic<uint64_t>	_parseErrors {0};
+		atomic<uint64_t>	_aisUpdates {0};
 
 		/*Document root;
 
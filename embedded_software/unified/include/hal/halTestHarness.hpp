@@ -1,7 +1,11 @@
 /******************************************************************************
  * Hackerboat HAL Test Harness module
  * hal/halTestHarness.hpp
- * This module permits manipulation of the I/O objects for writing useful unit tests
+ * This module permits manipulation of the I/O objects for writing useful unit tests.
+ * Input data is accessed in the current slot of each input's snapshot, so the
+ * input threads must not be running while the harness is in use.
+ * The simulate() functions cut devices off from the hardware, so that the
+ * control code can run off the boat (e.g. by the replay driver).
  * see the Hackerboat documentation for more details
  * Written by Pierce Nichols, Oct 2016
  * 
@@ -20,6 +24,7 @@
 #include "hal/throttle.hpp"
 #include "hal/relay.hpp"
 #include "hal/servo.hpp"
+#include "configuration.hpp"
 #include <string>
 #include <iostream>
 
@@ -29,17 +34,17 @@ class HalTestHarness {
 	public:
 		HalTestHarness () = default;
 		void accessADC (ADCInput *adc, std::map<std::string, int> **raw, bool **valid) {
-			if (raw) *raw = &(adc->_raw);
+			if (raw) *raw = adc->_values.unsafeCurrent();
 			if (valid) *valid = &(adc->inputsValid);
 		}
 		
 		void accessGPSd (GPSdInput *gps, GPSFix **fix, std::map<int, AISShip> **targets) {
-			if (fix) *fix = &(gps->_lastFix);
+			if (fix) *fix = gps->_fix.unsafeCurrent();
 			if (targets) *targets = &(gps->_aisTargets);
 		}
 		
 		void accessOrientation (OrientationInput *orient, Orientation **current, bool **valid) {
-			if (current) *current = &(orient->_current);
+			if (current) *current = orient->_orientation.unsafeCurrent();
 			if (valid) *valid = &(orient->sensorsValid);
 		}
 		
@@ -47,9 +52,9 @@ class HalTestHarness {
 						std::vector<uint16_t> **channels, std::string **buf, int **errs, int **good) {
 							if (throttle) *throttle = &(rc->_throttle);
 							if (rudder) *rudder = &(rc->_rudder);
-							if (failsafe) *failsafe = &(rc->failsafe);
+							if (failsafe) *failsafe = &(rc->_frame.unsafeCurrent()->failsafe);
 							if (valid) *valid = &(rc->_valid);
-							if (channels) *channels = &(rc->rawChannels);
+							if (channels) *channels = &(rc->_frame.unsafeCurrent()->channels);
 							if (buf) *buf = &(rc->inbuf);
 							if (errs) *errs = &(rc->_errorFrames);
 							if (good) *good = &(rc->_goodFrames);
@@ -59,6 +64,39 @@ class HalTestHarness {
 			if (drive) *drive = me->_drive;
 			if (fault) *fault = me->_fault;
 		}
+
+		void simulate (Pin *pin) {				/**< Reads return the last value written */
+			pin->_simulated = true;
+			pin->_init = true;
+		}
+
+		void simulate (Servo *servo) {			/**< attach() and write() succeed without a PWM channel */
+			servo->_simulated = true;
+		}
+
+		void simulate (ADCInput *adc) {			/**< Set up the channels without the ADC banks; publish readings with accessADC() */
+			adc->setDefaults();
+		}
+
+		void simulate (GPSdInput *gps) {		/**< Counts as connected; publish fixes with accessGPSd() */
+			gps->_simulated = true;
+		}
+
+		void simulate (RelayMap *relays) {		/**< Create any missing relays, all on simulated pins */
+			for (auto& a : Conf::get()->relayInit()) {
+				if (relays->relays->count(a.first)) continue;
+				RelaySpec r = a.second;
+				relays->relays->emplace(a.first,
+										new Relay(a.first, new Pin(std::get<1>(r), std::get<2>(r), true),
+										new Pin(std::get<3>(r), std::get<4>(r), false)));
+			}
+			for (auto& r : *relays->relays) {
+				simulate(r.second->_drive);
+				simulate(r.second->_fault);
+				r.second->initialized = true;
+			}
+			relays->initialized = true;
+		}
 };
 
 #endif
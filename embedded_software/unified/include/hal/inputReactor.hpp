@@ -0,0 +1,105 @@
+/******************************************************************************
+ * Hackerboat input reactor module
+ * hal/inputReactor.hpp
+ * This module runs all of the input readers from a single thread
+ *
+ * See the Hackerboat documentation for more details
+ * Written by agent, Oct 2026
+ *
+ * Version 0.1: First alpha
+ *
+ ******************************************************************************/
+
+#ifndef INPUTREACTOR_H
+#define INPUTREACTOR_H
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <list>
+#include <inttypes.h>
+#include "hal/inputThread.hpp"
+#include "cycleProfiler.hpp"
+
+/**
+ * @class InputReactor
+ *
+ * @brief Multiplexes any number of InputThread objects onto one epoll loop running in one thread.
+ *
+ * Inputs with a file descriptor are executed when it becomes readable, and also after the input event
+ * timeout has passed with no data so that they can notice failures. Inputs without a descriptor are
+ * executed from a timerfd on their period. An input that closes its descriptor, to reconnect say, should
+ * return -1 from getFD() at the end of that execute(); it then runs on its period until it has a new one,
+ * which is registered even if it reuses the old number. A descriptor that isConnecting() is watched until
+ * it's writable instead, and the input is executed on any event from it, errors included.
+ *
+ * Inputs are registered by InputThread::launch() when the input mode is Reactor, and the reactor thread is
+ * started with the first of them. InputThread::kill() removes an input, waiting for an execute() already
+ * under way, so an input can be destroyed safely once it has been killed; one stopped some other way is
+ * dropped the next time it comes up. Dropped sources are freed at the end of the batch of events they were
+ * dropped in.
+ *
+ * Every input is executed on the one reactor thread, without the lock held, so add(), remove() and
+ * getSourceCount() don't wait on a slow input, but the other inputs do: execute() must not block.
+ * The reactor thread is scheduled as "Reactor", and records how late each timer dispatch runs.
+ */
+
+class InputReactor {
+	public:
+		static InputReactor* get () {return _instance;};
+
+		bool add (InputThread *input);						/**< Register an input, starting the reactor thread if necessary */
+		void remove (InputThread *input);					/**< Deregister an input, waiting for it to finish executing if it's running now */
+		void stop ();										/**< Stop the reactor thread and kill every registered input */
+		bool isRunning () {return _running.load();};
+		int getSourceCount ();								/**< Number of live inputs */
+		uint64_t getDispatches () {return _dispatches.load(std::memory_order_relaxed);};	/**< Number of times any input has been executed */
+
+	private:
+		InputReactor () = default;
+		InputReactor (InputReactor const&) = delete;				/**< Hark, a singleton! */
+		InputReactor& operator=(InputReactor const&) = delete;		/**< Hark, a singleton! */
+		static InputReactor *_instance;
+
+		struct Source;
+
+		struct Handle {										/**< What epoll hands back to us for each registered descriptor */
+			Source	*source;
+			bool	timer;
+		};
+
+		struct Source {
+			InputThread	*input;
+			int			fd = -1;							/**< Input descriptor registered with epoll, or -1 */
+			bool		connecting = false;					/**< Watching the descriptor for a connection to finish rather than for input */
+			int			hungUp = -1;						/**< Last input descriptor that hung up; not registered again until the input lets it go */
+			int			timer = -1;							/**< timerfd driving the period or the event timeout */
+			bool		live = true;
+			bool		busy = false;						/**< Executing, so not to be freed or dropped until it's done */
+			Handle		fdHandle { this, false };
+			Handle		timerHandle { this, true };
+		};
+
+		bool start ();										/**< Create the epoll set and start the reactor thread */
+		void run ();										/**< Reactor thread body */
+		void dispatch (Source *src, uint32_t events, bool timer);	/**< Run the source's input if the event calls for it, taking the lock around but not over execute() */
+		bool watch (Source *src, int fd, bool connecting);	/**< Point the source at a new input descriptor, or at one to finish connecting */
+		bool arm (Source *src);								/**< (Re)start the source's timer */
+		void recordLatency (Source *src, uint64_t expirations);	/**< Record how long ago the source's timer first expired */
+		void retire (Source *src);							/**< Stop watching a source whose input has been killed */
+		void reap ();										/**< Free the retired sources */
+
+		int						_epoll = -1;
+		int						_wake = -1;					/**< eventfd used to break out of epoll_wait() on stop() */
+		std::thread				*_thread = NULL;
+		std::thread::id			_threadId;					/**< Reactor thread, which can't wait on its own dispatch */
+		std::mutex				_lock;						/**< Held while adding, removing or updating sources, but not while an input executes */
+		std::condition_variable	_idle;						/**< Signalled when a dispatch finishes */
+		std::list<Source*>		_sources;
+		std::atomic_bool		_running { false };
+		std::atomic<uint64_t>	_dispatches { 0 };
+		LatencyHistogram		*_latency = NULL;			/**< Wakeup latency of timer dispatches */
+};
+
+#endif /* INPUTREACTOR_H */
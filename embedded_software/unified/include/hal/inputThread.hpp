@@ -17,51 +17,150 @@
 #include <atomic>
 #include <thread>
 #include <chrono>
-#include <mutex>
+#include <inttypes.h>
 #include "hackerboatRoot.hpp"
+#include "enumdefs.hpp"
+#include "enumtable.hpp"
 
+class LatencyHistogram;
+
+
+/**
+ * @class Snapshot
+ *
+ * @brief Latest-value mailbox for passing data from an input thread to its readers.
+ *
+ * The input thread works on its own private copy and calls publish() once it has a complete
+ * reading. Readers get a consistent copy of the last published value from read() or get(), or
+ * can look at it in place with visit().
+ * There are N slots, each with a count of the readers currently copying out of it; publish()
+ * writes into a slot that is neither current nor being read, then makes it current. Neither
+ * side ever blocks the other. A reader whose slot is retired under it before it registers
+ * tries again, and a publish that finds every slot busy is dropped; both are counted.
+ *
+ * This is used rather than a plain seqlock because the payloads (maps, vectors, strings) are
+ * not trivially copyable, so a reader must never copy out of a slot while it is being written.
+ * There must be only one publishing thread per Snapshot.
+ */
+
+template <typename T, int N = 4>
+class Snapshot {
+	static_assert(N >= 3, "Snapshot needs at least three slots so that a reader cannot starve the writer");
+	public:
+		Snapshot () = default;
+		Snapshot (const T& initial) {_slots[0].data = initial;};
+
+		void publish (const T& value) {							/**< Make value the latest reading. Only call from the owning input thread */
+			int cur = _current.load();
+			for (int i = 0; i < N; i++) {
+				if ((i != cur) && (_slots[i].readers.load() == 0)) {
+					_slots[i].data = value;
+					_current.store(i);
+					_sequence.fetch_add(1, std::memory_order_relaxed);
+					return;
+				}
+			}
+			_dropped.fetch_add(1, std::memory_order_relaxed);
+		};
+
+		template <typename F>
+		void visit (F fn) const {								/**< Call fn with a const reference to the latest reading. fn must be short and must not throw */
+			for (;;) {
+				int cur = _current.load();
+				_slots[cur].readers.fetch_add(1);
+				if (_current.load() == cur) {
+					fn(static_cast<const T&>(_slots[cur].data));
+					_slots[cur].readers.fetch_sub(1);
+					return;
+				}
+				// the writer moved on before we registered, so this slot may be rewritten under us
+				_slots[cur].readers.fetch_sub(1);
+				_retries.fetch_add(1, std::memory_order_relaxed);
+			}
+		};
+
+		void read (T& out) const {visit([&out] (const T& in) {out = in;});};	/**< Copy the latest reading into out */
+		T get () const {T out; read(out); return out;};			/**< Return a copy of the latest reading */
+		T* unsafeCurrent () {return &(_slots[_current.load()].data);};	/**< Direct pointer to the current slot; only for use when nothing is publishing, e.g. by the test harness */
+		uint64_t sequence () const {return _sequence.load(std::memory_order_relaxed);};	/**< Number of successful publishes */
+		uint64_t retries () const {return _retries.load(std::memory_order_relaxed);};	/**< Number of times a reader had to start over */
+		uint64_t dropped () const {return _dropped.load(std::memory_order_relaxed);};	/**< Number of publishes dropped because every slot was busy */
+		uint64_t contention () const {return retries() + dropped();};
+
+	private:
+		Snapshot (Snapshot const&) = delete;
+		Snapshot& operator=(Snapshot const&) = delete;
+
+		struct Slot {
+			T						data;
+			mutable std::atomic_int	readers { 0 };
+		};
+
+		Slot							_slots[N];
+		std::atomic_int					_current { 0 };
+		std::atomic<uint64_t>			_sequence { 0 };
+		mutable std::atomic<uint64_t>	_retries { 0 };
+		std::atomic<uint64_t>			_dropped { 0 };
+};
 
 /**
  * @brief This class defines a common interface and routines for creating input threads.
+ *
+ * In periodic mode every input wakes up once per period and calls execute(). In event mode, inputs
+ * that return a file descriptor from getFD() instead block in poll() until that descriptor is readable
+ * (or the input event timeout expires) and execute() is expected to drain everything that is available.
+ * While isConnecting() is true the wait is for the descriptor to become writable instead, so that an input
+ * can start a non-blocking connect in one execute() and finish it in the next.
+ * Inputs without a descriptor run periodically in either mode. In reactor mode, launch() hands the input
+ * to the InputReactor instead of starting a thread for it, and the reactor calls execute() on the same terms.
  */
 class InputThread {
 	public:
+		static const EnumNameTable<InputModeEnum> inputModeNames;
+		static InputModeEnum configuredMode ();	/**< Input mode selected in the configuration file */
+
 		InputThread() = default;	
+		virtual ~InputThread();					/**< Kills the input, so that the reactor lets go of it. Subclasses should kill() first in their own destructors, before anything execute() uses goes away */
 		
 		class InputThreadRunner {
 			public:
 				InputThreadRunner (InputThread *mine) : me(mine) {};
-				void operator()() {						/**< Thread runner function */
-					me->runFlag = true;
-					while (me->runFlag) {
-						auto endtime = std::chrono::system_clock::now() + me->period;
-						me->execute();
-						std::this_thread::sleep_until(endtime);
-					}
-				};
+				void operator()();						/**< Thread runner function */
 				
 			private:
 				InputThread *me;	// The InputThread this function is running
 		};
 		
 		virtual bool begin() = 0;				/**< Start the input thread */
+		bool launch();							/**< Start running execute(), on a new thread or on the reactor depending on the input mode */
 		virtual bool execute() = 0;				/**< Gather input	*/
-		void kill() {runFlag = false;};			/**< Kill the thread */
+		virtual int getFD() {return -1;};		/**< File descriptor to wait on in event mode, or -1 to run periodically */
+		virtual bool isConnecting() {return false;};	/**< True while the descriptor from getFD() is still connecting, and should be waited on until it's writable */
+		virtual const char* getThreadName() {return "Input";};	/**< Name of the thread, and of its entry in the thread schedule */
+		void kill();							/**< Kill the thread. In reactor mode this also waits for any execute() under way and deregisters the input */
+		bool isRunning() {return runFlag;};		/**< True until the input is killed */
 		sysclock getLastInputTime() {			/**< Get the time the last data arrived. */
-			return lastInput;
+			return lastInput.load();
 		};
+		virtual uint64_t getContention() {return 0;};	/**< Number of snapshot retries and dropped publishes since startup */
+		uint64_t getWakeups() {return wakeups.load(std::memory_order_relaxed);};	/**< Number of times execute() has been called by the runner */
+		void setInputMode (InputModeEnum mode) {inputMode = mode;};	/**< Override the configured mode; call before begin() */
+		InputModeEnum getInputMode () {return inputMode;};
 		
-		std::unique_lock<std::timed_mutex> lock {mtx, std::defer_lock};	/**< Locking object for data */
 		friend InputThreadRunner;
+		friend class InputReactor;
 	
 	protected:
-		void setLastInputTime() {lastInput = system_clock::now();};
+		void setLastInputTime() {lastInput.store(system_clock::now());};
+		bool waitForInput (int fd, bool connecting);	/**< Block until fd is readable (writable, if connecting) or the event timeout expires. Returns true if it is */
 		std::atomic_bool runFlag { false };
 		std::chrono::system_clock::duration period = 10ms;
+		InputModeEnum inputMode = configuredMode();
 		
 	private:
-		sysclock lastInput;						/**< Time that last input was processed */
-		std::timed_mutex mtx;
+		std::atomic<sysclock> lastInput { sysclock() };	/**< Time that last input was processed */
+		std::atomic<uint64_t> wakeups { 0 };
+		LatencyHistogram *wakeupLatency = NULL;			/**< Set by the runner once the thread is configured */
 	
 };
 
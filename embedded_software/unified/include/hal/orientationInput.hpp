@@ -43,18 +43,19 @@ class OrientationInput : public InputThread {
 	friend class HalTestHarness;
 	public:	
 		OrientationInput(SensorOrientation axis = SensorOrientation::SENSOR_AXIS_Z_UP);
-		Orientation* getOrientation() {							/**< Get the last orientation recorded */
-			return &_current;
+		Orientation getOrientation() {							/**< Get the last orientation recorded */
+			return _orientation.get();
 		}
 		bool init();											/**< initialize hardware */
 		bool isValid() {return sensorsValid;};					/**< Check if the hardware connections are good */
 		bool begin();											/**< Start the input thread */
 		bool execute();											/**< Gather input	*/
+		const char* getThreadName() {return "Orientation";};
 		void setAxis(SensorOrientation axis) {_axis = axis;};	/**< Set the gravity axis */
 		SensorOrientation getAxis () {return _axis;};			/**< Get the gravity axis */
+		uint64_t getContention() {return _orientation.contention();};
 		~OrientationInput () {
 			this->kill(); 
-			//if (myThread) delete myThread;
 		}
 		LSM303 compass { Conf::get()->imuI2Cbus() };
 	
@@ -65,9 +66,8 @@ class OrientationInput : public InputThread {
 		void getMagOrientation ();
 		//L3GD20	gyro { IMU_I2C_BUS };
 		
-		std::thread *myThread;
-		
-		Orientation 				_current;
+		Orientation 				_current;				/**< Working copy, private to the input thread */
+		Snapshot<Orientation>		_orientation;			/**< Last orientation, as published to readers */
 		bool 						sensorsValid = false;
 		SensorOrientation			_axis = SensorOrientation::SENSOR_AXIS_Z_UP;
 };
@@ -58,6 +58,7 @@ class Servo {
 		unsigned long _center = 1500000;
 		unsigned long _val = 1500000;
 		bool attached = false;
+		bool _simulated = false;						/**< Set by HalTestHarness::simulate(); the PWM channel is never touched */
 	
 };
 
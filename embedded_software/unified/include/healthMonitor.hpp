@@ -29,7 +29,11 @@ class HealthMonitor : public HackerboatState {
 		HealthMonitor () = default;
 		HealthMonitor (ADCInput* adc) : _adc(adc) {};
 		bool parse (Value& input);
-		Value pack () const;
+		Value pack () const {return packFields(fields, this);};
+		bool writeJSON (JSONWriter& writer) const {return writeFields(fields, this, writer);};
+		bool readJSON (const char *json) USE_RESULT {return readFields(fields, this, json);};
+		size_t writeRecord (uint8_t *buf, size_t len) const {return encodeRecord(fields, this, buf, len);};
+		bool readRecord (const uint8_t *buf, size_t len) USE_RESULT {return decodeRecord(fields, this, buf, len);};
 		bool isValid () {return valid;};
 		bool setADCdevice(ADCInput* adc) {	/**< Set the ADC input thread */
 			valid = false;
@@ -52,10 +56,12 @@ class HealthMonitor : public HackerboatState {
 		int			rcRssi;					/**< RC system RSSI, dbm */
 		int			cellRssi;				/**< Cell system RSSI, dbm */
 		int			wifiRssi;				/**< Wifi RSSI, dbm */
+		static const FieldDescriptor fields[];	/**< Members written and read by writeJSON() and readJSON() */
 		
 	private:
 		bool valid;
 		ADCInput* _adc;
+		std::map<std::string, double> _data;	/**< Scaled ADC values, kept between reads so they don't allocate */
 };
 
 
@@ -0,0 +1,79 @@
+/******************************************************************************
+ * Hackerboat heartbeat module
+ * heartbeat.hpp
+ * This module passes a heartbeat from the master control program to the
+ * watchdog through shared memory
+ *
+ * See the Hackerboat documentation for more details
+ * Written by agent, Oct 2026
+ *
+ * Version 0.1: First alpha
+ *
+ ******************************************************************************/
+
+#ifndef HEARTBEAT_H
+#define HEARTBEAT_H
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <inttypes.h>
+#include "enumdefs.hpp"
+#include "configuration.hpp"
+
+using namespace std;
+
+#define HEARTBEAT_MAGIC		(0x48426862)	/**< "HBhb" -- marks an initialized heartbeat block */
+
+/**
+ * @brief Layout of the shared memory block. Every field is a lock-free 32-bit atomic
+ * so that it can be read and written from separate processes without locking.
+ */
+
+struct HeartbeatBlock {
+	atomic<uint32_t>	magic;			/**< HEARTBEAT_MAGIC once the master has written to the block */
+	atomic<uint32_t>	counter;		/**< Incremented once per control cycle */
+	atomic<int32_t>		mode;			/**< Current BoatModeEnum, as an integer */
+	atomic<int32_t>		pid;			/**< PID of the process writing the heartbeat */
+};
+
+/**
+ * @class Heartbeat
+ *
+ * @brief Shared memory heartbeat between the master control program and the watchdog.
+ *
+ * Either side may open the block first; it is created if it does not exist. The master calls beat() once
+ * per cycle, which is a pair of atomic stores and no system calls. The watchdog calls check() as often as
+ * it likes and fires when the counter has not moved for longer than the timeout. Staleness is judged against
+ * the watchdog's own monotonic clock, so wall clock steps cannot trip or mask it.
+ */
+
+class Heartbeat {
+	public:
+		Heartbeat (const string& name = Conf::get()->heartbeatName()) : _name(name) {};
+		~Heartbeat ();
+		bool open ();										/**< Open (creating if necessary) and map the shared memory block */
+		void close ();										/**< Unmap and close the shared memory block */
+		bool isOpen () const {return (_block != NULL);};
+		const string& getName () const {return _name;};
+
+		// master side
+		void beat (BoatModeEnum mode);						/**< Signal that the master has completed another cycle */
+
+		// watchdog side
+		bool check (sysdur timeout);						/**< Returns true if the master has beaten within the timeout */
+		uint32_t getCounter () const;						/**< Last counter value written by the master */
+		BoatModeEnum getMode () const;						/**< Last mode written by the master */
+		int getPid () const;								/**< PID of the master, or zero if it has never beaten */
+		sysdur sinceLastBeat () const;						/**< Time since check() last saw the counter move */
+
+	private:
+		string						_name;
+		int							_fd = -1;
+		HeartbeatBlock				*_block = NULL;
+		uint32_t					_lastCounter = 0;
+		steady_clock::time_point	_lastChange;
+		bool						_seen = false;			/**< True once check() has taken its first reading */
+};
+
+#endif /* HEARTBEAT_H */
@@ -0,0 +1,57 @@
+/******************************************************************************
+ * Hackerboat json scope module
+ * jsonScope.hpp
+ * This module provides the per-thread allocator used when packing objects
+ * into rapidjson Values, and the scopes that bound its lifetime
+ *
+ * See the Hackerboat documentation for more details
+ * Written by agent, Oct 2026
+ *
+ * Version 0.1: First alpha
+ *
+ ******************************************************************************/
+
+#ifndef JSONSCOPE_H
+#define JSONSCOPE_H
+
+#include <cstddef>
+#include <atomic>
+#include <inttypes.h>
+#include "rapidjson/rapidjson.h"
+#include "rapidjson/allocators.h"
+
+#define JSON_ARENA_SIZE		(65536)			/**< Bytes preallocated for each thread's json allocator */
+
+/**
+ * @class JSONScope
+ *
+ * @brief Bounds the lifetime of Values built by pack() and PutVar() on the current thread.
+ *
+ * Each thread packs into its own MemoryPoolAllocator, which starts out with a JSON_ARENA_SIZE block. When
+ * the outermost JSONScope on a thread closes, everything allocated on that thread is thrown away, and any
+ * extra chunks the allocator had to take from the heap are given back. Memory use is therefore bounded by
+ * the largest single cycle rather than growing for the life of the process.
+ *
+ * Every thread loop opens a scope around each cycle. A packed Value is good until the scope it was packed
+ * in closes, so it must not be kept across cycles or handed to another thread. Values packed outside of
+ * any scope last until the next outermost scope on that thread closes.
+ */
+
+class JSONScope {
+	public:
+		JSONScope ();
+		~JSONScope ();
+		static rapidjson::MemoryPoolAllocator<>& allocator ();		/**< The calling thread's allocator */
+		static size_t used ();											/**< Bytes allocated on the calling thread since its outermost scope opened */
+		static size_t highWater () {return _highWater.load(std::memory_order_relaxed);};	/**< Most bytes any thread has used in one scope */
+		static uint64_t spills () {return _spills.load(std::memory_order_relaxed);};		/**< Number of scopes that outgrew their thread's block */
+
+	private:
+		JSONScope (JSONScope const&) = delete;
+		JSONScope& operator=(JSONScope const&) = delete;
+
+		static std::atomic<size_t>		_highWater;
+		static std::atomic<uint64_t>	_spills;
+};
+
+#endif /* JSONSCOPE_H */
@@ -0,0 +1,82 @@
+/******************************************************************************
+ * Hackerboat vector lanes module
+ * lanes.hpp
+ * This module wraps the vector unit for the batched navigation kernels
+ *
+ * See the Hackerboat documentation for more details
+ * Written by agent, Oct 2026
+ *
+ * Version 0.1: First alpha
+ *
+ ******************************************************************************/
+
+#ifndef LANES_H
+#define LANES_H
+
+#include <math.h>
+
+/* Four lanes of single precision arithmetic for the batched kernels, or one lane where there is no vector
+ * unit. ARMv7 NEON has no square root or divide, so they are refined from the reciprocal estimates. */
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define BATCH_LANES	(4)
+typedef float32x4_t lanes;
+static inline lanes lset (float x) {return vdupq_n_f32(x);}
+static inline lanes lload (const float *p) {return vld1q_f32(p);}
+static inline void lstore (float *p, lanes v) {vst1q_f32(p, v);}
+static inline lanes ladd (lanes a, lanes b) {return vaddq_f32(a, b);}
+static inline lanes lsub (lanes a, lanes b) {return vsubq_f32(a, b);}
+static inline lanes lmul (lanes a, lanes b) {return vmulq_f32(a, b);}
+static inline lanes lmin (lanes a, lanes b) {return vminq_f32(a, b);}
+static inline lanes lmax (lanes a, lanes b) {return vmaxq_f32(a, b);}
+static inline lanes lsqrt (lanes q) {
+#if defined(__aarch64__)
+	return vsqrtq_f32(q);
+#else
+	float32x4_t r = vrsqrteq_f32(q);
+	r = vmulq_f32(r, vrsqrtsq_f32(vmulq_f32(q, r), r));
+	r = vmulq_f32(r, vrsqrtsq_f32(vmulq_f32(q, r), r));
+	return vbslq_f32(vceqq_f32(q, vdupq_n_f32(0)), q, vmulq_f32(q, r));	// the estimate of 1/sqrt(0) is infinite
+#endif
+}
+static inline lanes ldiv (lanes a, lanes b) {
+#if defined(__aarch64__)
+	return vdivq_f32(a, b);
+#else
+	float32x4_t r = vrecpeq_f32(b);
+	r = vmulq_f32(r, vrecpsq_f32(b, r));
+	r = vmulq_f32(r, vrecpsq_f32(b, r));
+	return vmulq_f32(a, r);
+#endif
+}
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define BATCH_LANES	(4)
+typedef __m128 lanes;
+static inline lanes lset (float x) {return _mm_set1_ps(x);}
+static inline lanes lload (const float *p) {return _mm_loadu_ps(p);}
+static inline void lstore (float *p, lanes v) {_mm_storeu_ps(p, v);}
+static inline lanes ladd (lanes a, lanes b) {return _mm_add_ps(a, b);}
+static inline lanes lsub (lanes a, lanes b) {return _mm_sub_ps(a, b);}
+static inline lanes lmul (lanes a, lanes b) {return _mm_mul_ps(a, b);}
+static inline lanes lmin (lanes a, lanes b) {return _mm_min_ps(a, b);}
+static inline lanes lmax (lanes a, lanes b) {return _mm_max_ps(a, b);}
+static inline lanes lsqrt (lanes q) {return _mm_sqrt_ps(q);}
+static inline lanes ldiv (lanes a, lanes b) {return _mm_div_ps(a, b);}
+#else
+#define BATCH_LANES	(1)
+typedef float lanes;
+static inline lanes lset (float x) {return x;}
+static inline lanes lload (const float *p) {return *p;}
+static inline void lstore (float *p, lanes v) {*p = v;}
+static inline lanes ladd (lanes a, lanes b) {return a + b;}
+static inline lanes lsub (lanes a, lanes b) {return a - b;}
+static inline lanes lmul (lanes a, lanes b) {return a * b;}
+static inline lanes lmin (lanes a, lanes b) {return (a < b) ? a : b;}
+static inline lanes lmax (lanes a, lanes b) {return (a > b) ? a : b;}
+static inline lanes lsqrt (lanes q) {return sqrtf(q);}
+static inline lanes ldiv (lanes a, lanes b) {return a / b;}
+#endif
+
+#endif /* LANES_H */
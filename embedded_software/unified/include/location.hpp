@@ -18,6 +18,7 @@
 #include "hal/config.h"
 #include <math.h>
 #include <string>
+#include <vector>
 #include "hackerboatRoot.hpp"
 #include "twovector.hpp"
 #include <GeographicLib/Geodesic.hpp>
@@ -27,10 +28,12 @@
 using namespace GeographicLib;
 using namespace rapidjson;
 
+#define LOCATION_APPROX_MAX_LAT	(80.0)		/**< Nearer the poles than this, Approximate courses use the great circle */
+
 enum class CourseTypeEnum {
 	GreatCircle,
 	RhumbLine,
-	Approximate
+	Approximate		/**< Flat earth, tangent to the ellipsoid between the two points; great circle past Conf::approxMaxDistance() */
 };
 
 /**
@@ -48,13 +51,32 @@ class Location : public HackerboatState {
 		  	: lat(_lat), lon(_lon) { };
 		Location (const Location& l)
 			: lat(l.lat), lon(l.lon) { };
-		bool parse (Value& input);					/**< Populate this Location object from a properly formated json object */
-		Value pack () const USE_RESULT;			/**< Pack a json object from this Location object. */
+		bool parse (Value& input) {return (parseFields(fields, this, input) && this->isValid());};	/**< Populate this Location object from a properly formated json object */
+		Value pack () const USE_RESULT {return packFields(fields, this);};		/**< Pack a json object from this Location object. */
+		bool writeJSON (JSONWriter& writer) const {return writeFields(fields, this, writer);};
+		bool readJSON (const char *json) USE_RESULT {return readFields(fields, this, json);};
+		size_t writeRecord (uint8_t *buf, size_t len) const {return encodeRecord(fields, this, buf, len);};
+		bool readRecord (const uint8_t *buf, size_t len) USE_RESULT {return decodeRecord(fields, this, buf, len);};
 		bool isValid (void) const;					/**< Check for validity */
 		double bearing (const Location& dest, CourseTypeEnum type = CourseTypeEnum::GreatCircle) const;		/**< Get the bearing from the current location to the target */
 		double distance (const Location& dest, CourseTypeEnum type = CourseTypeEnum::GreatCircle) const;	/**< Get the distance from the current location to the target, in meters */
 		TwoVector target (const Location& dest, CourseTypeEnum type = CourseTypeEnum::GreatCircle) const;	/**< Get the course and distance to destination as a TwoVector, in meters */
 		Location project (TwoVector& projection, CourseTypeEnum type = CourseTypeEnum::GreatCircle);		/**< Get the Location at the given meter-valued TwoVector from the current location */
+		void course (const Location& dest, double& dist, double& azi, CourseTypeEnum type = CourseTypeEnum::GreatCircle) const;	/**< Get the distance and bearing to the target together, for the cost of one of them. Both are NaN if either location is invalid */
+
+		/**
+		 * @brief Get the distance and bearing from the current location to many targets in one call.
+		 *
+		 * Targets are given as arrays of latitudes and longitudes, and the results go into arrays of the same
+		 * length; azi may be NULL if only distances are wanted. Approximate targets are worked out several at
+		 * a time with NEON or SSE, and agree with distance() and bearing() to within a centimeter and 0.0001
+		 * degrees. Any target the approximation doesn't cover is done with one great circle (or rhumb line)
+		 * query, so the cost is predictable from the return value, which is the number done that way.
+		 */
+		size_t targets (const double *lats, const double *lons, size_t count, double *dist, double *azi = NULL,
+						CourseTypeEnum type = CourseTypeEnum::Approximate) const;
+		size_t targets (const std::vector<Location>& dests, double *dist, double *azi = NULL,
+						CourseTypeEnum type = CourseTypeEnum::Approximate) const;	/**< As above, for a list of Locations such as a route */
 		Location& operator=(const Location& l) {
 			this->lat = l.lat;
 			this->lon = l.lon;
@@ -63,7 +85,11 @@ class Location : public HackerboatState {
 
 		double 		lat;							/**< Latitude in degrees north of the equator. Values from -90.0 to 90.0, inclusive. */
 		double 		lon;							/**< Longitude in degrees east of the prime meridian. Values from -180.0 to 180.0, inclusive. */		
+		static const FieldDescriptor fields[];	/**< Members written and read by writeJSON() and readJSON() */
 	private:
+		bool approxInverse (const Location& dest, double& dist, double& azi) const;	/**< Approximate distance and initial bearing. Returns false if it's out of range */
+		bool approxDirect (TwoVector& projection, Location& result) const;			/**< Approximate projection. Returns false if it's out of range */
+		void inverse (double destLat, double destLon, CourseTypeEnum type, double& dist, double& azi) const;	/**< Distance and bearing with one exact query */
 		static Geodesic *geod;	
 		static Rhumb 	*rhumb;
 };
@@ -0,0 +1,150 @@
+/******************************************************************************
+ * Hackerboat mission log module
+ * missionLog.hpp
+ * This module maps master logs and CSV files into memory and keeps a sparse
+ * time index of them beside the log, so that time range and field queries
+ * only read the parts of the log they need
+ *
+ * See the Hackerboat documentation for more details
+ * Written by agent, Oct 2026
+ *
+ * Version 0.1: First alpha
+ *
+ ******************************************************************************/
+
+#ifndef MISSIONLOG_H
+#define MISSIONLOG_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <functional>
+#include <inttypes.h>
+#include "hackerboatRoot.hpp"
+
+#define MISSIONLOG_INDEX_MAGIC		"HBLOGIDX"		/**< First eight bytes of an index file */
+#define MISSIONLOG_INDEX_VERSION	(1)
+#define MISSIONLOG_INDEX_SUFFIX		".idx"			/**< Added to the log's path to get the index file's path */
+#define MISSIONLOG_INDEX_STRIDE		(65536)			/**< Bytes of log covered by each index block, give or take a line */
+#define MISSIONLOG_CHECK_SIZE		(4096)			/**< Bytes at each end of the indexed part of the log that the index checks */
+#define MISSIONLOG_LINE_TAG			",CSV,"			/**< What the master puts in front of each CSV line in its log */
+
+/**
+ * @brief Header at the front of an index file, followed by the blocks and then the header line offsets.
+ *
+ * Index files are in the byte order of the machine that wrote them; one that doesn't match is rebuilt.
+ */
+
+struct LogIndexHeader {
+	char		magic[8];			/**< MISSIONLOG_INDEX_MAGIC, without a terminator */
+	uint32_t	version;			/**< MISSIONLOG_INDEX_VERSION */
+	uint32_t	stride;				/**< MISSIONLOG_INDEX_STRIDE */
+	uint64_t	logSize;			/**< Bytes of the log indexed, which always ends with a whole line */
+	int64_t		logMtime;			/**< Modification time of the log when it was indexed, in nanoseconds */
+	uint32_t	check;				/**< CRC-32 of the first and last MISSIONLOG_CHECK_SIZE bytes indexed */
+	uint32_t	flags;				/**< LOGINDEX_TAGGED */
+	uint64_t	blocks;				/**< Number of LogIndexBlocks that follow */
+	uint64_t	headers;			/**< Number of header line offsets after the blocks */
+};
+
+#define LOGINDEX_TAGGED		(1)		/**< The log is a master log, with its CSV lines marked by MISSIONLOG_LINE_TAG */
+
+/**
+ * @brief One stretch of the log and the span of record times in it.
+ *
+ * Times are milliseconds since the epoch. Logs aren't always in time order (the clock gets set after
+ * the master starts), so a query looks at every block whose span overlaps it, not just the first one.
+ */
+
+struct LogIndexBlock {
+	uint64_t	offset;				/**< Start of the first line in the block */
+	uint64_t	end;				/**< Just past the newline of the last line in the block */
+	int64_t		minTime;			/**< Earliest record time in the block */
+	int64_t		maxTime;			/**< Latest record time in the block */
+	uint64_t	lines;				/**< Data lines in the block */
+};
+
+/**
+ * @brief A test of one column of a data line, such as "Boat Mode=Navigation" or "Speed (m/s)>0.5".
+ *
+ * If the value reads as a number, so must the field, and they are compared as numbers. Otherwise they are
+ * compared as text.
+ */
+
+struct LogFilter {
+	enum class Op {EQ, NE, LT, GT, LE, GE};
+
+	static bool parse (const std::string& spec, LogFilter& filter);	/**< Read a filter written as column, operator (= != < > <= >=), value */
+	bool match (const std::string& field) const;
+
+	std::string		column;
+	Op				op = Op::EQ;
+	std::string		value;
+	double			number = 0;
+	bool			numeric = false;
+};
+
+/**
+ * @class MissionLog
+ *
+ * @brief A master log or bare CSV file, mapped into memory with a time index of its data lines.
+ *
+ * The index is saved next to the log the first time it is opened and reused after that. If the log has
+ * grown since, only the new part is indexed; if it has been changed any other way, the index is rebuilt.
+ * Only whole lines are indexed, so a log that is still being written can be opened. Lines are classified
+ * the same way CSVLogReplay does it: in a master log only the lines marked with MISSIONLOG_LINE_TAG count,
+ * and a line whose first field isn't a time is a header for the lines after it.
+ */
+
+class MissionLog {
+	public:
+		/**
+		 * @brief One data line, as handed to a query's callback. The pointers are into the mapped log.
+		 */
+		struct Line {
+			sysclock		time;			/**< Record time, from the first field */
+			const char		*data;			/**< The CSV fields, without the log prefix or the newline */
+			size_t			len;
+			const char		*header;		/**< The header line in effect, or NULL if there isn't one */
+			size_t			headerLen;
+		};
+
+		typedef std::function<bool(const Line&)> Callback;		/**< Called for each matching line; return false to stop */
+
+		MissionLog () = default;
+		~MissionLog () {close();};
+		bool open (const std::string& path, bool useCache = true);	/**< Map the log and load or build its index. useCache = false rebuilds it */
+		void close ();
+		bool isOpen () const {return (_fd >= 0);};
+		bool fromCache () const {return _fromCache;};				/**< True if any of the index came from the index file */
+		bool tagged () const {return (_flags & LOGINDEX_TAGGED);};
+		uint64_t lines () const;									/**< Data lines indexed */
+		size_t blocks () const {return _blocks.size();};
+		sysclock start () const;									/**< Earliest record time in the log */
+		sysclock end () const;										/**< Latest record time in the log */
+		size_t query (sysclock from, sysclock to, const std::vector<LogFilter>& filters, Callback callback) const;	/**< Call back for each data line from from to to, inclusive, that passes every filter. Returns the number of lines */
+
+		static void columns (const char *header, size_t len, std::vector<std::string>& names);	/**< Split a header line into its column names */
+		static int column (const std::vector<std::string>& names, const std::string& name);	/**< Index of a column, or -1 */
+
+	private:
+		MissionLog (MissionLog const&) = delete;
+		MissionLog& operator=(MissionLog const&) = delete;
+		bool load (const std::string& path, int64_t mtime, bool& sameTime);	/**< Read the index file; returns false if it's missing or stale */
+		void save (const std::string& path, int64_t mtime) const;
+		void build (uint64_t from);								/**< Index the log from a line start to the last whole line */
+		uint32_t check () const;
+		const char* headerAt (uint64_t offset) const;				/**< Start of the header line in effect at offset, or NULL */
+		const char* classify (const char *p, const char *eol, bool& header, sysclock& time) const;	/**< Returns the start of the fields, or NULL for a line to ignore */
+
+		int							_fd = -1;
+		const char					*_base = NULL;
+		size_t						_size = 0;					/**< Bytes mapped */
+		uint64_t					_indexed = 0;				/**< Bytes indexed */
+		uint32_t					_flags = 0;
+		bool						_fromCache = false;
+		std::vector<LogIndexBlock>	_blocks;
+		std::vector<uint64_t>		_headers;					/**< Offsets of the fields of each header line, in order */
+};
+
+#endif /* MISSIONLOG_H */
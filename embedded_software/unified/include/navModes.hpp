@@ -28,6 +28,8 @@ class NavModeBase : public StateMachineBase<NavModeEnum, BoatState> {
 		static NavModeBase* factory(BoatState& state, NavModeEnum mode);			/**< Create a new object of the given mode */
 		virtual NavModeBase* execute () = 0;
 		virtual ~NavModeBase() {};
+		static void* operator new (size_t size);							/**< Take a slot from the nav mode pool */
+		static void operator delete (void *p);
 	protected:
 		NavModeBase (BoatState& state, NavModeEnum last, NavModeEnum thisMode) :
 			StateMachineBase<NavModeEnum, BoatState> (state, last, thisMode) {};	/**< Protected constructor to allow the subclasses to call the superclass constructor. */
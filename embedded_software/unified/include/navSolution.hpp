@@ -0,0 +1,68 @@
+/******************************************************************************
+ * Hackerboat navigation solution module
+ * navSolution.hpp
+ * This module holds the geometry from the current fix to the current target,
+ * worked out once per fix and shared by everything that needs it
+ *
+ * See the Hackerboat documentation for more details
+ * Written by agent, Oct 2026
+ *
+ * Version 0.1: First alpha
+ *
+ ******************************************************************************/
+
+#ifndef NAVSOLUTION_H
+#define NAVSOLUTION_H
+
+#include <inttypes.h>
+#include "location.hpp"
+
+#define NAV_EARTH_RADIUS	(6371008.8)		/**< Mean radius of the earth in meters, for the cross track and along track distances */
+
+/**
+ * @class NavSolution
+ *
+ * @brief Bearing, distance, cross track and along track from a fix to a target, computed only when they change.
+ *
+ * The solution is keyed on the fix sequence number from the GPS input, which changes with every new fix,
+ * and on the fix, target and leg start themselves, since the fix can also be written directly (by the RC
+ * mode and the tests, for example). Within a control cycle every caller after the first gets the stored
+ * answer. Distance and bearing use the approximate course type, so they are exact beyond its range.
+ *
+ * Cross track and along track are measured against the leg from legStart to the target, on a sphere.
+ * Cross track is positive when the boat is to the right of the leg. Along track is the distance made good
+ * from legStart, and is negative before it. Both are NaN if there is no leg start.
+ */
+
+class NavSolution {
+	public:
+		NavSolution () = default;
+		bool update (uint64_t sequence, const Location& fix, const Location& target, const Location& legStart = Location());	/**< Recompute if any of the inputs have changed. Returns true if it did */
+		void invalidate () {_valid = false;};		/**< Force the next update() to recompute */
+		bool isValid () const {return (_valid && _fix.isValid() && _target.isValid());};	/**< True if there is a fix and a target to work from */
+		double bearing () const {return _bearing;};	/**< Initial bearing from the fix to the target, in degrees true */
+		double distance () const {return _distance;};	/**< Distance from the fix to the target, in meters */
+		double crossTrack () const {return _crossTrack;};	/**< Distance off the leg, in meters; positive to the right */
+		double alongTrack () const {return _alongTrack;};	/**< Distance along the leg from its start, in meters */
+		const Location& fix () const {return _fix;};
+		const Location& target () const {return _target;};
+		const Location& legStart () const {return _legStart;};
+		uint64_t sequence () const {return _sequence;};		/**< Fix sequence number the solution was computed for */
+		uint64_t computations () const {return _computations;};	/**< Number of times the solution has been worked out */
+
+	private:
+		static bool same (const Location& a, const Location& b);	/**< Equal, or both invalid */
+
+		bool		_valid = false;
+		uint64_t	_sequence = 0;
+		uint64_t	_computations = 0;
+		Location	_fix;
+		Location	_target;
+		Location	_legStart;
+		double		_bearing = NAN;
+		double		_distance = NAN;
+		double		_crossTrack = NAN;
+		double		_alongTrack = NAN;
+};
+
+#endif /* NAVSOLUTION_H */
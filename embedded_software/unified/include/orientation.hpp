@@ -39,7 +39,11 @@ class Orientation : public HackerboatState {
 		Orientation(double r, double p, double y, bool mag = true) :
 			pitch(p), roll(r), heading(y), magnetic(mag) {};
 		bool parse (Value& input);				/**< Parse an orientation object out of json object */
-		Value pack () const;					/**< Create a json object of this orientation */
+		Value pack () const {return packFields(fields, this);};	/**< Create a json object of this orientation */
+		bool writeJSON (JSONWriter& writer) const {return writeFields(fields, this, writer);};
+		bool readJSON (const char *json) USE_RESULT;	/**< Like parse(), the result is normalized */
+		size_t writeRecord (uint8_t *buf, size_t len) const {return encodeRecord(fields, this, buf, len);};
+		bool readRecord (const uint8_t *buf, size_t len) USE_RESULT;	/**< As with readJSON(), the result is normalized */
 		bool isValid ();						/**< Check if this is a valid orientation object */
 		bool normalize (void);					/**< Normalize the roll/pitch/heading values to +/-180 degrees (or 0-360 degrees in the case of heading) */
 		double headingError (double target);	/**< Get the error angle between this Orientation and target heading, in degrees. */	
@@ -51,6 +55,7 @@ class Orientation : public HackerboatState {
 		double roll 	= NAN;			
 		double pitch 	= NAN;
 		double heading 	= NAN;
+		static const FieldDescriptor fields[];	/**< Members written and read by writeJSON() and readJSON() */
 	
 	protected:
 		bool magnetic = true;
@@ -0,0 +1,138 @@
+/******************************************************************************
+ * Hackerboat object pool module
+ * pool.hpp
+ * This module provides fixed-capacity pools and queues so that the control
+ * loop does not touch the heap once it is running
+ *
+ * See the Hackerboat documentation for more details
+ * Written by agent, Oct 2026
+ *
+ * Version 0.1: First alpha
+ *
+ ******************************************************************************/
+
+#ifndef POOL_H
+#define POOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <inttypes.h>
+
+/**
+ * @brief The size of the largest of the given types, for sizing a pool that holds any of them.
+ */
+
+template <typename T, typename... Ts>
+struct MaxSize {
+	static constexpr size_t value = (sizeof(T) > MaxSize<Ts...>::value) ? sizeof(T) : MaxSize<Ts...>::value;
+};
+
+template <typename T>
+struct MaxSize<T> {
+	static constexpr size_t value = sizeof(T);
+};
+
+/**
+ * @class FixedPool
+ *
+ * @brief Count preallocated slots of Size bytes each.
+ *
+ * allocate() hands out a free slot, or NULL if the request is too big or every slot is taken. The caller
+ * should then fall back to the heap. Slots are claimed and returned with atomic flags, so allocating on one
+ * thread and releasing on another is safe.
+ *
+ * A pool has no constructor. It must have static storage duration so that it is zeroed before any
+ * constructor can run, which means it is ready even while other objects are being statically initialized.
+ */
+
+template <size_t Size, size_t Count>
+class FixedPool {
+	public:
+		static constexpr size_t slotSize = Size;
+		static constexpr size_t slotCount = Count;
+
+		void* allocate (size_t bytes) {					/**< Claim a slot. Returns NULL if bytes is more than Size or the pool is empty */
+			if (bytes <= Size) {
+				for (size_t i = 0; i < Count; i++) {
+					bool expected = false;
+					if (!_used[i].load(std::memory_order_relaxed) &&
+						_used[i].compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+						return _slots[i].data;
+					}
+				}
+			}
+			_misses.fetch_add(1, std::memory_order_relaxed);
+			return NULL;
+		}
+		bool release (void *p) {						/**< Return a slot. Returns false if p did not come from this pool */
+			if (!owns(p)) return false;
+			_used[static_cast<Slot*>(p) - _slots].store(false, std::memory_order_release);
+			return true;
+		}
+		void* allocateOrNew (size_t bytes) {			/**< Claim a slot, falling back to the heap. Suitable for a class operator new */
+			void *p = allocate(bytes);
+			return p ? p : ::operator new(bytes);
+		}
+		void releaseOrDelete (void *p) {				/**< Return a slot, or free p if it came from the heap. Suitable for a class operator delete */
+			if (!release(p)) ::operator delete(p);
+		}
+		bool owns (const void *p) const {
+			return ((p >= static_cast<const void*>(&_slots[0])) && (p < static_cast<const void*>(&_slots[Count])));
+		}
+		size_t inUse () const {							/**< Number of slots currently handed out */
+			size_t cnt = 0;
+			for (size_t i = 0; i < Count; i++) {
+				if (_used[i].load(std::memory_order_relaxed)) cnt++;
+			}
+			return cnt;
+		}
+		uint64_t misses () const {return _misses.load(std::memory_order_relaxed);};	/**< Number of requests that had to go to the heap */
+
+	private:
+		struct alignas(std::max_align_t) Slot {
+			unsigned char data[Size];
+		};
+		Slot					_slots[Count];
+		std::atomic_bool		_used[Count];
+		std::atomic<uint64_t>	_misses;
+};
+
+/**
+ * @class FixedQueue
+ *
+ * @brief First-in, first-out ring buffer of up to Count elements that never allocates.
+ *
+ * It does no locking of its own.
+ */
+
+template <typename T, size_t Count>
+class FixedQueue {
+	public:
+		bool push_back (const T& item) {				/**< Add an item at the back. Returns false if the queue is full */
+			if (_size >= Count) return false;
+			_items[(_head + _size) % Count] = item;
+			_size++;
+			return true;
+		}
+		T& front () {return _items[_head];};
+		void pop_front () {
+			if (!_size) return;
+			_head = (_head + 1) % Count;
+			_size--;
+		}
+		T& operator[] (size_t i) {return _items[(_head + i) % Count];};			/**< The i-th item counting from the front */
+		const T& operator[] (size_t i) const {return _items[(_head + i) % Count];};
+		size_t size () const {return _size;};
+		bool empty () const {return (_size == 0);};
+		bool full () const {return (_size >= Count);};
+		void clear () {_head = 0; _size = 0;};
+		static constexpr size_t capacity () {return Count;};
+
+	private:
+		T		_items[Count];
+		size_t	_head = 0;
+		size_t	_size = 0;
+};
+
+#endif /* POOL_H */
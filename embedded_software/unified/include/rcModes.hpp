@@ -27,6 +27,8 @@ class RCModeBase : public StateMachineBase<RCModeEnum, BoatState> {
 		static RCModeBase* factory(BoatState& state, RCModeEnum mode);			/**< Create a new object of the given mode */
 		virtual RCModeBase* execute () = 0;
 		virtual ~RCModeBase () {};												/**< Explicit destructor to make sure any connections etc get properly closed out */
+		static void* operator new (size_t size);								/**< Take a slot from the RC mode pool */
+		static void operator delete (void *p);
 	protected:	
 		RCModeBase (BoatState& state, RCModeEnum last, RCModeEnum thisMode) :	/**< Hidden constructor to allow subclasses to call the super class's constructor */
 			StateMachineBase<RCModeEnum, BoatState> (state, last, thisMode) {};
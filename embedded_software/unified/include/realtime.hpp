@@ -0,0 +1,65 @@
+/******************************************************************************
+ * Hackerboat real-time module
+ * realtime.hpp
+ * This module sets thread scheduling, affinity, and memory locking, and keeps
+ * wakeup latency histograms for each thread
+ *
+ * See the Hackerboat documentation for more details
+ * Written by agent, Oct 2026
+ *
+ * Version 0.1: First alpha
+ *
+ ******************************************************************************/
+
+#ifndef REALTIME_H
+#define REALTIME_H
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <map>
+#include "hackerboatRoot.hpp"
+#include "enumtable.hpp"
+#include "enumdefs.hpp"
+#include "cycleProfiler.hpp"
+
+using namespace std;
+
+/**
+ * @class RealTime
+ *
+ * @brief Applies the thread schedule from the configuration and tracks how late each thread wakes up.
+ *
+ * Each thread calls configureThread() with its own name once it is running. The name is looked up in
+ * the Thread Schedule to set its policy, priority, and CPU. A thread with no entry is set back to normal
+ * time-sharing, so it does not inherit real-time priority from the thread that created it. Failing
+ * to get the requested schedule (usually because we are not root) is logged and is not fatal.
+ *
+ * Each thread records how far past its intended wakeup time it actually ran in wakeup(name). The
+ * histograms are packed into the stats dump so that we can check that the control path wakes on time
+ * while the telemetry threads are busy.
+ */
+
+class RealTime : public HackerboatState {
+	public:
+		static const EnumNameTable<SchedPolicyEnum> policyNames;
+		static RealTime* get () {return _instance;};
+
+		bool parse (Value& input) {return false;};						/**< Statistics are read-only */
+		Value pack () const;											/**< Pack the wakeup histograms of all threads */
+		bool lockMemory ();												/**< Lock all current and future pages into RAM, if the configuration asks for it */
+		bool configureThread (const string& name);						/**< Name the calling thread and apply its schedule. Returns false if any part failed */
+		LatencyHistogram& wakeup (const string& name);					/**< Wakeup latency histogram for the named thread, created on first use */
+		void reset ();													/**< Discard all wakeup samples */
+
+	private:
+		RealTime () = default;
+		RealTime (RealTime const&) = delete;							/**< Hark, a singleton! */
+		RealTime& operator=(RealTime const&) = delete;					/**< Hark, a singleton! */
+		static RealTime *_instance;
+
+		mutable std::mutex					_lock;						/**< Protects the map, not the histograms */
+		map<string, LatencyHistogram*>		_wakeups;					/**< Never removed, so references stay valid */
+};
+
+#endif /* REALTIME_H */
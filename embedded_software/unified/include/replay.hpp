@@ -0,0 +1,206 @@
+/******************************************************************************
+ * Hackerboat mission replay module
+ * replay.hpp
+ * This module runs recorded missions back through the boat mode state machines
+ * with the boat clock set from the recording, as fast as the CPU allows, and
+ * compares the rudder and throttle commands with the recorded ones
+ *
+ * See the Hackerboat documentation for more details
+ * Written by agent, Oct 2026
+ *
+ * Version 0.1: First alpha
+ *
+ ******************************************************************************/
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <climits>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <inttypes.h>
+#include "hackerboatRoot.hpp"
+#include "enumdefs.hpp"
+#include "gps.hpp"
+#include "boatState.hpp"
+#include "boatModes.hpp"
+#include "flightRecorder.hpp"
+#include "hal/adcInput.hpp"
+#include "hal/gpsdInput.hpp"
+#include "hal/orientationInput.hpp"
+#include "hal/RCinput.hpp"
+#include "hal/throttle.hpp"
+#include "hal/halTestHarness.hpp"
+
+#define REPLAY_NOT_LOGGED		(INT_MIN)	/**< Integer fields of a ReplayFrame that the log didn't have */
+#define REPLAY_MAX_GAP_CYCLES	(600)		/**< Most control cycles run to cover a gap between frames; longer gaps are cut short */
+#define REPLAY_BATTERY_VOLTS	(12.6)		/**< Battery voltage fed to the health monitor when the log doesn't have it */
+#define REPLAY_RUDDER_TOL		(20)		/**< Default difference in rudder command that counts as a mismatch, in microseconds */
+
+/**
+ * @brief Everything one line or frame of a log tells us about one control cycle.
+ *
+ * Inputs are fed to the boat before the cycle runs; rudder and throttle are the commands the boat gave
+ * in that cycle, to be compared with the replayed ones. Anything the log didn't have is left at
+ * REPLAY_NOT_LOGGED, NAN, or NONE, and the driver holds or infers it.
+ */
+
+struct ReplayFrame {
+	sysclock		time;									/**< When the cycle ran */
+	GPSFix			fix;									/**< GPS fix, if fixLogged */
+	bool			fixLogged = false;
+	double			heading = NAN;							/**< Magnetic heading, degrees */
+	int				rcThrottle = REPLAY_NOT_LOGGED;			/**< Throttle position from the RC input */
+	double			rcRudder = NAN;							/**< Rudder position from the RC input */
+	double			rcCourse = NAN;							/**< Course command from the RC input, degrees */
+	RCModeEnum		rcMode = RCModeEnum::NONE;				/**< Position of the RC mode switch, or FAILSAFE */
+	BoatModeEnum	boatMode = BoatModeEnum::NONE;			/**< Logged boat mode */
+	NavModeEnum		navMode = NavModeEnum::NONE;			/**< Logged navigation mode */
+	AutoModeEnum	autoMode = AutoModeEnum::NONE;			/**< Logged autonomous mode */
+	int				armButton = REPLAY_NOT_LOGGED;			/**< Arm button pin; 0 is pressed */
+	int				stopButton = REPLAY_NOT_LOGGED;			/**< Stop button pin; 0 is pressed */
+	int				motorCurrentRaw = REPLAY_NOT_LOGGED;	/**< Raw ADC value of the motor current */
+	int				batteryRaw = REPLAY_NOT_LOGGED;			/**< Raw ADC value of the battery monitor */
+	int				rudder = REPLAY_NOT_LOGGED;				/**< Logged rudder command, microseconds */
+	int				throttle = REPLAY_NOT_LOGGED;			/**< Logged throttle position */
+};
+
+/**
+ * @class ReplaySource
+ *
+ * @brief A recorded mission, read one frame at a time in the order it was logged.
+ */
+
+class ReplaySource {
+	public:
+		virtual bool next (ReplayFrame& frame) = 0;			/**< Read the next frame. Returns false at the end of the log */
+		virtual ~ReplaySource () {};
+};
+
+/**
+ * @class CSVLogReplay
+ *
+ * @brief Reads the CSV lines out of a master control log.
+ *
+ * Lines are found by the ",CSV," the master puts in front of them, so whole log files can be read as they
+ * are. Columns are found by name from the last header line, and both the old (April 2017) and the
+ * current column names are understood. Short lines and empty fields leave the rest of the frame as
+ * not logged.
+ */
+
+class CSVLogReplay : public ReplaySource {
+	public:
+		bool open (const std::string& path);
+		void close () {_in.close();};
+		bool next (ReplayFrame& frame);
+		bool line (const char *text, size_t len, ReplayFrame& frame);	/**< Read one log line. Returns true if it was a data line; header lines only set the columns */
+		size_t columns () const {return _columns.size();};				/**< Columns in the last header line */
+		size_t skipped () const {return _skipped;};						/**< Data lines that were unreadable or came before any header */
+
+		enum class Column {
+			IGNORED, TIME, LAT, LON, TRACK, SPEED, FIX_VALID, FIX_TYPE, STOP_BUTTON, ARM_BUTTON,
+			THROTTLE, RUDDER, HEADING, RC_THROTTLE, RC_COURSE, RC_FAILSAFE, RC_MODE,
+			BOAT_MODE, NAV_MODE, AUTO_MODE, MOTOR_CURRENT, BATTERY
+		};
+
+	private:
+		void header (const char *p, const char *end);
+		bool field (Column c, const char *p, size_t len, ReplayFrame& frame);
+
+		std::ifstream		_in;
+		std::string			_line;
+		std::vector<Column>	_columns;
+		size_t				_skipped = 0;
+		bool				_tagged = false;				/**< Seen a line marked as CSV, so this is a log and not a bare CSV file */
+};
+
+/**
+ * @class RecorderReplay
+ *
+ * @brief Reads the frames of a flight recorder file, oldest first.
+ *
+ * Each frame carries the CycleSample and BoatState records the master wrote, so the RC inputs, the raw
+ * heading and ADC readings, and the logged modes and commands are all there.
+ */
+
+class RecorderReplay : public ReplaySource {
+	public:
+		~RecorderReplay () {delete _state;};
+		bool open (const std::string& path);
+		void close () {_reader.close();};
+		bool next (ReplayFrame& frame);
+		size_t skipped () const {return _skipped;};				/**< Frames that were overwritten, corrupt, or missing a record */
+
+	private:
+		FlightRecorderReader	_reader;
+		uint64_t				_seq = 0;
+		size_t					_skipped = 0;
+		uint8_t					_buf[RECORDER_FRAME_SIZE];
+		CycleSample				_sample;
+		BoatState				*_state = NULL;					/**< Scratch state to decode into; made on first use */
+};
+
+/**
+ * @brief What a replay found.
+ */
+
+struct ReplayStats {
+	uint64_t		frames = 0;						/**< Frames replayed */
+	uint64_t		cycles = 0;						/**< Control cycles run */
+	uint64_t		compared = 0;					/**< Frames that had logged commands to compare */
+	uint64_t		mismatches = 0;					/**< Frames where either command didn't match */
+	uint64_t		rudderMismatches = 0;
+	uint64_t		throttleMismatches = 0;
+	int				maxRudderError = 0;				/**< Largest rudder difference seen, microseconds */
+	sysclock		firstMismatch;					/**< Time of the first mismatched frame */
+};
+
+/**
+ * @class ReplayDriver
+ *
+ * @brief Runs a BoatState and its boat mode through a recorded mission.
+ *
+ * All the devices are cut off from the hardware with HalTestHarness::simulate(), and the boat clock is
+ * set from the log, so a replay gives the same commands every time it is run, wherever it is run. Each
+ * frame is fed in and then enough control cycles are run to cover the time since the last one. Inputs the
+ * log doesn't have are held from the last frame that did; the arm and stop buttons and the RC switches
+ * are worked out from the logged modes when the log doesn't have them.
+ */
+
+class ReplayDriver {
+	public:
+		ReplayDriver ();
+		~ReplayDriver ();
+		void begin (BoatModeEnum start = BoatModeEnum::START);	/**< Start the boat over in the given mode */
+		bool step (const ReplayFrame& frame);				/**< Feed in a frame and run the cycles up to it. Returns false if the commands don't match the log */
+		bool run (ReplaySource& source);					/**< Replay the whole source. Returns false if any frame didn't match */
+		void setRudderTolerance (int us) {_rudderTol = us;};
+		int rudder () {return _state.rudder->readMicroseconds();};	/**< Replayed rudder command, microseconds */
+		int throttle () {return _throttle.getThrottle();};	/**< Replayed throttle position */
+		const ReplayStats& stats () const {return _stats;};
+		BoatState& state () {return _state;};
+
+	private:
+		void feed (const ReplayFrame& frame);				/**< Publish the frame's inputs to the devices */
+		void buttons (const ReplayFrame& frame);
+		void cycle ();										/**< One pass of the master's control loop */
+		static uint16_t channel (double value, double outMin, double outMax);	/**< Inverse of the RC input mapping */
+
+		HalTestHarness		_harness;
+		RCInput				_rc;
+		ADCInput			_adc;
+		GPSdInput			_gps;
+		OrientationInput	_orient;
+		Throttle			_throttle;
+		HealthMonitor		_health { &_adc };
+		BoatState			_state;
+		BoatModeBase		*_mode = NULL;
+		sysclock			_now;
+		bool				_started = false;
+		int					_rudderTol = REPLAY_RUDDER_TOL;
+		ReplayStats			_stats;
+};
+
+#endif /* REPLAY_H */
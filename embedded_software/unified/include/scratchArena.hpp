@@ -0,0 +1,62 @@
+/******************************************************************************
+ * Hackerboat scratch arena module
+ * scratchArena.hpp
+ * This module provides a fixed-capacity bump allocator for short-lived data
+ * that is thrown away at the end of each control cycle
+ *
+ * See the Hackerboat documentation for more details
+ * Written by agent, Oct 2026
+ *
+ * Version 0.1: First alpha
+ *
+ ******************************************************************************/
+
+#ifndef SCRATCHARENA_H
+#define SCRATCHARENA_H
+
+#include <cstddef>
+#include <atomic>
+#include <inttypes.h>
+
+#define CYCLE_ARENA_SIZE		(16384)			/**< Bytes of scratch space available to each control cycle */
+
+/**
+ * @class ScratchArena
+ *
+ * @brief Fixed block of memory handed out by bumping a pointer, and reclaimed all at once by reset().
+ *
+ * The block is allocated and touched once at construction. After that, allocate() and print() never call
+ * the heap. They return NULL when the arena is full, and the overflow is counted. Nothing is destroyed on
+ * reset(), so only trivially destructible data belongs here.
+ *
+ * An arena is not thread safe. The cycle() arena belongs to the control thread, which resets it at the
+ * top of every cycle; anything allocated from it is valid until then.
+ */
+
+class ScratchArena {
+	public:
+		static ScratchArena* cycle () {return _cycle;};				/**< The control thread's per-cycle arena */
+
+		ScratchArena (size_t capacity);
+		~ScratchArena ();
+		void* allocate (size_t bytes, size_t align = alignof(std::max_align_t));	/**< Returns NULL if there is not enough room */
+		char* print (const char *format, ...) __attribute__((format(printf, 2, 3)));	/**< printf() into the arena. Returns NULL if the result does not fit */
+		void reset ();												/**< Reclaim everything allocated since the last reset */
+		size_t used () const {return _used;};
+		size_t capacity () const {return _capacity;};
+		size_t highWater () const {return _highWater.load(std::memory_order_relaxed);};	/**< Most bytes in use at once since startup */
+		uint64_t overflows () const {return _overflows.load(std::memory_order_relaxed);};	/**< Number of requests that did not fit */
+
+	private:
+		ScratchArena (ScratchArena const&) = delete;
+		ScratchArena& operator=(ScratchArena const&) = delete;
+		static ScratchArena *_cycle;
+
+		char					*_block;
+		size_t					_capacity;
+		size_t					_used = 0;
+		std::atomic<size_t>		_highWater { 0 };					/**< Atomic so that the stats can be read from other threads */
+		std::atomic<uint64_t>	_overflows { 0 };
+};
+
+#endif /* SCRATCHARENA_H */
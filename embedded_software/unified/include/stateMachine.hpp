@@ -19,6 +19,9 @@
 #include "hal/config.h"
 #include "enumdefs.hpp"
 #include "hackerboatRoot.hpp"
+#include "boatClock.hpp"
+
+#define MODE_POOL_SIZE		(8)		/**< Mode objects of each kind that can exist at once without touching the heap */
 
 /**
  * @brief A template for a state machine with the given mode enum T and state vector reference U&.
@@ -28,7 +31,7 @@ template <typename T, typename U> class StateMachineBase {
 	public:
 		StateMachineBase (U& state, T last, T thisMode) :	/**< Create a state object with the given state vector and last mode. */
 			_state(state), _lastMode(last), _thisMode(thisMode),
-			start(std::chrono::system_clock::now()) {};
+			start(BoatClock::now()) {};
 		virtual StateMachineBase* execute() = 0;			/**< Execute one step of the state machine */
 		U& getState() {return _state;}						/**< Get the state vector */
 		T getMode() {return _thisMode;}						/**< Get the current mode */
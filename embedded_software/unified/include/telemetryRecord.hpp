@@ -0,0 +1,104 @@
+/******************************************************************************
+ * Hackerboat telemetry record module
+ * telemetryRecord.hpp
+ * This module packs HackerboatState objects into compact binary records,
+ * using the same field tables as the json writer and reader
+ *
+ * See the Hackerboat documentation for more details
+ * Written by agent, Oct 2026
+ *
+ * Version 0.1: First alpha
+ *
+ ******************************************************************************/
+
+#ifndef TELEMETRYRECORD_H
+#define TELEMETRYRECORD_H
+
+#include <cstddef>
+#include <inttypes.h>
+#include "fields.hpp"
+
+#define RECORD_MAGIC		(0x48)			/**< First byte of every record, 'H' */
+#define RECORD_VERSION		(2)				/**< Encoding rules in use; bumped when they change, not when a table does */
+#define RECORD_MAX_SIZE		(1024)			/**< Buffer size that holds a record of any type we have, with room for long strings */
+
+/**
+ * @brief Header at the front of every record. All multi-byte values in a record are little endian.
+ *
+ * Record layout:
+ *   header
+ *   presence bitmap, one bit per field in table order, least significant bit first
+ *   each present field in table order:
+ *     DOUBLE		8 byte IEEE 754
+ *     INT			the member's own size, two's complement
+ *     TIME			8 bytes, milliseconds since the epoch
+ *     ENUM			the field's width (2 bytes), two's complement
+ *     STRING		2 byte length, then the bytes without a terminator
+ *     BOOL			nothing; the presence bit is the value
+ *     OBJECT		the nested object's bitmap and fields, laid out the same way
+ *
+ * A field is left out when it holds its default: NaN doubles, zero integers and times, empty strings,
+ * false, enum values with no name, and objects whose fields are all left out. Decoding a record puts those
+ * defaults back, except for enums, which are left alone. A named enum value too big for its width fails
+ * the encode rather than being dropped.
+ *
+ * Records are laid out from the same field tables as the json, rather than as a packed struct per type, so
+ * there is no second definition of each type to keep in step, and most of a sparse state (an AISShip
+ * without its static data, say) costs one bit. The price is that fields aren't at fixed offsets; read
+ * records with decodeRecord() or recordToJSON(), never by casting.
+ */
+
+struct __attribute__((packed)) RecordHeader {
+	uint8_t		magic;						/**< RECORD_MAGIC */
+	uint8_t		version;					/**< RECORD_VERSION */
+	uint16_t	length;						/**< Bytes following the header */
+	uint32_t	schema;						/**< recordSchema() of the table the record was written from */
+};
+
+static_assert(sizeof(RecordHeader) == 8, "RecordHeader must be packed");
+
+/**
+ * @brief Identifier for a field table, taken from its keys, kinds and widths. Any change to a table that
+ * would change the record layout changes the identifier.
+ */
+
+uint32_t recordSchema (const FieldDescriptor *fields);
+
+/**
+ * @brief The table for a schema identifier, or NULL if it isn't one of ours.
+ */
+
+const FieldDescriptor* recordFields (uint32_t schema);
+
+/**
+ * @brief Write the object described by fields into buf as a record.
+ *
+ * @return Bytes written, or 0 if buf is too small or a string is too long to encode. Does not allocate.
+ */
+
+size_t encodeRecord (const FieldDescriptor *fields, const void *obj, uint8_t *buf, size_t len);
+
+/**
+ * @brief Populate the object described by fields from a record.
+ *
+ * Returns false if the record is truncated or was written from a different table. Fields decoded before
+ * the problem was found are left in place.
+ */
+
+bool decodeRecord (const FieldDescriptor *fields, void *obj, const uint8_t *buf, size_t len);
+
+/**
+ * @brief Size of the record at the front of buf, or 0 if buf doesn't start with a whole record header.
+ */
+
+size_t recordSize (const uint8_t *buf, size_t len);
+
+/**
+ * @brief Write a record of any known type as json, without the object it came from.
+ *
+ * The output is the same text that the object's writeJSON() would have produced.
+ */
+
+bool recordToJSON (const uint8_t *buf, size_t len, JSONWriter& writer);
+
+#endif /* TELEMETRYRECORD_H */
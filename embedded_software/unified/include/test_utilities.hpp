@@ -7,6 +7,10 @@
 #include "rapidjson/stringbuffer.h"
 #include "rapidjson/writer.h"
 #include <cmath>
+#include <string>
+#include <inttypes.h>
+#include "hackerboatRoot.hpp"
+#include "gps.hpp"
 
 #ifndef TEST_UTILITIES
 #define TEST_UTILITIES
@@ -29,4 +33,27 @@ bool inline toleranceEquals (double a, double b, double tolerance) {	/**< Compar
 	}
 }
 
+std::string toJSON (const HackerboatState& state);				/**< Write out the state's stored fields as JSON, expecting that to succeed */
+std::string toJSON (const rapidjson::Value& v);					/**< Write out a packed value as JSON */
+GPSFix testFix ();												/**< A valid 3D fix, recorded now */
+
+/**
+ * @brief Counts heap allocations made by the calling thread between start() and stop().
+ *
+ * The unit tests replace the global operator new to do the counting, so this only works in the test binary.
+ */
+
+class AllocationCounter {
+	public:
+		static void start ();										/**< Zero the count and start counting on this thread */
+		static uint64_t stop ();									/**< Stop counting on this thread and return the count */
+};
+
+#define EXPECT_NO_ALLOCATIONS(statement) do { \
+	AllocationCounter::start(); \
+	statement; \
+	uint64_t allocations = AllocationCounter::stop(); \
+	EXPECT_EQ(allocations, 0u) << #statement << " allocated from the heap"; \
+} while (0)
+
 #endif /* TEST_UTILITIES */
\ No newline at end of file
@@ -44,6 +44,7 @@ class Waypoints {
 		bool increment ();							/**< Increment the current waypoint. Behavior is affected by the action variable -- this returns false if there is no new waypoint and the action is anything other than REPEAT. */
 		bool decrement ();							/**< Decrement the current waypoint. Returns false if already on the first waypoint, true otherwise. */
 		int count () {return waypoints.size();};	/**< Returns the number of waypoints */
+		size_t targets (const Location& from, double *dist, double *azi = NULL) const {return from.targets(waypoints, dist, azi);};	/**< Distance and bearing from the given location to every waypoint, in order, into arrays of count() entries. Returns the number computed exactly */
 		int current () {return _c;};				/**< Returns the current waypoint number */
 		WaypointActionEnum getAction () {return action;};			/**< Returns the action to take at the end of the waypoint list */
 		void setAction (WaypointActionEnum act) {action = act;};	/**< Set the action to take at the end of the waypoint list. This effects the response to increment() and is used by the appropriate mode to decide the next action. */
@@ -43,12 +43,13 @@ double RCInput::map(double x, double in_min, double in_max, double out_min, doub
 RCInput::RCInput (std::string devpath) : 
 	_path(devpath) {
 		LOG(INFO) << "Creating new RCInput object";
-		rawChannels.assign(Conf::get()->RCchannelCount(), 0);
+		_working.channels.assign(Conf::get()->RCchannelCount(), 0);
+		_frame.publish(_working);
 		period = Conf::get()->rcReadPeriod();
 	}
 
 int RCInput::getThrottle () {
-	int throttle = round(map(static_cast<double>(rawChannels[Conf::get()->RCchannelMap().at("throttle")]), 
+	int throttle = round(map(static_cast<double>(getChannel(Conf::get()->RCchannelMap().at("throttle"))), 
 												Conf::get()->RClimits().at("min"), 
 												Conf::get()->RClimits().at("max"), 
 												Conf::get()->throttleMin(), 
@@ -58,7 +59,7 @@ int RCInput::getThrottle () {
 }
 
 double RCInput::getRudder () {
-	double rudder = map(static_cast<double>(rawChannels[Conf::get()->RCchannelMap().at("rudder")]), 
+	double rudder = map(static_cast<double>(getChannel(Conf::get()->RCchannelMap().at("rudder"))), 
 											Conf::get()->RClimits().at("min"), 
 											Conf::get()->RClimits().at("max"), 
 											Conf::get()->rudderMin(), 
@@ -68,7 +69,7 @@ double RCInput::getRudder () {
 }
 
 double RCInput::getCourse () {
-	double course = map(static_cast<double>(rawChannels[Conf::get()->RCchannelMap().at("courseSelect")]), 
+	double course = map(static_cast<double>(getChannel(Conf::get()->RCchannelMap().at("courseSelect"))), 
 											Conf::get()->RClimits().at("min"), 
 											Conf::get()->RClimits().at("max"), 
 											Conf::get()->courseMin(), 
@@ -78,7 +79,15 @@ double RCInput::getCourse () {
 }
 
 int RCInput::getChannel (int channel) {
-	return rawChannels[channel];
+	int value = 0;
+	_frame.visit([&value, channel] (const RCFrame& frame) {value = frame.channels[channel];});
+	return value;
+}
+
+bool RCInput::isFailSafe () {
+	bool value = false;
+	_frame.visit([&value] (const RCFrame& frame) {value = frame.failsafe;});
+	return value;
 }
 
 RCModeEnum RCInput::getMode() {
@@ -138,76 +147,77 @@ bool RCInput::begin() {
 	}
 	
 	// fire off the thread
-	this->myThread = new std::thread (InputThread::InputThreadRunner(this));
-	myThread->detach();
+	this->launch();
 	LOG(INFO) << "Successfully configured RC input";
 	return true;
 }
 
 bool RCInput::execute() {
-	//if (!lock && (!lock.try_lock_for(Conf::get()->RC_LOCK_TIMEOUT))) {
-	//	LOG(ERROR) << "Failed to lock data for RC Input";
-	//	return false;
-	//}
 	if (devFD < 0) {
 		LOG(ERROR) << "RC Serial port failed; killing thread";
 		this->kill();
-		//lock.unlock();
 		return false;
 	}
-	char buf[buflen];
-	ssize_t bytesRead = read(devFD, buf, buflen);
-	if (bytesRead > 0) {
-		for (int i = 0; i < bytesRead; i++) inbuf.push_back(buf[i]); // we have to do this in order to copy /0 correctly
+	char buf[256];
+	ssize_t bytesRead;
+	bool result = true;
+	bool gotFrame = false;
+	// drain the port -- the port is non-blocking, so this stops when there is nothing left
+	while ((bytesRead = read(devFD, buf, sizeof(buf))) > 0) {
+		inbuf.append(buf, bytesRead);		// append() rather than operator+= in order to copy /0 correctly
 		LOG(DEBUG) << "Read " << to_string(bytesRead) << " bytes into inbuf: [" << inbuf << "]";
-		memset(buf, 0, buflen);
 	}
-	if (inbuf.size() >= buflen) {
+	// decode every complete frame; only the newest one gets published
+	while (inbuf.size() >= buflen) {
 		if ((inbuf[0] != startByte) || (inbuf[(buflen - 1)] != endByte)) {
 			LOG(DEBUG) << "Received invalid frame: [" << inbuf << "]";
-			inbuf.clear();
+			inbuf.erase(0, inbuf.find(static_cast<char>(startByte), 1));	// resynchronize on the next start byte
 			_errorFrames++;
 			_valid = false;
-			return false;
+			result = false;
 		} else {
 			_goodFrames++;
 			_valid = true;
 			setLastInputTime();
-
-			rawChannels[0]  = ((inbuf[1]    |inbuf[2]<<8)					& 0x07FF);
-			rawChannels[1]  = ((inbuf[2]>>3 |inbuf[3]<<5)					& 0x07FF);
-			rawChannels[2]  = ((inbuf[3]>>6 |inbuf[4]<<2 |inbuf[5]<<10)		& 0x07FF);
-			rawChannels[3]  = ((inbuf[5]>>1 |inbuf[6]<<7)					& 0x07FF);
-			rawChannels[4]  = ((inbuf[6]>>4 |inbuf[7]<<4)					& 0x07FF);
-			rawChannels[5]  = ((inbuf[7]>>7 |inbuf[8]<<1 |inbuf[9]<<9)		& 0x07FF);
-			rawChannels[6]  = ((inbuf[9]>>2 |inbuf[10]<<6)					& 0x07FF);
-			rawChannels[7]  = ((inbuf[10]>>5|inbuf[11]<<3)                & 0x07FF);
-			rawChannels[8]  = ((inbuf[12]   |inbuf[13]<<8)                & 0x07FF);
-			rawChannels[9]  = ((inbuf[13]>>3|inbuf[14]<<5)                & 0x07FF);
-			rawChannels[10] = ((inbuf[14]>>6|inbuf[15]<<2|inbuf[16]<<10) & 0x07FF);
-			rawChannels[11] = ((inbuf[16]>>1|inbuf[17]<<7)                & 0x07FF);
-			rawChannels[12] = ((inbuf[17]>>4|inbuf[18]<<4)                & 0x07FF);
-			rawChannels[13] = ((inbuf[18]>>7|inbuf[19]<<1|inbuf[20]<<9)  & 0x07FF);
-			rawChannels[14] = ((inbuf[20]>>2|inbuf[21]<<6)                & 0x07FF);
-			rawChannels[15] = ((inbuf[21]>>5|inbuf[22]<<3)                & 0x07FF);
-
-			((inbuf[23])      & 0x0001) ? rawChannels[16] = 2047: rawChannels[16] = 0;
-			((inbuf[23] >> 1) & 0x0001) ? rawChannels[17] = 2047: rawChannels[17] = 0;
-
-			if ((inbuf[23] >> 3) & 0x0001) {
-				failsafe = true;
-			} else {
-				failsafe = false;
-			}
-			inbuf.clear();			
+			decodeFrame(reinterpret_cast<const uint8_t*>(inbuf.data()));
+			inbuf.erase(0, buflen);
+			gotFrame = true;
+			result = true;
 		}
 	}
-	//lock.unlock();
-	return true;
+	if (gotFrame) _frame.publish(_working);
+	return result;
+}
+
+void RCInput::decodeFrame (const uint8_t *frame) {
+	_working.channels[0]  = ((frame[1]    |frame[2]<<8)					& 0x07FF);
+	_working.channels[1]  = ((frame[2]>>3 |frame[3]<<5)					& 0x07FF);
+	_working.channels[2]  = ((frame[3]>>6 |frame[4]<<2 |frame[5]<<10)		& 0x07FF);
+	_working.channels[3]  = ((frame[5]>>1 |frame[6]<<7)					& 0x07FF);
+	_working.channels[4]  = ((frame[6]>>4 |frame[7]<<4)					& 0x07FF);
+	_working.channels[5]  = ((frame[7]>>7 |frame[8]<<1 |frame[9]<<9)		& 0x07FF);
+	_working.channels[6]  = ((frame[9]>>2 |frame[10]<<6)					& 0x07FF);
+	_working.channels[7]  = ((frame[10]>>5|frame[11]<<3)                & 0x07FF);
+	_working.channels[8]  = ((frame[12]   |frame[13]<<8)                & 0x07FF);
+	_working.channels[9]  = ((frame[13]>>3|frame[14]<<5)                & 0x07FF);
+	_working.channels[10] = ((frame[14]>>6|frame[15]<<2|frame[16]<<10) & 0x07FF);
+	_working.channels[11] = ((frame[16]>>1|frame[17]<<7)                & 0x07FF);
+	_working.channels[12] = ((frame[17]>>4|frame[18]<<4)                & 0x07FF);
+	_working.channels[13] = ((frame[18]>>7|frame[19]<<1|frame[20]<<9)  & 0x07FF);
+	_working.channels[14] = ((frame[20]>>2|frame[21]<<6)                & 0x07FF);
+	_working.channels[15] = ((frame[21]>>5|frame[22]<<3)                & 0x07FF);
+
+	((frame[23])      & 0x0001) ? _working.channels[16] = 2047: _working.channels[16] = 0;
+	((frame[23] >> 1) & 0x0001) ? _working.channels[17] = 2047: _working.channels[17] = 0;
+
+	if ((frame[23] >> 3) & 0x0001) {
+		_working.failsafe = true;
+	} else {
+		_working.failsafe = false;
+	}
 }
 
 RCInput::~RCInput() {
 	this->kill();
 	close(devFD);
-	//if (myThread) delete myThread;
 }
@@ -54,6 +54,12 @@ bool ADCInput::init() {
 	lower.setReference(Conf::get()->adcExternRefVolt());
 	LOG(DEBUG) << "Result of initializing lower ADC bank; " << result;
 	
+	setDefaults();
+	inputsValid = result;
+	return inputsValid;
+}
+
+void ADCInput::setDefaults () {
 	// This populates the various maps
 	_raw[Conf::get()->batmonName()] = -1;
 	_offsets[Conf::get()->batmonName()] = -805;
@@ -69,14 +75,12 @@ bool ADCInput::init() {
 		_offsets[lowerChannels[j]] = 0.0;
 		_scales[lowerChannels[j]] = 0.001221001;	// default is to scale to raw voltage (0-5V)
 	}
-	inputsValid = result;
-	return inputsValid;
+	_values.publish(_raw);
 }
 
 bool ADCInput::begin() {
 	if (this->init()) {
-		this->myThread = new std::thread (InputThread::InputThreadRunner(this));
-		myThread->detach();
+		this->launch();
 		LOG(DEBUG) << "ADC subsystem started";
 		return true;
 	}
@@ -85,8 +89,6 @@ bool ADCInput::begin() {
 }
 
 bool ADCInput::execute() {
-	// grab the lock
-	//if (!lock && (!lock.try_lock_for(IMU_LOCK_TIMEOUT))) return false;
 	bool result = true;
 	
 	// set the time
@@ -112,15 +114,39 @@ bool ADCInput::execute() {
 		_raw[lowerChannels[j]] = lowerInputs[j];
 	}
 	
-	//lock.unlock();
+	_values.publish(_raw);
 	return result;
 }
 
 std::map<std::string, double> ADCInput::getScaledValues (void) {
 	std::map<std::string, double> out;
-	for (auto const &r : _raw) {
-		out[r.first] = (r.second + _offsets[r.first]) * _scales[r.first];
-	}
+	getScaledValues(out);
+	return out;
+}
+
+void ADCInput::getScaledValues (std::map<std::string, double>& out) {
+	_values.visit([this, &out] (const std::map<std::string, int>& raw) {
+		for (auto const &r : raw) {
+			out[r.first] = (r.second + _offsets[r.first]) * _scales[r.first];
+		}
+	});
+}
+
+int ADCInput::getRawValue (const std::string& name) {
+	int out = -1;
+	_values.visit([&name, &out] (const std::map<std::string, int>& raw) {
+		auto r = raw.find(name);
+		if (r != raw.end()) out = r->second;
+	});
+	return out;
+}
+
+double ADCInput::getScaledValue (const std::string& name) {
+	double out = NAN;
+	_values.visit([this, &name, &out] (const std::map<std::string, int>& raw) {
+		auto r = raw.find(name);
+		if (r != raw.end()) out = (r->second + _offsets[name]) * _scales[name];
+	});
 	return out;
 }
 
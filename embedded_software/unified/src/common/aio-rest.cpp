@@ -27,6 +27,7 @@
 #include "easylogging++.h"
 #include "rapidjson/rapidjson.h"
 #include "configuration.hpp"
+#include "cycleProfiler.hpp"
 extern "C" {
 	#include <curl/curl.h>
 }
@@ -105,6 +106,7 @@ int AIO_Rest::pollSubs() {
 // thread functions
 
 bool AIO_Rest::begin() {
+	// this always gets a thread of its own, even in reactor mode, because the curl calls block
 	this->myThread = new std::thread (InputThread::InputThreadRunner(this));
 	myThread->detach();
 	lastsub = chrono::system_clock::now();
@@ -285,7 +287,7 @@ int pub_Mode::pub() {
 int pub_MagHeading::pub() {
 	if (!_me->orient) return -1;
 	string payload = "{\"value\":";
-	payload += to_string(_me->orient->getOrientation()->heading) + ",";
+	payload += to_string(_me->orient->getOrientation().heading) + ",";
 	payload += "\"lat\":" + to_string(_me->lastFix.fix.lat) + ",";
 	payload += "\"lon\":" + to_string(_me->lastFix.fix.lon) + ",";
 	payload += "\"ele\":0.0}";
@@ -369,6 +371,23 @@ int pub_Waypoint::pub() {
 	return this->_rest->transmit(this->_key, payload);
 }
 
+int pub_Stats::pub() {
+	string stats;
+	if (!CycleProfiler::get()->takeReply(stats)) return CURLE_OK;		// nothing has been requested
+	Document d;
+	d.SetObject();
+	Value v;
+	v.SetString(stats.c_str(), stats.size(), d.GetAllocator());		// the dump is JSON, so let rapidjson escape it
+	d.AddMember("value", v, d.GetAllocator());
+	d.AddMember("lat", _me->lastFix.fix.lat, d.GetAllocator());
+	d.AddMember("lon", _me->lastFix.fix.lon, d.GetAllocator());
+	d.AddMember("ele", 0.0, d.GetAllocator());
+	StringBuffer buf;
+	Writer<StringBuffer> writer(buf);
+	d.Accept(writer);
+	return this->_rest->transmit(this->_key, buf.GetString());
+}
+
 // Subscriber functors
 
 int sub_Command::poll() {
@@ -20,6 +20,7 @@
 #include <stdexcept>
 #include "hackerboatRoot.hpp"
 #include "location.hpp"
+#include "boatClock.hpp"
 #include "hal/config.h"
 #include "hackerboatRoot.hpp"
 #include "enumtable.hpp"
@@ -38,93 +39,59 @@ const std::string AISBase::msgClass = "AIS";
 
 AISShip::AISShip (Value& packet) {
 	VLOG(2) << "Creating new AIS object";
-	recordTime = std::chrono::system_clock::now();
+	recordTime = BoatClock::now();
 	parseGpsdPacket(packet);
 }			
 
-bool AISShip::parseGpsdPacket (Value& input) {
-	bool result = true;
-	root.CopyFrom(input, root.GetAllocator());
-	
-	result = coreParse(input);
-	this->lastTimeStamp = std::chrono::system_clock::now();
-	if (input.HasMember("lat") && input["lat"].IsDouble() &&
-		input.HasMember("lon") && input["lon"].IsDouble()) {
-			this->fix.lat = input["lat"].GetDouble();
-			this->fix.lon = input["lon"].GetDouble();
-	} else result = false;
+// gpsd sends the position at the top level; the rest matches our own table
+const FieldDescriptor AISShip::gpsdFields[] = {
+	FIELD(IntField, "mmsi", AISShip, mmsi),
+	FIELD(StringField, "device", AISShip, device),
+	NESTED_FIELD(DoubleField, "lat", AISShip, fix, Location, lat),
+	NESTED_FIELD(DoubleField, "lon", AISShip, fix, Location, lon),
+	FIELD(EnumIntField, "status", AISShip, status),
+	FIELD(DoubleField, "turn", AISShip, turn),
+	FIELD(DoubleField, "speed", AISShip, speed),
+	FIELD(DoubleField, "course", AISShip, course),
+	FIELD(DoubleField, "heading", AISShip, heading),
+	FIELD(IntField, "imo", AISShip, imo),
+	FIELD(StringField, "callsign", AISShip, callsign),
+	FIELD(StringField, "shipname", AISShip, shipname),
+	FIELD(EnumIntField, "shiptype", AISShip, shiptype),
+	FIELD(IntField, "to_bow", AISShip, to_bow),
+	FIELD(IntField, "to_stern", AISShip, to_stern),
+	FIELD(IntField, "to_port", AISShip, to_port),
+	FIELD(IntField, "to_starboard", AISShip, to_starboard),
+	FIELD(EnumIntField, "epfd", AISShip, epfd),
+	FIELD_END
+};
+
+template <typename Read>
+bool AISShip::gpsdPacket (Read read) {
+	// the position is required, so it starts out missing and is checked for afterwards
+	Location lastFix = this->fix;
+	this->fix = Location(NAN, NAN);
+	bool result = read();
+	this->lastTimeStamp = BoatClock::now();
+	result &= std::isfinite(this->fix.lat) && std::isfinite(this->fix.lon);
+	if (!result) this->fix = lastFix;
 	
-	LOG_IF((!result), ERROR) << "Parsing AIS input from gpsd failed: " << input;
+	LOG_IF((!result), ERROR) << "Parsing AIS input from gpsd failed";
 	
 	if (result) return this->isValid();
 	return result;
 }
 
-bool AISShip::parse (Value& input) {
-	bool result = true;
-	std::string myTime, lastTime;
-	
-	result &= this->coreParse(input);
-	if (input.HasMember("fix")) {
-		result &= this->fix.parse(input["fix"]);
-	} else result = false;
-	if (input.HasMember("recordTime") && input["recordTime"].IsString()) {
-		result &= parseTime(input["recordTime"].GetString(), this->recordTime);
-	} else result = false;
-	if (input.HasMember("lastTimeStamp") && input["lastTimeStamp"].IsString()) {
-		result &= parseTime(input["lastTimeStamp"].GetString(), this->lastTimeStamp);
-	} else result = false;
-	
-	LOG_IF((!result), ERROR) << "Parsing AIS input failed: " << input;
-	if (result) return this->isValid();
-	return result;
+bool AISShip::parseGpsdPacket (Value& input) {
+	return gpsdPacket([this, &input] () {return parseFields(gpsdFields, this, input);});
 }
 
-bool AISShip::coreParse (Value& input) {
-	bool result = true;
-	int tmp;
-	
-	result &= GetVar("mmsi", 		this->mmsi, 	input);
-	result &= GetVar("course", 		this->course, 	input);
-	result &= GetVar("heading", 	this->heading, 	input);
-	result &= GetVar("turn", 		this->turn, 	input);
-	result &= GetVar("speed", 		this->speed, 	input);
-	result &= GetVar("device", 		this->device, 	input);
-	result &= GetVar("imo", 		this->imo, 		input);
-	result &= GetVar("callsign", 	this->callsign, input);
-	result &= GetVar("shipname", 	this->shipname, input);
-	result &= GetVar("to_bow", 		this->to_bow, 	input);
-	result &= GetVar("to_starboard",this->to_starboard, input);
-	result &= GetVar("to_port", 	this->to_port, 	input);
-	result &= GetVar("to_stern", 	this->to_stern, input);
-	
-	GetVar("status", tmp, input);
-	try {
-		this->status = static_cast<AISNavStatus>(tmp);
-	} catch (...) {
-		this->status = AISNavStatus::UNDEFINED;
-		result = false;
-	}
-	GetVar("shiptype", tmp, input);
-	try {
-		this->shiptype = static_cast<AISShipType>(tmp);
-	} catch (...) {
-		this->shiptype = AISShipType::UNAVAILABLE;
-		result = false;
-	}
-	GetVar("epfd", tmp, input);
-	try {
-		this->epfd = static_cast<AISEPFDType>(tmp);
-	} catch (...) {
-		this->epfd = AISEPFDType::UNDEFINED;
-		result = false;
-	}
-	
-	return result;
+bool AISShip::readGpsdPacket (const char *json) {
+	return gpsdPacket([this, json] () {return readFields(gpsdFields, this, json);});
 }
 
 Location AISShip::project () {
-	return project(std::chrono::system_clock::now());
+	return project(BoatClock::now());
 }	
 					
 Location AISShip::project (sysclock t) {
@@ -137,10 +104,14 @@ Location AISShip::project (sysclock t) {
 }
 			
 bool AISShip::prune (Location& current) {
+	return prune(current.isValid() ? fix.distance(current, CourseTypeEnum::Approximate) : NAN);
+}
+
+bool AISShip::prune (double distance) {
 	auto timeout = Conf::get()->aisMaxTime();
 	if ((!this->isValid()) || 
-		(current.isValid() && (fix.distance(current) > Conf::get()->aisMaxDistance())) ||
-		((std::chrono::system_clock::now() - lastTimeStamp) > timeout)) {
+		(distance > Conf::get()->aisMaxDistance()) ||
+		((BoatClock::now() - lastTimeStamp) > timeout)) {
 			LOG(DEBUG) << "Trimming target " << this->mmsi;
 			LOG(DEBUG) << "Trimmed target " << *this;
 			return true;
@@ -148,78 +119,83 @@ bool AISShip::prune (Location& current) {
 	return false;
 }
 
-Value AISShip::pack () const {
-	Value d;
-	int packResult = 0;
-
-	packResult += PutVar("mmsi", this->mmsi, d);
-	packResult += PutVar("recordTime", HackerboatState::packTime(this->recordTime), d);
-	packResult += PutVar("lastTimeStamp", HackerboatState::packTime(this->lastTimeStamp), d);
-	packResult += PutVar("device", this->device, d);
-	packResult += PutVar("fix", this->fix.pack(), d);
-	packResult += PutVar("status", static_cast<int>(this->status), d);
-	packResult += PutVar("turn", this->turn, d);
-	packResult += PutVar("speed", this->speed, d);
-	packResult += PutVar("course", this->course, d);
-	packResult += PutVar("heading", this->heading, d);
-	packResult += PutVar("imo", this->heading, d);
-	packResult += PutVar("callsign", this->callsign, d);
-	packResult += PutVar("shipname", this->shipname, d);
-	packResult += PutVar("shiptype", static_cast<int>(this->shiptype), d);
-	packResult += PutVar("to_bow", this->to_bow, d);
-	packResult += PutVar("to_stern", this->to_stern, d);
-	packResult += PutVar("to_port", this->to_port, d);
-	packResult += PutVar("to_starboard", this->to_starboard, d);
-	packResult += PutVar("epfd", static_cast<int>(this->epfd), d);
-	
-	return d;
-}
+const FieldDescriptor AISShip::fields[] = {
+	FIELD(IntField, "mmsi", AISShip, mmsi),
+	FIELD(TimeField, "recordTime", AISShip, recordTime),
+	FIELD(TimeField, "lastTimeStamp", AISShip, lastTimeStamp),
+	FIELD(StringField, "device", AISShip, device),
+	FIELD(ObjectField, "fix", AISShip, fix),
+	FIELD(EnumIntField, "status", AISShip, status),
+	FIELD(DoubleField, "turn", AISShip, turn),
+	FIELD(DoubleField, "speed", AISShip, speed),
+	FIELD(DoubleField, "course", AISShip, course),
+	FIELD(DoubleField, "heading", AISShip, heading),
+	FIELD(IntField, "imo", AISShip, imo),
+	FIELD(StringField, "callsign", AISShip, callsign),
+	FIELD(StringField, "shipname", AISShip, shipname),
+	FIELD(EnumIntField, "shiptype", AISShip, shiptype),
+	FIELD(IntField, "to_bow", AISShip, to_bow),
+	FIELD(IntField, "to_stern", AISShip, to_stern),
+	FIELD(IntField, "to_port", AISShip, to_port),
+	FIELD(IntField, "to_starboard", AISShip, to_starboard),
+	FIELD(EnumIntField, "epfd", AISShip, epfd),
+	FIELD_END
+};
 
 bool AISShip::isValid () const {
 	bool result = true;
 	auto timeout = Conf::get()->aisMaxTime();
 	result &= (mmsi > 0);
 	result &= (fix.isValid());
-	result &= ((std::chrono::system_clock::now() - (this->lastTimeStamp)) < timeout);
+	result &= ((BoatClock::now() - (this->lastTimeStamp)) < timeout);
 	return result;
 }
 
-bool AISShip::merge(AISShip& other) {
-	AISShip *a,*b;
+bool AISShip::merge(const AISShip& other) {
+	AISShip c(other);
+	return this->merge(std::move(c));
+}
+
+bool AISShip::merge(AISShip&& other) {
 	if (this->mmsi != other.mmsi) return false;		// Can only merge contacts with the same MMSI
-	if (this->lastTimeStamp > other.lastTimeStamp) {	// make the newer one dominant
-		a = this; 
-		b = &other;
-	} else {
-		a = &other;
-		b = this;
-	}
-	this->recordTime 	= std::chrono::system_clock::now();
-	this->lastTimeStamp = a->lastTimeStamp;
-	LOG(DEBUG) << "Merging AIS contacts with MMSI: " << this->mmsi;
+	bool newer = !(this->lastTimeStamp > other.lastTimeStamp);
+	this->recordTime 	= BoatClock::now();
+	VLOG(3) << "Merging AIS contacts with MMSI: " << this->mmsi;
 	
-	// Check the newer version for validity and if it's valid, use it; otherwise, use the older one
-	this->fix 			= (a->fix.isValid()) ? a->fix : b->fix;
-	this->device		= (a->device != "") ? a->device : b->device;
-	this->status 		= (a->status != AISNavStatus::UNDEFINED) ? b->status : a->status;
-	this->turn			= (std::isnormal(a->turn)) ? a->turn : b->turn;
-	this->speed			= (std::isnormal(a->speed)) ? a->speed : b->speed;
-	this->course		= (std::isnormal(a->course)) ? a->course : b->course;
-	this->heading		= (std::isnormal(a->heading)) ? a->heading : b->heading;
-	this->imo			= (a->imo >= 0) ? a->imo : b->imo;
-	this->callsign		= (a->callsign != "") ? a->callsign : b->callsign;
-	this->shipname		= (a->shipname != "") ? a->shipname : b->shipname;
-	this->shiptype		= (a->shiptype != AISShipType::UNAVAILABLE) ? a->shiptype : b->shiptype;
-	this->to_bow		= (a->to_bow >= 0) ? a->to_bow : b->to_bow;
-	this->to_stern		= (a->to_stern >= 0) ? a->to_stern : b->to_stern;
-	this->to_port		= (a->to_port >= 0) ? a->to_port : b->to_port;
-	this->to_starboard	= (a->to_starboard >= 0) ? a->to_starboard : b->to_starboard;
-	this->epfd			= (a->epfd != AISEPFDType::UNDEFINED) ? a->epfd : b->epfd;
+	// Take each field from the other report if it has one and it's newer, or if this one has none. The position and
+	// its time stamp go together, since the stamp is what the position is projected from. The motion and status
+	// go stale with every position report, so a newer one replaces them outright, unavailable values included;
+	// a report without a position (static data) never carries them and leaves them alone.
+	auto take = [newer] (bool has, bool had) {return has && (newer || !had);};
+	if (take(other.fix.isValid(), this->fix.isValid())) {
+		this->fix = other.fix;
+		this->lastTimeStamp = other.lastTimeStamp;
+	} else if (newer && !this->fix.isValid()) this->lastTimeStamp = other.lastTimeStamp;
+	if (take(other.device != "", this->device != "")) this->device.swap(other.device);
+	if (newer && other.fix.isValid()) {
+		this->status = other.status;
+		this->turn = other.turn;
+		this->speed = other.speed;
+		this->course = other.course;
+		this->heading = other.heading;
+	}
+	if (take(other.imo >= 0, this->imo >= 0)) this->imo = other.imo;
+	if (take(other.callsign != "", this->callsign != "")) this->callsign.swap(other.callsign);
+	if (take(other.shipname != "", this->shipname != "")) this->shipname.swap(other.shipname);
+	if (take(other.shiptype != AISShipType::UNAVAILABLE, this->shiptype != AISShipType::UNAVAILABLE)) this->shiptype = other.shiptype;
+	if (take(other.to_bow >= 0, this->to_bow >= 0)) this->to_bow = other.to_bow;
+	if (take(other.to_stern >= 0, this->to_stern >= 0)) this->to_stern = other.to_stern;
+	if (take(other.to_port >= 0, this->to_port >= 0)) this->to_port = other.to_port;
+	if (take(other.to_starboard >= 0, this->to_starboard >= 0)) this->to_starboard = other.to_starboard;
+	if (take(other.epfd != AISEPFDType::UNDEFINED, this->epfd != AISEPFDType::UNDEFINED)) this->epfd = other.epfd;
 	
 	return true;
 }
 
 void AISShip::copy (const AISShip& c) {
+	this->mmsi = c.mmsi;
+	this->recordTime = c.recordTime;
+	this->lastTimeStamp = c.lastTimeStamp;
 	this->fix = c.fix;
 	this->device = c.device;
 	this->status = c.status;
@@ -238,6 +214,20 @@ void AISShip::copy (const AISShip& c) {
 	this->epfd = c.epfd;
 }
 
+void AISShip::clear () {
+	std::string name, call, dev;
+	name.swap(this->shipname);
+	call.swap(this->callsign);
+	dev.swap(this->device);
+	*this = AISShip();
+	name.clear();
+	call.clear();
+	dev.clear();
+	this->shipname.swap(name);
+	this->callsign.swap(call);
+	this->device.swap(dev);
+}
+
 std::ostream& operator<< (std::ostream& stream, const AISShip& state) {
 	stream << state.pack();
 	return stream;
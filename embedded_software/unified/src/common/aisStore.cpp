@@ -0,0 +1,303 @@
+/******************************************************************************
+ * Hackerboat AIS contact store module
+ * aisStore.cpp
+ * This module holds the current AIS contacts, indexed by MMSI, by name, and
+ * by position, and expires them as they age out
+ *
+ * See the Hackerboat documentation for more details
+ * Written by agent, Oct 2026
+ *
+ * Version 0.1: First alpha
+ *
+ ******************************************************************************/
+
+#include <math.h>
+#include <algorithm>
+#include "aisStore.hpp"
+#include "twovector.hpp"
+#include "configuration.hpp"
+#include "easylogging++.h"
+
+#define AIS_GRID_LAT_CELLS	((int64_t)ceil(180.0 / AIS_GRID_CELL_DEG))
+#define AIS_GRID_LON_CELLS	((int64_t)ceil(360.0 / AIS_GRID_CELL_DEG))
+#define AIS_GRID_RADIUS		(6335439.0)		/**< Smallest radius of curvature of the earth, north-south at the equator, so the cells searched are never too few */
+
+const uint32_t AISContactStore::NONE;
+
+AISContactStore::AISContactStore () {
+	std::fill(_wheel, _wheel + AIS_WHEEL_SLOTS, NONE);
+}
+
+int64_t AISContactStore::cellOf (const Location& loc) {
+	int64_t row = (int64_t)floor((loc.lat + 90.0) / AIS_GRID_CELL_DEG);
+	int64_t col = (int64_t)floor((loc.lon + 180.0) / AIS_GRID_CELL_DEG);
+	row = std::min(row, AIS_GRID_LAT_CELLS - 1);
+	col = ((col % AIS_GRID_LON_CELLS) + AIS_GRID_LON_CELLS) % AIS_GRID_LON_CELLS;
+	return (row * AIS_GRID_LON_CELLS) + col;
+}
+
+int64_t AISContactStore::tickOf (sysclock t) {
+	return t.time_since_epoch() / AIS_WHEEL_TICK;
+}
+
+uint32_t AISContactStore::slotOf (AISShip *ship) const {
+	if (!ship) return NONE;
+	auto it = _byMMSI.find(ship->mmsi);
+	if ((it == _byMMSI.end()) || (&_slots[it->second].ship != ship)) return NONE;
+	return it->second;
+}
+
+AISShip* AISContactStore::upsert (const AISShip& ship) {
+	AISShip c(ship);
+	return upsert(std::move(c));
+}
+
+AISShip* AISContactStore::upsert (AISShip&& ship) {
+	bool added;
+	AISShip *stored = claim(ship.mmsi, added);
+	if (!stored) return NULL;
+	if (added) {
+		*stored = std::move(ship);
+	} else stored->merge(std::move(ship));
+	moved(stored);
+	return stored;
+}
+
+AISShip* AISContactStore::claim (int mmsi, bool& added) {
+	added = false;
+	if (mmsi <= 0) return NULL;
+	auto it = _byMMSI.find(mmsi);
+	if (it != _byMMSI.end()) return &_slots[it->second].ship;
+	uint32_t slot;
+	if (_free.empty()) {
+		slot = _slots.size();
+		_slots.emplace_back();
+	} else {
+		slot = _free.back();
+		_free.pop_back();
+	}
+	_slots[slot].ship.mmsi = mmsi;
+	_slots[slot].live = true;
+	_byMMSI[mmsi] = slot;
+	added = true;
+	return &_slots[slot].ship;
+}
+
+AISShip* AISContactStore::find (int mmsi) {
+	auto it = _byMMSI.find(mmsi);
+	return (it != _byMMSI.end()) ? &_slots[it->second].ship : NULL;
+}
+
+AISShip* AISContactStore::find (const std::string& name) {
+	auto it = _byName.find(name);
+	return (it != _byName.end()) ? &_slots[it->second].ship : NULL;
+}
+
+bool AISContactStore::erase (int mmsi) {
+	auto it = _byMMSI.find(mmsi);
+	if (it == _byMMSI.end()) return false;
+	remove(it->second);
+	return true;
+}
+
+void AISContactStore::clear () {
+	_slots.clear();
+	_free.clear();
+	_byMMSI.clear();
+	_byName.clear();
+	_cells.clear();
+	std::fill(_wheel, _wheel + AIS_WHEEL_SLOTS, NONE);
+	_wheelTick = INT64_MIN;
+}
+
+void AISContactStore::moved (AISShip *ship) {
+	uint32_t slot = slotOf(ship);
+	if (slot != NONE) index(slot);
+}
+
+void AISContactStore::index (uint32_t slot) {
+	Slot& s = _slots[slot];
+	int64_t cell = s.ship.fix.isValid() ? cellOf(s.ship.fix) : -1;
+	if (cell != s.cell) {
+		cellRemove(slot);
+		if (cell >= 0) {
+			std::vector<uint32_t>& members = _cells[cell];
+			s.cell = cell;
+			s.cellPos = members.size();
+			members.push_back(slot);
+		}
+	}
+	if (s.ship.shipname != s.name) {
+		auto it = _byName.find(s.name);
+		if ((it != _byName.end()) && (it->second == slot)) _byName.erase(it);
+		s.name = s.ship.shipname;
+		if (!s.name.empty()) _byName[s.name] = slot;
+	}
+	int64_t expiry = tickOf(s.ship.lastTimeStamp + Conf::get()->aisMaxTime()) + 1;
+	if (expiry != s.expiry) {
+		wheelRemove(slot);
+		s.expiry = expiry;
+		wheelInsert(slot);
+	}
+}
+
+void AISContactStore::cellRemove (uint32_t slot) {
+	Slot& s = _slots[slot];
+	if (s.cell < 0) return;
+	auto it = _cells.find(s.cell);
+	std::vector<uint32_t>& members = it->second;
+	uint32_t last = members.back();
+	members[s.cellPos] = last;
+	_slots[last].cellPos = s.cellPos;
+	members.pop_back();
+	if (members.empty()) _cells.erase(it);
+	s.cell = -1;
+	s.cellPos = NONE;
+}
+
+void AISContactStore::wheelInsert (uint32_t slot) {
+	Slot& s = _slots[slot];
+	// anything already due goes in the next bucket expire() will look at
+	int64_t tick = std::max(s.expiry, (_wheelTick == INT64_MIN) ? s.expiry : (_wheelTick + 1));
+	s.bucket = ((tick % AIS_WHEEL_SLOTS) + AIS_WHEEL_SLOTS) % AIS_WHEEL_SLOTS;
+	uint32_t& head = _wheel[s.bucket];
+	s.wheelPrev = NONE;
+	s.wheelNext = head;
+	if (head != NONE) _slots[head].wheelPrev = slot;
+	head = slot;
+}
+
+void AISContactStore::wheelRemove (uint32_t slot) {
+	Slot& s = _slots[slot];
+	if (s.bucket == NONE) return;
+	if (s.wheelPrev != NONE) {
+		_slots[s.wheelPrev].wheelNext = s.wheelNext;
+	} else _wheel[s.bucket] = s.wheelNext;
+	if (s.wheelNext != NONE) _slots[s.wheelNext].wheelPrev = s.wheelPrev;
+	s.bucket = NONE;
+	s.wheelPrev = NONE;
+	s.wheelNext = NONE;
+}
+
+void AISContactStore::remove (uint32_t slot) {
+	Slot& s = _slots[slot];
+	LOG(DEBUG) << "Removing AIS contact " << s.ship.mmsi;
+	cellRemove(slot);
+	wheelRemove(slot);
+	auto it = _byName.find(s.name);
+	if ((it != _byName.end()) && (it->second == slot)) _byName.erase(it);
+	_byMMSI.erase(s.ship.mmsi);
+	s.ship.clear();
+	s.name.clear();
+	s.expiry = 0;
+	s.live = false;
+	_free.push_back(slot);
+}
+
+size_t AISContactStore::expire (sysclock now) {
+	int64_t tick = tickOf(now);
+	if (tick <= _wheelTick) return 0;
+	// a whole lap of the wheel visits every bucket, so there's no need to go further back than that
+	int64_t from = (_wheelTick == INT64_MIN) ? (tick - AIS_WHEEL_SLOTS + 1) : std::max(_wheelTick + 1, tick - AIS_WHEEL_SLOTS + 1);
+	size_t count = 0;
+	for (int64_t t = from; t <= tick; t++) {
+		uint32_t slot = _wheel[((t % AIS_WHEEL_SLOTS) + AIS_WHEEL_SLOTS) % AIS_WHEEL_SLOTS];
+		while (slot != NONE) {
+			uint32_t next = _slots[slot].wheelNext;
+			if (_slots[slot].expiry <= tick) {
+				remove(slot);
+				count++;
+			}
+			slot = next;
+		}
+	}
+	_wheelTick = tick;
+	return count;
+}
+
+size_t AISContactStore::within (const Location& center, double radius, std::vector<AISShip*>& out, std::vector<double> *dist) {
+	out.clear();
+	if (dist) dist->clear();
+	if (!center.isValid() || !(radius >= 0)) return 0;
+	_candidates.clear();
+
+	// the rows and columns of cells the circle can reach; near the poles, or if it's cheaper, look at every cell
+	double span = TwoVector::rad2deg(radius / AIS_GRID_RADIUS);
+	double top = center.lat + span;
+	double bottom = center.lat - span;
+	double widest = std::max(fabs(top), fabs(bottom));
+	int64_t rowLo = std::max((int64_t)0, (int64_t)floor((bottom + 90.0) / AIS_GRID_CELL_DEG));
+	int64_t rowHi = std::min(AIS_GRID_LAT_CELLS - 1, (int64_t)floor((top + 90.0) / AIS_GRID_CELL_DEG));
+	int64_t cols = AIS_GRID_LON_CELLS;
+	if (widest < 89.0) {
+		double lonSpan = span / cos(TwoVector::deg2rad(widest));
+		cols = std::min(cols, (int64_t)ceil((2 * lonSpan) / AIS_GRID_CELL_DEG) + 2);
+	}
+	if ((uint64_t)((rowHi - rowLo + 1) * cols) > _cells.size()) {
+		for (auto& c : _cells) {
+			int64_t row = c.first / AIS_GRID_LON_CELLS;
+			if ((row >= rowLo) && (row <= rowHi)) _candidates.insert(_candidates.end(), c.second.begin(), c.second.end());
+		}
+	} else {
+		int64_t colLo = cellOf(Location(center.lat, center.lon)) % AIS_GRID_LON_CELLS - (cols / 2);
+		for (int64_t row = rowLo; row <= rowHi; row++) {
+			for (int64_t i = 0; i < cols; i++) {
+				int64_t col = (((colLo + i) % AIS_GRID_LON_CELLS) + AIS_GRID_LON_CELLS) % AIS_GRID_LON_CELLS;
+				auto it = _cells.find((row * AIS_GRID_LON_CELLS) + col);
+				if (it != _cells.end()) _candidates.insert(_candidates.end(), it->second.begin(), it->second.end());
+			}
+		}
+	}
+
+	// then measure the distance to each of them in one go
+	size_t n = _candidates.size();
+	_lat.resize(n);
+	_lon.resize(n);
+	_dist.resize(n);
+	for (size_t i = 0; i < n; i++) {
+		_lat[i] = _slots[_candidates[i]].ship.fix.lat;
+		_lon[i] = _slots[_candidates[i]].ship.fix.lon;
+	}
+	center.targets(_lat.data(), _lon.data(), n, _dist.data());
+	for (size_t i = 0; i < n; i++) {
+		if (_dist[i] <= radius) {
+			out.push_back(&_slots[_candidates[i]].ship);
+			if (dist) dist->push_back(_dist[i]);
+		}
+	}
+	return out.size();
+}
+
+size_t AISContactStore::ofType (AISShipType type, std::vector<AISShip*>& out) {
+	out.clear();
+	forEach([&] (AISShip& ship) {
+		if (ship.shiptype == type) out.push_back(&ship);
+	});
+	return out.size();
+}
+
+size_t AISContactStore::prune (const Location& here, sysclock now) {
+	size_t count = expire(now);
+	_candidates.clear();
+	_lat.clear();
+	_lon.clear();
+	for (uint32_t i = 0; i < _slots.size(); i++) {
+		if (!_slots[i].live) continue;
+		_candidates.push_back(i);
+		_lat.push_back(_slots[i].ship.fix.lat);
+		_lon.push_back(_slots[i].ship.fix.lon);
+	}
+	// all the distances in one go; with no fix, only the age and validity tests apply
+	size_t n = _candidates.size();
+	_dist.resize(n);
+	if (here.isValid()) {
+		here.targets(_lat.data(), _lon.data(), n, _dist.data());
+	} else std::fill(_dist.begin(), _dist.end(), NAN);
+	for (size_t i = 0; i < n; i++) {
+		if (_slots[_candidates[i]].ship.prune(_dist[i])) {
+			remove(_candidates[i]);
+			count++;
+		}
+	}
+	return count;
+}
@@ -0,0 +1,343 @@
+/******************************************************************************
+ * Hackerboat AIVDM module
+ * aivdm.cpp
+ * This module decodes raw AIVDM/AIVDO sentences straight into AIS contacts
+ * Message layouts from Eric Raymond's AIVDM/AIVDO protocol decoding
+ * http://catb.org/gpsd/AIVDM.html
+ *
+ * See the Hackerboat documentation for more details
+ * Written by agent, Oct 2026
+ *
+ * Version 0.1: First alpha
+ *
+ ******************************************************************************/
+
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include "aivdm.hpp"
+#include "easylogging++.h"
+
+#define AIVDM_FIELDS		(7)				/**< Fields in a sentence, counting the talker and sentence type */
+#define AIS_COORD_SCALE		(600000.0)		/**< Position units per degree */
+#define AIS_NO_LON			(181 * 600000)
+#define AIS_NO_LAT			(91 * 600000)
+#define AIS_NO_SPEED		(1023)
+#define AIS_NO_COURSE		(3600)
+#define AIS_NO_HEADING		(511)
+#define AIS_NO_TURN			(-128)
+#define AIS_TURN_FAST		(127)			/**< Turning faster than 5 degrees in 30 seconds, with no rate available */
+#define AIS_TURN_SCALE		(4.733)
+
+static int hexDigit (char c) {
+	if ((c >= '0') && (c <= '9')) return c - '0';
+	if ((c >= 'A') && (c <= 'F')) return c - 'A' + 10;
+	if ((c >= 'a') && (c <= 'f')) return c - 'a' + 10;
+	return -1;
+}
+
+bool AIVDMDecoder::checksum (const char *sentence, size_t len) {
+	if ((len < 4) || (sentence[len - 3] != '*')) return false;
+	int hi = hexDigit(sentence[len - 2]);
+	int lo = hexDigit(sentence[len - 1]);
+	if ((hi < 0) || (lo < 0)) return false;
+	uint8_t sum = 0;
+	for (size_t i = 1; i < (len - 3); i++) sum ^= (uint8_t)sentence[i];
+	return (sum == ((hi << 4) | lo));
+}
+
+AIVDMResult AIVDMDecoder::decode (const char *sentence, size_t len, sysclock now, AISShip& ship) {
+	bool own;
+	AIVDMResult result = assemble(sentence, len, own);
+	if (result != AIVDMResult::DECODED) return result;
+	result = check();
+	if (result != AIVDMResult::DECODED) {
+		if (result == AIVDMResult::BAD_FORMAT) _errors++;
+		return result;
+	}
+	ship.clear();
+	decodeMessage(ship);
+	ship.lastTimeStamp = now;
+	_lastShip = &ship;
+	_lastOwn = own;
+	_messages++;
+	return AIVDMResult::DECODED;
+}
+
+AIVDMResult AIVDMDecoder::decode (const char *sentence, size_t len, sysclock now, AISContactStore& contacts) {
+	bool own;
+	AIVDMResult result = assemble(sentence, len, own);
+	if (result != AIVDMResult::DECODED) return result;
+	result = check();
+	if (result != AIVDMResult::DECODED) {
+		if (result == AIVDMResult::BAD_FORMAT) _errors++;
+		return result;
+	}
+
+	// our own reports don't belong among the contacts; anyone else's are written over what we already know of them
+	AISShip *ship;
+	bool added = false;
+	if (own) {
+		_own.clear();
+		ship = &_own;
+	} else ship = contacts.claim(bits(8, 30), added);
+	bool located = decodeMessage(*ship);
+	if (located || added || own) ship->lastTimeStamp = now;		// the time stamp goes with the position
+	if (!own) contacts.moved(ship);
+	_lastShip = ship;
+	_lastOwn = own;
+	_messages++;
+	return AIVDMResult::DECODED;
+}
+
+AIVDMResult AIVDMDecoder::assemble (const char*& sentence, size_t& len, bool& own) {
+	_sentences++;
+	while ((len > 0) && ((sentence[len - 1] == '\r') || (sentence[len - 1] == '\n') || (sentence[len - 1] == ' '))) len--;
+	if ((len > 0) && (sentence[0] == '\\')) {		// a tag block, which we have no use for
+		const char *end = (const char *)memchr(sentence + 1, '\\', len - 1);
+		if (!end) {
+			_errors++;
+			return AIVDMResult::BAD_FORMAT;
+		}
+		len -= (end + 1) - sentence;
+		sentence = end + 1;
+	}
+	if ((len < 6) || (sentence[0] != '!') || (strncmp(sentence + 3, "VD", 2) != 0) ||
+		((sentence[5] != 'M') && (sentence[5] != 'O'))) return AIVDMResult::IGNORED;
+	own = (sentence[5] == 'O');
+	if (!checksum(sentence, len)) {
+		_errors++;
+		LOG(DEBUG) << "AIVDM checksum failed: " << std::string(sentence, len);
+		return AIVDMResult::BAD_CHECKSUM;
+	}
+
+	// !AIVDM,count,number,sequence,channel,payload,fill*hh
+	const char *field[AIVDM_FIELDS];
+	size_t flen[AIVDM_FIELDS];
+	size_t n = 0;
+	const char *start = sentence;
+	const char *star = sentence + len - 3;
+	for (const char *c = sentence; c <= star; c++) {
+		if ((c == star) || (*c == ',')) {
+			if (n < AIVDM_FIELDS) {
+				field[n] = start;
+				flen[n] = c - start;
+			}
+			n++;
+			start = c + 1;
+		}
+	}
+	if ((n != AIVDM_FIELDS) || (flen[1] != 1) || (flen[2] != 1) || (flen[3] > 1) || (flen[4] > 1) || (flen[6] != 1) ||
+		(field[1][0] < '1') || (field[1][0] > '9') || (field[2][0] < '1') || (field[2][0] > field[1][0]) ||
+		(field[6][0] < '0') || (field[6][0] > '5')) {
+		_errors++;
+		LOG(DEBUG) << "Malformed AIVDM sentence: " << std::string(sentence, len);
+		return AIVDMResult::BAD_FORMAT;
+	}
+	int count = field[1][0] - '0';
+	int number = field[2][0] - '0';
+	char seqId = (flen[3]) ? field[3][0] : 0;
+	char channel = (flen[4]) ? field[4][0] : 0;
+	int fill = field[6][0] - '0';
+
+	bool ok;
+	if (count == 1) {
+		ok = unpack(field[5], flen[5], fill);
+	} else {
+		Pending *slot = NULL;
+		for (auto& p : _pending) {
+			if (p.used && (p.seqId == seqId) && (p.channel == channel)) slot = &p;
+		}
+		if (number == 1) {
+			// start a new message, in place of any unfinished one with the same ID, or of the oldest ID if we're full
+			if (!slot) {
+				for (auto& p : _pending) {
+					if (!p.used) {
+						slot = &p;
+						break;
+					}
+				}
+			}
+			if (!slot) slot = &_pending[(unsigned)seqId % AIVDM_MAX_PENDING];
+			slot->used = true;
+			slot->seqId = seqId;
+			slot->channel = channel;
+			slot->count = count;
+			slot->next = 1;
+			slot->len = 0;
+		} else if (!slot || (slot->count != count) || (slot->next != number)) {
+			if (slot) slot->used = false;
+			_errors++;
+			LOG(DEBUG) << "AIVDM fragment out of order: " << std::string(sentence, len);
+			return AIVDMResult::BAD_FORMAT;
+		}
+		if ((slot->len + flen[5]) > AIVDM_MAX_PAYLOAD) {
+			slot->used = false;
+			_errors++;
+			return AIVDMResult::BAD_FORMAT;
+		}
+		memcpy(slot->payload + slot->len, field[5], flen[5]);
+		slot->len += flen[5];
+		if (number < count) {
+			slot->next++;
+			return AIVDMResult::PENDING;
+		}
+		slot->used = false;
+		ok = unpack(slot->payload, slot->len, fill);
+	}
+	if (!ok) {
+		_errors++;
+		LOG(DEBUG) << "Bad AIVDM payload: " << std::string(sentence, len);
+		return AIVDMResult::BAD_FORMAT;
+	}
+	return AIVDMResult::DECODED;
+}
+
+bool AIVDMDecoder::unpack (const char *payload, size_t len, int fill) {
+	if ((len > AIVDM_MAX_PAYLOAD) || ((len * 6) < (size_t)fill)) return false;
+	uint32_t acc = 0;
+	int held = 0;
+	size_t out = 0;
+	for (size_t i = 0; i < len; i++) {
+		int v = payload[i] - 48;
+		if (v > 40) v -= 8;
+		if ((v < 0) || (v > 63) || ((payload[i] > 'W') && (payload[i] < '`'))) return false;
+		acc = (acc << 6) | v;
+		held += 6;
+		if (held >= 8) {
+			held -= 8;
+			_bits[out++] = (acc >> held) & 0xff;
+		}
+	}
+	if (held) _bits[out++] = (acc << (8 - held)) & 0xff;
+	_nbits = (len * 6) - fill;
+	return true;
+}
+
+uint32_t AIVDMDecoder::bits (size_t start, size_t width) const {
+	uint32_t v = 0;
+	for (size_t i = start; i < (start + width); i++) {
+		v <<= 1;
+		if (i < _nbits) v |= (_bits[i >> 3] >> (7 - (i & 7))) & 1;		// short messages read as zero past the end
+	}
+	return v;
+}
+
+int32_t AIVDMDecoder::sbits (size_t start, size_t width) const {
+	uint32_t v = bits(start, width);
+	if (v & (1u << (width - 1))) return (int32_t)v - (int32_t)(1u << width);
+	return v;
+}
+
+void AIVDMDecoder::text (size_t start, size_t chars, std::string& out) const {
+	out.clear();
+	for (size_t i = 0; i < chars; i++) {
+		char c = bits(start + (i * 6), 6);
+		if (c == 0) break;							// '@' ends the text
+		out.push_back((c < 32) ? (c + 64) : c);
+	}
+	while (!out.empty() && (out.back() == ' ')) out.pop_back();
+}
+
+void AIVDMDecoder::textField (size_t start, size_t chars, std::string& out) {
+	text(start, chars, _text);
+	if (!_text.empty() && (_text != out)) out = _text;		// assigned rather than swapped, so a long name doesn't leave us a short buffer
+}
+
+bool AIVDMDecoder::position (AISShip& ship, size_t speed, size_t lon, size_t lat, size_t course, size_t heading) {
+	uint32_t sog = bits(speed, 10);
+	int32_t x = sbits(lon, 28);
+	int32_t y = sbits(lat, 27);
+	uint32_t cog = bits(course, 12);
+	uint32_t hdg = bits(heading, 9);
+	// these go stale with every report, so an unavailable value clears what we had rather than leaving it be
+	ship.speed = (sog != AIS_NO_SPEED) ? (sog / 10.0) : NAN;
+	ship.course = (cog < AIS_NO_COURSE) ? (cog / 10.0) : NAN;
+	ship.heading = ((hdg != AIS_NO_HEADING) && (hdg < 360)) ? hdg : NAN;
+	if ((x != AIS_NO_LON) && (y != AIS_NO_LAT) && (abs(x) <= (180 * 600000)) && (abs(y) <= (90 * 600000))) {
+		ship.fix = Location(y / AIS_COORD_SCALE, x / AIS_COORD_SCALE);
+		return true;
+	}
+	return false;
+}
+
+void AIVDMDecoder::dimensions (AISShip& ship, size_t start) {
+	uint32_t bow = bits(start, 9);
+	uint32_t stern = bits(start + 9, 9);
+	uint32_t port = bits(start + 18, 6);
+	uint32_t starboard = bits(start + 24, 6);
+	if (!(bow || stern || port || starboard)) return;		// all zero means not available
+	ship.to_bow = bow;
+	ship.to_stern = stern;
+	ship.to_port = port;
+	ship.to_starboard = starboard;
+}
+
+AIVDMResult AIVDMDecoder::check () const {
+	if (_nbits < 40) return AIVDMResult::BAD_FORMAT;
+	if (bits(8, 30) == 0) return AIVDMResult::IGNORED;		// no MMSI, so nothing to file it under
+	switch (bits(0, 6)) {
+		case 1:
+		case 2:
+		case 3:
+		case 18:
+			return (_nbits < 168) ? AIVDMResult::BAD_FORMAT : AIVDMResult::DECODED;
+		case 5:
+			return (_nbits < 420) ? AIVDMResult::BAD_FORMAT : AIVDMResult::DECODED;	// some transmitters leave off the last spare bits
+		case 24: {
+			if (_nbits < 160) return AIVDMResult::BAD_FORMAT;
+			int part = bits(38, 2);
+			return ((part == 0) || ((part == 1) && (_nbits >= 162))) ? AIVDMResult::DECODED : AIVDMResult::BAD_FORMAT;
+		}
+		default:
+			return AIVDMResult::IGNORED;
+	}
+}
+
+bool AIVDMDecoder::decodeMessage (AISShip& ship) {
+	int type = bits(0, 6);
+	bool located = false;
+	ship.mmsi = bits(8, 30);
+	switch (type) {
+		case 1:
+		case 2:
+		case 3: {
+			ship.status = static_cast<AISNavStatus>(bits(38, 4));
+			int32_t rot = sbits(42, 8);
+			if ((rot != AIS_NO_TURN) && (abs(rot) != AIS_TURN_FAST)) {
+				ship.turn = copysign(pow(rot / AIS_TURN_SCALE, 2), rot);
+			} else ship.turn = NAN;
+			located = position(ship, 50, 61, 89, 116, 128);
+			break;
+		}
+		case 5: {
+			uint32_t imo = bits(40, 30);
+			if (imo) ship.imo = imo;
+			textField(70, 7, ship.callsign);
+			textField(112, 20, ship.shipname);
+			uint32_t shiptype = bits(232, 8);
+			if (shiptype) ship.shiptype = static_cast<AISShipType>(shiptype);
+			dimensions(ship, 240);
+			uint32_t epfd = bits(270, 4);
+			if (epfd && (epfd <= (uint32_t)AISEPFDType::GALILEO)) ship.epfd = static_cast<AISEPFDType>(epfd);
+			break;
+		}
+		case 18:							// class B reports carry no status or rate of turn
+			ship.status = AISNavStatus::UNDEFINED;
+			ship.turn = NAN;
+			located = position(ship, 46, 57, 85, 112, 124);
+			break;
+		case 24:
+			if (bits(38, 2) == 0) {
+				textField(40, 20, ship.shipname);
+			} else {
+				uint32_t shiptype = bits(40, 8);
+				if (shiptype) ship.shiptype = static_cast<AISShipType>(shiptype);
+				textField(90, 7, ship.callsign);
+				dimensions(ship, 132);
+			}
+			break;
+	}
+	_lastType = static_cast<AISMsgType>(type);
+	return located;
+}
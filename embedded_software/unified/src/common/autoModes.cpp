@@ -25,6 +25,17 @@
 #include "rcModes.hpp"
 #include "easylogging++.h"
 #include "configuration.hpp"
+#include "pool.hpp"
+
+static FixedPool<MaxSize<AutoIdleMode, AutoWaypointMode, AutoReturnMode, AutoAnchorMode>::value, MODE_POOL_SIZE> autoModePool;
+
+void* AutoModeBase::operator new (size_t size) {
+	return autoModePool.allocateOrNew(size);
+}
+
+void AutoModeBase::operator delete (void *p) {
+	autoModePool.releaseOrDelete(p);
+}
 
 AutoModeBase* AutoModeBase::factory(BoatState& state, AutoModeEnum mode) {
 	switch (mode) {
@@ -84,25 +95,26 @@ AutoModeBase* AutoWaypointMode::execute() {
 	Location target = _state.waypointList.getWaypoint();
 	
 	// get course to the next waypoint
-	double targetCourse = _state.lastFix.fix.bearing(target);
+	const NavSolution& nav = _state.navTo(target, _state.getLegStart());
+	double targetCourse = nav.bearing();
 	
 	// apply dodge functionality, if implemented (this is currently a null)
 	
 	// operate helm
-	this->in = _state.orient->getOrientation()->makeTrue().headingError(targetCourse);
-	LOG_EVERY_N(100, DEBUG) << "True Heading: " << _state.orient->getOrientation()->makeTrue() 
+	this->in = _state.orient->getOrientation().makeTrue().headingError(targetCourse);
+	LOG_EVERY_N(100, DEBUG) << "True Heading: " << _state.orient->getOrientation().makeTrue() 
 							<< ", Target Course: " << targetCourse << ", Waypoint: " 
 							<< _state.waypointList.current() << ": " << _state.waypointList.getWaypoint();
 	helm.Compute();
 	_state.rudder->write(this->out);
-	LOG_EVERY_N(100, DEBUG) << "Rudder command: " << to_string(this->out);
+	LOG_EVERY_N(100, DEBUG) << "Rudder command: " << this->out;
 	
 	// set the throttle
 	_state.throttle->setThrottle(this->throttleSetting);
 	
 	// check if we've arrived at the next waypoint
-	if (_state.lastFix.fix.distance(target) < Conf::get()->autoWaypointTol()) {
-		LOG(INFO) << "Incrementing waypoint from waypoint " << to_string(_state.waypointList.current());
+	if (nav.distance() < Conf::get()->autoWaypointTol()) {
+		LOG(INFO) << "Incrementing waypoint from waypoint " << _state.waypointList.current();
 		if (!_state.waypointList.increment()) {	// if this returns false, it means we got to the end of the waypoint list with and end action other that RETURN
 			switch (_state.waypointList.getAction()) {
 				case WaypointActionEnum::RETURN:
@@ -118,7 +130,7 @@ AutoModeBase* AutoWaypointMode::execute() {
 					return new AutoIdleMode(_state, _state.getAutoMode());
 			}
 		} else {
-			LOG(INFO) << "New waypoint is #" << to_string(_state.waypointList.current())
+			LOG(INFO) << "New waypoint is #" << _state.waypointList.current()
 						<< " at " << _state.waypointList.getWaypoint();
 		}
 	}
@@ -149,24 +161,25 @@ AutoModeBase* AutoReturnMode::execute() {
 	Location target = _state.launchPoint;
 	
 	// get course to the next waypoint
-	double targetCourse = _state.lastFix.fix.bearing(target);
+	const NavSolution& nav = _state.navTo(target);
+	double targetCourse = nav.bearing();
 	
 	// apply dodge functionality, if implemented (this is currently a null)
 	
 	// operate helm
-	this->in = _state.orient->getOrientation()->makeTrue().headingError(targetCourse);
-	LOG_EVERY_N(100, DEBUG) << "True Heading: " << _state.orient->getOrientation()->makeTrue()
-							<< ", Target Course: " << to_string(targetCourse) << ", Target: " 
+	this->in = _state.orient->getOrientation().makeTrue().headingError(targetCourse);
+	LOG_EVERY_N(100, DEBUG) << "True Heading: " << _state.orient->getOrientation().makeTrue()
+							<< ", Target Course: " << targetCourse << ", Target: " 
 							<< _state.launchPoint;
 	helm.Compute();
 	_state.rudder->write(this->out);
-	LOG_EVERY_N(100, DEBUG) << "Rudder command: " << to_string(this->out);
+	LOG_EVERY_N(100, DEBUG) << "Rudder command: " << this->out;
 	
 	// set the throttle
 	_state.throttle->setThrottle(this->throttleSetting);
 	
 	// check if we've arrived at the origin
-	if (_state.lastFix.fix.distance(target) < Conf::get()->autoWaypointTol()) {
+	if (nav.distance() < Conf::get()->autoWaypointTol()) {
 		LOG(INFO) << "Arrived at origin point, anchoring";
 		return new AutoAnchorMode(_state, _state.getAutoMode());
 	}
@@ -194,8 +207,9 @@ AutoModeBase* AutoAnchorMode::execute() {
 	callCount++;
 	
 	// get the bearing and distance to the anchor point
-	double headingError = _state.orient->getOrientation()->makeTrue().headingError(_state.lastFix.fix.bearing(_state.anchorPoint));
-	double distance = _state.lastFix.fix.distance(_state.anchorPoint);
+	const NavSolution& nav = _state.navTo(_state.anchorPoint);
+	double headingError = _state.orient->getOrientation().makeTrue().headingError(nav.bearing());
+	double distance = nav.distance();
 	
 	// determine whether the target point is forward or aft of current position
 	
@@ -222,8 +236,8 @@ AutoModeBase* AutoAnchorMode::execute() {
 	helm.Compute();
 	_state.rudder->write(this->out);
 	_state.throttle->setThrottle(this->throttleSetting);
-	LOG_EVERY_N(100, DEBUG) << "Rudder command: " << to_string(this->out);
-	LOG_EVERY_N(100, DEBUG) << "Throttle command: " << to_string(this->throttleSetting);
+	LOG_EVERY_N(100, DEBUG) << "Rudder command: " << this->out;
+	LOG_EVERY_N(100, DEBUG) << "Throttle command: " << this->throttleSetting;
 	
 	// check for commands
 	if (_state.getAutoMode() != AutoModeEnum::ANCHOR) {
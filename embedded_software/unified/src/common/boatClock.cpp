@@ -0,0 +1,43 @@
+/******************************************************************************
+ * Hackerboat boat clock module
+ * boatClock.cpp
+ * This module provides the time used by the control code, so that it can be
+ * driven from a recording instead of the wall clock
+ *
+ * See the Hackerboat documentation for more details
+ * Written by agent, Oct 2026
+ *
+ * Version 0.1: First alpha
+ *
+ ******************************************************************************/
+
+#include <atomic>
+#include <chrono>
+#include "boatClock.hpp"
+
+using namespace std::chrono;
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "BoatClock requires lock-free 64-bit atomics");
+
+std::atomic<bool> BoatClock::_set { false };
+std::atomic<int64_t> BoatClock::_ticks { 0 };
+
+sysclock BoatClock::now () {
+	if (!_set.load(std::memory_order_acquire)) return system_clock::now();
+	return sysclock(system_clock::duration(_ticks.load(std::memory_order_relaxed)));
+}
+
+steady_clock::time_point BoatClock::steadyNow () {
+	if (!_set.load(std::memory_order_acquire)) return steady_clock::now();
+	// only differences between steady times mean anything, so any fixed offset will do
+	return steady_clock::time_point(duration_cast<steady_clock::duration>(system_clock::duration(_ticks.load(std::memory_order_relaxed))));
+}
+
+void BoatClock::set (sysclock t) {
+	_ticks.store(t.time_since_epoch().count(), std::memory_order_relaxed);
+	_set.store(true, std::memory_order_release);
+}
+
+void BoatClock::release () {
+	_set.store(false, std::memory_order_release);
+}
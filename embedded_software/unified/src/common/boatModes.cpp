@@ -19,11 +19,26 @@
 #include "navModes.hpp"
 #include "boatModes.hpp"
 #include "hackerboatRoot.hpp"
+#include "boatClock.hpp"
 #include "hal/relay.hpp"
 #include "hal/gpio.hpp"
 #include "easylogging++.h"
 #include "util.hpp"
 #include "configuration.hpp"
+#include "cycleProfiler.hpp"
+#include "pool.hpp"
+
+// self test mode keeps a whole copy of the BoatState, so it's left out and comes from the heap
+static FixedPool<MaxSize<BoatStartMode, BoatDisarmedMode, BoatFaultMode, BoatNavigationMode,
+						 BoatLowBatteryMode, BoatArmedTestMode>::value, MODE_POOL_SIZE> boatModePool;
+
+void* BoatModeBase::operator new (size_t size) {
+	return boatModePool.allocateOrNew(size);
+}
+
+void BoatModeBase::operator delete (void *p) {
+	boatModePool.releaseOrDelete(p);
+}
 
 BoatModeBase* BoatModeBase::factory(BoatState& state, BoatModeEnum mode) {
 	switch (mode) {
@@ -70,7 +85,7 @@ BoatModeBase* BoatStartMode::execute() {
 }
 
 BoatModeBase* BoatSelfTestMode::execute() {
-	_state.recordTime = std::chrono::system_clock::now();		// Get a consistent time for everything in this invocation
+	_state.recordTime = BoatClock::now();		// Get a consistent time for everything in this invocation
 	
 	if (this->callCount == 0) {				// Some housekeeping is in order if we just started up... 
 		LOG(INFO) << "Starting self-test";
@@ -129,7 +144,7 @@ BoatModeBase* BoatSelfTestMode::execute() {
 }
 
 BoatModeBase* BoatDisarmedMode::execute() {
-	_state.recordTime = std::chrono::system_clock::now();		// Get a consistent time for everything in this invocation
+	_state.recordTime = BoatClock::now();		// Get a consistent time for everything in this invocation
 	
 	if (this->callCount == 0) {				// Some housekeeping is in order if we just started up... 
 		LOG(INFO) << "Starting disarmed mode";
@@ -165,7 +180,7 @@ BoatModeBase* BoatDisarmedMode::execute() {
 		} else {
 			hornOn = true;
 			LOG(INFO) << "Boat armed; turning on horn";
-			hornStartTime = std::chrono::system_clock::now();
+			hornStartTime = BoatClock::now();
 			_state.relays->get("HORN")->set();
 		}
 	} else {
@@ -183,7 +198,7 @@ BoatModeBase* BoatDisarmedMode::execute() {
 }
 
 BoatModeBase* BoatFaultMode::execute() {
-	_state.recordTime = std::chrono::system_clock::now();		// Get a consistent time for everything in this invocation
+	_state.recordTime = BoatClock::now();		// Get a consistent time for everything in this invocation
 	if (!callCount) {						// Execute only on the first invocation... 
 		LOG(ERROR) << "Entering fault mode with faults: [" << _state.getFaultString() << "]";
 		_state.relays->get("DISARM")->set();
@@ -226,7 +241,7 @@ BoatModeBase* BoatFaultMode::execute() {
 }
 
 BoatModeBase* BoatNavigationMode::execute() {
-	_state.recordTime = std::chrono::system_clock::now();		// Get a consistent time for everything in this invocation
+	_state.recordTime = BoatClock::now();		// Get a consistent time for everything in this invocation
 	
 	if (this->callCount == 0) {				// Some housekeeping is in order if we just started up... 
 		LOG(INFO) << "Starting Navigation mode with submode " << _state.navModeNames.get(_state.getNavMode());
@@ -251,9 +266,12 @@ BoatModeBase* BoatNavigationMode::execute() {
 	} 
 	
 	// execute the current nav mode
-	_oldNavMode = _navMode;
-	_navMode = _navMode->execute();
-	if (_navMode != _oldNavMode) REMOVE(_oldNavMode);
+	{
+		StageTimer t(CycleStageEnum::NAV_MODE);
+		_oldNavMode = _navMode;
+		_navMode = _navMode->execute();
+		if (_navMode != _oldNavMode) REMOVE(_oldNavMode);
+	}
 
 	// check the battery
 	if (_state.health->batteryMon < Conf::get()->lowBatCutoffVolt()) {
@@ -283,7 +301,7 @@ BoatModeBase* BoatArmedTestMode::execute() {
 }
 
 BoatModeBase* BoatLowBatteryMode::execute() {
-	_state.recordTime = std::chrono::system_clock::now();		// Get a consistent time for everything in this invocation
+	_state.recordTime = BoatClock::now();		// Get a consistent time for everything in this invocation
 	
 	if (this->callCount == 0) {				// Some housekeeping is in order if we just started up... 
 		LOG(INFO) << "Starting low battery mode with voltage " << _state.health->batteryMon << "V";
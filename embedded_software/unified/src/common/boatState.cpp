@@ -12,6 +12,7 @@
 #include <string>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <list>
 #include "hackerboatRoot.hpp"
 #include "enumtable.hpp"
@@ -28,14 +29,20 @@
 #include "hal/RCinput.hpp"
 #include "hal/gpsdInput.hpp"
 #include "boatState.hpp"
+#include "boatClock.hpp"
 #include "easylogging++.h"
 #include "util.hpp"
+#include "cycleProfiler.hpp"
+#include "csvWriter.hpp"
+#include "pool.hpp"
 
 using namespace std;
 using namespace rapidjson;
 
 #define MAKE_FUNC(func) { #func, std::function<bool(Value&, BoatState*)>( Command::func ) }
 
+static FixedPool<sizeof(Command), COMMAND_POOL_SIZE> commandPool;
+
 BoatState::BoatState () {
 	VLOG(2) << "Creating new BoatState object";
 	relays = RelayMap::instance();
@@ -62,7 +69,9 @@ BoatState::BoatState () {
 	K = {Conf::get()->pidKp(), Conf::get()->pidKi(), Conf::get()->pidKd()};
 }
 
-bool BoatState::insertFault (const string fault) {
+// Faults are named by literals, which are searched for in place rather than made into strings, so
+// that the checks each mode runs every cycle don't go to the heap
+bool BoatState::insertFault (const char *fault) {
 	if (!this->hasFault(fault)) {
 		if (this->faultCount()) faultString += ":";
 		faultString += fault;
@@ -71,17 +80,17 @@ bool BoatState::insertFault (const string fault) {
 	return true;
 }
 
-bool BoatState::hasFault (const string fault) const {
+bool BoatState::hasFault (const char *fault) const {
 	if (faultString.find(fault) != std::string::npos) return true;
 	return false;
 }
 
-bool BoatState::removeFault (const string fault) {
+bool BoatState::removeFault (const char *fault) {
 	size_t index;
 	index = faultString.find(fault);
 	if (index != std::string::npos) {
 		if (index > 0) index--;
-		faultString.erase(index, fault.length() + 1);	// captures the leading colon
+		faultString.erase(index, strlen(fault) + 1);	// captures the leading colon
 		LOG(INFO) << "Removing fault " << fault;
 		return true;
 	} else return false;
@@ -146,85 +155,96 @@ bool BoatState::isValid() {
 	return result;
 }
 
-Value BoatState::pack () const {
-	Value d;
-	int p = 0;
+template <typename Handler>
+bool BoatState::write (Handler& handler) const {
+	SizeType members = 0;
+	auto key = [&handler, &members] (const char *name) {members++; return handler.Key(name, strlen(name), false);};
+	bool result = handler.StartObject() && writeFieldMembers(fields, this, handler, members);
 
-	p += PutVar("recordTime", HackerboatState::packTime(this->recordTime), d);
-	p += PutVar("lastContact", HackerboatState::packTime(this->lastContact), d);
-	p += PutVar("lastRC", HackerboatState::packTime(this->lastRC), d);
-	p += PutVar("lastFix", this->lastFix.pack(), d);
-	p += PutVar("launchPoint", this->launchPoint.pack(), d);
-	p += PutVar("faultString", this->faultString, d);
-	p += PutVar("boatMode", boatModeNames.get(this->_boat), d);
-	p += PutVar("navMode", navModeNames.get(this->_nav), d);
-	p += PutVar("autoMode", autoModeNames.get(this->_auto), d);
-	p += PutVar("rcMode", rcModeNames.get(this->_rc), d);
-	p += PutVar("disarmInput", this->disarmInput.getState(), d);
-	p += PutVar("armInput", this->armInput.getState(), d);
-	p += PutVar("servoEnable", this->servoEnable.getState(), d);
+	// Live readings, which aren't part of the stored state. Each is read before its key goes out, so one that throws is simply left out.
+	result = result && key("disarmInput") && writeFieldValue(FieldKind::BOOL, FieldValue(this->disarmInput.getState()), handler);
+	result = result && key("armInput") && writeFieldValue(FieldKind::BOOL, FieldValue(this->armInput.getState()), handler);
+	result = result && key("servoEnable") && writeFieldValue(FieldKind::BOOL, FieldValue(this->servoEnable.getState()), handler);
 	try {
-		if (throttle) p += PutVar("throttlePosition", throttle->getThrottle(), d);
+		if (throttle && result) {
+			FieldValue t((int64_t)throttle->getThrottle());
+			result = key("throttlePosition") && writeFieldValue(FieldKind::INT, t, handler);
+		}
 	} catch (...) {};
 	try {
-		if (rudder) p += PutVar("rudderPosition", rudder->read(), d);
+		if (rudder && result) {
+			FieldValue r(rudder->read());
+			result = key("rudderPosition") && writeFieldValue(FieldKind::DOUBLE, r, handler);
+		}
 	} catch (...) {};
 	try {
-		if (relays) p += PutVar("relays", this->relays->pack(), d);
+		if (relays && result) {
+			Value r = this->relays->pack();
+			result = key("relays") && r.Accept(handler);
+		}
 	} catch (...) {};
-	if (commandCnt()) {
-		Value cmdarray(kArrayType);
-		for (auto &x : cmdvec) {
-			cmdarray.PushBack(x->pack(), root.GetAllocator());
+	result = result && key("commands");
+	if (result && commandCnt()) {
+		result = handler.StartArray();
+		for (size_t i = 0; (i < cmdvec.size()) && result; i++) {
+			result = cmdvec[i]->pack().Accept(handler);
 		}
-		p += PutVar("commands", cmdarray, d);
-	} else {
-		p += PutVar("commands", d);
-	}
-	
+		result = result && handler.EndArray(cmdvec.size());
+	} else result = result && handler.Null();
 
-	return d;
+	return (result && handler.EndObject(members));
 }
 
-bool BoatState::parse (Value& d) {
-	string time, mode;
-	Value tmp;
-	bool result = true;
+bool BoatState::writeJSON (JSONWriter& writer) const {
+	return write(writer);
+}
+
+Value BoatState::pack () const {
+	return buildValue([this] (FieldDocument& d) {return write(d);});
+}
 
-	result &= GetVar("faultString", faultString, d);
-	result &= GetVar("boatMode", mode, d);
-	result &= boatModeNames.get(mode, &(this->_boat));
-	result &= GetVar("navMode", mode, d);
-	result &= navModeNames.get(mode, &(this->_nav));
-	result &= GetVar("autoMode", mode, d);
-	result &= autoModeNames.get(mode, &(this->_auto));
-	result &= GetVar("rcMode", mode, d);
-	result &= rcModeNames.get(mode, &(this->_rc));
-	result &= GetVar("recordTime", time, d);
-	result &= HackerboatState::parseTime(time, this->recordTime);
-	result &= GetVar("lastContact", time, d);
-	result &= HackerboatState::parseTime(time, this->lastContact);
-	result &= GetVar("lastRC", time, d);
-	result &= HackerboatState::parseTime(time, this->lastRC);
-	result &= GetVar("lastFix", tmp, d);
-	result &= this->lastFix.parse(tmp);
-	result &= GetVar("launchPoint", tmp, d);
-	result &= this->launchPoint.parse(tmp);
+bool BoatState::parse (Value& d) {
+	bool result = parseFields(fields, this, d);
 
 	LOG_IF(!result, ERROR) << "Parsing BoatState input failed: " << d;
 
 	return result;
 }
 
+const FieldDescriptor BoatState::fields[] = {
+	FIELD(TimeField, "recordTime", BoatState, recordTime),
+	FIELD(TimeField, "lastContact", BoatState, lastContact),
+	FIELD(TimeField, "lastRC", BoatState, lastRC),
+	FIELD(ObjectField, "lastFix", BoatState, lastFix),
+	FIELD(ObjectField, "launchPoint", BoatState, launchPoint),
+	FIELD(StringField, "faultString", BoatState, faultString),
+	ENUM_FIELD("boatMode", BoatState, _boat, BoatState::boatModeNames),
+	ENUM_FIELD("navMode", BoatState, _nav, BoatState::navModeNames),
+	ENUM_FIELD("autoMode", BoatState, _auto, BoatState::autoModeNames),
+	ENUM_FIELD("rcMode", BoatState, _rc, BoatState::rcModeNames),
+	FIELD_END
+};
+
 void BoatState::pushCmd (std::string name, const Value& args) {
+	if (cmdvec.full()) {
+		LOG(ERROR) << "Command queue full, dropping command " << name;
+		return;
+	}
 	try {
-		cmdvec.emplace_back(new Command(this, name, args));
+		cmdvec.push_back(new Command(this, name, args));
 	} catch (...) {
 		LOG(ERROR) << "Attempted to push invalid command " << name << " with arguments " << args;
 	}
 	LOG(DEBUG) << "Emplacing command [" << name << "] with arguments: " << args;
 }
 
+void BoatState::flushCmds () {
+	while (cmdvec.size()) {
+		delete cmdvec.front();
+		cmdvec.pop_front();
+	}
+}
+
 int BoatState::executeCmds (int num) {
 	if (num == 0) num = this->cmdvec.size();		// If we got a zero, eat everything
 	int result = 0;
@@ -235,10 +255,12 @@ int BoatState::executeCmds (int num) {
 				if (cmdvec.front()->execute()) result++;	// execute the command at the head of the queue
 			} catch (...) {
 				LOG(ERROR) << "Attempted to execute invalid command";
+				delete cmdvec.front();
 				cmdvec.pop_front();			// remove the head element
 				break;
 			}
 			LOG(DEBUG) << "Result: " << result;
+			delete cmdvec.front();
 			cmdvec.pop_front();			// remove the head element
 		}
 	}
@@ -281,56 +303,66 @@ Location BoatState::getCurrentTarget()  {
 	} else return Location();
 }								/**< Returns the current target location, or an invalid Location if there isn't one right now */
 
-std::string BoatState::getCSV() {
-	std::string csv;
-	csv =  HackerboatState::packTime(recordTime);
-	csv += ",";
-	csv += std::to_string(lastFix.fix.lat);
-	csv += ",";
-	csv += std::to_string(lastFix.fix.lon);
-	csv += ",";
-	csv += std::to_string(lastFix.track);
-	csv += ",";
-	csv += std::to_string(lastFix.speed);
-	csv += ",";
-	csv += GPSFix::NMEAModeNames.get(lastFix.mode);
-	csv += ",";
-	csv	+= this->printCurrentWaypointNum();
-	csv += ",";
-	csv += std::to_string(this->getCurrentTarget().lat);
-	csv += ",";
-	csv += std::to_string(this->getCurrentTarget().lon);
-	csv += ",";
-	csv += std::to_string(throttle->getThrottle());
-	csv += ",";
-	if (this->getCurrentTarget().isValid()) {
-		csv += std::to_string(lastFix.fix.bearing(this->getCurrentTarget()));
-	} else csv += "N/A";
-	csv += ",";
-	csv += std::to_string(rudder->readMicroseconds());
-	csv += ",";
-	csv += std::to_string(orient->getOrientation()->heading);
-	csv += ",";
-	csv += boatModeNames.get(getBoatMode());
-	csv += ",";
-	csv += navModeNames.get(getNavMode());
-	csv += ",";
-	csv += autoModeNames.get(getAutoMode());
-	csv += ",";
-	csv += rcModeNames.get(getRCMode());
-	csv += ",";
-	csv += std::to_string(adc->getRawValues()["mot_i"]);
-	csv += ",";
-	csv += std::to_string(adc->getRawValues()["battery_mon"]);
-	return csv;
+Location BoatState::getLegStart() {
+	unsigned int current = this->waypointList.current();
+	return (current > 0) ? this->waypointList.getWaypoint(current - 1) : this->launchPoint;
+}
+
+const NavSolution& BoatState::navTo (const Location& target, const Location& legStart) {
+	_navSolution.update((this->gps) ? this->gps->getFixSequence() : 0, this->lastFix.fix, target, legStart);
+	return _navSolution;
+}
+
+const NavSolution& BoatState::getNav () {
+	// the same leg the waypoint mode steers on, so the log gets the solution it already worked out
+	bool onLeg = (this->_nav == NavModeEnum::AUTONOMOUS) && (this->_auto == AutoModeEnum::WAYPOINT);
+	return navTo(getCurrentTarget(), onLeg ? getLegStart() : Location());
+}
+
+const CSVColumn<BoatState> BoatState::csvColumns[] = {
+	{ "Record Time", 0, [](BoatState& s, CSVWriter& out, int p) {out.time(s.recordTime);} },
+	{ "Lat", 7, [](BoatState& s, CSVWriter& out, int p) {out.number(s.lastFix.fix.lat, p);} },
+	{ "Lon", 7, [](BoatState& s, CSVWriter& out, int p) {out.number(s.lastFix.fix.lon, p);} },
+	{ "GPS Track (deg true)", 2, [](BoatState& s, CSVWriter& out, int p) {out.number(s.lastFix.track, p);} },
+	{ "Speed (m/s)", 2, [](BoatState& s, CSVWriter& out, int p) {out.number(s.lastFix.speed, p);} },
+	{ "Fix Type", 0, [](BoatState& s, CSVWriter& out, int p) {out.text(GPSFix::NMEAModeNames.get(s.lastFix.mode));} },
+	{ "Waypoint #", 0, [](BoatState& s, CSVWriter& out, int p) {out.text(s.printCurrentWaypointNum());} },
+	{ "Waypoint Lat", 7, [](BoatState& s, CSVWriter& out, int p) {out.number(s.getNav().target().lat, p);} },
+	{ "Waypoint Lon", 7, [](BoatState& s, CSVWriter& out, int p) {out.number(s.getNav().target().lon, p);} },
+	{ "Target Course (deg true)", 2, [](BoatState& s, CSVWriter& out, int p) {
+		const NavSolution& nav = s.getNav();
+		if (nav.target().isValid()) {
+			out.number(nav.bearing(), p);
+		} else out.text("N/A");
+	} },
+	{ "Throttle Position", 0, [](BoatState& s, CSVWriter& out, int p) {out.integer(s.throttle->getThrottle());} },
+	{ "Rudder Command (ms)", 0, [](BoatState& s, CSVWriter& out, int p) {out.integer(s.rudder->readMicroseconds());} },
+	{ "Current Heading (deg mag)", 2, [](BoatState& s, CSVWriter& out, int p) {out.number(s.orient->getOrientation().heading, p);} },
+	{ "Boat Mode", 0, [](BoatState& s, CSVWriter& out, int p) {out.text(boatModeNames.get(s.getBoatMode()));} },
+	{ "Nav Mode", 0, [](BoatState& s, CSVWriter& out, int p) {out.text(navModeNames.get(s.getNavMode()));} },
+	{ "Auto Mode", 0, [](BoatState& s, CSVWriter& out, int p) {out.text(autoModeNames.get(s.getAutoMode()));} },
+	{ "RC Mode", 0, [](BoatState& s, CSVWriter& out, int p) {out.text(rcModeNames.get(s.getRCMode()));} },
+	{ "Raw Motor Current", 0, [](BoatState& s, CSVWriter& out, int p) {out.integer(s.adc->getRawValue("mot_i"));} },
+	{ "Raw Battery Voltage", 0, [](BoatState& s, CSVWriter& out, int p) {out.integer(s.adc->getRawValue("battery_mon"));} },
+	{ "Target Distance (m)", 1, [](BoatState& s, CSVWriter& out, int p) {out.number(s.getNav().distance(), p);} },
+	{ "Cross Track (m)", 1, [](BoatState& s, CSVWriter& out, int p) {out.number(s.getNav().crossTrack(), p);} },
+	CSV_END
+};
+
+const char* BoatState::getCSV() {
+	CSVWriter out(_csvLine, sizeof(_csvLine));
+	if (!writeCSVRow(csvColumns, *this, out)) {
+		LOG_EVERY_N(100, WARNING) << "CSV line too long, dropping it";
+		return "";
+	}
+	return out.line();
 }
 
 std::string BoatState::getCSVheaders() {
-	std::string headers;
-	headers = "Record Time, Lat, Lon, GPS Track (deg true), Speed (m/s),Fix Type, Waypoint #,Waypoint Lat,Waypoint Lon, Target Course, ";
-	headers += "Throttle Position,Rudder Command (ms),Current Heading (deg mag),Boat Mode, Nav Mode, Auto Mode, ";
-	headers += "RC Mode, Raw Motor Current, Raw Battery Voltage";
-	return headers;
+	char headers[CSV_LINE_SIZE];
+	CSVWriter out(headers, sizeof(headers));
+	writeCSVHeaders(csvColumns, out);
+	return std::string(out.line(), out.size());
 }
 
 ArmButtonStateEnum BoatState::getArmState () {
@@ -360,9 +392,9 @@ ArmButtonStateEnum BoatState::getArmState () {
 			LOG(WARNING) << "Arm and disarm inputs are equal: " << std::to_string(armval);
 			return ArmButtonStateEnum::INVALID;
 		}
-		sysclock now = std::chrono::system_clock::now();
-		if (disarmval > 0) disarmedStart = std::chrono::system_clock::now();
-		if (armval > 0) armedStart = std::chrono::system_clock::now();
+		sysclock now = BoatClock::now();
+		if (disarmval > 0) disarmedStart = BoatClock::now();
+		if (armval > 0) armedStart = BoatClock::now();
 		if ((disarmval == 0) && ((now - disarmedStart) > 500ms)) {
 			buttonArmed = false;
 			return ArmButtonStateEnum::DISARM;
@@ -377,8 +409,8 @@ ArmButtonStateEnum BoatState::getArmState () {
 }
 
 Command::Command (BoatState *state, const string cmd, const Value& args) :
-	_state(state), _cmd(cmd), root() {
-		_args.CopyFrom(args, root.GetAllocator());
+	_state(state), _cmd(cmd) {
+		_args.CopyFrom(args, _argAlloc);
 		this->_funcs.at(_cmd);	// force an exception on an invalid command name
 	};
 
@@ -388,10 +420,22 @@ Command::Command (BoatState *state, const string cmd) :
 	};
 
 bool Command::execute () {
-	function<bool(Value&, BoatState*)> cmd = this->_funcs.at(_cmd);
+	const function<bool(Value&, BoatState*)>& cmd = this->_funcs.at(_cmd);
 	return cmd(_args, _state);
 }
 
+void* Command::operator new (size_t size) {
+	return commandPool.allocateOrNew(size);
+}
+
+void Command::operator delete (void *p) {
+	commandPool.releaseOrDelete(p);
+}
+
+size_t Command::poolInUse () {
+	return commandPool.inUse();
+}
+
 Value Command::pack () const {
 	Value d;
 	int p = 0;
@@ -581,6 +625,23 @@ bool Command::SetPID(Value& args, BoatState *state) {
 	return result;
 }
 
+bool Command::DumpStats(Value& args, BoatState *state) {
+	if (!state) {
+		LOG(WARNING) << "DumpStats command called without valid BoatState pointer";
+		return false;
+	}
+	std::string stats = CycleProfiler::get()->report(state->executive);
+	LOG(INFO) << "Stats," << stats;
+	CycleProfiler::get()->postReply(stats);
+	bool reset = false;
+	if (args.IsObject() && HackerboatState::GetVar("reset", reset, args) && reset) {
+		LOG(INFO) << "Resetting cycle statistics";
+		CycleProfiler::get()->reset();
+		if (state->executive) state->executive->resetStats();
+	}
+	return true;
+}
+
 std::ostream& operator<< (std::ostream& stream, const Command& cmd) {
 	Value json;
 	json = cmd.pack();
@@ -606,7 +667,8 @@ const map<std::string, std::function<bool(Value&, BoatState*)>> Command::_funcs
 	MAKE_FUNC(DumpAIS),
 	MAKE_FUNC(FetchWaypoints),
 	MAKE_FUNC(PushPath),
-	MAKE_FUNC(SetPID)
+	MAKE_FUNC(SetPID),
+	MAKE_FUNC(DumpStats)
 };
 
 const EnumNameTable<BoatModeEnum> BoatState::boatModeNames = {
@@ -75,6 +75,14 @@ int Conf::Fetch(const string& name, sysdur& duration) {
 	return 0;
 }
 
+int Conf::Fetch(const string& name, bool& target) {
+	if (d.HasMember(name.c_str()) && d[name.c_str()].IsBool()) {
+		target = d[name.c_str()].GetBool();
+		return 1;
+	}
+	return 0;
+}
+
 int Conf::Fetch(const string& name, Value& v) {
 	if (d.HasMember(name.c_str()) && d[name.c_str()].IsObject()) {
 		v = d[name.c_str()].GetObject();
@@ -158,8 +166,9 @@ Conf::Conf () {
 	_restTimeout		= (200ms);
 	_restMaxBuf			= (50000);
 	_restMaxCount		= (5000);
-	_wdFile				= "/tmp/watchdog";
-	_wdTimeout			= (30s);
+	_heartbeatName		= "/hackerboat-heartbeat";
+	_wdTimeout			= (500ms);
+	_wdCheckPeriod		= (20ms);
 	_relayInit			= { { "RED", { "RED", 8, 3, 8, 4 } },
 							{ "DIR", { "DIR", 8, 5, 8, 6 } }, 
 							{ "YLWWHT", { "YLWWHT", 8, 7, 8, 8 } }, 
@@ -171,7 +180,19 @@ Conf::Conf () {
 							{ "ENABLE", { "ENABLE", 8, 24, 8, 26 } } };
 	_RCchannelCount		= (18);
 	_aisMaxDistance		= (10000);
+	_aisRawNMEA			= true;
+	_approxMaxDistance	= (10000.0);
 	_selfTestDelay		= (30s);
+	_controlPeriod		= (100ms);
+	_controlOverrunPolicy = "Skip";
+	_inputMode			= "Event";
+	_inputEventTimeout	= (500ms);
+	_threadSchedule		= { { "AIO", { "Other", 10, -1 } },
+							{ "Recorder", { "Other", 5, -1 } } };	// real-time policies are opt-in, from the configuration file
+	_lockMemory			= false;
+	_recorderPath		= "/home/debian/logs/flight.rec";
+	_recorderSlots		= (4096);
+	_recorderSyncPeriod	= (1s);
 }
 
 int Conf::load (const string& file) {
@@ -239,11 +260,25 @@ int Conf::load (const string& file) {
 	result += Fetch("REST Timeout", _restTimeout);
 	result += Fetch("REST Max Buffer Size", _restMaxBuf);
 	result += Fetch("REST Max Count", _restMaxCount);
-	result += Fetch("Watchdog File", _wdFile);
+	result += Fetch("Heartbeat Name", _heartbeatName);
 	result += Fetch("Watchdog Timeout", _wdTimeout);
+	result += Fetch("Watchdog Check Period", _wdCheckPeriod);
 	result += Fetch("RC Channel Count", _RCchannelCount);
 	result += Fetch("AIS Max Distance", _aisMaxDistance);
+	result += Fetch("AIS Raw NMEA", _aisRawNMEA);
+	result += Fetch("Approximate Course Max Distance", _approxMaxDistance);
 	result += Fetch("Self Test Period", _selfTestDelay);
+	result += Fetch("Control Period", _controlPeriod);
+	result += Fetch("Control Overrun Policy", _controlOverrunPolicy);
+	result += Fetch("Input Mode", _inputMode);
+	result += Fetch("Input Event Timeout", _inputEventTimeout);
+	result += Fetch("Lock Memory", _lockMemory);
+	result += Fetch("Recorder Path", _recorderPath);
+	result += Fetch("Recorder Slots", _recorderSlots);
+	result += Fetch("Recorder Sync Period", _recorderSyncPeriod);
+	if (d.HasMember("Watchdog File")) {
+		cerr << "Configuration: \"Watchdog File\" is no longer used; the watchdog follows the shared-memory heartbeat named by \"Heartbeat Name\"" << endl;
+	}
 	if (Fetch("IMU Magnetic Offset", v) && v.IsArray() && (v.Size() >= 3)) {
 		_imuMagOffset = make_tuple(v[0].GetInt(), v[1].GetInt(), v[2].GetInt());
 		result++;
@@ -282,6 +317,18 @@ int Conf::load (const string& file) {
 		}
 		result++;
 	}
+	if (Fetch("Thread Schedule", v) && v.IsObject()) {
+		for (auto& itr : v.GetObject()) {
+			if (itr.value.IsObject() && itr.value.HasMember("Policy") && itr.value["Policy"].IsString()) {
+				int priority = 0;
+				int cpu = -1;
+				if (itr.value.HasMember("Priority") && itr.value["Priority"].IsInt()) priority = itr.value["Priority"].GetInt();
+				if (itr.value.HasMember("CPU") && itr.value["CPU"].IsInt()) cpu = itr.value["CPU"].GetInt();
+				_threadSchedule[itr.name.GetString()] = make_tuple(string(itr.value["Policy"].GetString()), priority, cpu);
+			}
+		}
+		result++;
+	}
 	if (Fetch("REST Configuration", v) && v.IsObject()) {
 		for (auto& itr : v.GetObject()) {
 			if (itr.value.IsString()) {
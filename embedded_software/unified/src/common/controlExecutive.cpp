@@ -0,0 +1,198 @@
+/******************************************************************************
+ * Hackerboat control executive module
+ * controlExecutive.cpp
+ * This module paces the master control loop off the monotonic clock
+ *
+ * See the Hackerboat documentation for more details
+ * Written by agent, Oct 2026
+ *
+ * Version 0.1: First alpha
+ *
+ ******************************************************************************/
+
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <string>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/timerfd.h>
+#include "hackerboatRoot.hpp"
+#include "enumtable.hpp"
+#include "enumdefs.hpp"
+#include "controlExecutive.hpp"
+#include "configuration.hpp"
+#include "easylogging++.h"
+
+using namespace std;
+using namespace std::chrono;
+
+ControlExecutive::ControlExecutive () :
+	_period(duration_cast<nanoseconds>(Conf::get()->controlPeriod())),
+	_policy(OverrunPolicyEnum::SKIP) {
+	if (!overrunPolicyNames.get(Conf::get()->controlOverrunPolicy(), &_policy) ||
+		(_policy == OverrunPolicyEnum::NONE)) {
+		LOG(WARNING) << "Unknown control overrun policy " << Conf::get()->controlOverrunPolicy() << ", using Skip";
+		_policy = OverrunPolicyEnum::SKIP;
+	}
+}
+
+ControlExecutive::ControlExecutive (nanoseconds period, OverrunPolicyEnum policy) :
+	_period(period), _policy(policy) {
+	if (_policy == OverrunPolicyEnum::NONE) _policy = OverrunPolicyEnum::SKIP;
+}
+
+ControlExecutive::~ControlExecutive () {
+	if (_timerfd >= 0) close(_timerfd);
+}
+
+bool ControlExecutive::begin () {
+	if (_period <= nanoseconds::zero()) {
+		LOG(ERROR) << "Control period must be positive";
+		return false;
+	}
+	_next = steady_clock::now() + _period;
+	_started = false;
+	_timed = false;
+	_owed = 0;
+
+	// steady_clock is CLOCK_MONOTONIC on Linux, so we can arm the timer on the same timeline
+	if (_timerfd < 0) _timerfd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+	if (_timerfd >= 0) {
+		struct itimerspec spec;
+		nanoseconds first = duration_cast<nanoseconds>(_next.time_since_epoch());
+		spec.it_value.tv_sec = first.count() / 1000000000;
+		spec.it_value.tv_nsec = first.count() % 1000000000;
+		spec.it_interval.tv_sec = _period.count() / 1000000000;
+		spec.it_interval.tv_nsec = _period.count() % 1000000000;
+		if (timerfd_settime(_timerfd, TFD_TIMER_ABSTIME, &spec, NULL) == 0) {
+			LOG(INFO) << "Control executive running every " << _period.count() << " ns on timerfd, overrun policy "
+					  << overrunPolicyNames.get(_policy);
+			return true;
+		}
+		LOG(ERROR) << "Unable to arm cycle timer: " << strerror(errno);
+		close(_timerfd);
+		_timerfd = -1;
+	} else {
+		LOG(ERROR) << "Unable to create cycle timer: " << strerror(errno);
+	}
+	LOG(WARNING) << "Control executive falling back to steady_clock sleeps";
+	return false;
+}
+
+uint64_t ControlExecutive::waitTicks () {
+	if (_timerfd >= 0) {
+		uint64_t expirations = 0;
+		ssize_t len;
+		do {
+			len = read(_timerfd, &expirations, sizeof(expirations));
+		} while ((len < 0) && (errno == EINTR));
+		if (len == sizeof(expirations)) return expirations;
+		LOG(ERROR) << "Cycle timer read failed: " << strerror(errno) << "; falling back to steady_clock sleeps";
+		close(_timerfd);
+		_timerfd = -1;
+	}
+	steady_clock::time_point now = steady_clock::now();
+	if (now < _next) {
+		std::this_thread::sleep_until(_next);
+		now = steady_clock::now();
+	}
+	return 1 + ((now - _next) / _period);
+}
+
+bool ControlExecutive::wait () {
+	steady_clock::time_point now = steady_clock::now();
+	bool ontime = true;
+
+	// book-keeping for the cycle that just finished
+	if (_started) {
+		int64_t exec = duration_cast<nanoseconds>(now - _cycleStart).count();
+		_lastExec = exec;
+		if (exec > _maxExec) _maxExec = exec;
+	}
+	_started = true;
+
+	// under the catch-up policy, owed cycles run immediately
+	if (_owed > 0) {
+		_owed--;
+		_caughtUp++;
+		_cycles++;
+		_cycleStart = now;
+		_timed = false;			// no deadline was waited for, so there's no jitter to report
+		return false;
+	}
+
+	uint64_t ticks = waitTicks();
+	now = steady_clock::now();
+	if (ticks < 1) ticks = 1;
+	steady_clock::time_point tick = _next + ((int64_t)(ticks - 1) * _period);	// the most recent tick
+	_next = tick + _period;
+
+	if (ticks > 1) {
+		ontime = false;
+		_overruns++;
+		uint64_t missed = ticks - 1;
+		if (_policy == OverrunPolicyEnum::CATCHUP) {
+			_owed = (missed > maxCatchUp) ? maxCatchUp : missed;
+			missed -= _owed;
+		}
+		_skipped += missed;
+		LOG_EVERY_N(10, WARNING) << "Control cycle overran by " << (ticks - 1) << " ticks; "
+								 << _overruns.load() << " overruns so far";
+	}
+
+	int64_t jitter = duration_cast<nanoseconds>(now - tick).count();
+	if (jitter < 0) jitter = 0;
+	_lastJitter = jitter;
+	if (jitter > _maxJitter) _maxJitter = jitter;
+	_jitterSum += jitter;
+	_jitterSamples++;
+	_cycles++;
+	_cycleStart = now;
+	_timed = true;
+	return ontime;
+}
+
+void ControlExecutive::resetStats () {
+	_cycles = 0;
+	_overruns = 0;
+	_skipped = 0;
+	_caughtUp = 0;
+	_jitterSamples = 0;
+	_jitterSum = 0;
+	_lastJitter = 0;
+	_maxJitter = 0;
+	_lastExec = 0;
+	_maxExec = 0;
+}
+
+nanoseconds ControlExecutive::meanJitter () const {
+	uint64_t samples = _jitterSamples.load();
+	if (samples == 0) return nanoseconds::zero();
+	return nanoseconds(_jitterSum.load() / (int64_t)samples);
+}
+
+Value ControlExecutive::pack () const {
+	Value d;
+	int packResult = 0;
+	packResult += PutVar("period", (double)duration_cast<microseconds>(_period).count(), d);
+	packResult += PutVar("policy", overrunPolicyNames.get(_policy), d);
+	packResult += PutVar("timerfd", (int)usingTimerFD(), d);
+	packResult += PutVar("cycles", (double)cycles(), d);
+	packResult += PutVar("overruns", (double)overruns(), d);
+	packResult += PutVar("skipped", (double)skipped(), d);
+	packResult += PutVar("caughtUp", (double)caughtUp(), d);
+	packResult += PutVar("lastJitter", (double)duration_cast<microseconds>(lastJitter()).count(), d);
+	packResult += PutVar("meanJitter", (double)duration_cast<microseconds>(meanJitter()).count(), d);
+	packResult += PutVar("maxJitter", (double)duration_cast<microseconds>(maxJitter()).count(), d);
+	packResult += PutVar("lastExecTime", (double)duration_cast<microseconds>(lastExecTime()).count(), d);
+	packResult += PutVar("maxExecTime", (double)duration_cast<microseconds>(maxExecTime()).count(), d);
+	return d;
+}
+
+const EnumNameTable<OverrunPolicyEnum> ControlExecutive::overrunPolicyNames = {
+	"Skip",
+	"CatchUp",
+	"None"
+};
@@ -0,0 +1,129 @@
+/******************************************************************************
+ * Hackerboat collision risk module
+ * cpa.cpp
+ * This module finds the closest point of approach to every AIS contact
+ * at once and ranks the contacts by how close they will come
+ *
+ * See the Hackerboat documentation for more details
+ * Written by agent, Oct 2026
+ *
+ * Version 0.1: First alpha
+ *
+ ******************************************************************************/
+
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <GeographicLib/Constants.hpp>
+#include "cpa.hpp"
+#include "lanes.hpp"
+#include "configuration.hpp"
+#include "easylogging++.h"
+
+#define CPA_METERS_PER_SECOND_PER_KNOT	(1852.0 / 3600.0)
+#define CPA_MIN_CLOSING_SQ				(1e-6)		/**< Square of the relative speed, in m/s, below which a contact is holding its distance */
+
+using namespace GeographicLib;
+
+static const double wgsA = Constants::WGS84_a();
+static const double wgsE2 = Constants::WGS84_f() * (2 - Constants::WGS84_f());
+
+/* Closest approach for count contacts, a multiple of BATCH_LANES, from their positions and velocities relative to us */
+static void cpaKernel (const float *north, const float *east, const float *velNorth, const float *velEast, size_t count,
+					   float horizon, float *cpa, float *tcpa, float *cpaNorth, float *cpaEast) {
+	const lanes zero = lset(0.0f);
+	const lanes minSq = lset(CPA_MIN_CLOSING_SQ);
+	const lanes limit = lset(horizon);
+	for (size_t i = 0; i < count; i += BATCH_LANES) {
+		lanes n = lload(north + i);
+		lanes e = lload(east + i);
+		lanes vn = lload(velNorth + i);
+		lanes ve = lload(velEast + i);
+		lanes closing = lsub(zero, ladd(lmul(n, vn), lmul(e, ve)));
+		lanes speedSq = lmax(ladd(lmul(vn, vn), lmul(ve, ve)), minSq);
+		lanes t = lmin(lmax(ldiv(closing, speedSq), zero), limit);	// a contact that's opening is closest now
+		lanes cn = ladd(n, lmul(vn, t));
+		lanes ce = ladd(e, lmul(ve, t));
+		lstore(tcpa + i, t);
+		lstore(cpaNorth + i, cn);
+		lstore(cpaEast + i, ce);
+		lstore(cpa + i, lsqrt(ladd(lmul(cn, cn), lmul(ce, ce))));
+	}
+}
+
+size_t CPAEngine::assess (const Location& here, double speed, double course, AISContactStore& contacts, sysclock now,
+						  size_t count, double horizon) {
+	_risks.clear();
+	_ships.clear();
+	_north.clear();
+	_east.clear();
+	_velNorth.clear();
+	_velEast.clear();
+	_assessed = 0;
+	if (!here.isValid()) return 0;
+
+	if (!isfinite(speed) || !isfinite(course)) {
+		speed = 0;
+		course = 0;
+	}
+	double ourNorth = speed * cos(TwoVector::deg2rad(course));
+	double ourEast = speed * sin(TwoVector::deg2rad(course));
+
+	const sysdur maxAge = Conf::get()->aisMaxTime();
+	contacts.forEach([&] (AISShip& ship) {
+		if (!ship.fix.isValid() || ((now - ship.lastTimeStamp) >= maxAge)) return;	// not yet expired from the store, but too old to trust
+		double vn = 0, ve = 0;
+		if (isfinite(ship.speed) && isfinite(ship.course)) {
+			vn = ship.speed * CPA_METERS_PER_SECOND_PER_KNOT * cos(TwoVector::deg2rad(ship.course));
+			ve = ship.speed * CPA_METERS_PER_SECOND_PER_KNOT * sin(TwoVector::deg2rad(ship.course));
+		}
+		double age = std::chrono::duration<double>(now - ship.lastTimeStamp).count();
+		// meters per radian of latitude and of longitude halfway to the contact
+		double mid = TwoVector::deg2rad((ship.fix.lat + here.lat) / 2);
+		double w = 1 - (wgsE2 * sin(mid) * sin(mid));
+		double meridian = (wgsA * (1 - wgsE2)) / (w * sqrt(w));
+		double parallel = (wgsA * cos(mid)) / sqrt(w);
+		_ships.push_back(&ship);
+		_north.push_back((TwoVector::deg2rad(ship.fix.lat - here.lat) * meridian) + (vn * age));
+		_east.push_back((TwoVector::deg2rad(remainder(ship.fix.lon - here.lon, 360.0)) * parallel) + (ve * age));
+		_velNorth.push_back(vn - ourNorth);
+		_velEast.push_back(ve - ourEast);
+	});
+	_assessed = _ships.size();
+	if (_assessed == 0) return 0;
+
+	size_t padded = ((_assessed + BATCH_LANES - 1) / BATCH_LANES) * BATCH_LANES;
+	_north.resize(padded, 0);
+	_east.resize(padded, 0);
+	_velNorth.resize(padded, 0);
+	_velEast.resize(padded, 0);
+	_cpa.resize(padded);
+	_tcpa.resize(padded);
+	_cpaNorth.resize(padded);
+	_cpaEast.resize(padded);
+	cpaKernel(_north.data(), _east.data(), _velNorth.data(), _velEast.data(), padded, horizon,
+			  _cpa.data(), _tcpa.data(), _cpaNorth.data(), _cpaEast.data());
+
+	// only the nearest few need to be in order
+	_order.resize(_assessed);
+	for (uint32_t i = 0; i < _assessed; i++) _order[i] = i;
+	count = std::min(count, _assessed);
+	std::partial_sort(_order.begin(), _order.begin() + count, _order.end(), [this] (uint32_t a, uint32_t b) {
+		return (_cpa[a] < _cpa[b]) || ((_cpa[a] == _cpa[b]) && (_tcpa[a] < _tcpa[b]));
+	});
+	_risks.resize(count);
+	for (size_t i = 0; i < count; i++) {
+		uint32_t k = _order[i];
+		CPARisk& r = _risks[i];
+		r.mmsi = _ships[k]->mmsi;
+		r.shiptype = _ships[k]->shiptype;
+		r.fix = _ships[k]->fix;
+		r.range = hypot(_north[k], _east[k]);
+		r.bearing = fmod(TwoVector::rad2deg(atan2(_east[k], _north[k])) + 360.0, 360.0);
+		r.cpa = _cpa[k];
+		r.tcpa = _tcpa[k];
+		r.offset = TwoVector(_cpaNorth[k], _cpaEast[k]);
+	}
+	VLOG(3) << "Assessed " << _assessed << " AIS contacts; nearest approach " << ((count) ? _risks[0].cpa : NAN) << " m";
+	return count;
+}
@@ -0,0 +1,194 @@
+/******************************************************************************
+ * Hackerboat CSV writer module
+ * csvWriter.cpp
+ * This module writes CSV lines straight into a caller-supplied buffer, with
+ * the columns and their headers described by a single static table
+ *
+ * See the Hackerboat documentation for more details
+ * Written by agent, Oct 2026
+ *
+ * Version 0.1: First alpha
+ *
+ ******************************************************************************/
+
+#include <cstddef>
+#include <cmath>
+#include <string.h>
+#include <inttypes.h>
+#include "rapidjson/internal/dtoa.h"
+#include "csvWriter.hpp"
+#include "hackerboatRoot.hpp"
+
+#define CSV_FIXED_LIMIT		(9007199254740992.0)	/**< 2^53; scaled values beyond this go to the Grisu2 form */
+
+static const double powersOfTen[CSV_MAX_PRECISION + 1] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9
+};
+
+// Write v in decimal, returning the end
+static char* putUnsigned (char *p, uint64_t v) {
+	char digits[20];
+	int n = 0;
+	do {
+		digits[n++] = '0' + (v % 10);
+		v /= 10;
+	} while (v);
+	while (n) *p++ = digits[--n];
+	return p;
+}
+
+size_t formatDouble (double v, int precision, char *buf) {
+	char *p = buf;
+	if (std::isnan(v)) {
+		memcpy(buf, "nan", 4);
+		return 3;
+	}
+	if (std::isinf(v)) {
+		if (v < 0) *p++ = '-';
+		memcpy(p, "inf", 4);
+		return (p - buf) + 3;
+	}
+	if (precision > CSV_MAX_PRECISION) precision = CSV_MAX_PRECISION;
+	if (precision >= 0) {
+		double scaled = std::round(std::fabs(v) * powersOfTen[precision]);
+		if (scaled < CSV_FIXED_LIMIT) {
+			uint64_t whole = static_cast<uint64_t>(scaled);
+			uint64_t scale = static_cast<uint64_t>(powersOfTen[precision]);
+			if ((v < 0) && whole) *p++ = '-';				// no sign when it rounds to zero
+			p = putUnsigned(p, whole / scale);
+			if (precision > 0) {
+				*p++ = '.';
+				uint64_t frac = whole % scale;
+				for (int i = precision - 1; i >= 0; i--) {
+					p[i] = '0' + (frac % 10);
+					frac /= 10;
+				}
+				p += precision;
+			}
+			*p = '\0';
+			return (p - buf);
+		}
+	}
+	p = rapidjson::internal::dtoa(v, buf);					// Grisu2, the same digits the json writer produces
+	*p = '\0';
+	return (p - buf);
+}
+
+CSVWriter::CSVWriter (char *buf, size_t len) : _buf(buf), _len(len) {
+	clear();
+}
+
+void CSVWriter::clear () {
+	_used = 0;
+	_full = (_len == 0);
+	_first = true;
+	if (_len) _buf[0] = '\0';
+}
+
+char* CSVWriter::field (size_t len) {
+	if (_full) return NULL;
+	size_t need = len + (_first ? 0 : 1) + 1;				// separator and terminator
+	if ((_len - _used) < need) {
+		_full = true;
+		return NULL;
+	}
+	char *p = _buf + _used;
+	if (!_first) *p++ = ',';
+	return p;
+}
+
+void CSVWriter::commit (char *end) {
+	*end = '\0';
+	_used = end - _buf;
+	_first = false;
+}
+
+CSVWriter& CSVWriter::number (double v, int precision) {
+	char num[CSV_NUMBER_SIZE];
+	size_t len = formatDouble(v, precision, num);
+	char *p = field(len);
+	if (p) {
+		memcpy(p, num, len);
+		commit(p + len);
+	}
+	return *this;
+}
+
+CSVWriter& CSVWriter::integer (int64_t v) {
+	char num[CSV_NUMBER_SIZE];
+	char *end = num;
+	if (v < 0) *end++ = '-';
+	end = putUnsigned(end, (v < 0) ? (0 - static_cast<uint64_t>(v)) : static_cast<uint64_t>(v));
+	size_t len = end - num;
+	char *p = field(len);
+	if (p) {
+		memcpy(p, num, len);
+		commit(p + len);
+	}
+	return *this;
+}
+
+CSVWriter& CSVWriter::text (const char *str, size_t len) {
+	size_t quotes = 0;
+	bool quote = false;
+	for (size_t i = 0; i < len; i++) {
+		if (str[i] == '"') quotes++;
+		if ((str[i] == ',') || (str[i] == '"') || (str[i] == '\n') || (str[i] == '\r')) quote = true;
+	}
+	char *p = field(quote ? (len + quotes + 2) : len);
+	if (!p) return *this;
+	if (quote) {
+		*p++ = '"';
+		for (size_t i = 0; i < len; i++) {
+			if (str[i] == '"') *p++ = '"';
+			*p++ = str[i];
+		}
+		*p++ = '"';
+	} else {
+		memcpy(p, str, len);
+		p += len;
+	}
+	commit(p);
+	return *this;
+}
+
+CSVWriter& CSVWriter::text (const char *str) {
+	return text(str, strlen(str));
+}
+
+const char* readCSVField (const char *p, const char *end, std::string& out) {
+	out.clear();
+	if ((p < end) && (*p == '"')) {
+		for (p++; p < end; p++) {
+			if (*p == '"') {
+				if (((p + 1) < end) && (p[1] == '"')) {
+					out += '"';
+					p++;
+				} else {
+					p++;
+					break;
+				}
+			} else out += *p;
+		}
+		while ((p < end) && (*p != ',')) p++;
+	} else {
+		const char *start = p;
+		while ((p < end) && (*p != ',')) p++;
+		out.assign(start, p - start);
+	}
+	return (p < end) ? (p + 1) : end;
+}
+
+CSVWriter& CSVWriter::time (std::chrono::system_clock::time_point t) {
+	char *p = field(TIME_STRING_SIZE - 1);
+	if (p) {
+		size_t len = HackerboatState::packTime(t, p, TIME_STRING_SIZE);
+		if (len) {
+			commit(p + len);
+		} else {
+			_buf[_used] = '\0';								// take back the separator
+			_full = true;
+		}
+	}
+	return *this;
+}
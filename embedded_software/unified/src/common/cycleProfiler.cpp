@@ -0,0 +1,167 @@
+/******************************************************************************
+ * Hackerboat cycle profiler module
+ * cycleProfiler.cpp
+ * This module keeps latency histograms for the stages of the control cycle
+ *
+ * See the Hackerboat documentation for more details
+ * Written by agent, Oct 2026
+ *
+ * Version 0.1: First alpha
+ *
+ ******************************************************************************/
+
+#include <chrono>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <sstream>
+#include "hackerboatRoot.hpp"
+#include "enumtable.hpp"
+#include "enumdefs.hpp"
+#include "controlExecutive.hpp"
+#include "cycleProfiler.hpp"
+#include "realtime.hpp"
+#include "easylogging++.h"
+
+using namespace std;
+using namespace std::chrono;
+
+LatencyHistogram::LatencyHistogram () {
+	reset();
+}
+
+int LatencyHistogram::bucketIndex (uint64_t us) {
+	if (us < subBuckets) return (int)us;
+	int msb = 63 - __builtin_clzll(us);						// position of the leading one, at least 2
+	int sub = (int)((us >> (msb - 2)) & (subBuckets - 1));	// the two bits below the leading one
+	int index = ((msb - 1) * subBuckets) + sub;
+	return (index < bucketCount) ? index : (bucketCount - 1);
+}
+
+uint64_t LatencyHistogram::bucketUpper (int index) {
+	if (index < subBuckets) return index;
+	int msb = (index / subBuckets) + 1;
+	uint64_t sub = index % subBuckets;
+	return ((subBuckets + sub + 1) << (msb - 2)) - 1;
+}
+
+void LatencyHistogram::record (nanoseconds sample) {
+	int64_t ns = sample.count();
+	if (ns < 0) ns = 0;
+	_buckets[bucketIndex(ns / 1000)].fetch_add(1, memory_order_relaxed);
+	_count.fetch_add(1, memory_order_relaxed);
+	_sum.fetch_add(ns, memory_order_relaxed);
+	uint64_t oldmax = _max.load(memory_order_relaxed);
+	while (((uint64_t)ns > oldmax) && !_max.compare_exchange_weak(oldmax, ns, memory_order_relaxed));
+}
+
+void LatencyHistogram::reset () {
+	for (int i = 0; i < bucketCount; i++) {
+		_buckets[i].store(0, memory_order_relaxed);
+	}
+	_count.store(0, memory_order_relaxed);
+	_sum.store(0, memory_order_relaxed);
+	_max.store(0, memory_order_relaxed);
+}
+
+nanoseconds LatencyHistogram::mean () const {
+	uint64_t cnt = count();
+	if (cnt == 0) return nanoseconds::zero();
+	return nanoseconds(_sum.load(memory_order_relaxed) / cnt);
+}
+
+nanoseconds LatencyHistogram::percentile (double p) const {
+	uint64_t cnt = 0;
+	uint64_t total = 0;
+	uint32_t snapshot[bucketCount];
+
+	// copy the buckets first so that the total we rank against matches what we walk
+	for (int i = 0; i < bucketCount; i++) {
+		snapshot[i] = _buckets[i].load(memory_order_relaxed);
+		total += snapshot[i];
+	}
+	if (total == 0) return nanoseconds::zero();
+	if (p < 0.0) p = 0.0;
+	if (p > 100.0) p = 100.0;
+	uint64_t rank = (uint64_t)((p / 100.0) * total);
+	if (rank < 1) rank = 1;
+	for (int i = 0; i < bucketCount; i++) {
+		cnt += snapshot[i];
+		if (cnt >= rank) {
+			if (i == (bucketCount - 1)) return max();			// the last bucket is open-ended
+			nanoseconds upper = microseconds(bucketUpper(i) + 1);
+			return (upper < max()) ? upper : max();
+		}
+	}
+	return max();
+}
+
+Value LatencyHistogram::pack () const {
+	Value d;
+	int packResult = 0;
+	packResult += PutVar("count", (double)count(), d);
+	packResult += PutVar("mean", (double)duration_cast<microseconds>(mean()).count(), d);
+	packResult += PutVar("p50", (double)duration_cast<microseconds>(percentile(50.0)).count(), d);
+	packResult += PutVar("p90", (double)duration_cast<microseconds>(percentile(90.0)).count(), d);
+	packResult += PutVar("p99", (double)duration_cast<microseconds>(percentile(99.0)).count(), d);
+	packResult += PutVar("max", (double)duration_cast<microseconds>(max()).count(), d);
+	return d;
+}
+
+void CycleProfiler::record (CycleStageEnum stage, nanoseconds sample) {
+	if (stage == CycleStageEnum::NONE) return;
+	_stages[static_cast<int>(stage)].record(sample);
+}
+
+void CycleProfiler::reset () {
+	for (auto &s : _stages) {
+		s.reset();
+	}
+}
+
+Value CycleProfiler::pack () const {
+	Value d;
+	int packResult = 0;
+	for (int i = 0; i < static_cast<int>(CycleStageEnum::NONE); i++) {
+		packResult += PutVar(stageNames.get(static_cast<CycleStageEnum>(i)), _stages[i].pack(), d);
+	}
+	return d;
+}
+
+std::string CycleProfiler::report (const ControlExecutive* executive) const {
+	Value d;
+	std::ostringstream out;
+	PutVar("stages", this->pack(), d);
+	if (executive) PutVar("executive", executive->pack(), d);
+	PutVar("wakeup", RealTime::get()->pack(), d);
+	out << d;
+	return out.str();
+}
+
+void CycleProfiler::postReply (const std::string& reply) {
+	std::lock_guard<std::mutex> guard(_replyLock);
+	_reply = reply;
+	_replyPending = true;
+}
+
+bool CycleProfiler::takeReply (std::string& reply) {
+	std::lock_guard<std::mutex> guard(_replyLock);
+	if (!_replyPending) return false;
+	reply = _reply;
+	_replyPending = false;
+	return true;
+}
+
+const EnumNameTable<CycleStageEnum> CycleProfiler::stageNames = {
+	"Input",
+	"Health",
+	"Commands",
+	"BoatMode",
+	"NavMode",
+	"SubMode",
+	"Log",
+	"Cycle",
+	"None"
+};
+
+CycleProfiler* CycleProfiler::_instance = new CycleProfiler();
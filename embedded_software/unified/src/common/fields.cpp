@@ -0,0 +1,131 @@
+/******************************************************************************
+ * Hackerboat field descriptor module
+ * fields.cpp
+ * This module describes the members of HackerboatState objects in static
+ * tables, so they can be written to and read from json without building
+ * intermediate rapidjson Values
+ *
+ * See the Hackerboat documentation for more details
+ * Written by agent, Oct 2026
+ *
+ * Version 0.1: First alpha
+ *
+ ******************************************************************************/
+
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <string.h>
+#include "hackerboatRoot.hpp"
+#include "fields.hpp"
+#include "rapidjson/rapidjson.h"
+#include "rapidjson/document.h"
+#include "rapidjson/reader.h"
+
+using namespace rapidjson;
+using namespace std;
+
+bool parseFieldTime (const FieldValue& value, sysclock& t) {
+	if (value.type == FieldValue::STRING) {
+		return HackerboatState::parseTime(value.s, value.len, t);
+	} else if (value.type == FieldValue::INT) {
+		t = sysclock(duration_cast<sysclock::duration>(milliseconds(value.i)));
+		return true;
+	}
+	return false;
+}
+
+size_t packFieldTime (int64_t ms, char *buf, size_t len) {
+	return HackerboatState::packTime(sysclock(duration_cast<sysclock::duration>(milliseconds(ms))), buf, len);
+}
+
+bool readFields (const FieldDescriptor *fields, void *obj, const char *json) {
+	Reader reader;
+	StringStream stream(json);
+	FieldReader handler(fields, obj);
+	return !reader.Parse(stream, handler).IsError();
+}
+
+FieldReader::FieldReader (const FieldDescriptor *fields, void *obj) {
+	_stack[0].fields = fields;
+	_stack[0].obj = obj;
+}
+
+bool FieldReader::value (const FieldValue& v) {
+	if (_skip) return true;
+	if (_depth < 0) return false;						// the top level has to be an object
+	const FieldDescriptor *f = _pending;
+	_pending = NULL;
+	if (!f) return true;								// unknown key
+	if (f->kind == FieldKind::OBJECT) return false;
+	return f->set(_stack[_depth].obj, v);
+}
+
+bool FieldReader::Null () {return value(FieldValue());}
+bool FieldReader::Bool (bool b) {return value(FieldValue(b));}
+bool FieldReader::Int (int i) {return value(FieldValue((int64_t)i));}
+bool FieldReader::Uint (unsigned u) {return value(FieldValue((int64_t)u));}
+bool FieldReader::Int64 (int64_t i) {return value(FieldValue(i));}
+bool FieldReader::Uint64 (uint64_t u) {
+	if (u > (uint64_t)INT64_MAX) return value(FieldValue((double)u));
+	return value(FieldValue((int64_t)u));
+}
+bool FieldReader::Double (double d) {return value(FieldValue(d));}
+bool FieldReader::String (const char *str, SizeType len, bool copy) {return value(FieldValue(str, len));}
+
+bool FieldReader::Key (const char *str, SizeType len, bool copy) {
+	if (_skip) return true;
+	_pending = NULL;
+	for (const FieldDescriptor *f = _stack[_depth].fields; f->name; f++) {
+		if ((strncmp(f->name, str, len) == 0) && (f->name[len] == '\0')) {
+			_pending = f;
+			break;
+		}
+	}
+	return true;
+}
+
+bool FieldReader::StartObject () {
+	if (_skip) {
+		_skip++;
+	} else if (_depth < 0) {
+		_depth = 0;
+	} else if (!_pending) {
+		_skip = 1;											// pass over an object we have no table for
+	} else if ((_pending->kind == FieldKind::OBJECT) && (_depth < (FIELD_MAX_DEPTH - 1))) {
+		_stack[_depth + 1].fields = _pending->fields;
+		_stack[_depth + 1].obj = _pending->child(_stack[_depth].obj);
+		_depth++;
+		_pending = NULL;
+	} else return false;
+	return true;
+}
+
+bool FieldReader::EndObject (SizeType members) {
+	if (_skip) {
+		_skip--;
+	} else _depth--;
+	return true;
+}
+
+bool FieldReader::StartArray () {
+	if (_depth < 0) return false;
+	if (!_skip && _pending) return false;					// none of our fields are arrays
+	_skip++;
+	return true;
+}
+
+bool FieldReader::EndArray (SizeType elements) {
+	_skip--;
+	return true;
+}
+
+bool HackerboatState::writeJSON (JSONWriter& writer) const {
+	return pack().Accept(writer);
+}
+
+bool HackerboatState::readJSON (const char *json) {
+	Document d;
+	d.Parse(json);
+	return (!d.HasParseError() && d.IsObject() && parse(d));
+}
@@ -0,0 +1,419 @@
+/******************************************************************************
+ * Hackerboat flight recorder module
+ * flightRecorder.cpp
+ * This module records the boat's state every control cycle into a
+ * preallocated, memory mapped ring file that survives crashes and can be
+ * read while it is being written
+ *
+ * See the Hackerboat documentation for more details
+ * Written by agent, Oct 2026
+ *
+ * Version 0.1: First alpha
+ *
+ ******************************************************************************/
+
+#include <atomic>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <vector>
+#include <errno.h>
+#include <string.h>
+#include "hackerboatRoot.hpp"
+#include "configuration.hpp"
+#include "realtime.hpp"
+#include "boatClock.hpp"
+#include "boatState.hpp"
+#include "flightRecorder.hpp"
+#include "easylogging++.h"
+extern "C" {
+	#include <sys/types.h>
+	#include <sys/stat.h>
+	#include <sys/mman.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <stdio.h>
+}
+
+using namespace rapidjson;
+using namespace std;
+using namespace std::chrono;
+
+static_assert(sizeof(RecorderFileHeader) <= RECORDER_HEADER_SIZE, "Recorder file header doesn't fit");
+static_assert((sizeof(RecorderSlotHeader) % 8) == 0, "Recorder slot header must keep the records aligned");
+
+namespace {
+	struct CRCTable {
+		uint32_t	entry[256];
+		CRCTable () {
+			for (uint32_t i = 0; i < 256; i++) {
+				uint32_t c = i;
+				for (int k = 0; k < 8; k++) c = (c & 1) ? (0xEDB88320 ^ (c >> 1)) : (c >> 1);
+				entry[i] = c;
+			}
+		};
+	};
+
+	const CRCTable crcTable;
+
+	// CRC of everything in a slot but the sequence number and the CRC itself
+	uint32_t slotCRC (const RecorderSlotHeader *slot, const uint8_t *payload, uint32_t length) {
+		uint32_t crc = recorderCRC(0, &slot->time, sizeof(slot->time));
+		crc = recorderCRC(crc, &length, sizeof(length));
+		return recorderCRC(crc, payload, length);
+	}
+
+	// Slot seq goes in, out of the slots starting at first
+	RecorderSlotHeader* slotAt (uint8_t *first, uint64_t slots, uint64_t seq) {
+		return reinterpret_cast<RecorderSlotHeader*>(first + (((seq - 1) % slots) * RECORDER_SLOT_SIZE));
+	}
+
+	bool intact (const RecorderFileHeader *header, size_t size) {
+		return ((memcmp(header->magic, RECORDER_MAGIC, sizeof(header->magic)) == 0) &&
+				(header->version == RECORDER_VERSION) &&
+				(header->slotSize == RECORDER_SLOT_SIZE) &&
+				(header->slots > 0) &&
+				(size >= (RECORDER_HEADER_SIZE + (header->slots * RECORDER_SLOT_SIZE))) &&
+				(header->next.load() > 0));
+	}
+
+	// First of path.1, path.2 ... that doesn't exist yet, or empty if they all do
+	std::string keptPath (const std::string& path) {
+		for (int i = 1; i < 1000; i++) {
+			std::string kept = path + "." + std::to_string(i);
+			if (access(kept.c_str(), F_OK) != 0) return kept;
+		}
+		return "";
+	}
+}
+
+uint32_t recorderCRC (uint32_t crc, const void *data, size_t len) {
+	const uint8_t *p = static_cast<const uint8_t*>(data);
+	crc = ~crc;
+	while (len--) crc = crcTable.entry[(crc ^ *p++) & 0xff] ^ (crc >> 8);
+	return ~crc;
+}
+
+bool FlightRecorder::open (const std::string& path, uint64_t slots, sysdur syncPeriod) {
+	struct stat fileStatus;
+	alignas(RecorderFileHeader) uint8_t raw[sizeof(RecorderFileHeader)];
+	const RecorderFileHeader *old = reinterpret_cast<const RecorderFileHeader*>(raw);
+	if (_header) return true;
+	if (slots == 0) return false;
+	_size = RECORDER_HEADER_SIZE + (slots * RECORDER_SLOT_SIZE);
+	_fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+	if (_fd < 0) {
+		LOG(ERROR) << "Unable to open flight recorder " << path << ": " << strerror(errno);
+		return false;
+	}
+	bool ours = ((fstat(_fd, &fileStatus) == 0) &&
+				 (pread(_fd, raw, sizeof(raw), 0) == (ssize_t)sizeof(raw)) &&
+				 (memcmp(old->magic, RECORDER_MAGIC, sizeof(old->magic)) == 0));
+	bool reopen = (ours && intact(old, fileStatus.st_size) && (old->slots == slots));
+	if (ours && !reopen) {
+		// an earlier flight in a shape we can't carry on with; move it out of the way rather than lose it
+		::close(_fd);
+		_fd = -1;
+		std::string kept = keptPath(path);
+		if (kept.empty() || (rename(path.c_str(), kept.c_str()) != 0)) {
+			LOG(ERROR) << "Flight recorder " << path << " doesn't match the configuration and can't be moved aside";
+			return false;
+		}
+		LOG(WARNING) << "Flight recorder " << path << " doesn't match the configuration, kept it as " << kept;
+		_fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+		if (_fd < 0) {
+			LOG(ERROR) << "Unable to open flight recorder " << path << ": " << strerror(errno);
+			return false;
+		}
+	}
+	// a new file reads back as zeros without our writing them, and allocating every block now means that
+	// writing a frame can never run the disk out of space
+	int err = (reopen || (ftruncate(_fd, 0) == 0)) ? posix_fallocate(_fd, 0, _size) : errno;
+	if (err != 0) {
+		LOG(ERROR) << "Unable to allocate flight recorder " << path << ": " << strerror(err);
+		::close(_fd);
+		_fd = -1;
+		return false;
+	}
+	void *mem = mmap(NULL, _size, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+	if (mem == MAP_FAILED) {
+		LOG(ERROR) << "Unable to map flight recorder " << path << ": " << strerror(errno);
+		::close(_fd);
+		_fd = -1;
+		return false;
+	}
+	_base = static_cast<uint8_t*>(mem);
+	_header = reinterpret_cast<RecorderFileHeader*>(_base);
+	if (reopen) {
+		LOG(INFO) << "Reopened flight recorder " << path << " at frame " << _header->next.load();
+	} else {
+		memcpy(_header->magic, RECORDER_MAGIC, sizeof(_header->magic));
+		_header->version = RECORDER_VERSION;
+		_header->slotSize = RECORDER_SLOT_SIZE;
+		_header->slots = slots;
+		_header->next.store(1, memory_order_release);
+		msync(_base, RECORDER_HEADER_SIZE, MS_SYNC);
+		LOG(INFO) << "Created flight recorder " << path << " with " << slots << " slots";
+	}
+	_ring.assign(RECORDER_RING_SLOTS * RECORDER_SLOT_SIZE, 0);
+	_slot = NULL;
+	_next = _header->next.load(memory_order_relaxed);
+	_committed.store(_next);
+	_copied.store(_next);
+	_truncated = 0;
+	_lost.store(0);
+	_stopping = false;
+	_syncer = std::thread(&FlightRecorder::syncThread, this, syncPeriod);
+	return true;
+}
+
+void FlightRecorder::close () {
+	if (_syncer.joinable()) {
+		{
+			lock_guard<mutex> guard(_syncLock);
+			_stopping = true;
+		}
+		_syncWake.notify_all();
+		_syncer.join();
+	}
+	if (_base) {
+		{
+			lock_guard<mutex> guard(_copyLock);
+			copyFrames();
+		}
+		msync(_base, _size, MS_SYNC);
+		munmap(_base, _size);
+	}
+	if (_fd >= 0) ::close(_fd);
+	_fd = -1;
+	_base = NULL;
+	_header = NULL;
+	_slot = NULL;
+}
+
+bool FlightRecorder::begin () {
+	if (!_header) return false;
+	_seq = _next;
+	_slot = slotAt(_ring.data(), RECORDER_RING_SLOTS, _seq);
+	// mark the slot before touching it, so the copy never takes the old frame for a finished one
+	_slot->seq.store(RECORDER_BUSY, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+	_slot->time = duration_cast<milliseconds>(BoatClock::now().time_since_epoch()).count();
+	_used = 0;
+	return true;
+}
+
+bool FlightRecorder::append (const HackerboatState& state) {
+	if (!_slot) return false;
+	uint8_t *payload = reinterpret_cast<uint8_t*>(_slot + 1);
+	size_t len = state.writeRecord(payload + _used, RECORDER_FRAME_SIZE - _used);
+	if (len == 0) {
+		_truncated++;
+		return false;
+	}
+	_used += len;
+	return true;
+}
+
+bool FlightRecorder::commit () {
+	if (!_slot) return false;
+	const uint8_t *payload = reinterpret_cast<const uint8_t*>(_slot + 1);
+	_slot->length = _used;
+	_slot->crc = slotCRC(_slot, payload, _used);
+	_slot->seq.store(_seq, memory_order_release);
+	_next = _seq + 1;
+	_committed.store(_next, memory_order_release);
+	_slot = NULL;
+	// not under _syncLock, so the control thread never waits on the copy; a wakeup that races the copy
+	// going back to sleep is picked up when its wait times out
+	_syncWake.notify_one();
+	return true;
+}
+
+bool FlightRecorder::sync () {
+	if (!_base) return false;
+	{
+		lock_guard<mutex> guard(_copyLock);
+		copyFrames();
+	}
+	return (msync(_base, _size, MS_SYNC) == 0);
+}
+
+uint64_t FlightRecorder::next () const {
+	if (!_header) return 0;
+	return _next;
+}
+
+void FlightRecorder::copyFrames () {
+	uint8_t payload[RECORDER_FRAME_SIZE];
+	uint64_t end = _committed.load(memory_order_acquire);
+	uint64_t seq = _copied.load(memory_order_relaxed);
+	uint64_t missed = 0;
+	if ((end - seq) > RECORDER_RING_SLOTS) {				// the control thread has come around the ring on us
+		missed += (end - RECORDER_RING_SLOTS) - seq;
+		seq = end - RECORDER_RING_SLOTS;
+	}
+	for (; seq < end; seq++) {
+		// read the ring slot the way a reader reads the file, in case the control thread is rewriting it
+		const RecorderSlotHeader *from = slotAt(_ring.data(), RECORDER_RING_SLOTS, seq);
+		if (from->seq.load(memory_order_acquire) != seq) {
+			missed++;
+			continue;
+		}
+		int64_t time = from->time;
+		uint32_t length = from->length;
+		uint32_t crc = from->crc;
+		if (length > RECORDER_FRAME_SIZE) length = RECORDER_FRAME_SIZE;		// torn, which the check below catches
+		memcpy(payload, from + 1, length);
+		atomic_thread_fence(memory_order_acquire);
+		if (from->seq.load(memory_order_relaxed) != seq) {
+			missed++;
+			continue;
+		}
+		RecorderSlotHeader *to = slotAt(_base + RECORDER_HEADER_SIZE, _header->slots, seq);
+		to->seq.store(RECORDER_BUSY, memory_order_relaxed);
+		atomic_thread_fence(memory_order_release);
+		to->time = time;
+		to->length = length;
+		to->crc = crc;
+		memcpy(to + 1, payload, length);
+		to->seq.store(seq, memory_order_release);
+		_header->next.store(seq + 1, memory_order_release);
+	}
+	if (_header->next.load(memory_order_relaxed) < end) _header->next.store(end, memory_order_release);
+	_copied.store(end, memory_order_relaxed);
+	if (missed > 0) {
+		_lost.fetch_add(missed, memory_order_relaxed);
+		LOG_EVERY_N(100, WARNING) << "Flight recorder copy fell behind, lost " << missed << " frames";
+	}
+}
+
+void FlightRecorder::syncThread (sysdur period) {
+	if (RealTime::get()) RealTime::get()->configureThread("Recorder");
+	auto lastSync = steady_clock::now();
+	unique_lock<mutex> guard(_syncLock);
+	while (!_stopping) {
+		_syncWake.wait_for(guard, period, [this] {
+			return (_stopping || (_committed.load(memory_order_acquire) != _copied.load(memory_order_relaxed)));
+		});
+		if (_stopping) break;
+		guard.unlock();
+		{
+			lock_guard<mutex> copyGuard(_copyLock);
+			copyFrames();
+		}
+		if ((steady_clock::now() - lastSync) >= period) {
+			if (msync(_base, _size, MS_SYNC) != 0) {
+				LOG_EVERY_N(100, ERROR) << "Flight recorder sync failed: " << strerror(errno);
+			}
+			lastSync = steady_clock::now();
+		}
+		guard.lock();
+	}
+}
+
+bool FlightRecorderReader::open (const std::string& path) {
+	struct stat fileStatus;
+	if (_header) return true;
+	_fd = ::open(path.c_str(), O_RDONLY);
+	if (_fd < 0) {
+		LOG(ERROR) << "Unable to open flight recorder " << path << ": " << strerror(errno);
+		return false;
+	}
+	if ((fstat(_fd, &fileStatus) != 0) || (fileStatus.st_size < RECORDER_HEADER_SIZE)) {
+		LOG(ERROR) << "Flight recorder " << path << " is too short";
+		::close(_fd);
+		_fd = -1;
+		return false;
+	}
+	_size = fileStatus.st_size;
+	void *mem = mmap(NULL, _size, PROT_READ, MAP_SHARED, _fd, 0);
+	if (mem == MAP_FAILED) {
+		LOG(ERROR) << "Unable to map flight recorder " << path << ": " << strerror(errno);
+		::close(_fd);
+		_fd = -1;
+		return false;
+	}
+	_base = static_cast<const uint8_t*>(mem);
+	_header = reinterpret_cast<const RecorderFileHeader*>(_base);
+	if (!intact(_header, _size)) {
+		LOG(ERROR) << "Flight recorder " << path << " has a bad header";
+		close();
+		return false;
+	}
+	return true;
+}
+
+void FlightRecorderReader::close () {
+	if (_base) munmap(const_cast<uint8_t*>(_base), _size);
+	if (_fd >= 0) ::close(_fd);
+	_fd = -1;
+	_base = NULL;
+	_header = NULL;
+}
+
+uint64_t FlightRecorderReader::next () const {
+	if (!_header) return 0;
+	return _header->next.load(memory_order_acquire);
+}
+
+uint64_t FlightRecorderReader::oldest () const {
+	if (!_header) return 0;
+	uint64_t n = next();
+	if (n > _header->slots) return (n - _header->slots);
+	return 1;
+}
+
+FlightRecorderReader::Result FlightRecorderReader::read (uint64_t seq, uint8_t *buf, size_t len, size_t& used, sysclock& time) const {
+	if (!_header || (seq == 0) || (seq >= next())) return Result::NOT_YET;
+	if (seq < oldest()) return Result::OVERWRITTEN;
+	const RecorderSlotHeader *slot = slotAt(const_cast<uint8_t*>(_base) + RECORDER_HEADER_SIZE, _header->slots, seq);
+	uint64_t before = slot->seq.load(memory_order_acquire);
+	if (before > seq) return Result::OVERWRITTEN;			// including RECORDER_BUSY
+	if (before != seq) return Result::CORRUPT;				// lost to a crash before it was synced
+	uint32_t length = slot->length;
+	uint32_t crc = slot->crc;
+	int64_t stamp = slot->time;
+	if ((length > RECORDER_FRAME_SIZE) || (length > len)) return Result::CORRUPT;
+	memcpy(buf, slot + 1, length);
+	// if the writer came around again while we copied, what we have is a mix of two frames
+	atomic_thread_fence(memory_order_acquire);
+	if (slot->seq.load(memory_order_relaxed) != seq) return Result::OVERWRITTEN;
+	uint32_t check = recorderCRC(0, &stamp, sizeof(stamp));
+	check = recorderCRC(check, &length, sizeof(length));
+	check = recorderCRC(check, buf, length);
+	if (check != crc) return Result::CORRUPT;
+	used = length;
+	time = sysclock(milliseconds(stamp));
+	return Result::OK;
+}
+
+void CycleSample::capture (BoatState& state, int64_t cycle) {
+	this->cycle = cycle;
+	this->rudder = (state.rudder) ? (int)state.rudder->readMicroseconds() : 0;
+	this->throttle = (state.throttle) ? state.throttle->getThrottle() : 0;
+	if (state.rc) {
+		this->rcThrottle = state.rc->getThrottle();
+		this->rcRudder = state.rc->getRudder();
+		this->rcCourse = state.rc->getCourse();
+	}
+	if (state.orient) this->orientation = state.orient->getOrientation();
+	if (state.adc) {
+		this->motorCurrentRaw = state.adc->getRawValue("mot_i");
+		this->batteryRaw = state.adc->getRawValue("battery_mon");
+	}
+}
+
+const FieldDescriptor CycleSample::fields[] = {
+	FIELD(IntField, "cycle", CycleSample, cycle),
+	FIELD(IntField, "rudder", CycleSample, rudder),
+	FIELD(IntField, "throttle", CycleSample, throttle),
+	FIELD(IntField, "rcThrottle", CycleSample, rcThrottle),
+	FIELD(DoubleField, "rcRudder", CycleSample, rcRudder),
+	FIELD(DoubleField, "rcCourse", CycleSample, rcCourse),
+	FIELD(ObjectField, "orientation", CycleSample, orientation),
+	FIELD(IntField, "motorCurrentRaw", CycleSample, motorCurrentRaw),
+	FIELD(IntField, "batteryRaw", CycleSample, batteryRaw),
+	FIELD_END
+};
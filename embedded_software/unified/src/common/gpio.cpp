@@ -128,6 +128,7 @@ bool Pin::setDir (bool dir) {
 bool Pin::writePin (bool val) {
 	ofstream value;
 	_state = val;
+	if (_simulated) return true;
 	if (!_init) {
 		LOG(ERROR) << "Attempted to write to an uninitialized pin";
 		return false;
@@ -152,6 +153,7 @@ int Pin::get() {
 	ifstream value;
 	std::string line;
 	int result = -1;
+	if (_simulated) return (_state ? 1 : 0);
 	if (!_init) {
 		LOG(ERROR) << "Attempted to read from an uninitialized pin";
 		return -1;
@@ -16,6 +16,7 @@
 #include "gps.hpp"
 #include "hal/config.h"
 #include "hackerboatRoot.hpp"
+#include "boatClock.hpp"
 #include "enumtable.hpp"
 #include "easylogging++.h"
 #include "rapidjson/rapidjson.h"
@@ -31,7 +32,7 @@ const EnumNameTable<NMEAModeEnum> GPSFix::NMEAModeNames = {
 
 GPSFix::GPSFix() {
 	LOG(DEBUG) << "Creating new blank GPSFix object";
-	recordTime = std::chrono::system_clock::now();
+	recordTime = BoatClock::now();
 	gpsTime = recordTime;
 	fix = Location(47.560644, -122.338816);	// location of HBL
 	fixValid = false;
@@ -42,98 +43,79 @@ GPSFix::GPSFix(Value& packet) {
 	fixValid = this->parseGpsdPacket(packet); 
 }
 
-Value GPSFix::pack () const {
-	Value d;
-	int packResult = 0;
-
-	packResult += PutVar("recordTime", HackerboatState::packTime(this->recordTime), d);
-	packResult += PutVar("gpsTime", HackerboatState::packTime(this->gpsTime), d);
-	packResult += PutVar("mode", NMEAModeNames.get(this->mode), d);
-	packResult += PutVar("device", this->device, d);
-	packResult += PutVar("fix", this->fix.pack(), d);
-	packResult += PutVar("track", this->track, d);
-	packResult += PutVar("speed", this->speed, d);
-	packResult += PutVar("alt", this->alt, d);
-	packResult += PutVar("climb", this->climb, d);
-	packResult += PutVar("epx", this->epx, d);
-	packResult += PutVar("epy", this->epy, d);
-	packResult += PutVar("epd", this->epd, d);
-	packResult += PutVar("eps", this->eps, d);
-	packResult += PutVar("ept", this->ept, d);
-	packResult += PutVar("epv", this->epv, d);
-	packResult += PutVar("epc", this->epc, d);
-	packResult += PutVar("fixValid", this->fixValid, d);
-
-	return d;
-}
+const FieldDescriptor GPSFix::fields[] = {
+	FIELD(TimeField, "recordTime", GPSFix, recordTime),
+	FIELD(TimeField, "gpsTime", GPSFix, gpsTime),
+	ENUM_FIELD("mode", GPSFix, mode, GPSFix::NMEAModeNames),
+	FIELD(StringField, "device", GPSFix, device),
+	FIELD(ObjectField, "fix", GPSFix, fix),
+	FIELD(DoubleField, "track", GPSFix, track),
+	FIELD(DoubleField, "speed", GPSFix, speed),
+	FIELD(DoubleField, "alt", GPSFix, alt),
+	FIELD(DoubleField, "climb", GPSFix, climb),
+	FIELD(DoubleField, "epx", GPSFix, epx),
+	FIELD(DoubleField, "epy", GPSFix, epy),
+	FIELD(DoubleField, "epd", GPSFix, epd),
+	FIELD(DoubleField, "eps", GPSFix, eps),
+	FIELD(DoubleField, "ept", GPSFix, ept),
+	FIELD(DoubleField, "epv", GPSFix, epv),
+	FIELD(DoubleField, "epc", GPSFix, epc),
+	FIELD(BoolField, "fixValid", GPSFix, fixValid),
+	FIELD_END
+};
 
-bool GPSFix::coreParse (Value& packet) {
-	GetVar("track", this->track, packet);
-	GetVar("speed", this->speed, packet);
-	GetVar("alt", this->alt, packet);
-	GetVar("climb", this->climb, packet);
-	GetVar("ept", this->ept, packet);
-	GetVar("epx", this->epx, packet);
-	GetVar("epy", this->epy, packet);
-	GetVar("epv", this->epv, packet);
-	GetVar("epd", this->epd, packet);
-	GetVar("eps", this->eps, packet);
-	GetVar("epc", this->epc, packet);
-	GetVar("device", this->device, packet);
-	return true;
-}
+// gpsd sends the mode as a number and the position at the top level. Anything else it leaves out keeps its last value.
+const FieldDescriptor GPSFix::gpsdFields[] = {
+	FIELD(TimeField, "time", GPSFix, gpsTime),
+	FIELD(EnumIntField, "mode", GPSFix, mode),
+	FIELD(StringField, "device", GPSFix, device),
+	NESTED_FIELD(DoubleField, "lat", GPSFix, fix, Location, lat),
+	NESTED_FIELD(DoubleField, "lon", GPSFix, fix, Location, lon),
+	FIELD(DoubleField, "track", GPSFix, track),
+	FIELD(DoubleField, "speed", GPSFix, speed),
+	FIELD(DoubleField, "alt", GPSFix, alt),
+	FIELD(DoubleField, "climb", GPSFix, climb),
+	FIELD(DoubleField, "epx", GPSFix, epx),
+	FIELD(DoubleField, "epy", GPSFix, epy),
+	FIELD(DoubleField, "epd", GPSFix, epd),
+	FIELD(DoubleField, "eps", GPSFix, eps),
+	FIELD(DoubleField, "ept", GPSFix, ept),
+	FIELD(DoubleField, "epv", GPSFix, epv),
+	FIELD(DoubleField, "epc", GPSFix, epc),
+	FIELD_END
+};
 
-bool GPSFix::parseGpsdPacket (Value& input) {
-	bool result = true;
-	int tmp;
-	std::string time;
-	double lat, lon;
-	root.CopyFrom(input, root.GetAllocator());
-	
-	result &= coreParse(input);
-	result &= GetVar("time", time, input);
-	result &= HackerboatState::parseTime(time, this->gpsTime);
-	result &= GetVar("lat", lat, input);
-	result &= GetVar("lon", lon, input);
-	result &= GetVar("mode", tmp, input);
-	if (NMEAModeNames.valid(tmp)) {
-		this->mode = static_cast<NMEAModeEnum>(tmp);
-	} else {
+template <typename Read>
+bool GPSFix::gpsdPacket (Read read) {
+	// time, position, and mode are required, so they start out missing and are checked for afterwards
+	Location lastFix = this->fix;
+	sysclock lastTime = this->gpsTime;
+	this->fix = Location(NAN, NAN);
+	this->gpsTime = sysclock::min();
+	this->mode = static_cast<NMEAModeEnum>(-1);
+	bool result = read();
+	result &= (this->gpsTime != sysclock::min());
+	result &= std::isfinite(this->fix.lat) && std::isfinite(this->fix.lon);
+	if (!NMEAModeNames.valid(static_cast<int>(this->mode))) {
 		this->mode = NMEAModeEnum::NONE;
 		result = false;
 	}
-	if (result) {
-		this->fix.lat = lat;
-		this->fix.lon = lon;
-	}
-	this->recordTime = std::chrono::system_clock::now();
+	if (!result) this->fix = lastFix;
+	if (this->gpsTime == sysclock::min()) this->gpsTime = lastTime;
+	this->recordTime = BoatClock::now();
 	
-	LOG_IF(!result, ERROR) << "Parsing GPSFix packet input failed: ";// << input;
+	LOG_IF(!result, ERROR) << "Parsing GPSFix packet input failed";
 	
 	if (result) return this->isValid();
 	return false;
 }
 
-bool GPSFix::parse (Value& input) {
-	Value inFix;
-	bool result = true;
-	std::string inTime, gpsInTime, tmp;
-	
-	result &= this->coreParse(input);
-	result &= GetVar("fix", inFix, input);
-	result &= this->fix.parse(inFix);
-	result &= GetVar("recordTime", inTime, input);
-	result &= GetVar("gpsTime", gpsInTime, input);
-	result &= HackerboatState::parseTime(inTime, this->recordTime);
-	result &= HackerboatState::parseTime(gpsInTime, this->gpsTime);
-	result &= GetVar("fixValid", fixValid, input);
-	result &= GetVar("mode", tmp, input);
-	result &= NMEAModeNames.get(tmp, &mode);
-	
-	LOG_IF(!result, ERROR) << "Parsing GPSFix input failed";
-	
-	if (result) return this->isValid();
-	return false;
+bool GPSFix::parseGpsdPacket (Value& input) {
+	return gpsdPacket([this, &input] () {return parseFields(gpsdFields, this, input);});
+}
+
+bool GPSFix::readGpsdPacket (const char *json) {
+	return gpsdPacket([this, json] () {return readFields(gpsdFields, this, json);});
 }
 
 bool GPSFix::isValid (void) const {
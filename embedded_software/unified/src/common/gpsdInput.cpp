@@ -18,18 +18,67 @@
 #include <chrono>
 #include <map>
 #include <iostream>
+#include <algorithm>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <poll.h>
+#include <netdb.h>
+#include <sys/socket.h>
 #include "rapidjson/rapidjson.h"
+#include "rapidjson/reader.h"
 #include "hal/config.h"
 #include "gps.hpp"
 #include "ais.hpp"
+#include "aivdm.hpp"
+#include "boatClock.hpp"
 #include "hal/inputThread.hpp"
 #include "hal/gpsdInput.hpp"
-#include "pstream.h"
 #include "easylogging++.h"
 #include "configuration.hpp"
 
 using namespace std;
-using namespace redi;
+
+namespace {
+	// Picks the class out of a gpsd report. gpsd always puts it first, so the parse stops as soon as it turns up.
+	class ClassReader : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, ClassReader> {
+		public:
+			ClassReader (string& cls) : _cls(cls) {};
+			bool Default () {return !_isClass;}			// a class that isn't a string
+			bool String (const char *str, rapidjson::SizeType len, bool copy) {
+				if (!_isClass) return true;
+				_cls.assign(str, len);
+				return false;							// that's all we came for
+			};
+			bool Key (const char *str, rapidjson::SizeType len, bool copy) {
+				_isClass = ((_depth == 1) && (len == 5) && (strncmp(str, "class", len) == 0));
+				return true;
+			};
+			bool StartObject () {
+				_depth++;
+				return !_isClass;
+			};
+			bool EndObject (rapidjson::SizeType members) {
+				_depth--;
+				return true;
+			};
+
+		private:
+			string&		_cls;
+			int			_depth = 0;
+			bool		_isClass = false;
+	};
+
+	/* Returns false if the line isn't json at all. cls is left empty if the report has no class */
+	bool gpsdClass (const char *line, string& cls) {
+		rapidjson::Reader reader;
+		rapidjson::StringStream stream(line);
+		ClassReader handler(cls);
+		cls.clear();
+		rapidjson::ParseResult r = reader.Parse(stream, handler);
+		return (!r.IsError() || (r.Code() == rapidjson::kParseErrorTermination));
+	}
+}
 
 GPSdInput::GPSdInput (string host, int port) :
 	_host(host), _port(port) {
@@ -46,6 +95,7 @@ GPSdInput::GPSdInput () :
 bool GPSdInput::setHost (string host) {
 	if (host != "") {
 		_host = host;
+		_addrs.clear();						// looked up again on the next connect()
 		LOG(DEBUG) << "Setting new host " << _host;
 		return true;
 	}
@@ -55,6 +105,7 @@ bool GPSdInput::setHost (string host) {
 bool GPSdInput::setPort (int port) {
 	if ((port > 0) && (port < 65535)) {
 		_port = port;
+		_addrs.clear();
 		LOG(DEBUG) << "Setting new port " << _port;
 		return true;
 	}
@@ -62,31 +113,108 @@ bool GPSdInput::setPort (int port) {
 }
 
 bool GPSdInput::connect () {
-	if ((_port > 0) && (_port < 65535) && (_host != "")) {
-		string cmd = "/usr/bin/gpspipe -w " + _host + ":" + to_string(_port);
-		gpsdstream.open(cmd, pstreams::pstdout | pstreams::pstderr);
-		LOG(DEBUG) << "Connecting to gpsd with command " << cmd;
-		std::this_thread::sleep_for(1ms);
-		LOG_IF(!isConnected(), ERROR) << "Failed to connect to gpsd with command " << cmd;
-		return (isConnected());
+	if ((_port <= 0) || (_port >= 65535) || (_host == "")) return false;
+	if (_addrs.empty() && !resolve()) return false;
+	return startConnect();
+}
+
+bool GPSdInput::resolve () {
+	struct addrinfo hints, *addrs = NULL;
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	int err = getaddrinfo(_host.c_str(), to_string(_port).c_str(), &hints, &addrs);
+	if (err != 0) {
+		LOG(ERROR) << "Unable to look up gpsd host " << _host << ": " << gai_strerror(err);
+		return false;
 	}
+	_addrs.clear();
+	_nextAddr = 0;
+	for (struct addrinfo *a = addrs; a; a = a->ai_next) {
+		Address addr;
+		memcpy(&addr.addr, a->ai_addr, a->ai_addrlen);
+		addr.len = a->ai_addrlen;
+		_addrs.push_back(addr);
+	}
+	freeaddrinfo(addrs);
+	return !_addrs.empty();
+}
+
+bool GPSdInput::startConnect () {
+	disconnect();
+	LOG(DEBUG) << "Connecting to gpsd at " << _host << ":" << _port;
+	int err = EDESTADDRREQ;
+	for (size_t i = 0; i < _addrs.size(); i++, _nextAddr++) {
+		const Address& a = _addrs[_nextAddr % _addrs.size()];
+		_sock = socket(a.addr.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+		if (_sock < 0) {
+			err = errno;
+			continue;
+		}
+		if (::connect(_sock, (const struct sockaddr *)&a.addr, a.len) == 0) return startWatch();
+		if (errno == EINPROGRESS) {
+			_connecting = true;
+			_connectBy = chrono::steady_clock::now() + GPSD_CONNECT_TIMEOUT;
+			return true;
+		}
+		err = errno;
+		disconnect();
+	}
+	LOG(ERROR) << "Failed to connect to gpsd at " << _host << ":" << _port << ": " << strerror(err);
 	return false;
 }
 
+bool GPSdInput::finishConnect () {
+	struct pollfd pfd = {_sock, POLLOUT, 0};
+	int err = 0;
+	socklen_t len = sizeof(err);
+	if (poll(&pfd, 1, 0) <= 0) {
+		if (chrono::steady_clock::now() < _connectBy) return false;
+		err = ETIMEDOUT;							// don't wait forever on a host that isn't answering
+	} else if (getsockopt(_sock, SOL_SOCKET, SO_ERROR, &err, &len) != 0) err = errno;
+	if (err == 0) {
+		_connecting = false;
+		if (startWatch()) return true;
+	} else {
+		LOG(ERROR) << "Failed to connect to gpsd at " << _host << ":" << _port << ": " << strerror(err);
+		disconnect();
+		_nextAddr++;
+	}
+	backoff();
+	return false;
+}
+
+bool GPSdInput::startWatch () {
+	// with raw AIS, gpsd sends the NMEA alongside the JSON, and AIVDM is decoded here rather than by gpsd
+	string watch = "?WATCH={\"enable\":true,\"json\":true" + string((Conf::get()->aisRawNMEA()) ? ",\"nmea\":true" : "") + "};\n";
+	if (send(_sock, watch.data(), watch.length(), MSG_NOSIGNAL) != (ssize_t)watch.length()) {
+		LOG(ERROR) << "Unable to start watching gpsd at " << _host << ":" << _port << ": " << strerror(errno);
+		disconnect();
+		return false;
+	}
+	_rxbuf.resize(GPSD_RECV_BUF + Conf::get()->gpsBufSize());
+	_retryDelay = GPSD_RETRY_MIN;
+	LOG(INFO) << "Connected to gpsd at " << _host << ":" << _port;
+	return true;
+}
+
 bool GPSdInput::disconnect () {
-	gpsdstream.close();
+	if (_sock >= 0) close(_sock);
+	_sock = -1;
+	_connecting = false;
+	_rxlen = 0;
+	_overlong = false;
 	return true;
 }
 
 bool GPSdInput::isConnected () {
-	if (/*gpsdstream.is_open() && */(!gpsdstream.exited())) return true;
-	return false;
+	if (_simulated) return true;
+	return (_sock >= 0) && !_connecting;
 }
 
 bool GPSdInput::begin() {
 	if (this->connect()) {
-		this->myThread = new std::thread (InputThread::InputThreadRunner(this));
-		myThread->detach();
+		this->launch();
 		LOG(INFO) << "GPS subsystem started";
 		return true;
 	}
@@ -95,106 +223,168 @@ bool GPSdInput::begin() {
 }
 
 bool GPSdInput::execute() {
-	Document root;
-	bool result = true;
-	string buf, s;
-	buf.reserve(Conf::get()->gpsBufSize());
-	int i = 0;
-	while (gpsdstream.in_avail()) {
-		buf.push_back(gpsdstream.sbumpc());
-		i++;
-		if (buf.back() == '\r')	break;
-		if (i > 5000) break;
-	} 
-	if (buf.length() > 10) {
-		//cerr << "Incoming buffer is: " << buf.c_str() << endl;
-		root.Parse(buf.c_str());
-		if (!root.HasParseError() && root.IsObject()) {
-			//cerr << "Loaded GPS JSON string." << endl;
-			if (root.HasMember("class") && root["class"].IsString()) {
-				s = root["class"].GetString();
-				if (s == "TPV") {
-					LOG(DEBUG) << "Got GPS packet";
-					LOG(DEBUG) << "GPS packet contents: " << root;
-					result = _lastFix.parseGpsdPacket(root);
-				} else if (s == "AIS") {
-					AISShip newship;
-					LOG(DEBUG) << "Got AIS packet";
-					LOG(DEBUG) << "AIS packet contents: " << root;
-					if (newship.parseGpsdPacket(root)) {
-						_aisTargets.emplace(newship.getMMSI(), newship);
-						result = true;
-					} 
-				} else result = false;
-			} else result = false;
-		} else result = false;
-	} else result = false;
+	bool result = false;
+	sysclock now = BoatClock::now();
+	if (now >= _pruneAt) {
+		_aisTargets.prune(_lastFix.fix, now);
+		_pruneAt = now + GPSD_PRUNE_PERIOD;
+	} else _aisTargets.expire(now);
+	if (_sock < 0) {
+		if (_simulated || (chrono::steady_clock::now() < _retryAt)) return false;
+		if (!connect()) {						// looks the host up again if setHost() or setPort() changed it
+			backoff();
+			return false;
+		}
+	}
+	if (_connecting && !finishConnect()) return false;		// still under way, or given up on
+
+	// drain everything gpsd has sent since the last wakeup, rather than one line per wakeup
+	for (;;) {
+		size_t room = _rxbuf.size() - _rxlen;
+		ssize_t got = recv(_sock, _rxbuf.data() + _rxlen, room, MSG_DONTWAIT);
+		if (got > 0) {
+			result |= processBuffer(got);
+			if ((size_t)got < room) break;			// that was all of it
+		} else if ((got < 0) && (errno == EINTR)) {
+			continue;
+		} else if ((got < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK))) {
+			break;
+		} else {
+			LOG(WARNING) << "Lost connection to gpsd at " << _host << ":" << _port << ": " << ((got == 0) ? "closed by gpsd" : strerror(errno));
+			disconnect();
+			backoff();
+			break;
+		}
+	}
+	return result;
+}
+
+bool GPSdInput::processBuffer(size_t fresh) {
+	bool result = false;
+	char *buf = _rxbuf.data();
+	size_t start = 0;
+	size_t scan = _rxlen;
+	_rxlen += fresh;
+	char *nl;
+	while ((nl = (char *)memchr(buf + scan, '\n', _rxlen - scan)) != NULL) {
+		size_t len = (nl - buf) - start;
+		while ((len > 0) && (buf[start + len - 1] == '\r')) len--;
+		buf[start + len] = '\0';
+		if (_overlong) {
+			_overlong = false;						// the end of a line that was already dropped
+		} else if (len > 10) {
+			result |= processLine(buf + start, len);
+		}
+		start = scan = (nl - buf) + 1;
+	}
+
+	// keep the partial line for next time, unless it's already too long to be any good
+	_rxlen -= start;
+	if (start && _rxlen) memmove(buf, buf + start, _rxlen);
+	if (_rxlen > (size_t)Conf::get()->gpsBufSize()) {
+		if (!_overlong) {
+			_lines++;
+			_parseErrors++;
+			LOG(DEBUG) << "Dropping a line from gpsd longer than " << Conf::get()->gpsBufSize() << " bytes";
+		}
+		_overlong = true;
+		_rxlen = 0;
+	}
+	return result;
+}
+
+void GPSdInput::backoff() {
+	_retryAt = chrono::steady_clock::now() + _retryDelay;
+	_retryDelay = min<chrono::steady_clock::duration>(_retryDelay * 2, GPSD_RETRY_MAX);
+}
+
+bool GPSdInput::processLine(const char *line, size_t len) {
+	_lines++;
+	if ((line[0] == '!') || (line[0] == '\\')) {
+		// decoded straight into the stored contact; our own reports are kept out, since they'd only show up as a contact right on top of us
+		AIVDMResult r = _aivdm.decode(line, len, BoatClock::now(), _aisTargets);
+		if ((r == AIVDMResult::DECODED) && !_aivdm.lastOwn()) _aisUpdates++;
+		if ((r == AIVDMResult::BAD_CHECKSUM) || (r == AIVDMResult::BAD_FORMAT)) _parseErrors++;
+		return ((r == AIVDMResult::DECODED) || (r == AIVDMResult::PENDING));
+	} else if (line[0] == '$') return false;	// the rest of the raw NMEA, which gpsd also sends as JSON
+	
+	// Reports are read straight into the fix or the contact through their field tables; only the class is looked at first
+	bool result = false;
+	string s;
+	if (!gpsdClass(line, s)) {
+		LOG(DEBUG) << "GPSd JSON loading error, buffer " << line;
+		_parseErrors++;
+	} else if (s == "TPV") {
+		LOG(DEBUG) << "Got GPS packet";
+		LOG(DEBUG) << "GPS packet contents: " << line;
+		result = _lastFix.readGpsdPacket(line);
+		if (!result) _parseErrors++;
+	} else if ((s == "AIS") && Conf::get()->aisRawNMEA()) {
+		result = false;				// already decoded from the raw sentence
+	} else if (s == "AIS") {
+		AISShip newship;
+		LOG(DEBUG) << "Got AIS packet";
+		LOG(DEBUG) << "AIS packet contents: " << line;
+		if (newship.readGpsdPacket(line)) {
+			_aisTargets.upsert(std::move(newship));
+			_aisUpdates++;
+			result = true;
+		} else _parseErrors++;
+	}
 	
-	LOG_IF(root.HasParseError(), DEBUG) << "GPSd JSON loading error: " << root.GetParseError() << " offset: " 
-										 << root.GetErrorOffset() << "buffer" << buf;
-	//lock.unlock();
 	if (result && s == "TPV") {
+		_fix.publish(_lastFix);
 		_gpsAvgList.emplace_front(_lastFix);
-		if (_gpsAvgList.size() < Conf::get()->gpsAvgLen()) {
+		if (_gpsAvgList.size() > Conf::get()->gpsAvgLen()) {
 			_gpsAvgList.pop_back();
 		}
+		updateAverage();
+		assessRisks();
 	}
 	return result;
 }
 
-map<int, AISShip>* GPSdInput::getData() {
+AISContactStore* GPSdInput::getData() {
 	return &_aisTargets;
 }
 
-map<int, AISShip> GPSdInput::getData(AISShipType shiptype) {
-	map<int, AISShip> result;
-	for (auto const &r : _aisTargets) {
-		if (shiptype == r.second.shiptype) {
-			result.emplace(r.first, r.second);
-		}
-	}
+std::vector<AISShip*> GPSdInput::getData(AISShipType shiptype) {
+	std::vector<AISShip*> result;
+	_aisTargets.ofType(shiptype, result);
 	return result;
 }
 
 AISShip* GPSdInput::getData(int MMSI) {
-	for (auto const &r : _aisTargets) {
-		if (MMSI == r.first) {
-			return &(_aisTargets[MMSI]);
-		}
-	}
-	return NULL;
+	return _aisTargets.find(MMSI);
 }
 
 AISShip* GPSdInput::getData(string name) {
-	for (auto const &r : _aisTargets) {
-		if (name == r.second.shipname) {
-			return &(_aisTargets[r.first]);
-		}
-	}
-	return NULL;
+	return _aisTargets.find(name);
+}
+
+size_t GPSdInput::getNearby(const Location& center, double radius, std::vector<AISShip*>& out) {
+	return _aisTargets.within(center, radius, out);
 }
 
 int GPSdInput::pruneAIS(Location loc) {
-	int count = 0;
-	for (auto &r : _aisTargets) {
-		if (r.second.prune(loc)) {
-			LOG(DEBUG) << "Pruning AIS target " << r.second.pack();
-			_aisTargets.erase(r.first);
-			count++;
-		}
-	}
-	return count;
+	return _aisTargets.prune(loc, BoatClock::now());
 }
 
-GPSFix GPSdInput::getAverageFix() {
+void GPSdInput::assessRisks() {
+	_report.time = BoatClock::now();
+	_cpa.assess(_lastFix.fix, _lastFix.speed, _lastFix.track, _aisTargets, _report.time, CPA_REPORT_CONTACTS);
+	_report.assessed = _cpa.assessed();
+	_report.risks = _cpa.risks();
+	_risks.publish(_report);
+}
+
+void GPSdInput::updateAverage() {
 	double lattot = 0, lontot = 0;
-	GPSFix result;
 	for (auto &thisfix: _gpsAvgList) {
 		lattot += thisfix.fix.lat;
 		lontot += thisfix.fix.lon;
 	}
-	result.fix.lat = lattot/_gpsAvgList.size();
-	result.fix.lon = lontot/_gpsAvgList.size();
-	return result;
-	
+	_averageFix.fix.lat = lattot/_gpsAvgList.size();
+	_averageFix.fix.lon = lontot/_gpsAvgList.size();
+	_average.publish(_averageFix);
 }
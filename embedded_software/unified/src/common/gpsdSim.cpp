@@ -0,0 +1,562 @@
+/******************************************************************************
+ * Hackerboat gpsd simulator module
+ * gpsdSim.cpp
+ * This module stands in for gpsd on a local port, playing back recorded
+ * streams or making up GPS fixes and AIS traffic at a set rate
+ * Message layouts from Eric Raymond's AIVDM/AIVDO protocol decoding
+ * http://catb.org/gpsd/AIVDM.html
+ *
+ * See the Hackerboat documentation for more details
+ * Written by agent, Oct 2026
+ *
+ * Version 0.1: First alpha
+ *
+ ******************************************************************************/
+
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <ctype.h>
+#include <errno.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <fstream>
+#include "gpsdSim.hpp"
+#include "aivdm.hpp"
+#include "twovector.hpp"
+#include "easylogging++.h"
+
+#define KNOT				(1852.0 / 3600.0)	/**< m/s */
+#define AIS_COORD_SCALE		(600000.0)			/**< Position units per degree */
+#define AIS_NO_TURN			(0x80)
+#define AIS_NO_TIMESTAMP	(60)
+#define AIS_CLASS_B_EVERY	(4)					/**< One contact in this many is class B */
+#define AIS_FRAGMENT_CHARS	(60)				/**< Payload characters in every fragment but the last, as gpsd splits them */
+#define GPSD_SIM_TICK		(1)					/**< Milliseconds between passes of the server loop */
+#define GPSD_SIM_MAX_LAG	(1.0)				/**< Seconds the schedule can fall behind before reports are skipped */
+#define GPSD_SIM_MAX_COMMAND	(4096)			/**< Longest client command held */
+#define GPSD_SIM_DEVICE		"/dev/ttyS4"
+
+using namespace std;
+using namespace std::chrono;
+
+static const char *versionReply = "{\"class\":\"VERSION\",\"release\":\"3.16\",\"rev\":\"hackerboat-sim\",\"proto_major\":3,\"proto_minor\":11}\r\n";
+static const char *devicesReply = "{\"class\":\"DEVICES\",\"devices\":[{\"class\":\"DEVICE\",\"path\":\"" GPSD_SIM_DEVICE "\",\"driver\":\"NMEA0183\",\"native\":0,\"bps\":38400}]}\r\n";
+
+// ISO 8601 time to the microsecond, the way gpsd writes it
+static size_t isoTime (sysclock t, char *buf) {
+	size_t len = HackerboatState::packTime(t, buf, TIME_STRING_SIZE);
+	if (!len) return 0;
+	buf[10] = 'T';
+	unsigned us = duration_cast<microseconds>(t.time_since_epoch()).count() % 1000;
+	len += sprintf(buf + len, "%03uZ", us);
+	return len;
+}
+
+GPSdTrafficGenerator::GPSdTrafficGenerator (const GPSdSimConfig& config, sysclock start) :
+	_config(config), _start(start), _rng(config.seed) {
+	std::uniform_real_distribution<double> angle(0, 360);
+	std::uniform_real_distribution<double> knots(0, 20);
+	for (int i = 0; i < _config.contacts; i++) {
+		Contact c;
+		c.mmsi = 366000000 + i;
+		c.classB = ((i % AIS_CLASS_B_EVERY) == (AIS_CLASS_B_EVERY - 1));
+		c.shiptype = (c.classB) ? 37 : 70;					// pleasure craft, cargo
+		c.name = "SIM " + to_string(i);
+		c.callsign = "S" + to_string(i % 1000000);
+		c.speed = knots(_rng);
+		c.course = angle(_rng);
+		TwoVector offset = TwoVector::getVectorDeg(angle(_rng), _config.contactRadius * sqrt(_uniform(_rng)));	// even over the area
+		c.origin = _config.center.project(offset, CourseTypeEnum::Approximate);
+		_contacts.push_back(c);
+	}
+}
+
+bool GPSdTrafficGenerator::loadReplay (const std::string& path) {
+	ifstream in(path);
+	if (!in) return false;
+	string line;
+	_replay.clear();
+	while (getline(in, line)) {
+		while (!line.empty() && ((line.back() == '\r') || (line.back() == ' '))) line.pop_back();
+		if ((line.size() > 1) && ((line[0] == '{') || (line[0] == '$') || (line[0] == '!') || (line[0] == '\\'))) {
+			_replay.push_back(line);
+		}
+	}
+	_replayNext = 0;
+	LOG(DEBUG) << "Loaded " << _replay.size() << " lines to replay from " << path;
+	return true;
+}
+
+size_t GPSdTrafficGenerator::generate (sysclock now, std::string& json, std::string& nmea) {
+	double t = duration<double>(now - _start).count();
+	uint64_t before = _lines;
+	_lastAIS = 0;
+
+	// a schedule that has fallen well behind, because the clients stalled, skips ahead rather than bursting
+	if (_config.tpvRate > 0) {
+		_tpvDue = max(_tpvDue, t - GPSD_SIM_MAX_LAG);
+		for (; _tpvDue <= t; _tpvDue += 1.0 / _config.tpvRate) tpv(t, now, json);
+	}
+	if (!_contacts.empty()) {
+		_aisDue = max(_aisDue, t - GPSD_SIM_MAX_LAG);
+		for (; _aisDue <= t; _aisDue += _config.reportPeriod / _contacts.size()) {
+			position(_contacts[_nextPosition], t, nmea);
+			_nextPosition = (_nextPosition + 1) % _contacts.size();
+		}
+		_staticDue = max(_staticDue, t - GPSD_SIM_MAX_LAG);
+		for (; _staticDue <= t; _staticDue += _config.staticPeriod / _contacts.size()) {
+			staticData(_contacts[_nextStatic], nmea);
+			_nextStatic = (_nextStatic + 1) % _contacts.size();
+		}
+	}
+	replay(now, json, nmea);
+	return _lines - before;
+}
+
+bool GPSdTrafficGenerator::damage () {
+	return (_config.errorRate > 0) && (_uniform(_rng) < _config.errorRate);
+}
+
+void GPSdTrafficGenerator::finish (std::string& out, size_t start, bool damaged) {
+	if (damaged && (out.size() > start)) {
+		if (out[start] == '{') {
+			out.pop_back();								// lose the closing brace
+		} else {
+			out.back() = (out.back() == '0') ? '1' : '0';	// spoil the checksum
+		}
+		_damaged++;
+	}
+	out += "\r\n";
+	_lines++;
+}
+
+void GPSdTrafficGenerator::fix (const Location& where, double speed, double course, int mode, sysclock now, std::string& json) {
+	char buf[384];
+	char when[TIME_STRING_SIZE + 8];
+	isoTime(now, when);
+	int len = snprintf(buf, sizeof(buf), "{\"class\":\"TPV\",\"device\":\"" GPSD_SIM_DEVICE "\",\"mode\":%d,\"time\":\"%s\",\"ept\":0.005", mode, when);
+	if (mode >= 2) {
+		len += snprintf(buf + len, sizeof(buf) - len, ",\"lat\":%.7f,\"lon\":%.7f,\"alt\":1.0,\"epx\":3.0,\"epy\":3.0", where.lat, where.lon);
+		if (isfinite(course)) len += snprintf(buf + len, sizeof(buf) - len, ",\"track\":%.2f", course);
+		if (isfinite(speed)) len += snprintf(buf + len, sizeof(buf) - len, ",\"speed\":%.3f", speed);
+	}
+	len += snprintf(buf + len, sizeof(buf) - len, "}");
+	size_t start = json.size();
+	json.append(buf, len);
+	bool damaged = damage();
+	finish(json, start, damaged);
+	if (!damaged && (mode >= 2)) _fixes++;
+}
+
+void GPSdTrafficGenerator::tpv (double t, sysclock now, std::string& json) {
+	Location here = _config.center;
+	if (_config.speed > 0) {
+		TwoVector run = TwoVector::getVectorDeg(_config.course, _config.speed * t);
+		here = _config.center.project(run, CourseTypeEnum::Approximate);
+	}
+	fix(here, _config.speed, _config.course, 3, now, json);
+}
+
+void GPSdTrafficGenerator::position (Contact& c, double t, std::string& nmea) {
+	TwoVector run = TwoVector::getVectorDeg(c.course, c.speed * KNOT * t);
+	Location here = c.origin.project(run, CourseTypeEnum::Approximate);
+	uint32_t sog = lround(c.speed * 10);
+	uint32_t lon = (uint32_t)lround(here.lon * AIS_COORD_SCALE) & 0x0fffffff;
+	uint32_t lat = (uint32_t)lround(here.lat * AIS_COORD_SCALE) & 0x07ffffff;
+	uint32_t cog = lround(c.course * 10) % 3600;
+	uint32_t hdg = lround(c.course) % 360;
+	Bits b;
+	if (c.classB) {
+		b.put(18, 6);
+		b.put(0, 2);
+		b.put(c.mmsi, 30);
+		b.put(0, 8);
+		b.put(sog, 10);
+		b.put(0, 1);
+		b.put(lon, 28);
+		b.put(lat, 27);
+		b.put(cog, 12);
+		b.put(hdg, 9);
+		b.put(AIS_NO_TIMESTAMP, 6);
+		b.put(0, 2);
+		b.put(1, 1);				// carrier sense unit
+		b.put(0, 6);				// no display, DSC, band or message 22; not assigned, no RAIM
+		b.put(0, 20);
+	} else {
+		b.put(1, 6);
+		b.put(0, 2);
+		b.put(c.mmsi, 30);
+		b.put(0, 4);				// under way using engine
+		b.put(AIS_NO_TURN, 8);
+		b.put(sog, 10);
+		b.put(0, 1);
+		b.put(lon, 28);
+		b.put(lat, 27);
+		b.put(cog, 12);
+		b.put(hdg, 9);
+		b.put(AIS_NO_TIMESTAMP, 6);
+		b.put(0, 2);
+		b.put(0, 3);
+		b.put(0, 1);
+		b.put(0, 19);
+	}
+	emit(b, nmea, 1);
+}
+
+void GPSdTrafficGenerator::staticData (Contact& c, std::string& nmea) {
+	if (c.classB) {
+		Bits a;
+		a.put(24, 6);
+		a.put(0, 2);
+		a.put(c.mmsi, 30);
+		a.put(0, 2);
+		a.text(c.name, 20);
+		emit(a, nmea, 1);
+		Bits b;
+		b.put(24, 6);
+		b.put(0, 2);
+		b.put(c.mmsi, 30);
+		b.put(1, 2);
+		b.put(c.shiptype, 8);
+		b.text("", 7);				// vendor ID
+		b.text(c.callsign, 7);
+		b.put(6, 9);
+		b.put(4, 9);
+		b.put(2, 6);
+		b.put(2, 6);
+		b.put(0, 6);
+		emit(b, nmea, 1);
+	} else {
+		Bits b;
+		b.put(5, 6);
+		b.put(0, 2);
+		b.put(c.mmsi, 30);
+		b.put(0, 2);
+		b.put(9000000 + (c.mmsi % 1000000), 30);	// IMO
+		b.text(c.callsign, 7);
+		b.text(c.name, 20);
+		b.put(c.shiptype, 8);
+		b.put(100, 9);
+		b.put(20, 9);
+		b.put(10, 6);
+		b.put(10, 6);
+		b.put(1, 4);				// GPS
+		b.put(0, 4);				// no ETA
+		b.put(0, 5);
+		b.put(24, 5);
+		b.put(60, 6);
+		b.put(50, 8);				// draught, decimeters
+		b.text("SEATTLE", 20);
+		b.put(0, 2);
+		emit(b, nmea, 2);
+	}
+}
+
+void GPSdTrafficGenerator::emit (const Bits& bits, std::string& nmea, int fragments) {
+	char payload[sizeof(bits.data) * 2];
+	int fill;
+	size_t len = bits.armor(payload, fill);
+	char seqId = 0;
+	char channel = (_channelB) ? 'B' : 'A';
+	_channelB = !_channelB;
+	if (fragments > 1) {
+		seqId = '0' + _seqId;
+		_seqId = (_seqId + 1) % 10;
+	}
+	bool damaged = false;
+	size_t done = 0;
+	for (int i = 1; i <= fragments; i++) {
+		size_t chunk = (i < fragments) ? min((size_t)AIS_FRAGMENT_CHARS, len - done) : (len - done);
+		size_t start = nmea.size();
+		sentence(payload + done, chunk, (i < fragments) ? 0 : fill, fragments, i, seqId, channel, nmea);
+		bool d = damage();
+		finish(nmea, start, d);
+		damaged |= d;
+		done += chunk;
+	}
+	if (!damaged) {
+		_aisMessages++;
+		_lastAIS++;
+	}
+}
+
+size_t GPSdTrafficGenerator::sentence (const char *payload, size_t len, int fill, int count, int number, char seqId, char channel, std::string& out) {
+	size_t start = out.size();
+	char head[32];
+	int n = snprintf(head, sizeof(head), "!AIVDM,%d,%d,", count, number);
+	out.append(head, n);
+	if (seqId) out.push_back(seqId);
+	out.push_back(',');
+	if (channel) out.push_back(channel);
+	out.push_back(',');
+	out.append(payload, len);
+	out.push_back(',');
+	out.push_back('0' + fill);
+	uint8_t sum = 0;
+	for (size_t i = start + 1; i < out.size(); i++) sum ^= (uint8_t)out[i];
+	n = snprintf(head, sizeof(head), "*%02X", sum);
+	out.append(head, n);
+	return out.size() - start;
+}
+
+void GPSdTrafficGenerator::Bits::put (uint32_t value, size_t width) {
+	for (size_t i = 0; i < width; i++, len++) {
+		if ((len >> 3) >= sizeof(data)) return;
+		if ((value >> (width - 1 - i)) & 1) data[len >> 3] |= 0x80 >> (len & 7);
+	}
+}
+
+void GPSdTrafficGenerator::Bits::text (const std::string& s, size_t chars) {
+	for (size_t i = 0; i < chars; i++) {
+		char c = (i < s.size()) ? toupper(s[i]) : '@';		// '@' pads the field out
+		put((c >= 64) ? (c - 64) : c, 6);
+	}
+}
+
+size_t GPSdTrafficGenerator::Bits::armor (char *out, int& fill) const {
+	size_t chars = (len + 5) / 6;
+	fill = (chars * 6) - len;
+	for (size_t i = 0; i < chars; i++) {
+		uint32_t v = 0;
+		for (size_t j = i * 6; j < ((i + 1) * 6); j++) {
+			v <<= 1;
+			if (j < len) v |= (data[j >> 3] >> (7 - (j & 7))) & 1;
+		}
+		out[i] = (v < 40) ? (v + 48) : (v + 56);
+	}
+	return chars;
+}
+
+void GPSdTrafficGenerator::replay (sysclock now, std::string& json, std::string& nmea) {
+	if (_replay.empty()) return;
+	double t = duration<double>(now - _start).count();
+	size_t burst = GPSD_SIM_REPLAY_BURST;
+	if (_config.replayRate > 0) _replayDue = max(_replayDue, t - GPSD_SIM_MAX_LAG);
+	while (((_config.replayRate > 0) ? (_replayDue <= t) : (burst-- > 0))) {
+		if (_replayNext >= _replay.size()) {
+			if (!_config.replayLoop) return;
+			_replayNext = 0;
+		}
+		const string& line = _replay[_replayNext++];
+		string& out = (line[0] == '{') ? json : nmea;
+		size_t start = out.size();
+		out += line;
+		finish(out, start, damage());
+		if (line[0] == '$') rmc(line, now, json);
+		if (_config.replayRate > 0) _replayDue += 1.0 / _config.replayRate;
+	}
+}
+
+bool GPSdTrafficGenerator::rmc (const std::string& line, sysclock now, std::string& json) {
+	// $GPRMC,time,status,lat,N/S,lon,E/W,knots,track,date,...*hh
+	if ((line.size() < 7) || (line.compare(3, 3, "RMC") != 0) || !AIVDMDecoder::checksum(line.data(), line.size())) return false;
+	const char *field[10];
+	size_t n = 0;
+	field[n++] = line.c_str();
+	for (const char *c = line.c_str(); *c && (n < 10); c++) {
+		if (*c == ',') field[n++] = c + 1;
+	}
+	if (n < 10) return false;
+	if (field[2][0] != 'A') {
+		fix(Location(), NAN, NAN, 1, now, json);			// gpsd reports no fix rather than saying nothing
+		return true;
+	}
+	double lat = atof(field[3]);
+	double lon = atof(field[5]);
+	lat = floor(lat / 100) + (fmod(lat, 100) / 60);
+	lon = floor(lon / 100) + (fmod(lon, 100) / 60);
+	if (field[4][0] == 'S') lat = -lat;
+	if (field[6][0] == 'W') lon = -lon;
+	double speed = (field[7][0] != ',') ? atof(field[7]) * KNOT : NAN;
+	double track = (field[8][0] != ',') ? atof(field[8]) : NAN;
+	fix(Location(lat, lon), speed, track, 2, now, json);
+	return true;
+}
+
+bool GPSdSimServer::start (int port) {
+	if (_running.load()) return true;
+	_generator.reset(new GPSdTrafficGenerator(_config, system_clock::now()));
+	if (!_config.replayFile.empty() && !_generator->loadReplay(_config.replayFile)) {
+		LOG(ERROR) << "gpsd simulator unable to read replay file " << _config.replayFile;
+		return false;
+	}
+	_listen = socket(AF_INET, SOCK_STREAM, 0);
+	if (_listen < 0) {
+		LOG(ERROR) << "gpsd simulator unable to open a socket: " << strerror(errno);
+		return false;
+	}
+	int yes = 1;
+	setsockopt(_listen, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+	struct sockaddr_in addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	addr.sin_port = htons(port);
+	socklen_t addrlen = sizeof(addr);
+	if ((bind(_listen, (struct sockaddr *)&addr, sizeof(addr)) < 0) || (listen(_listen, GPSD_SIM_MAX_CLIENTS) < 0) ||
+		(getsockname(_listen, (struct sockaddr *)&addr, &addrlen) < 0)) {
+		LOG(ERROR) << "gpsd simulator unable to listen on port " << port << ": " << strerror(errno);
+		close(_listen);
+		_listen = -1;
+		return false;
+	}
+	_port = ntohs(addr.sin_port);
+	_running = true;
+	_thread = std::thread(&GPSdSimServer::run, this);
+	LOG(INFO) << "gpsd simulator listening on 127.0.0.1:" << _port;
+	return true;
+}
+
+void GPSdSimServer::stop () {
+	_running = false;
+	if (_thread.joinable()) _thread.join();
+	while (!_clientList.empty()) drop(_clientList.size() - 1);
+	if (_listen >= 0) close(_listen);
+	_listen = -1;
+}
+
+bool GPSdSimServer::aisSentAt (uint64_t n, sysclock& t) const {
+	uint64_t sent = _aisMessages.load(std::memory_order_acquire);
+	if ((n >= sent) || ((sent - n) > (GPSD_SIM_AIS_HISTORY / 2))) return false;	// leave the writer room, so the slot isn't being reused
+	t = sysclock(sysclock::duration(_aisSent[n % GPSD_SIM_AIS_HISTORY].load(std::memory_order_relaxed)));
+	return true;
+}
+
+void GPSdSimServer::run () {
+	string json, nmea;
+	struct pollfd fds[GPSD_SIM_MAX_CLIENTS + 1];
+	while (_running.load()) {
+		fds[0].fd = _listen;
+		fds[0].events = POLLIN;
+		for (size_t i = 0; i < _clientList.size(); i++) {
+			fds[i + 1].fd = _clientList[i].fd;
+			fds[i + 1].events = POLLIN;
+		}
+		int ready = poll(fds, _clientList.size() + 1, GPSD_SIM_TICK);
+		if (ready > 0) {
+			for (size_t i = _clientList.size(); i > 0; i--) {
+				if (fds[i].revents && !command(_clientList[i - 1])) drop(i - 1);
+			}
+			if (fds[0].revents & POLLIN) accept();
+		}
+
+		// like gpsd, nothing goes out until someone is watching
+		bool watched = false;
+		for (auto& c : _clientList) watched |= (c.json || c.nmea);
+		if (!watched) continue;
+		json.clear();
+		nmea.clear();
+		if (!_generator->generate(system_clock::now(), json, nmea)) continue;
+		for (size_t i = _clientList.size(); i > 0; i--) {
+			Client& c = _clientList[i - 1];
+			bool ok = true;
+			if (c.nmea && !nmea.empty()) ok = send(c, nmea.data(), nmea.size());
+			if (ok && c.json && !json.empty()) ok = send(c, json.data(), json.size());
+			if (!ok) drop(i - 1);
+		}
+
+		// stamp the AIS messages before publishing the count, so a reader that sees the count finds the times
+		int64_t stamp = system_clock::now().time_since_epoch().count();
+		uint64_t first = _generator->aisMessages() - _generator->lastAIS();
+		for (uint64_t n = first; n < _generator->aisMessages(); n++) {
+			_aisSent[n % GPSD_SIM_AIS_HISTORY].store(stamp, std::memory_order_relaxed);
+		}
+		_aisMessages.store(_generator->aisMessages(), std::memory_order_release);
+		_lines.store(_generator->lines());
+		_damaged.store(_generator->damaged());
+		_fixes.store(_generator->fixes());
+	}
+}
+
+void GPSdSimServer::accept () {
+	int fd = ::accept(_listen, NULL, NULL);
+	if (fd < 0) return;
+	if (_clientList.size() >= GPSD_SIM_MAX_CLIENTS) {
+		LOG(WARNING) << "gpsd simulator already has " << GPSD_SIM_MAX_CLIENTS << " clients; refusing another";
+		close(fd);
+		return;
+	}
+	int yes = 1;
+	setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+	struct timeval timeout = {GPSD_SIM_SEND_TIMEOUT / 1000, (GPSD_SIM_SEND_TIMEOUT % 1000) * 1000};
+	setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+	Client c;
+	c.fd = fd;
+	if (!send(c, versionReply, strlen(versionReply))) {
+		close(fd);
+		return;
+	}
+	_clientList.push_back(c);
+	_clients = _clientList.size();
+	LOG(INFO) << "gpsd simulator client connected";
+}
+
+bool GPSdSimServer::command (Client& c) {
+	char buf[512];
+	ssize_t r = recv(c.fd, buf, sizeof(buf), MSG_DONTWAIT);
+	if (r == 0) return false;
+	if (r < 0) return ((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR));
+	c.in.append(buf, r);
+	if (c.in.size() > GPSD_SIM_MAX_COMMAND) c.in.clear();
+
+	size_t end;
+	while ((end = c.in.find_first_of(";\n")) != string::npos) {
+		string cmd = c.in.substr(0, end);
+		c.in.erase(0, end + 1);
+		while (!cmd.empty() && ((cmd.back() == '\r') || (cmd.back() == ' '))) cmd.pop_back();
+		if (cmd.empty()) continue;
+		bool ok = true;
+		if (cmd.compare(0, 6, "?WATCH") == 0) {
+			if (cmd.find('=') != string::npos) {
+				bool enable = (cmd.find("\"enable\":false") == string::npos);
+				bool nmea = (cmd.find("\"nmea\":true") != string::npos);
+				bool json = (cmd.find("\"json\":true") != string::npos) || ((cmd.find("\"json\"") == string::npos) && !nmea);
+				c.json = enable && json;
+				c.nmea = enable && nmea;
+				LOG(DEBUG) << "gpsd simulator client watching json: " << c.json << " nmea: " << c.nmea;
+			}
+			char reply[160];
+			int len = snprintf(reply, sizeof(reply), "{\"class\":\"WATCH\",\"enable\":%s,\"json\":%s,\"nmea\":%s,\"raw\":0,\"scaled\":false,\"timing\":false}\r\n",
+							   (c.json || c.nmea) ? "true" : "false", (c.json) ? "true" : "false", (c.nmea) ? "true" : "false");
+			ok = send(c, devicesReply, strlen(devicesReply)) && send(c, reply, len);
+		} else if (cmd == "?VERSION") {
+			ok = send(c, versionReply, strlen(versionReply));
+		} else if (cmd == "?DEVICES") {
+			ok = send(c, devicesReply, strlen(devicesReply));
+		} else {
+			static const char *unknown = "{\"class\":\"ERROR\",\"message\":\"Unrecognized request\"}\r\n";
+			ok = send(c, unknown, strlen(unknown));
+		}
+		if (!ok) return false;
+	}
+	return true;
+}
+
+bool GPSdSimServer::send (Client& c, const char *data, size_t len) {
+	size_t done = 0;
+	while (done < len) {
+		ssize_t r = ::send(c.fd, data + done, len - done, MSG_NOSIGNAL);
+		if (r < 0) {
+			if (errno == EINTR) continue;
+			LOG(WARNING) << "gpsd simulator dropping client: " << strerror(errno);
+			return false;
+		}
+		done += r;
+	}
+	_bytes += len;
+	return true;
+}
+
+void GPSdSimServer::drop (size_t i) {
+	close(_clientList[i].fd);
+	_clientList.erase(_clientList.begin() + i);
+	_clients = _clientList.size();
+	LOG(INFO) << "gpsd simulator client disconnected";
+}
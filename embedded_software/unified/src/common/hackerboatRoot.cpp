@@ -0,0 +1,122 @@
+/******************************************************************************
+ * Hackerboat root class
+ * hackerboatRoot.cpp
+ * This module holds the pieces of the common root class that are too big to
+ * live in the header, chiefly the time packing and parsing functions
+ * see the Hackerboat documentation for more details
+ *
+ * Written by agent, Oct 2026
+ *
+ * Version 0.1: First alpha
+ *
+ ******************************************************************************/
+
+#include <chrono>
+#include <stdlib.h>
+#include "date.h"
+#include "hackerboatRoot.hpp"
+
+using namespace date;
+using namespace std::chrono;
+
+// Write val as exactly width decimal digits, zero padded
+static inline char* putDigits (char *p, unsigned val, int width) {
+	for (int i = width - 1; i >= 0; i--) {
+		p[i] = '0' + (val % 10);
+		val /= 10;
+	}
+	return p + width;
+}
+
+// Read exactly width decimal digits
+static inline bool getDigits (const char *&p, const char *end, int width, int& val) {
+	if ((end - p) < width) return false;
+	val = 0;
+	for (int i = 0; i < width; i++) {
+		if ((p[i] < '0') || (p[i] > '9')) return false;
+		val = (val * 10) + (p[i] - '0');
+	}
+	p += width;
+	return true;
+}
+
+static inline bool expect (const char *&p, const char *end, char c) {
+	if ((p < end) && (*p == c)) {
+		p++;
+		return true;
+	}
+	return false;
+}
+
+size_t HackerboatState::packTime (sysclock t, char *buf, size_t len) {
+	if (len < TIME_STRING_SIZE) return 0;
+	auto ms = date::floor<milliseconds>(t);
+	auto dp = date::floor<days>(ms);
+	year_month_day ymd {dp};
+	int y = static_cast<int>(ymd.year());
+	if ((y < 0) || (y > 9999)) return 0;
+	unsigned tod = static_cast<unsigned>((ms - dp).count());		// milliseconds since midnight
+	char *p = buf;
+
+	p = putDigits(p, y, 4);
+	*p++ = '-';
+	p = putDigits(p, static_cast<unsigned>(ymd.month()), 2);
+	*p++ = '-';
+	p = putDigits(p, static_cast<unsigned>(ymd.day()), 2);
+	*p++ = ' ';
+	p = putDigits(p, tod / 3600000, 2);
+	*p++ = ':';
+	p = putDigits(p, (tod / 60000) % 60, 2);
+	*p++ = ':';
+	p = putDigits(p, (tod / 1000) % 60, 2);
+	*p++ = '.';
+	p = putDigits(p, tod % 1000, 3);
+	*p = '\0';
+	return (p - buf);
+}
+
+bool HackerboatState::parseTime (const char *in, size_t len, sysclock& t) {
+	const char *p = in;
+	const char *end = in + len;
+	int y, mo, d, h, mi, s;
+	int offset = 0;						// minutes east of UTC
+	int64_t nanos = 0;
+
+	if (!getDigits(p, end, 4, y) || !expect(p, end, '-') ||
+		!getDigits(p, end, 2, mo) || !expect(p, end, '-') ||
+		!getDigits(p, end, 2, d)) return false;
+	if (!expect(p, end, 'T') && !expect(p, end, ' ')) return false;
+	if (!getDigits(p, end, 2, h) || !expect(p, end, ':') ||
+		!getDigits(p, end, 2, mi) || !expect(p, end, ':') ||
+		!getDigits(p, end, 2, s)) return false;
+	if (expect(p, end, '.')) {
+		int digits = 0;
+		for (; (p < end) && (*p >= '0') && (*p <= '9'); p++) {
+			if (digits < 9) {					// anything finer than a nanosecond is dropped
+				nanos = (nanos * 10) + (*p - '0');
+				digits++;
+			}
+		}
+		if (!digits) return false;
+		for (; digits < 9; digits++) nanos *= 10;
+	}
+	if (expect(p, end, 'Z') || expect(p, end, 'z')) {
+		offset = 0;
+	} else if ((p < end) && ((*p == '+') || (*p == '-'))) {
+		int sign = (*p++ == '-') ? -1 : 1;
+		int oh, om = 0;
+		if (!getDigits(p, end, 2, oh)) return false;
+		if (p < end) {
+			expect(p, end, ':');
+			if (!getDigits(p, end, 2, om)) return false;
+		}
+		offset = sign * ((oh * 60) + om);
+	}
+	if (p != end) return false;
+
+	year_month_day ymd {date::year(y), date::month(mo), date::day(d)};
+	if (!ymd.ok() || (h > 23) || (mi > 59) || (s > 60) || (abs(offset) > (24 * 60))) return false;	// 60 seconds is a leap second
+	auto tp = sys_days(ymd) + hours(h) + minutes(mi - offset) + seconds(s) + nanoseconds(nanos);
+	t = time_point_cast<sysclock::duration>(tp);
+	return true;
+}
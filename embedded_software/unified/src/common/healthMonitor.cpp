@@ -29,7 +29,8 @@ bool HealthMonitor::readHealth () {
 	//if (!_adc->lock.try_lock_for(ADC_LOCK_TIMEOUT)) {
 	//	return false;
 	//}
-	std::map<std::string, double> data = _adc->getScaledValues();	
+	_adc->getScaledValues(_data);
+	std::map<std::string, double>& data = _data;
 	this->recordTime = _adc->getLastInputTime();
 	//_adc->lock.unlock();
 	// End lock block
@@ -51,43 +52,22 @@ bool HealthMonitor::readHealth () {
 }
 
 bool HealthMonitor::parse (Value& input) {
-	string recordTimeIn;
-	bool result = true;
-
-	result &= GetVar("recordTime", recordTimeIn, input);
-	result &= HackerboatState::parseTime(recordTimeIn, this->recordTime);
-	result &= GetVar("servoCurrent", this->servoCurrent, input);
-	result &= GetVar("batteryMon", this->batteryMon, input);
-	result &= GetVar("mainVoltage", this->mainVoltage, input);
-	result &= GetVar("mainCurrent", this->mainCurrent, input);
-	result &= GetVar("chargeVoltage", this->chargeVoltage, input);
-	result &= GetVar("chargeCurrent", this->chargeVoltage, input);
-	result &= GetVar("motorVoltage", this->motorVoltage, input);
-	result &= GetVar("motorCurrent", this->motorCurrent, input);
-	result &= GetVar("rcRssi", this->rcRssi, input);
-	result &= GetVar("cellRssi", this->cellRssi, input);
-	result &= GetVar("wifiRssi", this->wifiRssi, input);
-	
-	valid = result;
-	return result;
+	valid = parseFields(fields, this, input);
+	return valid;
 }
 
-Value HealthMonitor::pack () const {
-	Value o;
-	int packResult = 0;
-	packResult += PutVar("recordTime", HackerboatState::packTime(this->recordTime), o);
-	packResult += PutVar("servoCurrent", this->servoCurrent, o);
-	packResult += PutVar("batteryMon", this->batteryMon, o);
-	packResult += PutVar("mainVoltage", this->mainVoltage, o);
-	packResult += PutVar("mainCurrent", this->mainCurrent, o);
-	packResult += PutVar("chargeVoltage", this->chargeVoltage, o);
-	packResult += PutVar("chargeCurrent", this->chargeCurrent, o);
-	packResult += PutVar("motorVoltage", this->motorVoltage, o);
-	packResult += PutVar("motorCurrent", this->motorCurrent, o);
-	packResult += PutVar("rcRssi", this->rcRssi, o);
-	packResult += PutVar("cellRssi", this->cellRssi, o);
-	packResult += PutVar("wifiRssi", this->wifiRssi, o);
-	
-	return o;
-	
-}
\ No newline at end of file
+const FieldDescriptor HealthMonitor::fields[] = {
+	FIELD(TimeField, "recordTime", HealthMonitor, recordTime),
+	FIELD(DoubleField, "servoCurrent", HealthMonitor, servoCurrent),
+	FIELD(DoubleField, "batteryMon", HealthMonitor, batteryMon),
+	FIELD(DoubleField, "mainVoltage", HealthMonitor, mainVoltage),
+	FIELD(DoubleField, "mainCurrent", HealthMonitor, mainCurrent),
+	FIELD(DoubleField, "chargeVoltage", HealthMonitor, chargeVoltage),
+	FIELD(DoubleField, "chargeCurrent", HealthMonitor, chargeCurrent),
+	FIELD(DoubleField, "motorVoltage", HealthMonitor, motorVoltage),
+	FIELD(DoubleField, "motorCurrent", HealthMonitor, motorCurrent),
+	FIELD(IntField, "rcRssi", HealthMonitor, rcRssi),
+	FIELD(IntField, "cellRssi", HealthMonitor, cellRssi),
+	FIELD(IntField, "wifiRssi", HealthMonitor, wifiRssi),
+	FIELD_END
+};
\ No newline at end of file
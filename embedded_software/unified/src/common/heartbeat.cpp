@@ -0,0 +1,118 @@
+/******************************************************************************
+ * Hackerboat heartbeat module
+ * heartbeat.cpp
+ * This module passes a heartbeat from the master control program to the
+ * watchdog through shared memory
+ *
+ * See the Hackerboat documentation for more details
+ * Written by agent, Oct 2026
+ *
+ * Version 0.1: First alpha
+ *
+ ******************************************************************************/
+
+#include <atomic>
+#include <string>
+#include <chrono>
+#include <errno.h>
+#include <string.h>
+#include "enumdefs.hpp"
+#include "configuration.hpp"
+#include "heartbeat.hpp"
+#include "easylogging++.h"
+extern "C" {
+	#include <sys/types.h>
+	#include <sys/stat.h>
+	#include <sys/mman.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+}
+
+using namespace std;
+using namespace std::chrono;
+
+static_assert(ATOMIC_INT_LOCK_FREE == 2, "Heartbeat requires lock-free 32-bit atomics");
+
+Heartbeat::~Heartbeat () {
+	this->close();
+}
+
+bool Heartbeat::open () {
+	struct stat shmStatus;
+	if (_block) return true;
+	_fd = shm_open(_name.c_str(), O_RDWR | O_CREAT, 0660);
+	if (_fd < 0) {
+		LOG(ERROR) << "Unable to open heartbeat " << _name << ": " << strerror(errno);
+		return false;
+	}
+	// whichever side gets here first sizes the block; a fresh block is all zeros
+	if ((fstat(_fd, &shmStatus) != 0) ||
+		((shmStatus.st_size < (off_t)sizeof(HeartbeatBlock)) && (ftruncate(_fd, sizeof(HeartbeatBlock)) != 0))) {
+		LOG(ERROR) << "Unable to size heartbeat " << _name << ": " << strerror(errno);
+		::close(_fd);
+		_fd = -1;
+		return false;
+	}
+	void *mem = mmap(NULL, sizeof(HeartbeatBlock), PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+	if (mem == MAP_FAILED) {
+		LOG(ERROR) << "Unable to map heartbeat " << _name << ": " << strerror(errno);
+		::close(_fd);
+		_fd = -1;
+		return false;
+	}
+	_block = static_cast<HeartbeatBlock*>(mem);
+	_seen = false;
+	LOG(INFO) << "Opened heartbeat " << _name;
+	return true;
+}
+
+void Heartbeat::close () {
+	if (_block) munmap(_block, sizeof(HeartbeatBlock));
+	if (_fd >= 0) ::close(_fd);
+	_block = NULL;
+	_fd = -1;
+}
+
+void Heartbeat::beat (BoatModeEnum mode) {
+	if (!_block) return;
+	if (_block->magic.load(memory_order_relaxed) != HEARTBEAT_MAGIC) {
+		_block->pid.store(getpid(), memory_order_relaxed);
+		_block->magic.store(HEARTBEAT_MAGIC, memory_order_relaxed);
+	}
+	_block->mode.store(static_cast<int32_t>(mode), memory_order_relaxed);
+	_block->counter.fetch_add(1, memory_order_release);
+}
+
+bool Heartbeat::check (sysdur timeout) {
+	steady_clock::time_point now = steady_clock::now();
+	if (!_block) return false;
+	uint32_t counter = _block->counter.load(memory_order_acquire);
+	if (!_seen || (counter != _lastCounter)) {
+		_lastCounter = counter;
+		_lastChange = now;
+		_seen = true;
+	}
+	return ((now - _lastChange) <= timeout);
+}
+
+uint32_t Heartbeat::getCounter () const {
+	if (!_block) return 0;
+	return _block->counter.load(memory_order_acquire);
+}
+
+BoatModeEnum Heartbeat::getMode () const {
+	if (!_block) return BoatModeEnum::NONE;
+	if (_block->magic.load(memory_order_relaxed) != HEARTBEAT_MAGIC) return BoatModeEnum::NONE;
+	return static_cast<BoatModeEnum>(_block->mode.load(memory_order_relaxed));
+}
+
+int Heartbeat::getPid () const {
+	if (!_block) return 0;
+	if (_block->magic.load(memory_order_relaxed) != HEARTBEAT_MAGIC) return 0;
+	return _block->pid.load(memory_order_relaxed);
+}
+
+sysdur Heartbeat::sinceLastBeat () const {
+	if (!_seen) return sysdur::zero();
+	return duration_cast<sysdur>(steady_clock::now() - _lastChange);
+}
@@ -0,0 +1,288 @@
+/******************************************************************************
+ * Hackerboat input reactor module
+ * inputReactor.cpp
+ * This module runs all of the input readers from a single thread
+ *
+ * See the Hackerboat documentation for more details
+ * Written by agent, Oct 2026
+ *
+ * Version 0.1: First alpha
+ *
+ ******************************************************************************/
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <list>
+#include <algorithm>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include "hal/inputThread.hpp"
+#include "hal/inputReactor.hpp"
+#include "configuration.hpp"
+#include "cycleProfiler.hpp"
+#include "realtime.hpp"
+#include "jsonScope.hpp"
+#include "easylogging++.h"
+
+using namespace std;
+using namespace std::chrono;
+
+#define REACTOR_MAX_EVENTS		(16)
+
+bool InputReactor::add (InputThread *input) {
+	std::lock_guard<std::mutex> guard(_lock);
+	if (!_running && !start()) return false;
+	Source *src = new Source();
+	struct epoll_event ev;
+	src->input = input;
+	src->timer = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+	if (src->timer < 0) {
+		LOG(ERROR) << "Unable to create input timer: " << strerror(errno);
+		delete src;
+		return false;
+	}
+	input->runFlag = true;
+	watch(src, input->getFD(), input->isConnecting());
+	arm(src);
+	ev.events = EPOLLIN;
+	ev.data.ptr = &(src->timerHandle);
+	if (epoll_ctl(_epoll, EPOLL_CTL_ADD, src->timer, &ev) != 0) {
+		LOG(ERROR) << "Unable to watch input timer: " << strerror(errno);
+		watch(src, -1, false);
+		close(src->timer);
+		delete src;
+		return false;
+	}
+	_sources.push_back(src);
+	LOG(INFO) << "Input added to reactor, " << ((src->fd >= 0) ? "watching fd " + to_string(src->fd) : "polling");
+	return true;
+}
+
+void InputReactor::remove (InputThread *input) {
+	std::unique_lock<std::mutex> guard(_lock);
+	for (;;) {
+		auto it = find_if(_sources.begin(), _sources.end(), [input] (Source *s) {return (s->input == input);});
+		if (it == _sources.end()) return;
+		Source *src = *it;
+		// an input killing itself from inside execute() can't wait for that execute() to finish; anyone
+		// else waits, and then looks again, since the reactor may have retired and freed the source meanwhile
+		if (src->busy && (std::this_thread::get_id() != _threadId)) {
+			_idle.wait(guard);
+			continue;
+		}
+		if (src->live) retire(src);
+		src->input = NULL;
+	}
+}
+
+void InputReactor::stop () {
+	{
+		std::lock_guard<std::mutex> guard(_lock);
+		if (!_running) return;
+		_running = false;
+		uint64_t one = 1;
+		if (write(_wake, &one, sizeof(one)) < 0) {
+			LOG(ERROR) << "Unable to wake the input reactor: " << strerror(errno);
+		}
+	}
+	if (_thread) {
+		_thread->join();
+		delete _thread;
+		_thread = NULL;
+	}
+	std::lock_guard<std::mutex> guard(_lock);
+	for (auto src : _sources) {
+		if (src->input) src->input->runFlag = false;		// not kill(), which would come back here for the lock
+		if (src->timer >= 0) close(src->timer);
+		delete src;
+	}
+	_sources.clear();
+	close(_wake);
+	close(_epoll);
+	_wake = -1;
+	_epoll = -1;
+	LOG(INFO) << "Input reactor stopped";
+}
+
+int InputReactor::getSourceCount () {
+	std::lock_guard<std::mutex> guard(_lock);
+	int count = 0;
+	for (auto src : _sources) {
+		if (src->live) count++;
+	}
+	return count;
+}
+
+bool InputReactor::start () {
+	_epoll = epoll_create1(EPOLL_CLOEXEC);
+	_wake = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if ((_epoll < 0) || (_wake < 0)) {
+		LOG(ERROR) << "Unable to create input reactor: " << strerror(errno);
+		if (_epoll >= 0) close(_epoll);
+		if (_wake >= 0) close(_wake);
+		_epoll = _wake = -1;
+		return false;
+	}
+	struct epoll_event ev;
+	ev.events = EPOLLIN;
+	ev.data.ptr = NULL;								// the only registration without a handle
+	epoll_ctl(_epoll, EPOLL_CTL_ADD, _wake, &ev);
+	_running = true;
+	_thread = new std::thread(&InputReactor::run, this);
+	_threadId = _thread->get_id();
+	LOG(INFO) << "Input reactor started";
+	return true;
+}
+
+void InputReactor::run () {
+	struct epoll_event events[REACTOR_MAX_EVENTS];
+	RealTime::get()->configureThread("Reactor");
+	_latency = &(RealTime::get()->wakeup("Reactor"));
+	while (_running) {
+		int count = epoll_wait(_epoll, events, REACTOR_MAX_EVENTS, -1);
+		if (count < 0) {
+			if (errno != EINTR) {
+				LOG(ERROR) << "epoll_wait() failed in input reactor: " << strerror(errno);
+				std::this_thread::sleep_for(10ms);
+			}
+			continue;
+		}
+		for (int i = 0; (i < count) && _running; i++) {
+			Handle *h = static_cast<Handle*>(events[i].data.ptr);
+			if (h) dispatch(h->source, events[i].events, h->timer);
+		}
+		// nothing in this batch refers to a retired source any more, and epoll won't hand them back
+		reap();
+	}
+}
+
+void InputReactor::dispatch (Source *src, uint32_t events, bool timer) {
+	uint64_t expirations;
+	InputThread *input;
+	{
+		std::lock_guard<std::mutex> guard(_lock);
+		if (!src->live) return;
+		if (!src->input->runFlag) {
+			retire(src);
+			return;
+		}
+		if (timer) {
+			if (read(src->timer, &expirations, sizeof(expirations)) < 0) return;	// already drained
+			recordLatency(src, expirations);
+		} else if (!src->connecting && !(events & EPOLLIN)) {
+			// hung up or errored with nothing left to read; fall back to the timer until the input reconnects
+			LOG(WARNING) << "Input fd " << src->fd << " is no longer readable";
+			src->hungUp = src->fd;
+			watch(src, -1, false);
+			arm(src);
+			return;
+		}
+		src->busy = true;
+		input = src->input;
+	}
+
+	// remove() waits for busy to clear, so the input can't go away under us
+	input->wakeups.fetch_add(1, memory_order_relaxed);
+	_dispatches.fetch_add(1, memory_order_relaxed);
+	{
+		JSONScope jsonScope;
+		input->execute();
+	}
+	int fd = input->getFD();
+	bool connecting = input->isConnecting();
+
+	std::lock_guard<std::mutex> guard(_lock);
+	src->busy = false;
+	_idle.notify_all();
+	if (!src->live) return;								// removed while it ran
+	if (fd < 0) {
+		// the input has let its descriptor go, so the next one is new even if it gets the same number
+		src->hungUp = -1;
+		if (src->fd >= 0) {
+			watch(src, -1, false);
+			arm(src);
+		}
+	} else if (((fd != src->fd) && (fd != src->hungUp)) || ((fd == src->fd) && (connecting != src->connecting))) {
+		watch(src, fd, connecting);
+		arm(src);
+	} else if (src->fd >= 0) {
+		arm(src);										// push the timeout back, since we just heard from it
+	}
+}
+
+void InputReactor::recordLatency (Source *src, uint64_t expirations) {
+	struct itimerspec spec;
+	if (!_latency || (timerfd_gettime(src->timer, &spec) != 0)) return;
+	// the timer is periodic, so the time left until the next expiry tells us how long ago the first one was
+	nanoseconds interval = seconds(spec.it_interval.tv_sec) + nanoseconds(spec.it_interval.tv_nsec);
+	nanoseconds remaining = seconds(spec.it_value.tv_sec) + nanoseconds(spec.it_value.tv_nsec);
+	_latency->record((interval * (int64_t)expirations) - remaining);
+}
+
+bool InputReactor::watch (Source *src, int fd, bool connecting) {
+	struct epoll_event ev;
+	if (src->fd >= 0) {
+		epoll_ctl(_epoll, EPOLL_CTL_DEL, src->fd, &ev);		// fails harmlessly if it has already been closed
+		src->fd = -1;
+		src->connecting = false;
+	}
+	if (fd < 0) return true;
+	ev.events = (connecting) ? EPOLLOUT : EPOLLIN;
+	ev.data.ptr = &(src->fdHandle);
+	if (epoll_ctl(_epoll, EPOLL_CTL_ADD, fd, &ev) != 0) {
+		LOG(ERROR) << "Unable to watch input fd " << fd << ": " << strerror(errno);
+		return false;
+	}
+	src->fd = fd;
+	src->connecting = connecting;
+	src->hungUp = -1;
+	return true;
+}
+
+bool InputReactor::arm (Source *src) {
+	struct itimerspec spec;
+	nanoseconds interval;
+	if (src->fd >= 0) {
+		interval = duration_cast<nanoseconds>(Conf::get()->inputEventTimeout());
+	} else interval = duration_cast<nanoseconds>(src->input->period);
+	if (interval <= nanoseconds::zero()) interval = 1ms;
+	spec.it_interval.tv_sec = interval.count() / 1000000000;
+	spec.it_interval.tv_nsec = interval.count() % 1000000000;
+	spec.it_value = spec.it_interval;
+	if (timerfd_settime(src->timer, 0, &spec, NULL) != 0) {
+		LOG(ERROR) << "Unable to arm input timer: " << strerror(errno);
+		return false;
+	}
+	return true;
+}
+
+void InputReactor::retire (Source *src) {
+	struct epoll_event ev;
+	watch(src, -1, false);
+	epoll_ctl(_epoll, EPOLL_CTL_DEL, src->timer, &ev);
+	src->live = false;
+	LOG(INFO) << "Input removed from reactor";
+}
+
+void InputReactor::reap () {
+	std::lock_guard<std::mutex> guard(_lock);
+	for (auto it = _sources.begin(); it != _sources.end();) {
+		Source *src = *it;
+		if (src->live || src->busy) {
+			it++;
+			continue;
+		}
+		if (src->timer >= 0) close(src->timer);
+		delete src;
+		it = _sources.erase(it);
+	}
+}
+
+InputReactor* InputReactor::_instance = new InputReactor();
@@ -0,0 +1,117 @@
+/******************************************************************************
+ * Hackerboat threaded input module
+ * inputThread.cpp
+ * This module provides common routines for all threaded input readers
+ *
+ * See the Hackerboat documentation for more details
+ * Written by agent, Oct 2026
+ *
+ * Version 0.1: First alpha
+ *
+ ******************************************************************************/
+
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <errno.h>
+#include <string.h>
+#include "enumdefs.hpp"
+#include "enumtable.hpp"
+#include "hal/inputThread.hpp"
+#include "hal/inputReactor.hpp"
+#include "configuration.hpp"
+#include "cycleProfiler.hpp"
+#include "realtime.hpp"
+#include "jsonScope.hpp"
+#include "easylogging++.h"
+extern "C" {
+	#include <poll.h>
+}
+
+using namespace std;
+using namespace std::chrono;
+
+InputModeEnum InputThread::configuredMode () {
+	InputModeEnum mode = InputModeEnum::PERIODIC;
+	if (!inputModeNames.get(Conf::get()->inputMode(), &mode) || (mode == InputModeEnum::NONE)) {
+		LOG(WARNING) << "Unknown input mode " << Conf::get()->inputMode() << ", using Periodic";
+		mode = InputModeEnum::PERIODIC;
+	}
+	return mode;
+}
+
+InputThread::~InputThread () {
+	kill();
+}
+
+void InputThread::kill () {
+	runFlag = false;
+	if (inputMode == InputModeEnum::REACTOR) InputReactor::get()->remove(this);
+}
+
+bool InputThread::launch () {
+	if (inputMode == InputModeEnum::REACTOR) {
+		return InputReactor::get()->add(this);
+	}
+	std::thread runner(InputThreadRunner(this));
+	runner.detach();
+	return true;
+}
+
+void InputThread::InputThreadRunner::operator()() {
+	me->runFlag = true;
+	RealTime::get()->configureThread(me->getThreadName());
+	me->wakeupLatency = &(RealTime::get()->wakeup(me->getThreadName()));
+	while (me->runFlag) {
+		JSONScope jsonScope;
+		int fd = me->getFD();
+		if ((me->inputMode != InputModeEnum::PERIODIC) && (fd >= 0)) {
+			me->waitForInput(fd, me->isConnecting());
+			me->wakeups.fetch_add(1, memory_order_relaxed);
+			me->execute();
+		} else {
+			auto endtime = steady_clock::now() + me->period;
+			me->wakeups.fetch_add(1, memory_order_relaxed);
+			me->execute();
+			std::this_thread::sleep_until(endtime);
+			me->wakeupLatency->record(steady_clock::now() - endtime);
+		}
+	}
+}
+
+bool InputThread::waitForInput (int fd, bool connecting) {
+	struct pollfd pfd;
+	milliseconds timeout = duration_cast<milliseconds>(Conf::get()->inputEventTimeout());
+	auto deadline = steady_clock::now() + timeout;
+	pfd.fd = fd;
+	pfd.events = (connecting) ? POLLOUT : POLLIN;
+	pfd.revents = 0;
+	int result = poll(&pfd, 1, timeout.count());
+	if (result < 0) {
+		if (errno != EINTR) {
+			LOG_EVERY_N(100, ERROR) << "poll() failed on input fd " << fd << ": " << strerror(errno);
+			std::this_thread::sleep_for(period);
+		}
+		return false;
+	}
+	if (result == 0) {
+		// only a timeout has a known intended wakeup time
+		if (wakeupLatency) wakeupLatency->record(steady_clock::now() - deadline);
+		return false;
+	}
+	if (connecting) return true;					// execute() finds out whether the connection was made
+	if (!(pfd.revents & POLLIN)) {
+		// hung up or errored with nothing left to read; don't spin on it
+		LOG_EVERY_N(100, WARNING) << "Input fd " << fd << " is no longer readable";
+		std::this_thread::sleep_for(period);
+		return false;
+	}
+	return true;
+}
+
+const EnumNameTable<InputModeEnum> InputThread::inputModeNames = {
+	"Periodic",
+	"Event",
+	"Reactor",
+	"None"
+};
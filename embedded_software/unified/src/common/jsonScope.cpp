@@ -0,0 +1,63 @@
+/******************************************************************************
+ * Hackerboat json scope module
+ * jsonScope.cpp
+ * This module provides the per-thread allocator used when packing objects
+ * into rapidjson Values, and the scopes that bound its lifetime
+ *
+ * See the Hackerboat documentation for more details
+ * Written by agent, Oct 2026
+ *
+ * Version 0.1: First alpha
+ *
+ ******************************************************************************/
+
+#include <cstddef>
+#include <memory>
+#include <string.h>
+#include "rapidjson/rapidjson.h"
+#include "rapidjson/allocators.h"
+#include "jsonScope.hpp"
+
+using namespace rapidjson;
+using namespace std;
+
+namespace {
+	struct ThreadArena {
+		ThreadArena () : block(new char[JSON_ARENA_SIZE]), alloc(block.get(), JSON_ARENA_SIZE) {
+			memset(block.get(), 0, JSON_ARENA_SIZE);		// fault the pages in now rather than in the middle of a cycle
+		}
+		unique_ptr<char[]>			block;				// declared first so it outlives alloc
+		MemoryPoolAllocator<>		alloc;
+		int							depth = 0;
+	};
+
+	ThreadArena& arena () {
+		static thread_local ThreadArena mine;
+		return mine;
+	}
+}
+
+JSONScope::JSONScope () {
+	arena().depth++;
+}
+
+JSONScope::~JSONScope () {
+	ThreadArena& a = arena();
+	if (--a.depth > 0) return;
+	a.depth = 0;
+	size_t size = a.alloc.Size();
+	if (size > _highWater.load(memory_order_relaxed)) _highWater.store(size, memory_order_relaxed);
+	if (a.alloc.Capacity() > JSON_ARENA_SIZE) _spills.fetch_add(1, memory_order_relaxed);
+	a.alloc.Clear();										// frees any chunks beyond the block
+}
+
+MemoryPoolAllocator<>& JSONScope::allocator () {
+	return arena().alloc;
+}
+
+size_t JSONScope::used () {
+	return arena().alloc.Size();
+}
+
+atomic<size_t> JSONScope::_highWater { 0 };
+atomic<uint64_t> JSONScope::_spills { 0 };
@@ -16,8 +16,12 @@
 #include "rapidjson/rapidjson.h"
 #include <stdlib.h>
 #include <math.h>
+#include <vector>
+#include <algorithm>
 #include "location.hpp"
+#include "lanes.hpp"
 #include "twovector.hpp"
+#include "configuration.hpp"
 #include "easylogging++.h"
 
 using namespace GeographicLib;
@@ -26,6 +30,26 @@ using namespace rapidjson;
 /* Minimum angle (close to roundoff error) */
 #define MIN_ANG	0.0000001
 
+/* Iterations of the approximate projection; the mean latitude settles in two */
+#define APPROX_DIRECT_ITERATIONS	(3)
+
+/* Targets a batched query works through at a time, in buffers on the stack; a multiple of BATCH_LANES */
+#define BATCH_CHUNK					(64)
+
+/* Largest difference in latitude or longitude, in degrees, that the batched kernel's series are good for */
+#define BATCH_MAX_DEG				(1.0)
+
+static const double wgsA = Constants::WGS84_a();
+static const double wgsE2 = Constants::WGS84_f() * (2 - Constants::WGS84_f());
+
+/* Meridional (M) and prime vertical (N) radii of curvature of the ellipsoid at latitude phi, in radians */
+static void radii (double phi, double& M, double& N) {
+	double s = sin(phi);
+	double w = 1 - (wgsE2 * s * s);
+	N = wgsA / sqrt(w);
+	M = N * (1 - wgsE2) / w;
+}
+
 /* Reading and writing from JSON and the database. */
 
 bool Location::isValid(void) const {
@@ -34,33 +58,62 @@ bool Location::isValid(void) const {
 			(std::isfinite(lat)) && (std::isfinite(lon)));
 }
 
-bool Location::parse(Value& input) {
-	LOG(DEBUG) << "Parsing a location object from " << input;
-	GetVar("lon", this->lon, input);
-	GetVar("lat", this->lat, input);
-	return this->isValid();
+const FieldDescriptor Location::fields[] = {
+	FIELD(DoubleField, "lat", Location, lat),
+	FIELD(DoubleField, "lon", Location, lon),
+	FIELD_END
+};
+
+/* Computation methods. */
+
+/* The approximate course works in a plane tangent to the ellipsoid at the mean latitude of the two points,
+ * scaled by the radii of curvature there. The bearing along the chord is corrected for the convergence of
+ * the meridians to give the initial bearing, as the great circle does. Within 10 km and 80 degrees of
+ * latitude, this is within 3 cm and 0.0001 degrees of the great circle, and several times faster. */
+
+bool Location::approxInverse (const Location& dest, double& dist, double& azi) const {
+	if ((fabs(this->lat) > LOCATION_APPROX_MAX_LAT) || (fabs(dest.lat) > LOCATION_APPROX_MAX_LAT)) return false;
+	double phi = TwoVector::deg2rad((this->lat + dest.lat) / 2);
+	double dlon = remainder(dest.lon - this->lon, 360.0);		// the short way round, across the antimeridian if need be
+	double M, N;
+	radii(phi, M, N);
+	double north = TwoVector::deg2rad(dest.lat - this->lat) * M;
+	double east = TwoVector::deg2rad(dlon) * N * cos(phi);
+	dist = hypot(north, east);
+	if (dist > Conf::get()->approxMaxDistance()) return false;
+	azi = remainder(TwoVector::rad2deg(atan2(east, north)) - ((dlon / 2) * sin(phi)), 360.0);
+	return true;
 }
 
-Value Location::pack(void) const {
-	Value d;
-	int packResult = 0;
-	if (this->isValid()) {
-		packResult += PutVar("lon", this->lon, d);
-		packResult += PutVar("lat", this->lat, d);
-	} else {
-		packResult += PutVar("lon", NAN, d);
-		packResult += PutVar("lat", NAN, d);
+bool Location::approxDirect (TwoVector& projection, Location& result) const {
+	double dist = projection.mag();
+	double azi = projection.angleDeg();
+	if ((fabs(this->lat) > LOCATION_APPROX_MAX_LAT) || !(dist <= Conf::get()->approxMaxDistance())) return false;
+	double phi = TwoVector::deg2rad(this->lat);
+	double dlat = 0, dlon = 0;
+	for (int i = 0; i < APPROX_DIRECT_ITERATIONS; i++) {
+		double M, N;
+		radii(phi, M, N);
+		double chord = TwoVector::deg2rad(azi + ((dlon / 2) * sin(phi)));
+		dlat = TwoVector::rad2deg((dist * cos(chord)) / M);
+		dlon = TwoVector::rad2deg((dist * sin(chord)) / (N * cos(phi)));
+		phi = TwoVector::deg2rad(this->lat + (dlat / 2));
 	}
-	
-	return d;
+	result.lat = this->lat + dlat;
+	result.lon = remainder(this->lon + dlon, 360.0);
+	return (fabs(result.lat) <= LOCATION_APPROX_MAX_LAT);
 }
 
-/* Computation methods. */
-
 double Location::bearing (const Location& dest, CourseTypeEnum type) const {
 	if ((!this->isValid()) || (!dest.isValid())) return NAN;
 	double azi1, azi2, dist;
 	switch (type) {
+		case CourseTypeEnum::Approximate:
+			if (approxInverse(dest, dist, azi1)) {
+				VLOG(3) << "Approximate bearing to " << dest << " is " << to_string(azi1);
+				return azi1;
+			}
+			// fall through to the great circle
 		case CourseTypeEnum::GreatCircle: {
 			geod->Inverse(this->lat, this->lon, dest.lat, dest.lon, azi1, azi2);
 			VLOG(3) << "Great circle bearing to " << dest << " is " << to_string(azi1);
@@ -83,6 +136,12 @@ double Location::distance (const Location& dest, CourseTypeEnum type) const {
 	if ((!this->isValid()) || (!dest.isValid())) return NAN;
 	double azi1, dist;
 	switch (type) {
+		case CourseTypeEnum::Approximate:
+			if (approxInverse(dest, dist, azi1)) {
+				VLOG(3) << "Approximate distance to " << dest << " is " << to_string(dist) << "m";
+				return dist;
+			}
+			// fall through to the great circle
 		case CourseTypeEnum::GreatCircle: {
 			geod->Inverse(this->lat, this->lon, dest.lat, dest.lon, dist);
 			VLOG(3) << "Great circle distance to " << dest << " is " << to_string(dist) << "m";
@@ -115,6 +174,12 @@ TwoVector Location::target (const Location& dest, CourseTypeEnum type) const {
 Location Location::project (TwoVector& projection, CourseTypeEnum type) {					
 	Location result;
 	switch (type) {
+		case CourseTypeEnum::Approximate:
+			if (approxDirect(projection, result)) {
+				VLOG(3) << "Approximate projection along " << projection << " is " << result;
+				return result;
+			}
+			// fall through to the great circle
 		case CourseTypeEnum::GreatCircle: {
 			geod->Direct(this->lat, this->lon, projection.angleDeg(), projection.mag(), result.lat, result.lon);
 			VLOG(3) << "Great circle projection along " << projection << " is " << result;
@@ -132,6 +197,116 @@ Location Location::project (TwoVector& projection, CourseTypeEnum type) {
 	return result;
 } 
 
+void Location::course (const Location& dest, double& dist, double& azi, CourseTypeEnum type) const {
+	if ((type == CourseTypeEnum::Approximate) && this->isValid() && dest.isValid() && approxInverse(dest, dist, azi)) return;
+	inverse(dest.lat, dest.lon, (type == CourseTypeEnum::RhumbLine) ? type : CourseTypeEnum::GreatCircle, dist, azi);
+}
+
+void Location::inverse (double destLat, double destLon, CourseTypeEnum type, double& dist, double& azi) const {
+	double azi2;
+	if ((!this->isValid()) || (!Location(destLat, destLon).isValid())) {
+		dist = NAN;
+		azi = NAN;
+	} else if (type == CourseTypeEnum::RhumbLine) {
+		rhumb->Inverse(this->lat, this->lon, destLat, destLon, dist, azi);
+	} else {
+		geod->Inverse(this->lat, this->lon, destLat, destLon, dist, azi, azi2);
+	}
+}
+
+/* The batched approximate kernel does what approxInverse() does, four targets at a time, on the differences
+ * from the origin in radians. Single precision is good to a millimeter at 10 km. The sine and cosine of the
+ * mean latitude come from the origin's by the angle sum formulas, and the radii of curvature are power series
+ * in e^2 sin^2, so everything is a multiply or an add apart from the final square root. */
+
+static void batchKernel (const float *dlat, const float *dlon, size_t count, float sinPhi, float cosPhi,
+						 float *north, float *east, float *dist, float *conv) {
+	const lanes one = lset(1.0f);
+	const lanes half = lset(0.5f);
+	const lanes sixth = lset(1.0f / 6.0f);
+	const lanes e2 = lset(wgsE2);
+	const lanes a = lset(wgsA);
+	const lanes am = lset(wgsA * (1 - wgsE2));
+	const lanes sp = lset(sinPhi);
+	const lanes cp = lset(cosPhi);
+	for (size_t i = 0; i < count; i += BATCH_LANES) {
+		lanes la = lload(dlat + i);
+		lanes lo = lload(dlon + i);
+		lanes h = lmul(la, half);
+		lanes h2 = lmul(h, h);
+		lanes ch = lsub(one, lmul(h2, half));								// cos(h)
+		lanes sh = lmul(h, lsub(one, lmul(h2, sixth)));						// sin(h)
+		lanes s = ladd(lmul(sp, ch), lmul(cp, sh));							// sin(phi + h)
+		lanes c = lsub(lmul(cp, ch), lmul(sp, sh));							// cos(phi + h)
+		lanes x = lmul(e2, lmul(s, s));
+		lanes rn = ladd(one, lmul(x, ladd(lset(0.5f), lmul(x, ladd(lset(0.375f), lmul(x, lset(0.3125f)))))));		// (1 - x)^-1/2
+		lanes rm = ladd(one, lmul(x, ladd(lset(1.5f), lmul(x, ladd(lset(1.875f), lmul(x, lset(2.1875f)))))));		// (1 - x)^-3/2
+		lanes n = lmul(la, lmul(am, rm));
+		lanes e = lmul(lo, lmul(a, lmul(rn, c)));
+		lstore(north + i, n);
+		lstore(east + i, e);
+		lstore(dist + i, lsqrt(ladd(lmul(n, n), lmul(e, e))));
+		lstore(conv + i, lmul(lo, lmul(s, half)));
+	}
+}
+
+size_t Location::targets (const double *lats, const double *lons, size_t count, double *dist, double *azi, CourseTypeEnum type) const {
+	double skip;
+	size_t exact = 0;
+	if ((type != CourseTypeEnum::Approximate) || (!this->isValid()) || (fabs(this->lat) > LOCATION_APPROX_MAX_LAT)) {
+		for (size_t i = 0; i < count; i++) {
+			inverse(lats[i], lons[i], type, dist[i], (azi) ? azi[i] : skip);
+		}
+		return count;
+	}
+
+	float dlat[BATCH_CHUNK], dlon[BATCH_CHUNK], north[BATCH_CHUNK], east[BATCH_CHUNK], d[BATCH_CHUNK], conv[BATCH_CHUNK];
+	double phi = TwoVector::deg2rad(this->lat);
+	double maxDist = Conf::get()->approxMaxDistance();
+	const float maxRad = TwoVector::deg2rad(BATCH_MAX_DEG);
+	for (size_t start = 0; start < count; start += BATCH_CHUNK) {
+		size_t n = std::min((size_t)BATCH_CHUNK, count - start);
+		size_t padded = ((n + BATCH_LANES - 1) / BATCH_LANES) * BATCH_LANES;
+		for (size_t i = 0; i < n; i++) {
+			double dl = lons[start + i] - this->lon;
+			if (dl > 180) {
+				dl -= 360;
+			} else if (dl < -180) dl += 360;
+			dlat[i] = TwoVector::deg2rad(lats[start + i] - this->lat);
+			dlon[i] = TwoVector::deg2rad(dl);
+		}
+		std::fill(dlat + n, dlat + padded, 0.0f);
+		std::fill(dlon + n, dlon + padded, 0.0f);
+		batchKernel(dlat, dlon, padded, sin(phi), cos(phi), north, east, d, conv);
+		for (size_t i = 0; i < n; i++) {
+			size_t k = start + i;
+			// written so that NaN, from an invalid target, fails the test
+			if ((fabs(lats[k]) <= LOCATION_APPROX_MAX_LAT) && (fabs(dlat[i]) <= maxRad) && (fabs(dlon[i]) <= maxRad) && (d[i] <= maxDist)) {
+				dist[k] = d[i];
+				if (azi) azi[k] = remainder(TwoVector::rad2deg(atan2(east[i], north[i]) - conv[i]), 360.0);
+			} else {
+				inverse(lats[k], lons[k], CourseTypeEnum::GreatCircle, dist[k], (azi) ? azi[k] : skip);
+				exact++;
+			}
+		}
+	}
+	return exact;
+}
+
+size_t Location::targets (const std::vector<Location>& dests, double *dist, double *azi, CourseTypeEnum type) const {
+	double lats[BATCH_CHUNK], lons[BATCH_CHUNK];
+	size_t exact = 0;
+	for (size_t start = 0; start < dests.size(); start += BATCH_CHUNK) {
+		size_t n = std::min((size_t)BATCH_CHUNK, dests.size() - start);
+		for (size_t i = 0; i < n; i++) {
+			lats[i] = dests[start + i].lat;
+			lons[i] = dests[start + i].lon;
+		}
+		exact += targets(lats, lons, n, dist + start, (azi) ? (azi + start) : NULL, type);
+	}
+	return exact;
+}
+
 Geodesic *Location::geod = new Geodesic(Constants::WGS84_a(), Constants::WGS84_f());
 Rhumb *Location::rhumb = new Rhumb(Constants::WGS84_a(), Constants::WGS84_f());
 
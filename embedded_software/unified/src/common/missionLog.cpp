@@ -0,0 +1,422 @@
+/******************************************************************************
+ * Hackerboat mission log module
+ * missionLog.cpp
+ * This module maps master logs and CSV files into memory and keeps a sparse
+ * time index of them beside the log, so that time range and field queries
+ * only read the parts of the log they need
+ *
+ * See the Hackerboat documentation for more details
+ * Written by agent, Oct 2026
+ *
+ * Version 0.1: First alpha
+ *
+ ******************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <limits>
+#include <algorithm>
+#include "hackerboatRoot.hpp"
+#include "missionLog.hpp"
+#include "flightRecorder.hpp"
+#include "csvWriter.hpp"
+#include "easylogging++.h"
+extern "C" {
+	#include <sys/types.h>
+	#include <sys/stat.h>
+	#include <sys/mman.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+}
+
+using namespace std;
+using namespace std::chrono;
+
+static const size_t tagLen = strlen(MISSIONLOG_LINE_TAG);
+
+static int64_t toMillis (sysclock t) {
+	return duration_cast<milliseconds>(t.time_since_epoch()).count();
+}
+
+static bool readNumber (const string& text, double& out) {
+	char *stop;
+	if (text.empty()) return false;
+	out = strtod(text.c_str(), &stop);
+	return (*stop == '\0');
+}
+
+bool LogFilter::parse (const std::string& spec, LogFilter& filter) {
+	size_t at = spec.find_first_of("=!<>");
+	if ((at == string::npos) || (at == 0)) return false;
+	size_t len = 1;
+	string op = spec.substr(at, 2);
+	if (op == "!=") {
+		filter.op = Op::NE;
+		len = 2;
+	} else if (op == "<=") {
+		filter.op = Op::LE;
+		len = 2;
+	} else if (op == ">=") {
+		filter.op = Op::GE;
+		len = 2;
+	} else if (op[0] == '=') {
+		filter.op = Op::EQ;
+	} else if (op[0] == '<') {
+		filter.op = Op::LT;
+	} else if (op[0] == '>') {
+		filter.op = Op::GT;
+	} else return false;
+	filter.column = spec.substr(0, at);
+	filter.value = spec.substr(at + len);
+	filter.numeric = readNumber(filter.value, filter.number);
+	return true;
+}
+
+bool LogFilter::match (const std::string& field) const {
+	int order;
+	if (numeric) {
+		double v;
+		if (!readNumber(field, v)) return (op == Op::NE);
+		order = (v < number) ? -1 : ((v > number) ? 1 : 0);
+	} else {
+		order = field.compare(value);
+	}
+	switch (op) {
+		case Op::EQ: return (order == 0);
+		case Op::NE: return (order != 0);
+		case Op::LT: return (order < 0);
+		case Op::GT: return (order > 0);
+		case Op::LE: return (order <= 0);
+		case Op::GE: return (order >= 0);
+	}
+	return false;
+}
+
+bool MissionLog::open (const std::string& path, bool useCache) {
+	close();
+	_fd = ::open(path.c_str(), O_RDONLY);
+	if (_fd < 0) {
+		LOG(ERROR) << "Unable to open mission log " << path << ": " << strerror(errno);
+		return false;
+	}
+	struct stat fileStatus;
+	if (fstat(_fd, &fileStatus) != 0) {
+		LOG(ERROR) << "Unable to stat mission log " << path << ": " << strerror(errno);
+		close();
+		return false;
+	}
+	_size = fileStatus.st_size;
+	if (_size > 0) {
+		void *mem = mmap(NULL, _size, PROT_READ, MAP_SHARED, _fd, 0);
+		if (mem == MAP_FAILED) {
+			LOG(ERROR) << "Unable to map mission log " << path << ": " << strerror(errno);
+			close();
+			return false;
+		}
+		_base = static_cast<const char*>(mem);
+	}
+	int64_t mtime = ((int64_t)fileStatus.st_mtim.tv_sec * 1000000000LL) + fileStatus.st_mtim.tv_nsec;
+
+	string indexPath = path + MISSIONLOG_INDEX_SUFFIX;
+	uint64_t was = 0;
+	bool sameTime = false;
+	if (useCache && load(indexPath, mtime, sameTime)) {
+		_fromCache = true;
+		was = _indexed;
+		// reopen a short last block, so that a log that grows a little at a time doesn't get tiny blocks
+		uint64_t from = _indexed;
+		if (!_blocks.empty() && (_blocks.back().end == _indexed) &&
+			((_blocks.back().end - _blocks.back().offset) < MISSIONLOG_INDEX_STRIDE) && (_size > _indexed)) {
+			from = _blocks.back().offset;
+			_blocks.pop_back();
+			while (!_headers.empty() && (_headers.back() >= from)) _headers.pop_back();
+		}
+		build(from);
+	} else {
+		build(0);
+	}
+	if (!_fromCache || (_indexed != was) || !sameTime) save(indexPath, mtime);
+	VLOG(1) << "Mission log " << path << ": " << lines() << " lines in " << _blocks.size() << " blocks, "
+			<< (_fromCache ? "index reused" : "index built");
+	return true;
+}
+
+void MissionLog::close () {
+	if (_base) munmap(const_cast<char*>(_base), _size);
+	if (_fd >= 0) ::close(_fd);
+	_fd = -1;
+	_base = NULL;
+	_size = 0;
+	_indexed = 0;
+	_flags = 0;
+	_fromCache = false;
+	_blocks.clear();
+	_headers.clear();
+}
+
+uint64_t MissionLog::lines () const {
+	uint64_t count = 0;
+	for (auto& b : _blocks) count += b.lines;
+	return count;
+}
+
+sysclock MissionLog::start () const {
+	if (_blocks.empty()) return sysclock();
+	int64_t t = numeric_limits<int64_t>::max();
+	for (auto& b : _blocks) t = min(t, b.minTime);
+	return sysclock(milliseconds(t));
+}
+
+sysclock MissionLog::end () const {
+	if (_blocks.empty()) return sysclock();
+	int64_t t = numeric_limits<int64_t>::min();
+	for (auto& b : _blocks) t = max(t, b.maxTime);
+	return sysclock(milliseconds(t));
+}
+
+bool MissionLog::load (const std::string& path, int64_t mtime, bool& sameTime) {
+	LogIndexHeader header;
+	FILE *in = fopen(path.c_str(), "rb");
+	if (!in) return false;
+	bool ok = (fread(&header, sizeof(header), 1, in) == 1) &&
+			  (memcmp(header.magic, MISSIONLOG_INDEX_MAGIC, sizeof(header.magic)) == 0) &&
+			  (header.version == MISSIONLOG_INDEX_VERSION) &&
+			  (header.stride == MISSIONLOG_INDEX_STRIDE) &&
+			  (header.logSize <= _size) &&
+			  (header.blocks <= (header.logSize / 2) + 1) &&		// a block holds at least one line of at least two bytes
+			  (header.headers <= (header.logSize / 2) + 1);
+	if (ok) {
+		_blocks.resize(header.blocks);
+		_headers.resize(header.headers);
+		ok = (fread(_blocks.data(), sizeof(LogIndexBlock), _blocks.size(), in) == _blocks.size()) &&
+			 (fread(_headers.data(), sizeof(uint64_t), _headers.size(), in) == _headers.size());
+	}
+	fclose(in);
+	if (ok) {
+		_indexed = header.logSize;
+		_flags = header.flags;
+		sameTime = (header.logSize == _size) && (header.logMtime == mtime);
+		// a log that was rewritten in place, or cut short and written again, doesn't match at the ends
+		if (!sameTime) ok = (check() == header.check);
+	}
+	if (!ok) {
+		VLOG(1) << "Mission log index " << path << " is stale; rebuilding";
+		_blocks.clear();
+		_headers.clear();
+		_indexed = 0;
+		_flags = 0;
+	}
+	return ok;
+}
+
+void MissionLog::save (const std::string& path, int64_t mtime) const {
+	LogIndexHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, MISSIONLOG_INDEX_MAGIC, sizeof(header.magic));
+	header.version = MISSIONLOG_INDEX_VERSION;
+	header.stride = MISSIONLOG_INDEX_STRIDE;
+	header.logSize = _indexed;
+	header.logMtime = mtime;
+	header.check = check();
+	header.flags = _flags;
+	header.blocks = _blocks.size();
+	header.headers = _headers.size();
+
+	// write it beside the real one and rename it, so a reader never sees half an index
+	string tmp = path + ".tmp";
+	FILE *out = fopen(tmp.c_str(), "wb");
+	bool ok = (out != NULL);
+	if (ok) {
+		ok = (fwrite(&header, sizeof(header), 1, out) == 1) &&
+			 (fwrite(_blocks.data(), sizeof(LogIndexBlock), _blocks.size(), out) == _blocks.size()) &&
+			 (fwrite(_headers.data(), sizeof(uint64_t), _headers.size(), out) == _headers.size());
+		ok = (fclose(out) == 0) && ok;
+		ok = ok && (rename(tmp.c_str(), path.c_str()) == 0);
+		if (!ok) unlink(tmp.c_str());
+	}
+	if (!ok) LOG(WARNING) << "Unable to save mission log index " << path << ": " << strerror(errno);
+}
+
+uint32_t MissionLog::check () const {
+	size_t len = min((size_t)_indexed, (size_t)MISSIONLOG_CHECK_SIZE);
+	uint32_t crc = recorderCRC(0, _base, len);
+	return recorderCRC(crc, _base + _indexed - len, len);
+}
+
+void MissionLog::build (uint64_t from) {
+	if (!_base) return;
+	if (from == 0) {
+		_blocks.clear();
+		_headers.clear();
+		_flags = 0;
+	}
+	// a master log has the tag somewhere; a bare CSV file never does
+	if (!(_flags & LOGINDEX_TAGGED) && memmem(_base + from, _size - from, MISSIONLOG_LINE_TAG, tagLen)) {
+		if (from != 0) {
+			build(0);
+			return;
+		}
+		_flags |= LOGINDEX_TAGGED;
+	}
+
+	const char *limit = static_cast<const char*>(memrchr(_base + from, '\n', _size - from));
+	if (!limit) {
+		_indexed = from;
+		return;
+	}
+	limit++;
+	LogIndexBlock block = {from, from, numeric_limits<int64_t>::max(), numeric_limits<int64_t>::min(), 0};
+	const char *p = _base + from;
+	sysclock when;
+	bool isHeader;
+	while (p < limit) {
+		const char *eol = static_cast<const char*>(memchr(p, '\n', limit - p));
+		const char *fields = classify(p, eol, isHeader, when);
+		if (fields && isHeader) {
+			if (tagged() || _headers.empty()) _headers.push_back(fields - _base);
+		} else if (fields) {
+			int64_t t = toMillis(when);
+			block.minTime = min(block.minTime, t);
+			block.maxTime = max(block.maxTime, t);
+			block.lines++;
+		}
+		p = eol + 1;
+		if (((uint64_t)(p - _base) - block.offset >= MISSIONLOG_INDEX_STRIDE) || (p == limit)) {
+			block.end = p - _base;
+			if (block.lines) _blocks.push_back(block);
+			block = {block.end, block.end, numeric_limits<int64_t>::max(), numeric_limits<int64_t>::min(), 0};
+		}
+	}
+	_indexed = limit - _base;
+}
+
+const char* MissionLog::classify (const char *p, const char *eol, bool& header, sysclock& time) const {
+	const char *end = eol;
+	if ((end > p) && (end[-1] == '\r')) end--;
+	if (tagged()) {
+		const char *tag = static_cast<const char*>(memmem(p, end - p, MISSIONLOG_LINE_TAG, tagLen));
+		if (!tag) return NULL;					// something else the master logged
+		p = tag + tagLen;
+	}
+	if (p >= end) return NULL;
+	const char *first = static_cast<const char*>(memchr(p, ',', end - p));
+	if (!first) first = end;
+	header = !HackerboatState::parseTime(p, first - p, time);
+	return p;
+}
+
+const char* MissionLog::headerAt (uint64_t offset) const {
+	auto h = lower_bound(_headers.begin(), _headers.end(), offset);
+	if (h == _headers.begin()) return NULL;
+	return _base + *(h - 1);
+}
+
+static size_t lineLength (const char *p, const char *limit) {
+	const char *eol = static_cast<const char*>(memchr(p, '\n', limit - p));
+	if (!eol) eol = limit;
+	if ((eol > p) && (eol[-1] == '\r')) eol--;
+	return eol - p;
+}
+
+size_t MissionLog::query (sysclock from, sysclock to, const std::vector<LogFilter>& filters, Callback callback) const {
+	int64_t lo = toMillis(from);
+	int64_t hi = toMillis(to);
+	const char *limit = _base + _indexed;
+	const char *resolved = NULL;				// header the filter columns were last looked up in
+	vector<int> index(filters.size(), -1);
+	int last = -1;
+	vector<string> names, fields;
+	size_t count = 0;
+	Line line;
+	bool isHeader;
+
+	for (auto& block : _blocks) {
+		if ((block.maxTime < lo) || (block.minTime > hi)) continue;
+		const char *header = headerAt(block.offset);
+		const char *p = _base + block.offset;
+		const char *end = _base + block.end;
+		while (p < end) {
+			const char *eol = static_cast<const char*>(memchr(p, '\n', end - p));
+			const char *data = classify(p, eol, isHeader, line.time);
+			p = eol + 1;
+			if (!data) continue;
+			if (isHeader) {
+				// in a bare CSV file, only the first one is
+				if (tagged() || (!_headers.empty() && (data == (_base + _headers[0])))) header = data;
+				continue;
+			}
+			int64_t t = toMillis(line.time);
+			if ((t < lo) || (t > hi)) continue;
+			line.data = data;
+			line.len = lineLength(data, eol);
+			line.header = header;
+			line.headerLen = (header) ? lineLength(header, limit) : 0;
+
+			if (!filters.empty()) {
+				if (!header) continue;
+				if (header != resolved) {
+					columns(header, line.headerLen, names);
+					last = -1;
+					for (size_t i = 0; i < filters.size(); i++) {
+						index[i] = column(names, filters[i].column);
+						last = max(last, index[i]);
+					}
+					resolved = header;
+				}
+				const char *f = data;
+				const char *fend = data + line.len;
+				fields.resize(last + 1);
+				for (int i = 0; i <= last; i++) {
+					if (f < fend) {
+						f = readCSVField(f, fend, fields[i]);
+					} else fields[i].clear();
+				}
+				bool pass = true;
+				for (size_t i = 0; pass && (i < filters.size()); i++) {
+					pass = (index[i] >= 0) && filters[i].match(fields[index[i]]);
+				}
+				if (!pass) continue;
+			}
+			count++;
+			if (!callback(line)) return count;
+		}
+	}
+	return count;
+}
+
+void MissionLog::columns (const char *header, size_t len, std::vector<std::string>& names) {
+	const char *p = header;
+	const char *end = header + len;
+	string name;
+	names.clear();
+	while (p < end) {
+		p = readCSVField(p, end, name);
+		// the old header had some columns commented out; they were never written
+		size_t open = name.find("/*");
+		if (open != string::npos) {
+			while ((name.find("*/") == string::npos) && (p < end)) {
+				p = readCSVField(p, end, name);
+			}
+			size_t close = name.find("*/");
+			name = (close == string::npos) ? "" : name.substr(close + 2);
+			if (name.empty()) continue;
+		}
+		size_t first = name.find_first_not_of(' ');
+		name = (first == string::npos) ? "" : name.substr(first, name.find_last_not_of(' ') + 1 - first);
+		names.push_back(name);
+	}
+	// before the column table, the header named the target course and throttle columns in the wrong order
+	auto course = find(names.begin(), names.end(), "Target Course");
+	auto throttle = find(names.begin(), names.end(), "Throttle Position");
+	if ((course != names.end()) && (throttle != names.end())) iter_swap(course, throttle);
+}
+
+int MissionLog::column (const std::vector<std::string>& names, const std::string& name) {
+	auto c = find(names.begin(), names.end(), name);
+	return (c == names.end()) ? -1 : (c - names.begin());
+}
@@ -19,9 +19,22 @@
 #include "rcModes.hpp"
 #include "autoModes.hpp"
 #include "navModes.hpp"
+#include "boatClock.hpp"
 #include "easylogging++.h"
 #include "util.hpp"
 #include "configuration.hpp"
+#include "cycleProfiler.hpp"
+#include "pool.hpp"
+
+static FixedPool<MaxSize<NavIdleMode, NavFaultMode, NavRCMode, NavAutoMode>::value, MODE_POOL_SIZE> navModePool;
+
+void* NavModeBase::operator new (size_t size) {
+	return navModePool.allocateOrNew(size);
+}
+
+void NavModeBase::operator delete (void *p) {
+	navModePool.releaseOrDelete(p);
+}
 
 NavModeBase *NavModeBase::factory(BoatState& state, NavModeEnum mode) {
 	switch (mode) {
@@ -54,7 +67,7 @@ NavModeBase *NavIdleMode::execute () {
 		LOG(INFO) << "Starting nav idle mode";
 	}
 	this->callCount++;
-	_state.recordTime = std::chrono::system_clock::now();		// Get a consistent time for everything in this invocation
+	_state.recordTime = BoatClock::now();		// Get a consistent time for everything in this invocation
 	(!_state.throttle->setThrottle(0)) ? _state.insertFault("Throttle Fault") : _state.removeFault("Throttle Fault");
 	(!_state.rudder->write(0)) ? _state.insertFault("Rudder Fault") : _state.removeFault("Rudder Fault");
 	(!_state.servoEnable.set()) ? _state.insertFault("Servo Enable Fault") : _state.removeFault("Servo Enable Fault");
@@ -92,7 +105,7 @@ NavModeBase *NavFaultMode::execute () {
 		LOG(INFO) << "Starting nav fault mode";
 	}
 	this->callCount++;
-	_state.recordTime = std::chrono::system_clock::now();		// Get a consistent time for everything in this invocation
+	_state.recordTime = BoatClock::now();		// Get a consistent time for everything in this invocation
 	(!_state.throttle->setThrottle(0)) ? _state.insertFault("Throttle Fault") : _state.removeFault("Throttle Fault");
 	(!_state.rudder->write(0)) ? _state.insertFault("Rudder Fault") : _state.removeFault("Rudder Fault");
 	(!_state.servoEnable.set()) ? _state.insertFault("Servo Enable Fault") : _state.removeFault("Servo Enable Fault");
@@ -117,7 +130,7 @@ NavModeBase *NavRCMode::execute () {
 		LOG(INFO) << "Starting nav RC mode";
 	}
 	this->callCount++;
-	_state.recordTime = std::chrono::system_clock::now();		// Get a consistent time for everything in this invocation
+	_state.recordTime = BoatClock::now();		// Get a consistent time for everything in this invocation
 	(!_state.servoEnable.set()) ? _state.insertFault("Servo Enable Fault") : _state.removeFault("Servo Enable Fault");
 	(!_state.adc->isValid()) ? _state.insertFault("ADC Invalid") : _state.removeFault("ADC Invalid");
 	(!_state.orient->isValid()) ? _state.insertFault("IMU Invalid") : _state.removeFault("IMU Invalid");
@@ -143,9 +156,12 @@ NavModeBase *NavRCMode::execute () {
 	_state.setNavMode(NavModeEnum::RC);	// Overwrites any improper commands
 	
 	// execute the current RC mode
-	_oldRCmode = _rcMode;
-	_rcMode = _rcMode->execute();
-	if (_rcMode != _oldRCmode) REMOVE(_oldRCmode);
+	{
+		StageTimer t(CycleStageEnum::SUB_MODE);
+		_oldRCmode = _rcMode;
+		_rcMode = _rcMode->execute();
+		if (_rcMode != _oldRCmode) REMOVE(_oldRCmode);
+	}
 	
 	return this;
 }
@@ -155,7 +171,7 @@ NavModeBase *NavAutoMode::execute () {
 		LOG(INFO) << "Starting nav auto mode";
 	}
 	this->callCount++;
-	_state.recordTime = std::chrono::system_clock::now();		// Get a consistent time for everything in this invocation
+	_state.recordTime = BoatClock::now();		// Get a consistent time for everything in this invocation
 	(!_state.servoEnable.set()) ? _state.insertFault("Servo Enable Fault") : _state.removeFault("Servo Enable Fault");
 	(!_state.adc->isValid()) ? _state.insertFault("ADC Invalid") : _state.removeFault("ADC Invalid");
 	(!_state.orient->isValid()) ? _state.insertFault("IMU Invalid") : _state.removeFault("IMU Invalid");
@@ -179,10 +195,13 @@ NavModeBase *NavAutoMode::execute () {
 		return NavModeBase::factory(_state, NavModeEnum::RC);
 	}
 	
-	// execute the current RC mode
-	_oldAutoMode = _autoMode;
-	_autoMode = _autoMode->execute();
-	if (_autoMode != _oldAutoMode) REMOVE(_oldAutoMode);
+	// execute the current autonomous mode
+	{
+		StageTimer t(CycleStageEnum::SUB_MODE);
+		_oldAutoMode = _autoMode;
+		_autoMode = _autoMode->execute();
+		if (_autoMode != _oldAutoMode) REMOVE(_oldAutoMode);
+	}
 	
 	return this;
 }
@@ -0,0 +1,48 @@
+/******************************************************************************
+ * Hackerboat navigation solution module
+ * navSolution.cpp
+ * This module holds the geometry from the current fix to the current target,
+ * worked out once per fix and shared by everything that needs it
+ *
+ * See the Hackerboat documentation for more details
+ * Written by agent, Oct 2026
+ *
+ * Version 0.1: First alpha
+ *
+ ******************************************************************************/
+
+#include <math.h>
+#include "navSolution.hpp"
+#include "twovector.hpp"
+#include "easylogging++.h"
+
+bool NavSolution::same (const Location& a, const Location& b) {
+	if (!a.isValid()) return !b.isValid();
+	return ((a.lat == b.lat) && (a.lon == b.lon));
+}
+
+bool NavSolution::update (uint64_t sequence, const Location& fix, const Location& target, const Location& legStart) {
+	if (_valid && (sequence == _sequence) && same(fix, _fix) && same(target, _target) && same(legStart, _legStart)) {
+		return false;
+	}
+	_valid = true;
+	_sequence = sequence;
+	_fix = fix;
+	_target = target;
+	_legStart = legStart;
+	_computations++;
+	fix.course(target, _distance, _bearing, CourseTypeEnum::Approximate);
+
+	// cross track and along track from the right triangle formed by the leg, the track from its start
+	// to the fix, and the perpendicular from the fix to the leg
+	double legBearing, startDistance, startBearing;
+	legStart.course(target, startDistance, legBearing, CourseTypeEnum::Approximate);
+	legStart.course(fix, startDistance, startBearing, CourseTypeEnum::Approximate);
+	double delta = startDistance / NAV_EARTH_RADIUS;
+	double angle = TwoVector::deg2rad(startBearing - legBearing);
+	_crossTrack = asin(sin(delta) * sin(angle)) * NAV_EARTH_RADIUS;
+	_alongTrack = atan2(sin(delta) * cos(angle), cos(delta)) * NAV_EARTH_RADIUS;
+	VLOG(3) << "Navigation solution to " << target << ": " << _distance << " m at " << _bearing
+			<< ", cross track " << _crossTrack << " m, along track " << _alongTrack << " m";
+	return true;
+}
@@ -16,6 +16,7 @@
 #include <chrono>
 #include <ctime>
 #include "orientation.hpp"
+#include "boatClock.hpp"
 #include <GeographicLib/MagneticModel.hpp>
 #include <GeographicLib/Geocentric.hpp>
 #include <GeographicLib/Constants.hpp>
@@ -26,26 +27,24 @@ using namespace std;
 using namespace rapidjson;
 
 bool Orientation::parse (Value& input) {
-	bool result = true;
-
-	result += GetVar("pitch", this->pitch, input);
-	result += GetVar("roll", this->roll, input);
-	result += GetVar("heading", this->heading, input);
-
-	return (result && this->isValid() && this->normalize());
+	return (parseFields(fields, this, input) && this->isValid() && this->normalize());
 }
 
-Value Orientation::pack () const {
-	Value d;
-	int packResult = 0;
+bool Orientation::readJSON (const char *json) {
+	return (readFields(fields, this, json) && this->isValid() && this->normalize());
+}
 
-	packResult += PutVar("pitch", this->pitch, d);
-	packResult += PutVar("roll", this->roll, d);
-	packResult += PutVar("heading", this->heading, d);
-	
-	return d;
+bool Orientation::readRecord (const uint8_t *buf, size_t len) {
+	return (decodeRecord(fields, this, buf, len) && this->isValid() && this->normalize());
 }
 
+const FieldDescriptor Orientation::fields[] = {
+	FIELD(DoubleField, "pitch", Orientation, pitch),
+	FIELD(DoubleField, "roll", Orientation, roll),
+	FIELD(DoubleField, "heading", Orientation, heading),
+	FIELD_END
+};
+
 bool Orientation::isValid () {
 	return (std::isfinite(roll) && std::isfinite(pitch) && std::isfinite(heading));
 }
@@ -111,7 +110,7 @@ bool Orientation::updateDeclination (Location loc) {
 		return false;
 	}
 	// time information for the mag model
-	sysclock thisTime = std::chrono::system_clock::now();
+	sysclock thisTime = BoatClock::now();
 	time_t tt = std::chrono::system_clock::to_time_t(thisTime);
 	tm utc_tm = *gmtime(&tt);
 	MagneticModel mag("emm2015");
@@ -44,8 +44,7 @@ bool OrientationInput::init() {
 				
 bool OrientationInput::begin() {
 	if (this->init()) {
-		this->myThread = new std::thread (InputThread::InputThreadRunner(this));
-		myThread->detach();
+		this->launch();
 		LOG(INFO) << "Successfully initialized orientation subsystem";
 		return true;
 	}
@@ -53,17 +52,12 @@ bool OrientationInput::begin() {
 }
 
 bool OrientationInput::execute() {
-	//if (!lock && (!lock.try_lock_for(IMU_LOCK_TIMEOUT))) {
-	//	LOG(ERROR) << "Failed to lock data for OrientationInput";
-	//	return false;
-	//}
 	if (!getData()) {
-		//lock.unlock();
 		return false;
 	}
 	getAccelOrientation();
 	getMagOrientation();
-	//lock.unlock();
+	_orientation.publish(_current);
 	return true;
 }		
 
@@ -18,6 +18,7 @@
 #include <vector>
 #include <tuple>
 #include "pid.hpp" 
+#include "boatClock.hpp"
 #include "easylogging++.h"
 
 using namespace std;
@@ -34,7 +35,7 @@ PID::PID(double* Input, double* Output, double* Setpoint,
 		inAuto(false), SampleTime(100), controllerDirection(ControllerDirection)
 {
     PID::SetTunings(Kp, Ki, Kd);
-	lastTime = PID_CLOCK::now();
+	lastTime = BoatClock::steadyNow();
 	lastTime = lastTime - SampleTime;				
 }
  
@@ -48,7 +49,7 @@ PID::PID(double* Input, double* Output, double* Setpoint,
  **********************************************************************************/ 
 bool PID::Compute()
 {
-   time_point<PID_CLOCK> thisTime = PID_CLOCK::now();
+   time_point<PID_CLOCK> thisTime = BoatClock::steadyNow();
    if (((thisTime - lastTime) >= SampleTime) || !inAuto)
    {
       /*Compute all the working error variables*/
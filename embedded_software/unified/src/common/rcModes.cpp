@@ -20,6 +20,17 @@
 #include "pid.hpp"
 #include "rcModes.hpp"
 #include "easylogging++.h"
+#include "pool.hpp"
+
+static FixedPool<MaxSize<RCIdleMode, RCRudderMode, RCCourseMode, RCFailsafeMode>::value, MODE_POOL_SIZE> rcModePool;
+
+void* RCModeBase::operator new (size_t size) {
+	return rcModePool.allocateOrNew(size);
+}
+
+void RCModeBase::operator delete (void *p) {
+	rcModePool.releaseOrDelete(p);
+}
 
 RCModeBase *RCModeBase::factory(BoatState& state, RCModeEnum mode) {
 	switch(mode) {
@@ -69,10 +80,10 @@ RCModeBase *RCRudderMode::execute() {
 	callCount++;
 	// Write the outgoing rudder command
 	_state.rudder->write(_state.rc->getRudder());
-	LOG_EVERY_N(100, DEBUG) << "Rudder command: " << to_string(_state.rc->getRudder());
+	LOG_EVERY_N(100, DEBUG) << "Rudder command: " << _state.rc->getRudder();
 	// Set the throttle
 	_state.throttle->setThrottle(_state.rc->getThrottle());
-	LOG_EVERY_N(100, DEBUG) << "Throttle command: " << to_string(_state.rc->getThrottle());
+	LOG_EVERY_N(100, DEBUG) << "Throttle command: " << _state.rc->getThrottle();
 	// Choose the next command
 	if (_state.rc->getMode() != RCModeEnum::RUDDER) {
 		LOG(DEBUG) << "Switching to RC mode " << _state.rcModeNames.get(_state.rc->getMode()) << " by switch";
@@ -94,17 +105,17 @@ RCModeBase *RCCourseMode::execute() {
 	}
 	callCount++;
 	// Grab the current orientation and find the heading error for the PID loop
-	in = _state.orient->getOrientation()->headingError(_state.rc->getCourse());
+	in = _state.orient->getOrientation().headingError(_state.rc->getCourse());
 	// Execute the PID process
-	LOG_EVERY_N(100, DEBUG) << "True Heading: " << _state.orient->getOrientation()->makeTrue() 
+	LOG_EVERY_N(100, DEBUG) << "True Heading: " << _state.orient->getOrientation().makeTrue() 
 							<< ", Target Course: " << _state.rc->getCourse();
 	helm.Compute();	
 	// Write the outgoing rudder command
 	_state.rudder->write(out);
-	LOG_EVERY_N(100, DEBUG) << "Rudder command: " << to_string(this->out);
+	LOG_EVERY_N(100, DEBUG) << "Rudder command: " << this->out;
 	// Set the throttle
 	_state.throttle->setThrottle(_state.rc->getThrottle());
-	LOG_EVERY_N(100, DEBUG) << "Throttle command: " << to_string(_state.rc->getThrottle());
+	LOG_EVERY_N(100, DEBUG) << "Throttle command: " << _state.rc->getThrottle();
 	// Choose the next command
 	if (_state.rc->getMode() != RCModeEnum::COURSE) {
 		LOG(DEBUG) << "Switching to RC mode " << _state.rcModeNames.get(_state.rc->getMode()) << " by switch";
@@ -0,0 +1,133 @@
+/******************************************************************************
+ * Hackerboat real-time module
+ * realtime.cpp
+ * This module sets thread scheduling, affinity, and memory locking, and keeps
+ * wakeup latency histograms for each thread
+ *
+ * See the Hackerboat documentation for more details
+ * Written by agent, Oct 2026
+ *
+ * Version 0.1: First alpha
+ *
+ ******************************************************************************/
+
+#include <mutex>
+#include <string>
+#include <map>
+#include <tuple>
+#include <errno.h>
+#include <string.h>
+#include "hackerboatRoot.hpp"
+#include "enumtable.hpp"
+#include "enumdefs.hpp"
+#include "configuration.hpp"
+#include "cycleProfiler.hpp"
+#include "realtime.hpp"
+#include "easylogging++.h"
+extern "C" {
+	#include <pthread.h>
+	#include <sched.h>
+	#include <unistd.h>
+	#include <sys/mman.h>
+	#include <sys/resource.h>
+	#include <sys/syscall.h>
+}
+
+using namespace std;
+
+bool RealTime::lockMemory () {
+	if (!Conf::get()->lockMemory()) return false;
+	if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+		LOG(WARNING) << "Unable to lock memory: " << strerror(errno);
+		return false;
+	}
+	LOG(INFO) << "Locked process memory";
+	return true;
+}
+
+bool RealTime::configureThread (const string& name) {
+	pthread_t self = pthread_self();
+	ThreadSpec spec { "Other", 0, -1 };
+	SchedPolicyEnum policy = SchedPolicyEnum::OTHER;
+	struct sched_param param;
+	bool result = true;
+	int err;
+
+	wakeup(name);
+	pthread_setname_np(self, name.substr(0, 15).c_str());		// the kernel limits names to 15 characters
+	auto entry = Conf::get()->threadSchedule().find(name);
+	if (entry != Conf::get()->threadSchedule().end()) {
+		spec = entry->second;
+	} else LOG(INFO) << "No schedule for thread " << name << ", running it at normal priority";
+	if (!policyNames.get(std::get<0>(spec), &policy) || (policy == SchedPolicyEnum::NONE)) {
+		LOG(WARNING) << "Unknown scheduling policy " << std::get<0>(spec) << " for thread " << name;
+		policy = SchedPolicyEnum::OTHER;
+	}
+
+	if (policy == SchedPolicyEnum::OTHER) {
+		param.sched_priority = 0;
+		err = pthread_setschedparam(self, SCHED_OTHER, &param);
+		// on Linux, the nice value belongs to the thread, not the process
+		if (!err && (setpriority(PRIO_PROCESS, syscall(SYS_gettid), std::get<1>(spec)) != 0)) err = errno;
+	} else {
+		int native = (policy == SchedPolicyEnum::FIFO) ? SCHED_FIFO : SCHED_RR;
+		param.sched_priority = std::get<1>(spec);
+		if (param.sched_priority < sched_get_priority_min(native)) param.sched_priority = sched_get_priority_min(native);
+		if (param.sched_priority > sched_get_priority_max(native)) param.sched_priority = sched_get_priority_max(native);
+		err = pthread_setschedparam(self, native, &param);
+	}
+	if (err) {
+		LOG(WARNING) << "Unable to set " << policyNames.get(policy) << " priority " << std::get<1>(spec)
+					 << " for thread " << name << ": " << strerror(err);
+		result = false;
+	}
+
+	if (std::get<2>(spec) >= 0) {
+		cpu_set_t cpus;
+		CPU_ZERO(&cpus);
+		CPU_SET(std::get<2>(spec), &cpus);
+		err = pthread_setaffinity_np(self, sizeof(cpus), &cpus);
+		if (err) {
+			LOG(WARNING) << "Unable to pin thread " << name << " to CPU " << std::get<2>(spec) << ": " << strerror(err);
+			result = false;
+		}
+	}
+	if (result) LOG(INFO) << "Thread " << name << " running " << policyNames.get(policy) << " priority " << std::get<1>(spec)
+						  << ((std::get<2>(spec) >= 0) ? " on CPU " + to_string(std::get<2>(spec)) : "");
+	return result;
+}
+
+LatencyHistogram& RealTime::wakeup (const string& name) {
+	std::lock_guard<std::mutex> guard(_lock);
+	auto entry = _wakeups.find(name);
+	if (entry != _wakeups.end()) return *(entry->second);
+	LatencyHistogram *histogram = new LatencyHistogram();
+	_wakeups.emplace(name, histogram);
+	return *histogram;
+}
+
+void RealTime::reset () {
+	std::lock_guard<std::mutex> guard(_lock);
+	for (auto &w : _wakeups) {
+		w.second->reset();
+	}
+}
+
+Value RealTime::pack () const {
+	Value d;
+	int packResult = 0;
+	std::lock_guard<std::mutex> guard(_lock);
+	for (auto &w : _wakeups) {
+		packResult += PutVar(w.first, w.second->pack(), d);
+	}
+	return d;
+}
+
+const EnumNameTable<SchedPolicyEnum> RealTime::policyNames = {
+	"Other",
+	"FIFO",
+	"RR",
+	"None"
+};
+
+RealTime* RealTime::_instance = new RealTime();
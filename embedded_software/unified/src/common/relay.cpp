@@ -59,7 +59,7 @@ bool Relay::init() {
 
 double Relay::current() {
 	if (this->_adc) {
-		return this->_adc->getScaledValues().at(this->_name);
+		return this->_adc->getScaledValue(this->_name);
 	}
 	return NAN;
 }
@@ -0,0 +1,505 @@
+/******************************************************************************
+ * Hackerboat mission replay module
+ * replay.cpp
+ * This module runs recorded missions back through the boat mode state machines
+ * with the boat clock set from the recording, as fast as the CPU allows, and
+ * compares the rudder and throttle commands with the recorded ones
+ *
+ * See the Hackerboat documentation for more details
+ * Written by agent, Oct 2026
+ *
+ * Version 0.1: First alpha
+ *
+ ******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <cmath>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include "replay.hpp"
+#include "boatClock.hpp"
+#include "boatModes.hpp"
+#include "telemetryRecord.hpp"
+#include "csvWriter.hpp"
+#include "missionLog.hpp"
+#include "configuration.hpp"
+#include "util.hpp"
+#include "easylogging++.h"
+
+#define REPLAY_FIELD_SIZE	(64)		/**< Longest field we read a value out of */
+
+using namespace std;
+using namespace std::chrono;
+
+typedef CSVLogReplay::Column Column;
+
+// Every name each column has gone by in the master's CSV header
+static const map<string, Column> columnNames = {
+	{"RecordTime", Column::TIME},				{"Record Time", Column::TIME},
+	{"Lat", Column::LAT},
+	{"Lon", Column::LON},
+	{"Track", Column::TRACK},					{"GPS Track (deg true)", Column::TRACK},
+	{"Speed", Column::SPEED},					{"Speed (m/s)", Column::SPEED},
+	{"FixValid", Column::FIX_VALID},
+	{"Fix Type", Column::FIX_TYPE},
+	{"StopButtonState", Column::STOP_BUTTON},
+	{"ArmButtonState", Column::ARM_BUTTON},
+	{"ThrottlePosition", Column::THROTTLE},	{"Throttle Position", Column::THROTTLE},
+	{"RudderCommand", Column::RUDDER},			{"Rudder Command (ms)", Column::RUDDER},
+	{"CurrentHeading", Column::HEADING},		{"Current Heading (deg mag)", Column::HEADING},
+	{"ThrottleInput", Column::RC_THROTTLE},
+	{"CourseInput", Column::RC_COURSE},
+	{"RCFailSafe", Column::RC_FAILSAFE},
+	{"RCMode", Column::RC_MODE},				{"RC Mode", Column::RC_MODE},
+	{"Boat Mode", Column::BOAT_MODE},
+	{"Nav Mode", Column::NAV_MODE},
+	{"Auto Mode", Column::AUTO_MODE},
+	{"RawMotorCurrent", Column::MOTOR_CURRENT},	{"Raw Motor Current", Column::MOTOR_CURRENT},
+	{"RawBatteryVoltage", Column::BATTERY},	{"Raw Battery Voltage", Column::BATTERY}
+};
+
+// Copy a field into buf so that strtol() and friends can read it. Returns false if it's empty or too long
+static bool terminate (const char *p, size_t len, char *buf) {
+	if ((len == 0) || (len >= REPLAY_FIELD_SIZE)) return false;
+	memcpy(buf, p, len);
+	buf[len] = '\0';
+	return true;
+}
+
+static bool readInt (const char *p, size_t len, int& out) {
+	char buf[REPLAY_FIELD_SIZE];
+	char *stop;
+	if (!terminate(p, len, buf)) return false;
+	if ((len == 1) && (buf[0] < ' ')) {			// old logs wrote some flags as raw bytes
+		out = buf[0];
+		return true;
+	}
+	long v = strtol(buf, &stop, 10);
+	if (*stop && (*stop != '.')) return false;
+	out = v;
+	return true;
+}
+
+static bool readDouble (const char *p, size_t len, double& out) {
+	char buf[REPLAY_FIELD_SIZE];
+	char *stop;
+	if (!terminate(p, len, buf)) return false;
+	double v = strtod(buf, &stop);
+	if (*stop) return false;
+	out = v;
+	return true;
+}
+
+bool CSVLogReplay::open (const std::string& path) {
+	_in.close();
+	_in.clear();
+	_in.open(path);
+	_columns.clear();
+	_skipped = 0;
+	_tagged = false;
+	return _in.is_open();
+}
+
+bool CSVLogReplay::next (ReplayFrame& frame) {
+	while (getline(_in, _line)) {
+		if (line(_line.c_str(), _line.size(), frame)) return true;
+	}
+	return false;
+}
+
+bool CSVLogReplay::line (const char *text, size_t len, ReplayFrame& frame) {
+	const char *end = text + len;
+	while ((end > text) && ((end[-1] == '\r') || (end[-1] == '\n'))) end--;
+	const char *p = text;
+	const char *tag = std::search(text, end, MISSIONLOG_LINE_TAG, MISSIONLOG_LINE_TAG + strlen(MISSIONLOG_LINE_TAG));
+	if (tag != end) {
+		p = tag + strlen(MISSIONLOG_LINE_TAG);
+		_tagged = true;
+	} else if (_tagged) {
+		return false;							// something else the master logged
+	}
+
+	// a line that doesn't start with a time is a header; in a bare CSV file, only the first one is
+	sysclock when;
+	const char *first = p;
+	while ((first < end) && (*first != ',')) first++;
+	if (!HackerboatState::parseTime(p, first - p, when)) {
+		if ((p < end) && ((tag != end) || _columns.empty())) header(p, end);
+		return false;
+	}
+	if (_columns.empty()) {
+		_skipped++;
+		return false;
+	}
+
+	frame = ReplayFrame();
+	string value;
+	for (size_t i = 0; (i < _columns.size()) && (p < end); i++) {
+		p = readCSVField(p, end, value);
+		if (!field(_columns[i], value.data(), value.size(), frame)) {
+			_skipped++;
+			return false;
+		}
+	}
+	return true;
+}
+
+void CSVLogReplay::header (const char *p, const char *end) {
+	vector<string> names;
+	MissionLog::columns(p, end - p, names);
+	_columns.clear();
+	for (const string& name : names) {
+		auto c = columnNames.find(name);
+		_columns.push_back((c == columnNames.end()) ? Column::IGNORED : c->second);
+	}
+	VLOG(2) << "Replay header has " << _columns.size() << " columns";
+}
+
+bool CSVLogReplay::field (Column c, const char *p, size_t len, ReplayFrame& frame) {
+	int i;
+	double d;
+	string name(p, len);
+	if (len == 0) return true;					// not logged
+	switch (c) {
+		case Column::TIME:
+			return HackerboatState::parseTime(p, len, frame.time);
+		case Column::LAT:
+			if (readDouble(p, len, d)) {
+				frame.fix.fix.lat = d;
+				frame.fixLogged = true;
+			}
+			break;
+		case Column::LON:
+			if (readDouble(p, len, d)) {
+				frame.fix.fix.lon = d;
+				frame.fixLogged = true;
+			}
+			break;
+		case Column::TRACK:
+			if (readDouble(p, len, d)) frame.fix.track = d;
+			break;
+		case Column::SPEED:
+			if (readDouble(p, len, d)) frame.fix.speed = d;
+			break;
+		case Column::FIX_VALID:
+			if (readInt(p, len, i)) frame.fix.fixValid = (i != 0);
+			break;
+		case Column::FIX_TYPE:
+			GPSFix::NMEAModeNames.get(name, &frame.fix.mode);
+			break;
+		case Column::STOP_BUTTON:
+			if (readInt(p, len, i)) frame.stopButton = i;
+			break;
+		case Column::ARM_BUTTON:
+			if (readInt(p, len, i)) frame.armButton = i;
+			break;
+		case Column::THROTTLE:
+			if (readInt(p, len, i)) frame.throttle = i;
+			break;
+		case Column::RUDDER:
+			if (readInt(p, len, i)) frame.rudder = i;
+			break;
+		case Column::HEADING:
+			if (readDouble(p, len, d)) frame.heading = d;
+			break;
+		case Column::RC_THROTTLE:
+			if (readInt(p, len, i)) frame.rcThrottle = i;
+			break;
+		case Column::RC_COURSE:
+			if (readDouble(p, len, d)) frame.rcCourse = d;
+			break;
+		case Column::RC_FAILSAFE:
+			if (readInt(p, len, i) && i) frame.rcMode = RCModeEnum::FAILSAFE;
+			break;
+		case Column::RC_MODE:
+			if (frame.rcMode != RCModeEnum::FAILSAFE) BoatState::rcModeNames.get(name, &frame.rcMode);
+			break;
+		case Column::BOAT_MODE:
+			BoatState::boatModeNames.get(name, &frame.boatMode);
+			break;
+		case Column::NAV_MODE:
+			BoatState::navModeNames.get(name, &frame.navMode);
+			break;
+		case Column::AUTO_MODE:
+			BoatState::autoModeNames.get(name, &frame.autoMode);
+			break;
+		case Column::MOTOR_CURRENT:
+			if (readInt(p, len, i)) frame.motorCurrentRaw = i;
+			break;
+		case Column::BATTERY:
+			if (readInt(p, len, i)) frame.batteryRaw = i;
+			break;
+		case Column::IGNORED:
+			break;
+	}
+	return true;
+}
+
+bool RecorderReplay::open (const std::string& path) {
+	_skipped = 0;
+	if (!_reader.open(path)) return false;
+	_seq = _reader.oldest();
+	return true;
+}
+
+bool RecorderReplay::next (ReplayFrame& frame) {
+	if (!_state) _state = new BoatState();
+	while (_reader.isOpen() && (_seq < _reader.next())) {
+		size_t used = 0;
+		sysclock time;
+		FlightRecorderReader::Result result = _reader.read(_seq, _buf, sizeof(_buf), used, time);
+		if (result == FlightRecorderReader::Result::NOT_YET) return false;
+		if ((result == FlightRecorderReader::Result::OVERWRITTEN) && (_reader.oldest() > _seq)) {
+			_skipped += _reader.oldest() - _seq;
+			_seq = _reader.oldest();
+			continue;
+		}
+		_seq++;
+		if (result != FlightRecorderReader::Result::OK) {
+			_skipped++;
+			continue;
+		}
+
+		bool haveSample = false;
+		bool haveState = false;
+		for (size_t pos = 0; pos < used;) {
+			size_t size = recordSize(_buf + pos, used - pos);
+			if (size == 0) break;
+			if (!haveSample && _sample.readRecord(_buf + pos, size)) {
+				haveSample = true;
+			} else if (!haveState && _state->readRecord(_buf + pos, size)) {
+				haveState = true;
+			}
+			pos += size;
+		}
+		if (!haveSample || !haveState) {
+			_skipped++;
+			continue;
+		}
+
+		frame = ReplayFrame();
+		frame.time = time;
+		frame.fix.copy(_state->lastFix);
+		frame.fixLogged = true;
+		frame.heading = _sample.orientation.heading;
+		frame.rcThrottle = _sample.rcThrottle;
+		frame.rcRudder = _sample.rcRudder;
+		frame.rcCourse = _sample.rcCourse;
+		frame.boatMode = _state->getBoatMode();
+		frame.navMode = _state->getNavMode();
+		frame.autoMode = _state->getAutoMode();
+		if (frame.navMode == NavModeEnum::RC) frame.rcMode = _state->getRCMode();	// otherwise it's left over from the last time we were in RC
+		frame.motorCurrentRaw = _sample.motorCurrentRaw;
+		frame.batteryRaw = _sample.batteryRaw;
+		frame.rudder = _sample.rudder;
+		frame.throttle = _sample.throttle;
+		return true;
+	}
+	return false;
+}
+
+ReplayDriver::ReplayDriver () {
+	_state.rc = &_rc;
+	_state.adc = &_adc;
+	_state.gps = &_gps;
+	_state.orient = &_orient;
+	_state.throttle = &_throttle;
+	_state.health = &_health;
+	_state.relays = RelayMap::instance();
+
+	// cut everything off from the hardware
+	_harness.simulate(&_state.disarmInput);
+	_harness.simulate(&_state.armInput);
+	_harness.simulate(&_state.servoEnable);
+	_harness.simulate(_state.rudder);
+	_state.rudder->attach(Conf::get()->rudderPort(), Conf::get()->rudderPin());
+	_harness.simulate(&_adc);
+	_harness.simulate(&_gps);
+	_harness.simulate(_state.relays);
+
+	bool *valid;
+	_harness.accessADC(&_adc, NULL, &valid);
+	*valid = true;
+	_harness.accessOrientation(&_orient, NULL, &valid);
+	*valid = true;
+	_harness.accessRC(&_rc, NULL, NULL, NULL, &valid, NULL, NULL, NULL, NULL);
+	*valid = true;
+}
+
+ReplayDriver::~ReplayDriver () {
+	REMOVE(_mode);
+	BoatClock::release();
+}
+
+uint16_t ReplayDriver::channel (double value, double outMin, double outMax) {
+	double raw = RCInput::map(value, outMin, outMax, Conf::get()->RClimits().at("min"), Conf::get()->RClimits().at("max"));
+	return (raw > 0) ? lround(raw) : 0;
+}
+
+void ReplayDriver::begin (BoatModeEnum start) {
+	REMOVE(_mode);
+	_stats = ReplayStats();
+	_started = false;
+	_state.clearFaults();
+
+	// sticks centered, throttle off, mode switch in the middle, auto switch on RC, buttons up
+	std::vector<uint16_t> *channels;
+	bool *failsafe;
+	auto& map = Conf::get()->RCchannelMap();
+	auto& limits = Conf::get()->RClimits();
+	_harness.accessRC(&_rc, NULL, NULL, &failsafe, NULL, &channels, NULL, NULL, NULL);
+	channels->assign(Conf::get()->RCchannelCount(), limits.at("middlePosn"));
+	(*channels)[map.at("throttle")] = channel(0, Conf::get()->throttleMin(), Conf::get()->throttleMax());
+	(*channels)[map.at("auto")] = limits.at("max");
+	*failsafe = false;
+	_state.armInput.set();
+	_state.disarmInput.set();
+
+	Orientation *orientation;
+	_harness.accessOrientation(&_orient, &orientation, NULL);
+	*orientation = Orientation(0, 0, 0);
+
+	_mode = BoatModeBase::factory(_state, start);
+}
+
+void ReplayDriver::buttons (const ReplayFrame& frame) {
+	if ((frame.armButton != REPLAY_NOT_LOGGED) || (frame.stopButton != REPLAY_NOT_LOGGED)) {
+		if (frame.armButton != REPLAY_NOT_LOGGED) _state.armInput.writePin(frame.armButton != 0);
+		if (frame.stopButton != REPLAY_NOT_LOGGED) _state.disarmInput.writePin(frame.stopButton != 0);
+		return;
+	}
+
+	// hold down whichever button takes the boat to the logged mode until it gets there
+	bool armed = ((_state.getBoatMode() == BoatModeEnum::NAVIGATION) || (_state.getBoatMode() == BoatModeEnum::ARMEDTEST));
+	bool arm = false;
+	bool stop = false;
+	switch (frame.boatMode) {
+		case BoatModeEnum::NAVIGATION:
+		case BoatModeEnum::ARMEDTEST:
+			arm = !armed;
+			break;
+		case BoatModeEnum::DISARMED:
+			stop = armed;
+			break;
+		default:
+			break;
+	}
+	_state.armInput.writePin(!arm);
+	_state.disarmInput.writePin(!stop);
+}
+
+void ReplayDriver::feed (const ReplayFrame& frame) {
+	auto& map = Conf::get()->RCchannelMap();
+	auto& limits = Conf::get()->RClimits();
+
+	GPSFix *fix;
+	_harness.accessGPSd(&_gps, &fix, NULL);
+	if (frame.fixLogged) fix->copy(frame.fix);
+
+	Orientation *orientation;
+	_harness.accessOrientation(&_orient, &orientation, NULL);
+	if (!std::isnan(frame.heading)) orientation->heading = frame.heading;
+
+	std::map<std::string, int> *raw;
+	_harness.accessADC(&_adc, &raw, NULL);
+	int& battery = (*raw)[Conf::get()->batmonName()];
+	if (frame.batteryRaw != REPLAY_NOT_LOGGED) {
+		battery = frame.batteryRaw;
+	} else if (battery < 0) {
+		battery = lround((REPLAY_BATTERY_VOLTS / _adc.getScales()[Conf::get()->batmonName()]) - _adc.getOffsets()[Conf::get()->batmonName()]);
+	}
+	if (frame.motorCurrentRaw != REPLAY_NOT_LOGGED) (*raw)["mot_i"] = frame.motorCurrentRaw;
+
+	std::vector<uint16_t> *channels;
+	bool *failsafe;
+	_harness.accessRC(&_rc, NULL, NULL, &failsafe, NULL, &channels, NULL, NULL, NULL);
+	if (frame.rcThrottle != REPLAY_NOT_LOGGED) {
+		(*channels)[map.at("throttle")] = channel(frame.rcThrottle, Conf::get()->throttleMin(), Conf::get()->throttleMax());
+	}
+	if (!std::isnan(frame.rcRudder)) {
+		(*channels)[map.at("rudder")] = channel(frame.rcRudder, Conf::get()->rudderMin(), Conf::get()->rudderMax());
+	}
+	if (!std::isnan(frame.rcCourse)) {
+		(*channels)[map.at("courseSelect")] = channel(frame.rcCourse, Conf::get()->courseMin(), Conf::get()->courseMax());
+	}
+	if (frame.rcMode != RCModeEnum::NONE) {
+		*failsafe = (frame.rcMode == RCModeEnum::FAILSAFE);
+		if (frame.rcMode == RCModeEnum::RUDDER) (*channels)[map.at("mode")] = limits.at("min");
+		if (frame.rcMode == RCModeEnum::COURSE) (*channels)[map.at("mode")] = limits.at("max");
+		if (frame.rcMode == RCModeEnum::IDLE) (*channels)[map.at("mode")] = limits.at("middlePosn");
+	}
+	if (frame.navMode != NavModeEnum::NONE) {
+		(*channels)[map.at("auto")] = (frame.navMode == NavModeEnum::AUTONOMOUS) ? limits.at("min") : limits.at("max");
+	}
+
+	buttons(frame);
+}
+
+void ReplayDriver::cycle () {
+	_state.lastFix.copy(_state.gps->getFix());
+	_state.health->readHealth();
+	BoatModeBase *oldmode = _mode;
+	_mode = _mode->execute();
+	if (_mode != oldmode) REMOVE(oldmode);
+	_stats.cycles++;
+}
+
+bool ReplayDriver::step (const ReplayFrame& frame) {
+	if (!_mode) begin();
+	feed(frame);
+
+	// run the cycles that fill the time since the last frame, with the last one landing on this frame
+	sysdur period = Conf::get()->controlPeriod();
+	sysclock end = frame.time;
+	int cycles = 1;
+	if (_started) {
+		if (end <= _now) end = _now + period;	// the log went backwards; keep the clock moving forward
+		cycles = lround(duration_cast<nanoseconds>(end - _now).count() / (double)duration_cast<nanoseconds>(period).count());
+		cycles = std::min(std::max(cycles, 1), REPLAY_MAX_GAP_CYCLES);
+	}
+	for (int i = cycles - 1; i >= 0; i--) {
+		BoatClock::set(end - (period * i));
+		cycle();
+	}
+	_now = end;
+	_started = true;
+	_stats.frames++;
+
+	bool compared = false;
+	bool match = true;
+	if (frame.rudder != REPLAY_NOT_LOGGED) {
+		int error = abs(rudder() - frame.rudder);
+		_stats.maxRudderError = std::max(_stats.maxRudderError, error);
+		compared = true;
+		if (error > _rudderTol) {
+			_stats.rudderMismatches++;
+			match = false;
+		}
+	}
+	if (frame.throttle != REPLAY_NOT_LOGGED) {
+		compared = true;
+		if (throttle() != frame.throttle) {
+			_stats.throttleMismatches++;
+			match = false;
+		}
+	}
+	if (compared) _stats.compared++;
+	if (!match) {
+		if (_stats.mismatches == 0) _stats.firstMismatch = frame.time;
+		_stats.mismatches++;
+	}
+	return match;
+}
+
+bool ReplayDriver::run (ReplaySource& source) {
+	ReplayFrame frame;
+	bool result = true;
+	while (source.next(frame)) {
+		result &= step(frame);
+	}
+	return result;
+}
@@ -0,0 +1,58 @@
+/******************************************************************************
+ * Hackerboat scratch arena module
+ * scratchArena.cpp
+ * This module provides a fixed-capacity bump allocator for short-lived data
+ * that is thrown away at the end of each control cycle
+ *
+ * See the Hackerboat documentation for more details
+ * Written by agent, Oct 2026
+ *
+ * Version 0.1: First alpha
+ *
+ ******************************************************************************/
+
+#include <cstddef>
+#include <cstdarg>
+#include <cstdio>
+#include <string.h>
+#include "scratchArena.hpp"
+
+using namespace std;
+
+ScratchArena::ScratchArena (size_t capacity) : _block(new char[capacity]), _capacity(capacity) {
+	memset(_block, 0, _capacity);				// fault the pages in now rather than in the middle of a cycle
+}
+
+ScratchArena::~ScratchArena () {
+	delete[] _block;
+}
+
+void* ScratchArena::allocate (size_t bytes, size_t align) {
+	size_t start = (_used + align - 1) & ~(align - 1);
+	if ((start > _capacity) || (bytes > (_capacity - start))) {
+		_overflows.fetch_add(1, memory_order_relaxed);
+		return NULL;
+	}
+	_used = start + bytes;
+	if (_used > _highWater.load(memory_order_relaxed)) _highWater.store(_used, memory_order_relaxed);
+	return _block + start;
+}
+
+char* ScratchArena::print (const char *format, ...) {
+	va_list args;
+	size_t room = _capacity - _used;
+	va_start(args, format);
+	int len = vsnprintf(_block + _used, room, format, args);
+	va_end(args);
+	if ((len < 0) || ((size_t)len >= room)) {
+		_overflows.fetch_add(1, memory_order_relaxed);
+		return NULL;
+	}
+	return static_cast<char*>(allocate(len + 1, 1));		// claim what vsnprintf() just wrote
+}
+
+void ScratchArena::reset () {
+	_used = 0;
+}
+
+ScratchArena* ScratchArena::_cycle = new ScratchArena(CYCLE_ARENA_SIZE);
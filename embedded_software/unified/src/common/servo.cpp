@@ -40,6 +40,10 @@ bool Servo::attach (int port, int pin, long min, long max, long freq) {
 	_center = (_min + _max)/2;	// find the center point
 	_freq = (1e9/freq);			// convert Hz into ns
 	_val = _center;
+	if (_simulated) {
+		attached = true;
+		return true;
+	}
 	
 	// Turn on the PWM subsystem, set permissions correctly, and check that we've got access
 	// It includes some very rude hacks using sudo, chown, and chmod to get the permissions right
@@ -139,6 +143,7 @@ bool Servo::setFrequency (unsigned long freq) {
 }
 
 bool Servo::writeMicroseconds () {
+	if (_simulated) return true;
 	std::ofstream duty;
 	duty.open(path + "/duty_cycle");
 	if (duty.is_open()) {
@@ -0,0 +1,337 @@
+/******************************************************************************
+ * Hackerboat telemetry record module
+ * telemetryRecord.cpp
+ * This module packs HackerboatState objects into compact binary records,
+ * using the same field tables as the json writer and reader
+ *
+ * See the Hackerboat documentation for more details
+ * Written by agent, Oct 2026
+ *
+ * Version 0.1: First alpha
+ *
+ ******************************************************************************/
+
+#include <cstddef>
+#include <cmath>
+#include <string.h>
+#include <inttypes.h>
+#include <endian.h>
+#include "telemetryRecord.hpp"
+#include "fields.hpp"
+#include "location.hpp"
+#include "orientation.hpp"
+#include "gps.hpp"
+#include "ais.hpp"
+#include "healthMonitor.hpp"
+#include "boatState.hpp"
+#include "flightRecorder.hpp"
+
+#define FNV_OFFSET	(2166136261u)
+#define FNV_PRIME	(16777619u)
+
+namespace {
+	struct Cursor {
+		const uint8_t	*p;
+		const uint8_t	*end;
+	};
+
+	uint32_t fnv (uint32_t hash, const void *data, size_t len) {
+		const uint8_t *d = static_cast<const uint8_t*>(data);
+		for (size_t i = 0; i < len; i++) {
+			hash = (hash ^ d[i]) * FNV_PRIME;
+		}
+		return hash;
+	}
+
+	uint32_t hashFields (uint32_t hash, const FieldDescriptor *fields) {
+		for (const FieldDescriptor *f = fields; f->name; f++) {
+			uint8_t shape[2] = { static_cast<uint8_t>(f->kind), f->width };
+			hash = fnv(hash, f->name, strlen(f->name) + 1);
+			hash = fnv(hash, shape, sizeof(shape));
+			if (f->kind == FieldKind::OBJECT) hash = hashFields(hash, f->fields);
+		}
+		return fnv(hash, "", 1);				// so that a table ending is distinct from the next field starting
+	}
+
+	struct KnownSchema {
+		const FieldDescriptor	*fields;
+		uint32_t				schema;
+	};
+
+	const KnownSchema* known () {
+		static const KnownSchema schemas[] = {
+			{ Location::fields, hashFields(FNV_OFFSET, Location::fields) },
+			{ Orientation::fields, hashFields(FNV_OFFSET, Orientation::fields) },
+			{ GPSFix::fields, hashFields(FNV_OFFSET, GPSFix::fields) },
+			{ AISShip::fields, hashFields(FNV_OFFSET, AISShip::fields) },
+			{ HealthMonitor::fields, hashFields(FNV_OFFSET, HealthMonitor::fields) },
+			{ BoatState::fields, hashFields(FNV_OFFSET, BoatState::fields) },
+			{ CycleSample::fields, hashFields(FNV_OFFSET, CycleSample::fields) },
+			{ NULL, 0 }
+		};
+		return schemas;
+	}
+
+	size_t countFields (const FieldDescriptor *fields) {
+		size_t n = 0;
+		while (fields[n].name) n++;
+		return n;
+	}
+
+	void putLE (uint8_t *p, uint64_t v, int width) {
+		for (int i = 0; i < width; i++) {
+			p[i] = static_cast<uint8_t>(v >> (8 * i));
+		}
+	}
+
+	uint64_t getLE (const uint8_t *p, int width) {
+		uint64_t v = 0;
+		for (int i = 0; i < width; i++) {
+			v |= static_cast<uint64_t>(p[i]) << (8 * i);
+		}
+		return v;
+	}
+
+	int64_t signExtend (uint64_t v, int width) {
+		if (width >= 8) return static_cast<int64_t>(v);
+		uint64_t sign = 1ull << ((8 * width) - 1);
+		uint64_t mask = (sign << 1) - 1;
+		return static_cast<int64_t>(((v & mask) ^ sign) - sign);
+	}
+
+	bool fits (int64_t v, int width) {
+		return (signExtend(static_cast<uint64_t>(v), width) == v);
+	}
+
+	// Write the fields of obj at p, returning the end of what was written or NULL if it doesn't fit
+	uint8_t* encodeTable (const FieldDescriptor *fields, const void *obj, uint8_t *p, uint8_t *end) {
+		size_t mapBytes = (countFields(fields) + 7) / 8;
+		if ((size_t)(end - p) < mapBytes) return NULL;
+		uint8_t *map = p;
+		memset(map, 0, mapBytes);
+		p += mapBytes;
+		size_t i = 0;
+		for (const FieldDescriptor *f = fields; f->name; f++, i++) {
+			bool present = false;
+			if (f->kind == FieldKind::OBJECT) {
+				uint8_t *child = encodeTable(f->fields, f->child(const_cast<void*>(obj)), p, end);
+				if (!child) return NULL;
+				size_t childMap = (countFields(f->fields) + 7) / 8;
+				for (uint8_t *b = p; b < (p + childMap); b++) present |= (*b != 0);
+				if (present) p = child;
+			} else {
+				FieldValue v = f->get(obj);
+				switch (f->kind) {
+					case FieldKind::DOUBLE:
+						present = !std::isnan(v.d);
+						if (present) {
+							if ((end - p) < 8) return NULL;
+							uint64_t bits;
+							memcpy(&bits, &v.d, sizeof(bits));
+							putLE(p, bits, 8);
+							p += 8;
+						}
+						break;
+					case FieldKind::INT:
+					case FieldKind::TIME:
+						present = (v.i != 0);
+						if (present) {
+							if ((end - p) < f->width) return NULL;
+							putLE(p, static_cast<uint64_t>(v.i), f->width);
+							p += f->width;
+						}
+						break;
+					case FieldKind::ENUM:
+						present = (v.s != NULL);
+						if (present) {
+							if (!fits(v.i, f->width) || ((end - p) < f->width)) return NULL;
+							putLE(p, static_cast<uint64_t>(v.i), f->width);
+							p += f->width;
+						}
+						break;
+					case FieldKind::STRING:
+						if (v.len > UINT16_MAX) return NULL;
+						present = (v.len > 0);
+						if (present) {
+							if ((size_t)(end - p) < (v.len + 2)) return NULL;
+							putLE(p, v.len, 2);
+							memcpy(p + 2, v.s, v.len);
+							p += v.len + 2;
+						}
+						break;
+					case FieldKind::BOOL:
+						present = v.b;
+						break;
+					default:
+						return NULL;
+				}
+			}
+			if (present) map[i / 8] |= (1 << (i % 8));
+		}
+		return p;
+	}
+
+	// Read the value of one non-object field. If the field isn't present, this gives its default.
+	bool readValue (const FieldDescriptor *f, bool present, Cursor *c, FieldValue& v) {
+		if (!present) {
+			switch (f->kind) {
+				case FieldKind::DOUBLE:	v = FieldValue((double)NAN); break;
+				case FieldKind::INT:
+				case FieldKind::TIME:	v = FieldValue((int64_t)0); break;
+				case FieldKind::STRING:	v = FieldValue("", 0); break;
+				case FieldKind::BOOL:	v = FieldValue(false); break;
+				default:				v = FieldValue(); break;
+			}
+			return true;
+		}
+		switch (f->kind) {
+			case FieldKind::DOUBLE: {
+				if ((c->end - c->p) < 8) return false;
+				uint64_t bits = getLE(c->p, 8);
+				double d;
+				memcpy(&d, &bits, sizeof(d));
+				v = FieldValue(d);
+				c->p += 8;
+				return true;
+			}
+			case FieldKind::INT:
+			case FieldKind::TIME:
+			case FieldKind::ENUM:
+				if ((c->end - c->p) < f->width) return false;
+				v = FieldValue(signExtend(getLE(c->p, f->width), f->width));
+				c->p += f->width;
+				return true;
+			case FieldKind::STRING: {
+				if ((c->end - c->p) < 2) return false;
+				size_t len = getLE(c->p, 2);
+				if ((size_t)(c->end - c->p) < (len + 2)) return false;
+				v = FieldValue(reinterpret_cast<const char*>(c->p + 2), len);
+				c->p += len + 2;
+				return true;
+			}
+			case FieldKind::BOOL:
+				v = FieldValue(true);
+				return true;
+			default:
+				return false;
+		}
+	}
+
+	// Read the presence bitmap for a table. A NULL cursor means the whole table was left out.
+	bool readMap (const FieldDescriptor *fields, Cursor *c, const uint8_t *&map) {
+		map = NULL;
+		if (!c) return true;
+		size_t mapBytes = (countFields(fields) + 7) / 8;
+		if ((size_t)(c->end - c->p) < mapBytes) return false;
+		map = c->p;
+		c->p += mapBytes;
+		return true;
+	}
+
+	bool isPresent (const uint8_t *map, size_t i) {
+		return (map && (map[i / 8] & (1 << (i % 8))));
+	}
+
+	bool decodeTable (const FieldDescriptor *fields, void *obj, Cursor *c) {
+		const uint8_t *map;
+		if (!readMap(fields, c, map)) return false;
+		size_t i = 0;
+		for (const FieldDescriptor *f = fields; f->name; f++, i++) {
+			bool present = isPresent(map, i);
+			if (f->kind == FieldKind::OBJECT) {
+				if (!decodeTable(f->fields, f->child(obj), present ? c : NULL)) return false;
+				continue;
+			}
+			FieldValue v;
+			if (!readValue(f, present, c, v)) return false;
+			if ((f->kind == FieldKind::ENUM) && !present) continue;
+			if (!f->set(obj, v)) return false;
+		}
+		return true;
+	}
+
+	bool tableToJSON (const FieldDescriptor *fields, Cursor *c, JSONWriter& writer) {
+		const uint8_t *map;
+		if (!readMap(fields, c, map)) return false;
+		bool result = writer.StartObject();
+		size_t i = 0;
+		for (const FieldDescriptor *f = fields; f->name && result; f++, i++) {
+			bool present = isPresent(map, i);
+			result &= writer.Key(f->name, strlen(f->name));
+			if (f->kind == FieldKind::OBJECT) {
+				result &= tableToJSON(f->fields, present ? c : NULL, writer);
+				continue;
+			}
+			FieldValue v;
+			if (!readValue(f, present, c, v)) return false;
+			if ((f->kind == FieldKind::ENUM) && present) v = f->lookup(v.i);
+			result &= writeFieldValue(f->kind, v, writer);
+		}
+		return (result && writer.EndObject());
+	}
+
+	// Check the header and set up a cursor over the body
+	bool openRecord (const uint8_t *buf, size_t len, uint32_t& schema, Cursor& c) {
+		RecordHeader h;
+		if (len < sizeof(h)) return false;
+		memcpy(&h, buf, sizeof(h));
+		if ((h.magic != RECORD_MAGIC) || (h.version != RECORD_VERSION)) return false;
+		if (len < (sizeof(h) + le16toh(h.length))) return false;
+		schema = le32toh(h.schema);
+		c.p = buf + sizeof(h);
+		c.end = c.p + le16toh(h.length);
+		return true;
+	}
+}
+
+uint32_t recordSchema (const FieldDescriptor *fields) {
+	for (const KnownSchema *k = known(); k->fields; k++) {
+		if (k->fields == fields) return k->schema;
+	}
+	return hashFields(FNV_OFFSET, fields);
+}
+
+const FieldDescriptor* recordFields (uint32_t schema) {
+	for (const KnownSchema *k = known(); k->fields; k++) {
+		if (k->schema == schema) return k->fields;
+	}
+	return NULL;
+}
+
+size_t encodeRecord (const FieldDescriptor *fields, const void *obj, uint8_t *buf, size_t len) {
+	if (len < sizeof(RecordHeader)) return 0;
+	uint8_t *body = buf + sizeof(RecordHeader);
+	uint8_t *end = encodeTable(fields, obj, body, buf + len);
+	if (!end || ((end - body) > UINT16_MAX)) return 0;
+	RecordHeader h;
+	h.magic = RECORD_MAGIC;
+	h.version = RECORD_VERSION;
+	h.length = htole16(static_cast<uint16_t>(end - body));
+	h.schema = htole32(recordSchema(fields));
+	memcpy(buf, &h, sizeof(h));
+	return (end - buf);
+}
+
+bool decodeRecord (const FieldDescriptor *fields, void *obj, const uint8_t *buf, size_t len) {
+	uint32_t schema;
+	Cursor c;
+	if (!openRecord(buf, len, schema, c) || (schema != recordSchema(fields))) return false;
+	return (decodeTable(fields, obj, &c) && (c.p == c.end));
+}
+
+size_t recordSize (const uint8_t *buf, size_t len) {
+	RecordHeader h;
+	if (len < sizeof(h)) return 0;
+	memcpy(&h, buf, sizeof(h));
+	if ((h.magic != RECORD_MAGIC) || (h.version != RECORD_VERSION)) return 0;
+	return sizeof(h) + le16toh(h.length);
+}
+
+bool recordToJSON (const uint8_t *buf, size_t len, JSONWriter& writer) {
+	uint32_t schema;
+	Cursor c;
+	if (!openRecord(buf, len, schema, c)) return false;
+	const FieldDescriptor *fields = recordFields(schema);
+	if (!fields) return false;
+	return (tableToJSON(fields, &c, writer) && (c.p == c.end));
+}
@@ -25,15 +25,16 @@
 
 bool Throttle::setThrottle(int throttle) {
 	if ((throttle < throttleMin) || (throttle > throttleMax)) return false;
+	bool changed = (throttle != _throttle);		// the modes set the throttle every cycle, so only log changes
 	_throttle = throttle;
 	bool result = true;
 	try {
 		if (_throttle >= 0) {
 			result &= relays->get("DIR")->clear();
-			LOG(DEBUG) << "Setting throttle forward";
+			LOG_IF(changed, DEBUG) << "Setting throttle forward";
 		} else {
 			result &= relays->get("DIR")->set();
-			LOG(DEBUG) << "Setting throttle reverse";
+			LOG_IF(changed, DEBUG) << "Setting throttle reverse";
 		}
 	} catch (...) {
 		LOG(WARNING) << "Failed at direction setting" << std::endl;
@@ -41,7 +42,7 @@ bool Throttle::setThrottle(int throttle) {
 	}
 	switch (abs(_throttle)) {
 		case 5:
-			LOG(DEBUG) << "Setting throttle to 5";
+			LOG_IF(changed, DEBUG) << "Setting throttle to 5";
 			result &= relays->get("RED")->set();
 			result &= relays->get("WHT")->set();
 			result &= relays->get("YLW")->set();
@@ -49,7 +50,7 @@ bool Throttle::setThrottle(int throttle) {
 			result &= relays->get("YLWWHT")->set();
 			break;
 		case 4:
-			LOG(DEBUG) << "Setting throttle to 4";
+			LOG_IF(changed, DEBUG) << "Setting throttle to 4";
 			result &= relays->get("RED")->clear();
 			result &= relays->get("WHT")->clear();
 			result &= relays->get("YLW")->set();
@@ -57,7 +58,7 @@ bool Throttle::setThrottle(int throttle) {
 			result &= relays->get("YLWWHT")->clear();
 			break;
 		case 3:
-			LOG(DEBUG) << "Setting throttle to 3";
+			LOG_IF(changed, DEBUG) << "Setting throttle to 3";
 			result &= relays->get("RED")->clear();
 			result &= relays->get("WHT")->set();
 			result &= relays->get("YLW")->set();
@@ -65,7 +66,7 @@ bool Throttle::setThrottle(int throttle) {
 			result &= relays->get("YLWWHT")->clear();
 			break;
 		case 2:
-			LOG(DEBUG) << "Setting throttle to 2";
+			LOG_IF(changed, DEBUG) << "Setting throttle to 2";
 			result &= relays->get("RED")->clear();
 			result &= relays->get("WHT")->set();
 			result &= relays->get("YLW")->clear();
@@ -73,7 +74,7 @@ bool Throttle::setThrottle(int throttle) {
 			result &= relays->get("YLWWHT")->set();
 			break;
 		case 1:
-			LOG(DEBUG) << "Setting throttle to 1";
+			LOG_IF(changed, DEBUG) << "Setting throttle to 1";
 			result &= relays->get("RED")->clear();
 			result &= relays->get("WHT")->set();
 			result &= relays->get("YLW")->clear();
@@ -82,7 +83,7 @@ bool Throttle::setThrottle(int throttle) {
 			break;
 		case 0:
 		default:
-			LOG(DEBUG) << "Setting throttle to off";
+			LOG_IF(changed, DEBUG) << "Setting throttle to off";
 			result &= relays->get("RED")->clear();
 			result &= relays->get("WHT")->clear();
 			result &= relays->get("YLW")->clear();
@@ -95,16 +96,18 @@ bool Throttle::setThrottle(int throttle) {
 
 double Throttle::getMotorCurrent() {
 	if (_adc) {
-		LOG(DEBUG) << "Motor current is: " << std::to_string(_adc->getScaledValues().at("mot_i")); 
-		return _adc->getScaledValues().at("mot_i");
+		double current = _adc->getScaledValue("mot_i");
+		LOG(DEBUG) << "Motor current is: " << current; 
+		return current;
 	} 
 	return NAN;
 }
 
 double Throttle::getMotorVoltage() {
-		LOG(DEBUG) << "Motor voltage is: " << std::to_string(_adc->getScaledValues().at("mot_v"));
 	if (_adc) {
-		return _adc->getScaledValues().at("mot_v");
+		double voltage = _adc->getScaledValue("mot_v");
+		LOG(DEBUG) << "Motor voltage is: " << voltage;
+		return voltage;
 	} 
 	return NAN;
 }
\ No newline at end of file
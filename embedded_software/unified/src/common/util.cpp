@@ -19,4 +19,3 @@ using namespace rapidjson;
  
  // initialization of static class members
  Args* Args::_instance = new Args();
- Document HackerboatState::root;
@@ -28,16 +28,15 @@ INITIALIZE_EASYLOGGINGPP
 using namespace std;
 
 void runTestSet (OrientationInput *orient) {
-	Orientation *data = orient->getOrientation();
+	Orientation data;
 	double pitch, roll, heading;
 	bool valid;
 	for (int i = 0; i < 300; i++) {
-		//orient->lock.try_lock_for(100ms);
-		pitch = data->pitch;
-		roll = data->roll;
-		heading = data->heading;
-		valid = data->isValid();
-		//orient->lock.unlock();
+		data = orient->getOrientation();
+		pitch = data.pitch;
+		roll = data.roll;
+		heading = data.heading;
+		valid = data.isValid();
 		cout << to_string(pitch) << "\t" << to_string(roll) << "\t"; 
 		cout << to_string(heading) << "\t";
 		tuple<double,double,double> mag = orient->compass.getMagData();
@@ -69,7 +69,7 @@ int main(int argc, char **argv) {
 	}
 	
 	for (int i = 0; i < 100; i++) {
-		double currentheading = me->orient->getOrientation()->makeTrue().heading;
+		double currentheading = me->orient->getOrientation().makeTrue().heading;
 		if (isfinite(currentheading)) targetHeading += currentheading;
 		cout << ".";
 		std::this_thread::sleep_for(100ms);
@@ -79,9 +79,9 @@ int main(int argc, char **argv) {
 	cout << "Target heading is " << to_string(targetHeading) << " degrees true " << endl;
 	int count = 0;
 	for (;;) {
-		in = me->orient->getOrientation()->makeTrue().headingError(targetHeading);
+		in = me->orient->getOrientation().makeTrue().headingError(targetHeading);
 		count++;
-		LOG_EVERY_N(10, DEBUG) << "True Heading: " << me->orient->getOrientation()->makeTrue() 
+		LOG_EVERY_N(10, DEBUG) << "True Heading: " << me->orient->getOrientation().makeTrue() 
 								<< ", Target Course: " << targetHeading;
 		helm->Compute();
 		me->rudder->write(out);
@@ -89,7 +89,7 @@ int main(int argc, char **argv) {
 		std::this_thread::sleep_for(100ms);
 		if (count > 9) {
 			count = 0;
-			cout << "True Heading: " << me->orient->getOrientation()->makeTrue().heading 
+			cout << "True Heading: " << me->orient->getOrientation().makeTrue().heading 
 								<< "\tTarget Course: " << targetHeading
 								<< "\tRudder command: " << to_string(out) << endl;
 		}
@@ -90,12 +90,12 @@ bool GPSdInput::execute() {
 	return true;
 }
 
-std::map<int, AISShip>* GPSdInput::getData() {
+AISContactStore* GPSdInput::getData() {
 	return NULL;
 }
 
-std::map<int, AISShip> GPSdInput::getData(AISShipType type) {
-	std::map<int, AISShip> result;
+std::vector<AISShip*> GPSdInput::getData(AISShipType type) {
+	std::vector<AISShip*> result;
 	return result;
 }
 
@@ -107,6 +107,11 @@ AISShip* GPSdInput::getData(string name) {
 	return NULL;
 }
 
+size_t GPSdInput::getNearby(const Location& center, double radius, std::vector<AISShip*>& out) {
+	out.clear();
+	return 0;
+}
+
 GPSFix GPSdInput::getAverageFix() {
 	double lattot = 0, lontot = 0;
 	GPSFix result;
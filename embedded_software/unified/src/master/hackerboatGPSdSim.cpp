@@ -0,0 +1,200 @@
+/******************************************************************************
+ * Hackerboat gpsd simulator program
+ * hackerboatGPSdSim.cpp
+ * This program stands in for gpsd on a local port, so that the boat can be
+ * run on the bench without a receiver. It plays back recorded gpsd or NMEA
+ * streams and makes up GPS fixes and AIS traffic at a set rate. With -b, it
+ * instead feeds its own GPSdInput for a while and reports how fast the input
+ * took the traffic in, how much of it failed to parse, and how long each
+ * report took to show up in getFix() and getData().
+ * see the Hackerboat documentation for more details
+ *
+ * Written by agent, Oct 2026
+ *
+ * Version 0.1: First alpha
+ *
+ ******************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <signal.h>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <iostream>
+#include "hackerboatRoot.hpp"
+#include "configuration.hpp"
+#include "gpsdSim.hpp"
+#include "gps.hpp"
+#include "hal/gpsdInput.hpp"
+#include "easylogging++.h"
+
+#define BENCH_POLL		(100us)		/**< How often the benchmark looks for new reports */
+#define BENCH_DRAIN		(1s)		/**< Time allowed for the input to catch up at the end */
+
+INITIALIZE_EASYLOGGINGPP
+
+using namespace std;
+using namespace std::chrono;
+
+static volatile sig_atomic_t running = 1;
+
+static void quit (int) {
+	running = 0;
+}
+
+static void usage () {
+	cerr << "Usage: gpsdsim [-p port | -b seconds] [-t rate] [-c contacts] [-a seconds] [-e fraction] [-r file [-R rate] [-1]] [-v m/s] [-h degrees] [-s seed]" << endl;
+	cerr << "  -p port       port to listen on; default " << GPSD_SIM_PORT << endl;
+	cerr << "  -b seconds    instead of serving, feed a GPSdInput for this long and report how it kept up" << endl;
+	cerr << "  -t rate       own position reports per second; default 1, 0 for none" << endl;
+	cerr << "  -c contacts   number of made up AIS contacts; default 0" << endl;
+	cerr << "  -a seconds    seconds between position reports from each contact; default 10" << endl;
+	cerr << "  -e fraction   fraction of lines to send damaged; default 0" << endl;
+	cerr << "  -r file       recorded gpsd JSON or raw NMEA to play back" << endl;
+	cerr << "  -R rate       replayed lines per second; default 10, 0 for as fast as the clients take them" << endl;
+	cerr << "  -1            play the recording once rather than over and over" << endl;
+	cerr << "  -v m/s        our own speed; default 0" << endl;
+	cerr << "  -h degrees    our own course; default 0" << endl;
+	cerr << "  -s seed       seed for the contacts and the damage; default 1" << endl;
+}
+
+static void latencies (const char *name, vector<double>& ms) {
+	cout << name << " latency: ";
+	if (ms.empty()) {
+		cout << "none measured" << endl;
+		return;
+	}
+	sort(ms.begin(), ms.end());
+	double total = 0;
+	for (double m : ms) total += m;
+	cout << ms.size() << " samples, mean " << total / ms.size() << " ms, median " << ms[ms.size() / 2]
+		 << " ms, 99th percentile " << ms[(ms.size() * 99) / 100] << " ms, max " << ms.back() << " ms" << endl;
+}
+
+static int serve (GPSdSimServer& server) {
+	signal(SIGINT, quit);
+	signal(SIGTERM, quit);
+	cout << "Listening on 127.0.0.1:" << server.port() << endl;
+
+	auto start = steady_clock::now();
+	auto report = start;
+	uint64_t lastLines = 0;
+	while (running) {
+		std::this_thread::sleep_for(100ms);
+		auto now = steady_clock::now();
+		if ((now - report) < 10s) continue;
+		double period = duration<double>(now - report).count();
+		cout << (int)duration<double>(now - start).count() << " s: " << server.clients() << " clients, "
+			 << server.lines() << " lines (" << (server.lines() - lastLines) / period << "/s), "
+			 << server.fixes() << " fixes, " << server.aisMessages() << " AIS messages, "
+			 << server.damaged() << " damaged" << endl;
+		lastLines = server.lines();
+		report = now;
+	}
+	return 0;
+}
+
+static int benchmark (GPSdSimServer& server, double seconds) {
+	GPSdInput gps("127.0.0.1", server.port());
+	if (!gps.begin()) return -1;
+	vector<double> fixMs, aisMs;
+	uint64_t fixSeq = gps.getFixSequence();
+	uint64_t aisSeen = 0;
+	auto start = steady_clock::now();
+	auto end = start + duration_cast<steady_clock::duration>(duration<double>(seconds));
+	auto stop = end;
+
+	// the fix carries the time it was sent, and the AIS send times are kept by the server
+	while (steady_clock::now() < (stop + BENCH_DRAIN)) {
+		if ((steady_clock::now() >= end) && (stop == end)) {
+			stop = steady_clock::now();
+			server.stop();								// no more traffic; give the input time to catch up
+		}
+		std::this_thread::sleep_for(BENCH_POLL);
+		sysclock now = system_clock::now();
+		if (gps.getFixSequence() != fixSeq) {
+			fixSeq = gps.getFixSequence();
+			fixMs.push_back(duration<double, milli>(now - gps.getFix().gpsTime).count());
+		}
+		uint64_t ais = gps.getAISUpdates();
+		sysclock sent;
+		if ((ais != aisSeen) && server.aisSentAt(ais - 1, sent)) {
+			aisMs.push_back(duration<double, milli>(now - sent).count());
+		}
+		aisSeen = ais;
+	}
+	gps.kill();
+	double elapsed = duration<double>(stop - start).count();
+
+	cout << "Sent " << server.lines() << " lines in " << elapsed << " s: " << server.fixes() << " fixes, "
+		 << server.aisMessages() << " AIS messages, " << server.damaged() << " damaged" << endl;
+	cout << "Ingested " << gps.getLines() << " lines, " << gps.getLines() / elapsed << " per second" << endl;
+	cout << "Parse errors: " << gps.getParseErrors() << " (" << (100.0 * gps.getParseErrors()) / max<uint64_t>(gps.getLines(), 1) << "%)" << endl;
+	cout << "Fixes published: " << gps.getFixSequence() << "; AIS reports stored: " << gps.getAISUpdates()
+		 << " of " << server.aisMessages() << " sent intact; " << gps.getData()->size() << " contacts" << endl;
+	latencies("Fix", fixMs);
+	latencies("AIS", aisMs);
+	LOG_IF(!Conf::get()->aisRawNMEA(), WARNING) << "AIS Raw NMEA is off, so the made up AIS traffic was not read";
+	return 0;
+}
+
+int main (int argc, char **argv) {
+	GPSdSimConfig config;
+	int port = GPSD_SIM_PORT;
+	double bench = 0;
+
+	el::Loggers::reconfigureAllLoggers(el::ConfigurationType::ToStandardOutput, "false");
+	for (int i = 1; i < argc; i++) {
+		bool arg = ((i + 1) < argc);
+		if (!strcmp(argv[i], "-p") && arg) {
+			port = atoi(argv[++i]);
+		} else if (!strcmp(argv[i], "-b") && arg) {
+			bench = atof(argv[++i]);
+		} else if (!strcmp(argv[i], "-t") && arg) {
+			config.tpvRate = atof(argv[++i]);
+		} else if (!strcmp(argv[i], "-c") && arg) {
+			config.contacts = atoi(argv[++i]);
+		} else if (!strcmp(argv[i], "-a") && arg) {
+			config.reportPeriod = atof(argv[++i]);
+		} else if (!strcmp(argv[i], "-e") && arg) {
+			config.errorRate = atof(argv[++i]);
+		} else if (!strcmp(argv[i], "-r") && arg) {
+			config.replayFile = argv[++i];
+		} else if (!strcmp(argv[i], "-R") && arg) {
+			config.replayRate = atof(argv[++i]);
+		} else if (!strcmp(argv[i], "-1")) {
+			config.replayLoop = false;
+		} else if (!strcmp(argv[i], "-v") && arg) {
+			config.speed = atof(argv[++i]);
+		} else if (!strcmp(argv[i], "-h") && arg) {
+			config.course = atof(argv[++i]);
+		} else if (!strcmp(argv[i], "-s") && arg) {
+			config.seed = strtoul(argv[++i], NULL, 10);
+		} else {
+			usage();
+			return -1;
+		}
+	}
+	if ((config.tpvRate < 0) || (config.contacts < 0) || (config.reportPeriod <= 0) || (config.replayRate < 0) ||
+		(config.errorRate < 0) || (config.errorRate > 1) || (bench < 0)) {
+		usage();
+		return -1;
+	}
+
+	GPSdSimServer server(config);
+	if (bench > 0) {
+		Conf::get()->load();
+		port = 0;
+	}
+	if (!server.start(port)) {
+		cerr << "Unable to start the gpsd simulator on port " << port << endl;
+		return -1;
+	}
+	int result = (bench > 0) ? benchmark(server, bench) : serve(server);
+	server.stop();
+	return result;
+}
@@ -0,0 +1,228 @@
+/******************************************************************************
+ * Hackerboat mission log query program
+ * hackerboatLogQuery.cpp
+ * This program pulls the lines from a time range of one or more mission logs,
+ * optionally filtered on their fields, and writes them out as CSV or as a
+ * KML track. The logs are indexed the first time they are read.
+ * see the Hackerboat documentation for more details
+ *
+ * Written by agent, Oct 2026
+ *
+ * Version 0.1: First alpha
+ *
+ ******************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <iostream>
+#include "hackerboatRoot.hpp"
+#include "missionLog.hpp"
+#include "csvWriter.hpp"
+#include "easylogging++.h"
+
+INITIALIZE_EASYLOGGINGPP
+
+using namespace std;
+using namespace std::chrono;
+
+enum class Output {CSV, KML, COUNT};
+
+static void usage () {
+	cerr << "Usage: hackerboatLogQuery [-f time] [-t time] [-w filter]... [-c columns] [-k | -n] [-r] file..." << endl;
+	cerr << "  -f time     first record time to include, e.g. \"2017-04-09 20:47:00\"" << endl;
+	cerr << "  -t time     last record time to include" << endl;
+	cerr << "  -w filter   only lines where a column passes a test, e.g. \"Boat Mode=Navigation\" or \"Speed (m/s)>0.5\";" << endl;
+	cerr << "              may be given more than once. Tests are = != < > <= >=" << endl;
+	cerr << "  -c columns  comma separated list of columns to write; default is the whole line" << endl;
+	cerr << "  -k          write the Lat and Lon columns as a KML track instead of CSV" << endl;
+	cerr << "  -n          only count the matching lines" << endl;
+	cerr << "  -r          rebuild the index even if there is a good one" << endl;
+	cerr << "  file        master log (.log) or bare CSV file" << endl;
+}
+
+static bool readTime (const char *text, sysclock& t) {
+	// allow the seconds or the milliseconds to be left off
+	string s = text;
+	size_t colons = 0;
+	for (char c : s) colons += (c == ':');
+	if (colons == 1) s += ":00";
+	if (s.find('.') == string::npos) s += ".000";
+	return HackerboatState::parseTime(s, t);
+}
+
+static void kmlStart (sysclock start) {
+	string when = HackerboatState::packTime(start);
+	cout << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>" << endl;
+	cout << "<kml xmlns=\"http://www.opengis.net/kml/2.2\">" << endl;
+	cout << "<Document>" << endl;
+	cout << "<Style id=\"yellowLineGreenPoly\">" << endl;
+	cout << "<LineStyle>" << endl << "<color>7f00ffff</color>" << endl << "<width>4</width>" << endl << "</LineStyle>" << endl;
+	cout << "<PolyStyle>" << endl << "<color>7f00ff00</color>" << endl << "</PolyStyle>" << endl;
+	cout << "</Style>" << endl;
+	cout << "<name>Hackerboat Test " << when << " UTC</name>" << endl;
+	cout << "<description>Hackerboat test starting at " << when << " UTC</description>" << endl;
+	cout << "<Placemark>" << endl;
+	cout << "<name>Test Path</name>" << endl;
+	cout << "<styleUrl>#yellowLineGreenPoly</styleUrl>" << endl;
+	cout << "<LineString>" << endl << "<tessellate>1</tessellate>" << endl << "<altitudeMode>absolute</altitudeMode>" << endl;
+	cout << "<coordinates>" << endl;
+}
+
+static void kmlEnd () {
+	cout << "</coordinates>" << endl << "</LineString>" << endl << "</Placemark>" << endl;
+	cout << "</Document>" << endl << "</kml>" << endl;
+}
+
+int main (int argc, char **argv) {
+	vector<string> files;
+	vector<LogFilter> filters;
+	vector<string> wanted;
+	sysclock from = sysclock::min();
+	sysclock to = sysclock::max();
+	Output output = Output::CSV;
+	bool useCache = true;
+
+	el::Loggers::reconfigureAllLoggers(el::ConfigurationType::ToStandardOutput, "false");
+	for (int i = 1; i < argc; i++) {
+		if ((!strcmp(argv[i], "-f") || !strcmp(argv[i], "-t")) && ((i + 1) < argc)) {
+			bool first = (argv[i][1] == 'f');
+			if (!readTime(argv[++i], first ? from : to)) {
+				cerr << "Unable to read time " << argv[i] << endl;
+				return -1;
+			}
+		} else if (!strcmp(argv[i], "-w") && ((i + 1) < argc)) {
+			LogFilter filter;
+			if (!LogFilter::parse(argv[++i], filter)) {
+				cerr << "Unable to read filter " << argv[i] << endl;
+				return -1;
+			}
+			filters.push_back(filter);
+		} else if (!strcmp(argv[i], "-c") && ((i + 1) < argc)) {
+			i++;
+			MissionLog::columns(argv[i], strlen(argv[i]), wanted);
+		} else if (!strcmp(argv[i], "-k")) {
+			output = Output::KML;
+		} else if (!strcmp(argv[i], "-n")) {
+			output = Output::COUNT;
+		} else if (!strcmp(argv[i], "-r")) {
+			useCache = false;
+		} else if (argv[i][0] == '-') {
+			usage();
+			return -1;
+		} else {
+			files.push_back(argv[i]);
+		}
+	}
+	if (files.empty()) {
+		usage();
+		return -1;
+	}
+
+	const char *lastHeader = NULL;
+	vector<string> names, fields;
+	vector<int> index;
+	int latCol = -1, lonCol = -1;
+	bool started = false;
+	char buf[CSV_LINE_SIZE];
+	CSVWriter out(buf, sizeof(buf));
+	size_t total = 0;
+	sysclock firstStart;
+
+	// look the output columns up again whenever the header changes
+	auto header = [&] (const MissionLog::Line& line) {
+		if (line.header == lastHeader) return;
+		lastHeader = line.header;
+		names.clear();
+		if (line.header) MissionLog::columns(line.header, line.headerLen, names);
+		latCol = MissionLog::column(names, "Lat");
+		lonCol = MissionLog::column(names, "Lon");
+		index.clear();
+		for (auto& w : wanted) index.push_back(MissionLog::column(names, w));
+		if ((output == Output::CSV) && wanted.empty() && line.header) {
+			cout.write(line.header, line.headerLen) << '\n';
+		}
+	};
+
+	auto split = [&] (const MissionLog::Line& line) {
+		const char *p = line.data;
+		const char *end = line.data + line.len;
+		size_t n = 0;
+		while (p < end) {
+			if (fields.size() <= n) fields.emplace_back();
+			p = readCSVField(p, end, fields[n++]);
+		}
+		fields.resize(n);
+	};
+
+	if ((output == Output::CSV) && !wanted.empty()) {
+		out.clear();
+		for (auto& w : wanted) out.text(w);
+		cout.write(out.line(), out.size()) << '\n';
+	}
+
+	for (auto& path : files) {
+		MissionLog log;
+		if (!log.open(path, useCache)) {
+			cerr << "Unable to open " << path << endl;
+			return -1;
+		}
+		lastHeader = NULL;
+		if (files.front() == path) firstStart = log.start();
+		auto wallStart = steady_clock::now();
+		size_t count = log.query(from, to, filters, [&] (const MissionLog::Line& line) {
+			switch (output) {
+				case Output::CSV:
+					header(line);
+					if (wanted.empty()) {
+						cout.write(line.data, line.len) << '\n';
+						break;
+					}
+					split(line);
+					out.clear();
+					for (int i : index) {
+						if ((i >= 0) && ((size_t)i < fields.size())) {
+							out.text(fields[i]);
+						} else out.text("");
+					}
+					cout.write(out.line(), out.size()) << '\n';
+					break;
+				case Output::KML:
+					header(line);
+					if ((latCol < 0) || (lonCol < 0)) break;
+					split(line);
+					if (((size_t)latCol < fields.size()) && ((size_t)lonCol < fields.size())) {
+						double lat = atof(fields[latCol].c_str());
+						double lon = atof(fields[lonCol].c_str());
+						if ((lat == 0) && (lon == 0)) break;		// no fix yet
+						if (!started) {
+							kmlStart(line.time);
+							started = true;
+						}
+						char point[64];
+						snprintf(point, sizeof(point), "%8.6f, %8.6f,0", lon, lat);
+						cout << point << '\n';
+					}
+					break;
+				case Output::COUNT:
+					break;
+			}
+			return true;
+		});
+		double wall = duration_cast<microseconds>(steady_clock::now() - wallStart).count() / 1e3;
+		total += count;
+		cerr << path << ": " << count << " of " << log.lines() << " lines, "
+			 << HackerboatState::packTime(log.start()) << " to " << HackerboatState::packTime(log.end())
+			 << ", index " << (log.fromCache() ? "reused" : "built") << ", query took " << wall << " ms" << endl;
+	}
+	if (output == Output::KML) {
+		if (!started) kmlStart(firstStart);
+		kmlEnd();
+	} else if (output == Output::COUNT) {
+		cout << total << endl;
+	}
+	return 0;
+}
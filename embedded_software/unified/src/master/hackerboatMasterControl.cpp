@@ -36,6 +36,13 @@
 #include "waypoint.hpp"
 #include "easylogging++.h"
 #include "configuration.hpp"
+#include "controlExecutive.hpp"
+#include "cycleProfiler.hpp"
+#include "heartbeat.hpp"
+#include "realtime.hpp"
+#include "scratchArena.hpp"
+#include "jsonScope.hpp"
+#include "flightRecorder.hpp"
 
 #include "util.hpp"
 
@@ -57,6 +64,7 @@ int main (int argc, char **argv) {
 	START_EASYLOGGINGPP(argc, argv);
 	Args::getargs()->load(argc, argv);
 	Conf::get()->load();
+	RealTime::get()->lockMemory();
 
 	// system setup
 	BoatState state;
@@ -103,7 +111,8 @@ int main (int argc, char **argv) {
 											{"RudderPosition", new pub_RudderPosition(&state, &myrest)},
 											{"ThrottlePosition", new pub_ThrottlePosition(&state, &myrest)},
 											{"FaultString", new pub_FaultString(&state, &myrest)},
-											{"Waypoint", new pub_Waypoint(&state, &myrest)} };
+											{"Waypoint", new pub_Waypoint(&state, &myrest)},
+											{"Stats", new pub_Stats(&state, &myrest)} };
 	cerr << "Publishing map created..." << endl;
 	SubFuncMap *mysubmap = new SubFuncMap {{"Command", new sub_Command(&state, &myrest)}};
 	cerr << "Subscription map created..." << endl;
@@ -122,37 +131,87 @@ int main (int argc, char **argv) {
 		//return -1;
 	}
 
+	// open the heartbeat to the watchdog
+	Heartbeat heartbeat;
+	if (!heartbeat.open()) {
+		LOG(FATAL) << "Unable to open watchdog heartbeat " << heartbeat.getName();
+		return -1;
+	}
+
+	// open the flight recorder; losing it costs us the record, not the boat, so carry on without it
+	FlightRecorder recorder;
+	CycleSample sample;
+	if (!recorder.open(Conf::get()->recorderPath(), Conf::get()->recorderSlots(), Conf::get()->recorderSyncPeriod())) {
+		LOG(ERROR) << "Unable to open flight recorder " << Conf::get()->recorderPath();
+	}
+
+	// set up the control executive
+	ControlExecutive executive;
+	state.executive = &executive;
+	if (!executive.begin()) {
+		LOG(WARNING) << "Cycle timer unavailable; control loop is pacing itself with steady_clock sleeps";
+	}
+
+	// the input threads have their own schedules, so raise our priority only once they're running
+	RealTime::get()->configureThread("Control");
+	LatencyHistogram& controlWakeup = RealTime::get()->wakeup("Control");
+
 	cerr << "All configured -- entering state" << std::endl;
 	LOG(INFO) << "CSV," << state.getCSVheaders();
 
 	// run the boat
 	for (;;) {
+		// wait for the start of the next cycle
+		executive.wait();
+		if (executive.timed()) controlWakeup.record(executive.lastJitter());		// caught-up cycles have no deadline of their own
+		ScratchArena::cycle()->reset();
+		JSONScope jsonScope;							// anything packed this cycle is freed at the bottom of the loop
+		StageTimer cycleTimer(CycleStageEnum::CYCLE);
+
 		// kick the dog
-		ofstream wdfile;
-		wdfile.open(Conf::get()->wdFile());
-		wdfile << "1" << endl;
-		wdfile.close();
+		heartbeat.beat(state.getBoatMode());
 
 		// read inputs
-		state.lastFix.copy(state.gps->getFix());
-		state.health->readHealth();
-
-		// check if we have a valid fix and have not loaded the declination -- if so, load it. 
-		if (state.lastFix.isValid() && !declinationLoaded) {
-			declinationLoaded = state.orient->getOrientation()->updateDeclination(state.lastFix.fix);
+		{
+			StageTimer t(CycleStageEnum::INPUT);
+			state.lastFix.copy(state.gps->getFix());
+
+			// check if we have a valid fix and have not loaded the declination -- if so, load it. 
+			if (state.lastFix.isValid() && !declinationLoaded) {
+				declinationLoaded = state.orient->getOrientation().updateDeclination(state.lastFix.fix);
+			}
+		}
+		{
+			StageTimer t(CycleStageEnum::HEALTH);
+			state.health->readHealth();
 		}
 
 		// run the state
-		auto endtime = std::chrono::system_clock::now() + 100ms;
 		if (state.commandCnt()) {
-			cerr << to_string(state.commandCnt()) << " commands in the queue" << endl;
-			cerr << to_string(state.executeCmds(0)) << " commands successfully executed" << endl;
+			StageTimer t(CycleStageEnum::COMMANDS);
+			cerr << state.commandCnt() << " commands in the queue" << endl;
+			cerr << state.executeCmds(0) << " commands successfully executed" << endl;
+		}
+		{
+			StageTimer t(CycleStageEnum::BOAT_MODE);
+			oldmode = mode;
+			mode = mode->execute();
+			if (mode != oldmode) REMOVE(oldmode);
+		}
+		{
+			StageTimer t(CycleStageEnum::LOG);
+			if (recorder.begin()) {
+				sample.capture(state, executive.cycles());
+				recorder.append(sample);
+				recorder.append(state);
+				recorder.append(*state.health);
+				recorder.commit();
+			}
+			if ((executive.cycles() % 5) == 0) {
+				LOG(INFO) << "CSV," << state.getCSV();
+			}
 		}
-		oldmode = mode;
-		mode = mode->execute();
-		if (mode != oldmode) REMOVE(oldmode);		
-		LOG_EVERY_N(5, INFO) << "CSV," << state.getCSV();
-		std::this_thread::sleep_until(endtime);
+		LOG_EVERY_N(600, INFO) << "Stats," << CycleProfiler::get()->report(&executive);
 	}
 
 	return 0;
@@ -18,6 +18,8 @@
 #include "hal/orientationInput.hpp"
 #include "hal/relay.hpp"
 #include "hal/RCinput.hpp"
+#include "scratchArena.hpp"
+#include "jsonScope.hpp"
 
 using namespace std;
 
@@ -74,6 +76,8 @@ int main () {
 	logfile << state.getCSVheaders();
 	cout << "Setup completed!" << endl;
 	while (1) {
+		ScratchArena::cycle()->reset();
+		JSONScope jsonScope;
 		state.recordTime = std::chrono::system_clock::now();
 		if (!state.armInput.get()) startState = true;
 		if (!state.disarmInput.get()) startState = false;
@@ -87,8 +91,8 @@ int main () {
 		} else if (state.rc->getMode() == RCModeEnum::COURSE) {
 			get<0>(state.K) = RCInput::map(static_cast<double>(state.rc->getChannel(2)), RC_MIN, RC_MAX, 0.0, 100.0);
 			get<1>(state.K) = RCInput::map(static_cast<double>(state.rc->getChannel(1)), RC_MIN, RC_MAX, 0.0, 10.0);
-			Orientation *heading = state.orient->getOrientation();
-			courseError = heading->headingError(state.rc->getCourse());
+			Orientation heading = state.orient->getOrientation();
+			courseError = heading.headingError(state.rc->getCourse());
 			rudderpid.SetTunings(state.K);
 			rudderpid.Compute();
 			state.rudder->write(rudderCommand);
@@ -101,7 +105,7 @@ int main () {
 		} else {
 			state.relays->get("HORN").clear();
 		}
-		state.lastFix = *(state.gps->getFix());
+		state.lastFix = state.gps->getFix();
 		string csv = state.getCSV();
 		cout << csv << "," << to_string(get<0>(state.K));
 		cout << "," << to_string(get<1>(state.K)) << ",";
@@ -0,0 +1,144 @@
+/******************************************************************************
+ * Hackerboat flight recorder dump program
+ * hackerboatRecorder.cpp
+ * This program dumps the frames of a flight recorder file as json, one frame
+ * per line, and can follow the file while the master is writing it
+ * see the Hackerboat documentation for more details
+ *
+ * Written by agent, Oct 2026
+ *
+ * Version 0.1: First alpha
+ *
+ ******************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <iostream>
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
+#include "configuration.hpp"
+#include "flightRecorder.hpp"
+#include "telemetryRecord.hpp"
+#include "easylogging++.h"
+
+#define RECORDER_POLL_PERIOD	(100ms)
+
+INITIALIZE_EASYLOGGINGPP
+
+using namespace rapidjson;
+using namespace std;
+using namespace std::chrono;
+
+static void usage () {
+	cerr << "Usage: hackerboatRecorder [-f] [-n frames] [file]" << endl;
+	cerr << "  -f         keep printing frames as they are written" << endl;
+	cerr << "  -n frames  print only the last this many frames" << endl;
+	cerr << "  file       recorder file; defaults to the configured Recorder Path" << endl;
+}
+
+// Write one frame as a json object on its own line. Returns false if a record in it is unreadable
+static bool dumpFrame (uint64_t seq, sysclock time, const uint8_t *buf, size_t len) {
+	StringBuffer out;
+	JSONWriter writer(out);
+	char timeBuf[TIME_STRING_SIZE];
+	bool result = true;
+
+	writer.StartObject();
+	writer.Key("frame");
+	writer.Uint64(seq);
+	writer.Key("time");
+	writer.String(timeBuf, HackerboatState::packTime(time, timeBuf, sizeof(timeBuf)));
+	writer.Key("records");
+	writer.StartArray();
+	size_t used = 0;
+	while (used < len) {
+		size_t size = recordSize(buf + used, len - used);
+		if ((size == 0) || !recordToJSON(buf + used, size, writer)) {
+			result = false;
+			break;
+		}
+		used += size;
+	}
+	writer.EndArray();
+	writer.EndObject();
+	cout << out.GetString() << '\n';
+	return result;
+}
+
+int main (int argc, char **argv) {
+	string path;
+	bool follow = false;
+	uint64_t back = 0;
+	bool backSet = false;
+	uint8_t buf[RECORDER_FRAME_SIZE];
+
+	el::Loggers::reconfigureAllLoggers(el::ConfigurationType::ToStandardOutput, "false");
+	Conf::get()->load();
+	path = Conf::get()->recorderPath();
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "-f")) {
+			follow = true;
+		} else if (!strcmp(argv[i], "-n") && ((i + 1) < argc)) {
+			back = strtoull(argv[++i], NULL, 10);
+			backSet = true;
+		} else if (argv[i][0] == '-') {
+			usage();
+			return -1;
+		} else {
+			path = argv[i];
+		}
+	}
+
+	FlightRecorderReader reader;
+	if (!reader.open(path)) {
+		cerr << "Unable to open flight recorder " << path << endl;
+		return -1;
+	}
+
+	// following with no count prints only new frames, like tail -f
+	uint64_t seq = reader.oldest();
+	if (backSet) {
+		seq = (reader.next() > back) ? (reader.next() - back) : 1;
+	} else if (follow) {
+		seq = reader.next();
+	}
+	if (seq < reader.oldest()) seq = reader.oldest();
+
+	uint64_t skipped = 0;
+	for (;;) {
+		size_t used = 0;
+		sysclock time;
+		switch (reader.read(seq, buf, sizeof(buf), used, time)) {
+			case FlightRecorderReader::Result::OK:
+				if (!dumpFrame(seq, time, buf, used)) {
+					cerr << "Frame " << seq << " has an unreadable record" << endl;
+				}
+				seq++;
+				break;
+			case FlightRecorderReader::Result::NOT_YET:
+				if (!follow) {
+					if (skipped) cerr << skipped << " frames were unreadable" << endl;
+					return 0;
+				}
+				cout.flush();
+				this_thread::sleep_for(RECORDER_POLL_PERIOD);
+				break;
+			case FlightRecorderReader::Result::OVERWRITTEN:
+				// we fell behind the writer; pick up at the oldest frame it has left us
+				// (or it is rewriting this very slot, so step past it)
+				skipped += (reader.oldest() > seq) ? (reader.oldest() - seq) : 1;
+				seq = (reader.oldest() > seq) ? reader.oldest() : (seq + 1);
+				break;
+			case FlightRecorderReader::Result::CORRUPT:
+				skipped++;
+				seq++;
+				break;
+		}
+	}
+
+	return 0;
+}
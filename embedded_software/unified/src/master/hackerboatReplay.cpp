@@ -0,0 +1,118 @@
+/******************************************************************************
+ * Hackerboat mission replay program
+ * hackerboatReplay.cpp
+ * This program runs recorded missions back through the boat modes, as fast
+ * as it can, and reports where the rudder and throttle commands differ from
+ * the recorded ones
+ * see the Hackerboat documentation for more details
+ *
+ * Written by agent, Oct 2026
+ *
+ * Version 0.1: First alpha
+ *
+ ******************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <iostream>
+#include "configuration.hpp"
+#include "boatState.hpp"
+#include "replay.hpp"
+#include "easylogging++.h"
+
+INITIALIZE_EASYLOGGINGPP
+
+using namespace std;
+using namespace std::chrono;
+
+static void usage () {
+	cerr << "Usage: hackerboatReplay [-q] [-t microseconds] [-s mode] file..." << endl;
+	cerr << "  -q               print only the summary of each file" << endl;
+	cerr << "  -t microseconds  rudder difference that counts as a mismatch; default " << REPLAY_RUDDER_TOL << endl;
+	cerr << "  -s mode          boat mode to start each file in, e.g. Disarmed; default Start" << endl;
+	cerr << "  file             master log (.log), bare CSV file (.csv), or flight recorder file" << endl;
+}
+
+static bool endsWith (const string& s, const char *suffix) {
+	size_t len = strlen(suffix);
+	return (s.size() >= len) && (s.compare(s.size() - len, len, suffix) == 0);
+}
+
+int main (int argc, char **argv) {
+	vector<string> files;
+	bool quiet = false;
+	int tolerance = REPLAY_RUDDER_TOL;
+	BoatModeEnum start = BoatModeEnum::START;
+
+	el::Loggers::reconfigureAllLoggers(el::ConfigurationType::ToStandardOutput, "false");
+	Conf::get()->load();
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "-q")) {
+			quiet = true;
+		} else if (!strcmp(argv[i], "-t") && ((i + 1) < argc)) {
+			tolerance = atoi(argv[++i]);
+		} else if (!strcmp(argv[i], "-s") && ((i + 1) < argc)) {
+			if (!BoatState::boatModeNames.get(argv[++i], &start)) {
+				cerr << "Unknown boat mode " << argv[i] << endl;
+				return -1;
+			}
+		} else if (argv[i][0] == '-') {
+			usage();
+			return -1;
+		} else {
+			files.push_back(argv[i]);
+		}
+	}
+	if (files.empty()) {
+		usage();
+		return -1;
+	}
+
+	ReplayDriver driver;
+	driver.setRudderTolerance(tolerance);
+	uint64_t mismatches = 0;
+	for (auto& path : files) {
+		CSVLogReplay csv;
+		RecorderReplay recorder;
+		ReplaySource *source;
+		bool isCSV = endsWith(path, ".log") || endsWith(path, ".csv");
+		if (isCSV ? !csv.open(path) : !recorder.open(path)) {
+			cerr << "Unable to open " << path << endl;
+			return -1;
+		}
+		source = isCSV ? static_cast<ReplaySource*>(&csv) : static_cast<ReplaySource*>(&recorder);
+
+		driver.begin(start);
+		ReplayFrame frame;
+		sysclock first, last;
+		auto wallStart = steady_clock::now();
+		while (source->next(frame)) {
+			if (driver.stats().frames == 0) first = frame.time;
+			last = frame.time;
+			if (!driver.step(frame) && !quiet) {
+				cout << HackerboatState::packTime(frame.time) << " " << BoatState::boatModeNames.get(driver.state().getBoatMode())
+					 << " rudder " << driver.rudder() << " (logged " << frame.rudder << ")"
+					 << " throttle " << driver.throttle() << " (logged " << frame.throttle << ")" << endl;
+			}
+		}
+		double wall = duration_cast<microseconds>(steady_clock::now() - wallStart).count() / 1e6;
+		double mission = duration_cast<milliseconds>(last - first).count() / 1e3;
+
+		const ReplayStats& stats = driver.stats();
+		cout << path << ": " << stats.frames << " frames, " << stats.cycles << " cycles, "
+			 << stats.compared << " compared, " << stats.mismatches << " mismatched ("
+			 << stats.rudderMismatches << " rudder, " << stats.throttleMismatches << " throttle), "
+			 << "worst rudder error " << stats.maxRudderError << " us";
+		if (stats.mismatches) cout << ", first at " << HackerboatState::packTime(stats.firstMismatch);
+		cout << "; " << mission << " s of mission in " << wall << " s" << endl;
+		size_t skipped = isCSV ? csv.skipped() : recorder.skipped();
+		if (skipped) cerr << path << ": " << skipped << " unreadable lines or frames skipped" << endl;
+		mismatches += stats.mismatches;
+	}
+
+	return (mismatches) ? 1 : 0;
+}
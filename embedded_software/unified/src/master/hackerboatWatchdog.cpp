@@ -17,11 +17,8 @@
 #include <chrono>
 #include "hal/throttle.hpp"
 #include "configuration.hpp"
-extern "C" {
-	#include <sys/types.h>
-	#include <sys/stat.h>
-	#include <unistd.h>
-}
+#include "heartbeat.hpp"
+#include "realtime.hpp"
 
 #include "easylogging++.h"
 #include "util.hpp"
@@ -45,50 +42,75 @@ bool killRelays () {
 }
 
 int main (int argc, char **argv) {
-	std::string wdFilePath;
-	struct stat wdFileStatus;
+	std::string heartbeatName;
+	bool fired = false;
+	steady_clock::time_point lastKill;
 
     // Load configuration from file
     el::Configurations conf("/home/debian/hackerboat/embedded_software/unified/setup/log.conf");
     // Actually reconfigure all loggers instead
     el::Loggers::reconfigureAllLoggers(conf);
 	//START_EASYLOGGINGPP(argc, argv);
+	Conf::get()->load();
 
 	cerr << "Starting watchdog..." << std::endl;
 
+	// the watchdog has to be able to preempt anything it's guarding, or a spinning real-time thread
+	// can keep it from firing; warn about any schedule that could
+	RealTime::get()->lockMemory();
+	RealTime::get()->configureThread("Watchdog");
+	auto& schedule = Conf::get()->threadSchedule();
+	auto mine = schedule.find("Watchdog");
+	for (auto& entry : schedule) {
+		if ((entry.first == "Watchdog") || (std::get<0>(entry.second) == "Other")) continue;
+		if ((mine == schedule.end()) || (std::get<0>(mine->second) == "Other") ||
+			(std::get<1>(entry.second) >= std::get<1>(mine->second))) {
+			LOG(WARNING) << "Thread " << entry.first << " is scheduled " << std::get<0>(entry.second) << " priority "
+						 << std::get<1>(entry.second) << ", not below the watchdog; it could keep the watchdog from firing";
+		}
+	}
+
 	// start up the relays
 	RelayMap *relays = RelayMap::instance();
 	relays->init();
 
-	// Determine the watchdog file
-	if (argc > 2) {
-		wdFilePath = argv[1];
+	// Determine the heartbeat
+	if (argc > 1) {
+		heartbeatName = argv[1];
 	} else {
-		wdFilePath = Conf::get()->wdFile();
+		heartbeatName = Conf::get()->heartbeatName();
 	}
-	cerr << "Watchdog file is: " << wdFilePath << endl;
-	if (stat(wdFilePath.c_str(), &wdFileStatus)) {
-		cerr << "Unable to open " << wdFilePath << " errno: " << errno << std::endl;
+	cerr << "Watchdog heartbeat is: " << heartbeatName << endl;
+	Heartbeat heartbeat(heartbeatName);
+	if (!heartbeat.open()) {
+		cerr << "Unable to open heartbeat " << heartbeatName << " errno: " << errno << std::endl;
 		return -1;
 	}
 
 	// run the watchdog
+	steady_clock::time_point nextCheck = steady_clock::now();
 	for (;;) {
-		// Check the last file modification time. Turn off relays if file can't be found
-		if (stat(wdFilePath.c_str(), &wdFileStatus)) {
-			cerr << "Unable to open " << wdFilePath << " errno: " << errno << std::endl;
-			killRelays();
-		} else {
-			// If time since last modification greater than timeout, turn off all relays
-			system_clock::time_point lastmod(duration_cast<system_clock::duration>(
-												seconds{wdFileStatus.st_mtim.tv_sec} + 
-												nanoseconds{wdFileStatus.st_mtim.tv_nsec}));
-			if ((system_clock::now() - lastmod) > Conf::get()->wdTimeout()) {
+		// If the master hasn't beaten within the timeout, turn off all relays. Once fired, keep
+		// killing them once a second for as long as the master stays silent.
+		if (heartbeat.check(Conf::get()->wdTimeout())) {
+			if (fired) {
+				LOG(INFO) << "Master heartbeat resumed at cycle " << heartbeat.getCounter();
+				cerr << "Master heartbeat resumed" << std::endl;
+			}
+			fired = false;
+		} else if (!fired || ((steady_clock::now() - lastKill) > 1s)) {
+			if (!fired) {
+				LOG(ERROR) << "Watchdog fired: master (pid " << heartbeat.getPid() << ") silent for "
+						   << duration_cast<milliseconds>(heartbeat.sinceLastBeat()).count() << " ms at cycle "
+						   << heartbeat.getCounter() << " in mode " << static_cast<int>(heartbeat.getMode());
 				cerr << "Watchdog fired" << std::endl;
-				killRelays();
 			}
+			killRelays();
+			lastKill = steady_clock::now();
+			fired = true;
 		}
-		std::this_thread::sleep_for(1s);
+		nextCheck += Conf::get()->wdCheckPeriod();
+		std::this_thread::sleep_until(nextCheck);
 	}
 
 	return 0;
@@ -0,0 +1,302 @@
+#include <stdexcept>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <set>
+#include <vector>
+#include "aisStore.hpp"
+#include "ais.hpp"
+#include "location.hpp"
+#include "configuration.hpp"
+#include "test_utilities.hpp"
+#include "easylogging++.h"
+
+#define SEATTLE {47.592597, -122.382938}
+#define LANE_CONTACTS (5000)		// A busy shipping lane, and then some
+#define BENCHMARK_QUERIES (1000)
+#define EDGE_TOL (0.05)				// Meters; contacts this close to the edge of a query can go either way
+
+using namespace std::chrono;
+
+static const sysclock testTime = sysclock(seconds(1491770827));
+
+static AISShip makeShip (int mmsi, double lat, double lon, sysclock stamp = testTime) {
+	AISShip ship;
+	ship.mmsi = mmsi;
+	ship.fix = Location(lat, lon);
+	ship.lastTimeStamp = stamp;
+	return ship;
+}
+
+// Contacts scattered over half a degree around the center
+static void fillLane (AISContactStore& store, const Location& center, int count, std::mt19937& rng) {
+	std::uniform_real_distribution<double> offset(-0.25, 0.25);
+	for (int i = 0; i < count; i++) {
+		double lon = remainder(center.lon + offset(rng), 360.0);
+		store.upsert(makeShip(100000 + i, center.lat + offset(rng), lon));
+	}
+}
+
+// Check a range query against measuring the distance to every contact
+static void checkWithin (AISContactStore& store, const Location& center, double radius) {
+	std::vector<AISShip*> found;
+	std::vector<double> dist;
+	store.within(center, radius, found, &dist);
+	ASSERT_EQ(found.size(), dist.size());
+	std::set<int> got;
+	for (size_t i = 0; i < found.size(); i++) {
+		got.insert(found[i]->mmsi);
+		EXPECT_LE(dist[i], radius);
+	}
+	store.forEach([&] (AISShip& ship) {
+		double d = center.distance(ship.fix, CourseTypeEnum::Approximate);
+		if (fabs(d - radius) < EDGE_TOL) return;
+		EXPECT_EQ(got.count(ship.mmsi), (d <= radius) ? 1u : 0u);
+	});
+}
+
+TEST(AISStoreTest, Lookup) {
+	VLOG(1) << "===AIS Store Test, Lookup===";
+	AISContactStore store;
+	EXPECT_EQ(store.upsert(makeShip(-1, 47.6, -122.4)), (AISShip*)NULL);
+	AISShip *a = store.upsert(makeShip(367000001, 47.6, -122.4));
+	AISShip *b = store.upsert(makeShip(367000002, 47.61, -122.41));
+	ASSERT_NE(a, (AISShip*)NULL);
+	EXPECT_EQ(store.size(), 2u);
+	EXPECT_EQ(store.find(367000001), a);
+	EXPECT_EQ(store.find(367000002), b);
+	EXPECT_EQ(store.find(367000003), (AISShip*)NULL);
+
+	// a later report updates the contact in place, and a name from static data indexes it by name
+	AISShip update = makeShip(367000001, 47.65, -122.45, testTime + 10s);
+	update.shipname = "WENATCHEE";
+	update.shiptype = AISShipType::PASSENGER;
+	EXPECT_EQ(store.upsert(update), a);
+	EXPECT_EQ(store.size(), 2u);
+	EXPECT_EQ(a->mmsi, 367000001);
+	EXPECT_EQ(a->fix.lat, 47.65);
+	EXPECT_EQ(a->lastTimeStamp, testTime + 10s);
+	EXPECT_EQ(store.find("WENATCHEE"), a);
+	EXPECT_EQ(store.find("TACOMA"), (AISShip*)NULL);
+	std::vector<AISShip*> ferries;
+	EXPECT_EQ(store.ofType(AISShipType::PASSENGER, ferries), 1u);
+
+	// a contact changed in place is re-indexed by moved()
+	b->shipname = "TACOMA";
+	store.moved(b);
+	EXPECT_EQ(store.find("TACOMA"), b);
+
+	EXPECT_TRUE(store.erase(367000001));
+	EXPECT_FALSE(store.erase(367000001));
+	EXPECT_EQ(store.find(367000001), (AISShip*)NULL);
+	EXPECT_EQ(store.find("WENATCHEE"), (AISShip*)NULL);
+	EXPECT_EQ(store.size(), 1u);
+
+	// the slot is reused, and the other contact hasn't moved
+	EXPECT_EQ(store.upsert(makeShip(367000004, 47.6, -122.4)), a);
+	EXPECT_EQ(store.find(367000002), b);
+	EXPECT_EQ(b->fix.lat, 47.61);
+}
+
+TEST(AISStoreTest, Merge) {
+	VLOG(1) << "===AIS Store Test, Merge===";
+	AISContactStore store;
+	AISShip report = makeShip(367000001, 47.6, -122.4);
+	report.speed = 0;
+	report.course = 0;
+	report.status = AISNavStatus::ENGINE;
+	AISShip *a = store.upsert(std::move(report));
+	ASSERT_NE(a, (AISShip*)NULL);
+
+	// static data fills in the rest, without moving the time stamp that goes with the position
+	AISShip data;
+	data.mmsi = 367000001;
+	data.lastTimeStamp = testTime + 5s;
+	data.shipname = "CATHLAMET OF SEATTLE";
+	data.callsign = "WYX2158";
+	data.shiptype = AISShipType::PASSENGER;
+	data.to_bow = 70;
+	EXPECT_EQ(store.upsert(std::move(data)), a);
+	EXPECT_EQ(a->shipname, "CATHLAMET OF SEATTLE");
+	EXPECT_EQ(a->callsign, "WYX2158");
+	EXPECT_EQ(a->to_bow, 70);
+	EXPECT_EQ(a->fix.lat, 47.6);
+	EXPECT_EQ(a->lastTimeStamp, testTime);
+	EXPECT_EQ(a->speed, 0);						// stopped isn't the same as unknown
+	EXPECT_EQ(store.find("CATHLAMET OF SEATTLE"), a);
+
+	// a newer position report wins, motion and all, and one that arrives late changes nothing it has
+	AISShip moored = makeShip(367000001, 47.61, -122.41, testTime + 10s);
+	moored.status = AISNavStatus::MOORED;
+	moored.heading = 45;
+	store.upsert(moored);
+	EXPECT_TRUE(std::isnan(a->speed));			// not sent with this report, so no longer known
+	EXPECT_TRUE(std::isnan(a->course));
+	AISShip late = makeShip(367000001, 47.5, -122.3, testTime + 1s);
+	late.status = AISNavStatus::ENGINE;
+	late.speed = 12;
+	late.heading = 90;
+	store.upsert(late);
+	EXPECT_EQ(a->status, AISNavStatus::MOORED);
+	EXPECT_EQ(a->fix.lat, 47.61);
+	EXPECT_TRUE(std::isnan(a->speed));
+	EXPECT_EQ(a->heading, 45);
+	EXPECT_EQ(a->lastTimeStamp, testTime + 10s);
+	EXPECT_EQ(a->shipname, "CATHLAMET OF SEATTLE");
+	EXPECT_EQ(store.size(), 1u);
+
+	// a claimed contact is written in place and indexed by moved()
+	bool added;
+	EXPECT_EQ(store.claim(367000001, added), a);
+	EXPECT_FALSE(added);
+	EXPECT_EQ(store.claim(0, added), (AISShip*)NULL);
+	AISShip *b = store.claim(367000002, added);
+	ASSERT_NE(b, (AISShip*)NULL);
+	EXPECT_TRUE(added);
+	EXPECT_EQ(b->mmsi, 367000002);
+	b->fix = Location(47.6, -122.4);
+	b->lastTimeStamp = testTime;
+	store.moved(b);
+	std::vector<AISShip*> found;
+	EXPECT_EQ(store.within(Location(47.6, -122.4), 100, found), 1u);
+	EXPECT_EQ(store.expire(testTime + Conf::get()->aisMaxTime() + 1s), 1u);		// the other one reported later
+
+	// a contact that's gone leaves its slot, with the room for its name, to the next
+	size_t room = a->shipname.capacity();
+	EXPECT_TRUE(store.erase(367000001));
+	EXPECT_EQ(store.claim(367000003, added), a);
+	EXPECT_TRUE(a->shipname.empty());
+	EXPECT_EQ(a->shipname.capacity(), room);
+	EXPECT_TRUE(std::isnan(a->speed));
+}
+
+TEST(AISStoreTest, Within) {
+	VLOG(1) << "===AIS Store Test, Within===";
+	std::mt19937 rng(17);
+	AISContactStore store;
+	Location seattle SEATTLE;
+	fillLane(store, seattle, 2000, rng);
+	store.upsert(makeShip(200000, NAN, NAN));		// no position yet
+	for (double radius : {0.0, 500.0, 2000.0, 10000.0, 30000.0}) {
+		checkWithin(store, seattle, radius);
+		checkWithin(store, Location(47.75, -122.2), radius);
+	}
+
+	// contacts that move are found in their new cells
+	std::vector<AISShip*> found;
+	EXPECT_EQ(store.within(Location(48.5, -123.0), 1000, found), 0u);
+	store.upsert(makeShip(100000, 48.5, -123.0, testTime + 1s));
+	ASSERT_EQ(store.within(Location(48.5, -123.0), 1000, found), 1u);
+	EXPECT_EQ(found[0]->mmsi, 100000);
+	checkWithin(store, seattle, 10000);
+
+	// across the antimeridian, and near the pole
+	AISContactStore dateline;
+	fillLane(dateline, Location(10, 180), 500, rng);
+	checkWithin(dateline, Location(10, 179.99), 10000);
+	checkWithin(dateline, Location(10, -179.99), 20000);
+	AISContactStore polar;
+	fillLane(polar, Location(89.5, 0), 500, rng);
+	checkWithin(polar, Location(89.6, 10), 20000);
+	EXPECT_EQ(store.within(Location(), 1000, found), 0u);
+}
+
+TEST(AISStoreTest, Expire) {
+	VLOG(1) << "===AIS Store Test, Expire===";
+	AISContactStore store;
+	auto maxAge = Conf::get()->aisMaxTime();
+	for (int i = 0; i < 100; i++) {
+		store.upsert(makeShip(1000 + i, 47.6, -122.4, testTime - maxAge + seconds(i)));
+	}
+	// one due more than a lap of the wheel from now
+	store.upsert(makeShip(2000, 47.6, -122.4, testTime - maxAge + seconds(AIS_WHEEL_SLOTS + 45)));
+	EXPECT_EQ(store.expire(testTime), 0u);
+	EXPECT_EQ(store.expire(testTime + 10s), 10u);
+	EXPECT_EQ(store.find(1009), (AISShip*)NULL);
+	EXPECT_NE(store.find(1010), (AISShip*)NULL);
+
+	// a new report puts off expiry
+	store.upsert(makeShip(1010, 47.6, -122.4, testTime + 50s));
+	EXPECT_EQ(store.expire(testTime + 100s), 89u);
+	EXPECT_NE(store.find(1010), (AISShip*)NULL);
+	EXPECT_NE(store.find(2000), (AISShip*)NULL);
+	EXPECT_EQ(store.expire(testTime + seconds(AIS_WHEEL_SLOTS + 46)), 1u);
+	EXPECT_EQ(store.find(2000), (AISShip*)NULL);
+	EXPECT_EQ(store.size(), 1u);
+
+	// a report that's already stale goes at the next expire()
+	store.upsert(makeShip(3000, 47.6, -122.4, testTime - maxAge));
+	EXPECT_EQ(store.expire(testTime + seconds(AIS_WHEEL_SLOTS + 47)), 1u);
+	EXPECT_EQ(store.expire(testTime + 2 * maxAge), 1u);
+	EXPECT_EQ(store.size(), 0u);
+}
+
+TEST(AISStoreTest, Prune) {
+	VLOG(1) << "===AIS Store Test, Prune===";
+	AISContactStore store;
+	Location seattle SEATTLE;
+	sysclock now = system_clock::now();
+	double limit = Conf::get()->aisMaxDistance();
+	TwoVector near = TwoVector::getVectorDeg(45, limit / 2);
+	TwoVector far = TwoVector::getVectorDeg(45, limit * 2);
+	Location nearby = seattle.project(near);
+	Location distant = seattle.project(far);
+	store.upsert(makeShip(1, nearby.lat, nearby.lon, now));
+	store.upsert(makeShip(2, distant.lat, distant.lon, now));
+	store.upsert(makeShip(3, nearby.lat, nearby.lon, now - Conf::get()->aisMaxTime() - 10s));
+	store.upsert(makeShip(4, NAN, NAN, now));
+	EXPECT_EQ(store.prune(Location(), now), 2u);		// too old and no position
+	EXPECT_EQ(store.size(), 2u);
+	EXPECT_EQ(store.prune(seattle, now), 1u);
+	EXPECT_NE(store.find(1), (AISShip*)NULL);
+	EXPECT_EQ(store.find(2), (AISShip*)NULL);
+}
+
+TEST(AISStoreTest, DISABLED_Benchmark) {
+	VLOG(1) << "===AIS Store Test, Benchmark===";
+	std::mt19937 rng(23);
+	std::uniform_real_distribution<double> offset(-0.25, 0.25);
+	AISContactStore store;
+	Location seattle SEATTLE;
+	auto start = steady_clock::now();
+	fillLane(store, seattle, LANE_CONTACTS, rng);
+	auto insertTime = steady_clock::now() - start;
+	ASSERT_EQ(store.size(), (size_t)LANE_CONTACTS);
+
+	// every contact reports a new position
+	start = steady_clock::now();
+	for (int i = 0; i < LANE_CONTACTS; i++) {
+		store.upsert(makeShip(100000 + i, seattle.lat + offset(rng), seattle.lon + offset(rng), testTime + 1s));
+	}
+	auto updateTime = steady_clock::now() - start;
+
+	std::vector<AISShip*> found;
+	size_t total = 0;
+	start = steady_clock::now();
+	for (int i = 0; i < BENCHMARK_QUERIES; i++) {
+		total += store.within(Location(seattle.lat + offset(rng), seattle.lon + offset(rng)), 5000, found);
+	}
+	auto queryTime = steady_clock::now() - start;
+	size_t scanned = 0;
+	start = steady_clock::now();
+	for (int i = 0; i < (BENCHMARK_QUERIES / 10); i++) {
+		Location center(seattle.lat + offset(rng), seattle.lon + offset(rng));
+		store.forEach([&] (AISShip& ship) {
+			if (center.distance(ship.fix, CourseTypeEnum::Approximate) <= 5000) scanned++;
+		});
+	}
+	auto scanTime = (steady_clock::now() - start) * 10;
+	EXPECT_GT(total, 0u);
+	EXPECT_GT(scanned, 0u);
+
+	start = steady_clock::now();
+	EXPECT_EQ(store.expire(testTime + Conf::get()->aisMaxTime() + 10s), (size_t)LANE_CONTACTS);
+	auto expireTime = steady_clock::now() - start;
+
+	LOG(INFO) << "AIS store with " << LANE_CONTACTS << " contacts: insert " << duration_cast<nanoseconds>(insertTime).count() / LANE_CONTACTS
+			  << " ns, update " << duration_cast<nanoseconds>(updateTime).count() / LANE_CONTACTS << " ns per contact";
+	LOG(INFO) << "AIS store 5 km query: " << duration_cast<nanoseconds>(queryTime).count() / (1000.0 * BENCHMARK_QUERIES)
+			  << " us indexed, " << duration_cast<nanoseconds>(scanTime).count() / (1000.0 * BENCHMARK_QUERIES)
+			  << " us scanning every contact; expiring all of them took " << duration_cast<microseconds>(expireTime).count() << " us";
+}
@@ -0,0 +1,281 @@
+#include <stdexcept>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cmath>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "aivdm.hpp"
+#include "ais.hpp"
+#include "aisStore.hpp"
+#include "location.hpp"
+#include "test_utilities.hpp"
+#include "easylogging++.h"
+
+#define BENCHMARK_PASSES (20000)
+
+using namespace std::chrono;
+
+static const sysclock testTime = sysclock(seconds(1491770827));
+
+// Example sentences from the AIVDM/AIVDO protocol decoding, and a few more made to cover the other message types
+static const char *posnA = "!AIVDM,1,1,,B,177KQJ5000G?tO`K>RA1wUbN0TKH,0*5C";
+static const char *posnA3 = "!AIVDM,1,1,,B,15M67FC000G?ufbE`FepT@3n00Sa,0*5C";
+static const char *staticA1 = "!AIVDM,2,1,1,A,55?MbV02;H;s<HtKR20EHE:0@T4@Dn2222222216L961O5Gf0NSQEp6ClRp8,0*1C";
+static const char *staticA2 = "!AIVDM,2,2,1,A,88888888880,2*25";
+static const char *posnB = "!AIVDM,1,1,,B,B52K>;h0Nuks:06kj`2>=i?00000,0*5F";
+static const char *staticB0 = "!AIVDM,1,1,,B,H52K>;i<D60@tL0000000000000,2*79";
+static const char *staticB1 = "!AIVDM,1,1,,B,H52K>;lU1230000G43ijkl104210,0*6F";
+static const char *ownPosn = "!AIVDO,1,1,,A,15Mwqh@s1Eo?jO0K>k43Q2nD0000,0*51";
+static const char *noPosn = "!AIVDM,1,1,,A,35MwqhQP?w<tSF0l4Q@>4?wp0000,0*5C";
+static const char *fullPosn = "!AIVDM,1,1,,A,15MwqhP50jG?d`0K?:P3Q2op0000,0*23";		// the same contact as noPosn, with everything filled in
+static const char *fastPosn = "!AIVDM,1,1,,A,15MwqhgOwwG?d`0K?:P>4?wp0000,0*49";		// and again turning fast, with no status or motion
+static const char *fullName = "!AIVDM,1,1,,A,H5MwqhQADL8t5@00000000000000,0*59";		// and its name
+
+static AIVDMResult feed (AIVDMDecoder& decoder, const char *sentence, AISShip& ship) {
+	return decoder.decode(sentence, strlen(sentence), testTime, ship);
+}
+
+TEST(AIVDMTest, PositionReports) {
+	VLOG(1) << "===AIVDM Test, Position Reports===";
+	AIVDMDecoder decoder;
+	AISShip ship;
+	ASSERT_EQ(feed(decoder, posnA, ship), AIVDMResult::DECODED);
+	EXPECT_EQ(decoder.lastType(), AISMsgType::POSN_REPORT_A1);
+	EXPECT_FALSE(decoder.lastOwn());
+	EXPECT_EQ(ship.mmsi, 477553000);
+	EXPECT_EQ(ship.status, AISNavStatus::MOORED);
+	EXPECT_NEAR(ship.fix.lat, 47.582833, 0.000001);
+	EXPECT_NEAR(ship.fix.lon, -122.345833, 0.000001);
+	EXPECT_EQ(ship.speed, 0);
+	EXPECT_EQ(ship.course, 51);
+	EXPECT_EQ(ship.heading, 181);
+	EXPECT_EQ(ship.turn, 0);
+	EXPECT_EQ(ship.lastTimeStamp, testTime);
+
+	ASSERT_EQ(feed(decoder, posnA3, ship), AIVDMResult::DECODED);
+	EXPECT_EQ(ship.mmsi, 366053209);
+	EXPECT_EQ(ship.status, AISNavStatus::RESTRICTED_MANEUVER);
+	EXPECT_NEAR(ship.fix.lat, 37.802118, 0.000001);
+	EXPECT_NEAR(ship.fix.lon, -122.341618, 0.000001);
+	EXPECT_NEAR(ship.course, 219.3, 0.01);
+
+	ASSERT_EQ(feed(decoder, posnB, ship), AIVDMResult::DECODED);
+	EXPECT_EQ(decoder.lastType(), AISMsgType::POSN_REPORT_B);
+	EXPECT_EQ(ship.mmsi, 338087471);
+	EXPECT_NEAR(ship.fix.lat, 47.6, 0.000001);
+	EXPECT_NEAR(ship.fix.lon, -122.4, 0.000001);
+	EXPECT_NEAR(ship.speed, 12.3, 0.01);
+	EXPECT_NEAR(ship.course, 227.5, 0.01);
+	EXPECT_EQ(ship.heading, 226);
+
+	// our own reports are marked, and the rate of turn is scaled back to degrees per minute
+	ASSERT_EQ(feed(decoder, ownPosn, ship), AIVDMResult::DECODED);
+	EXPECT_TRUE(decoder.lastOwn());
+	EXPECT_EQ(ship.mmsi, 367000001);
+	EXPECT_NEAR(ship.speed, 8.5, 0.01);
+	EXPECT_NEAR(ship.turn, -pow(20 / 4.733, 2), 0.01);
+
+	// unavailable values are left at the defaults
+	ASSERT_EQ(feed(decoder, noPosn, ship), AIVDMResult::DECODED);
+	EXPECT_EQ(decoder.lastType(), AISMsgType::POSN_REPORT_A3);
+	EXPECT_EQ(ship.mmsi, 367000002);
+	EXPECT_FALSE(ship.fix.isValid());
+	EXPECT_TRUE(std::isnan(ship.speed));
+	EXPECT_TRUE(std::isnan(ship.course));
+	EXPECT_TRUE(std::isnan(ship.heading));
+	EXPECT_TRUE(std::isnan(ship.turn));
+	EXPECT_EQ(decoder.messages(), 5u);
+	EXPECT_EQ(decoder.errors(), 0u);
+}
+
+TEST(AIVDMTest, StaticData) {
+	VLOG(1) << "===AIVDM Test, Static Data===";
+	AIVDMDecoder decoder;
+	AISShip ship;
+	EXPECT_EQ(feed(decoder, staticA1, ship), AIVDMResult::PENDING);
+	ASSERT_EQ(feed(decoder, staticA2, ship), AIVDMResult::DECODED);
+	EXPECT_EQ(decoder.lastType(), AISMsgType::STATIC_DATA_A);
+	EXPECT_EQ(ship.mmsi, 351759000);
+	EXPECT_EQ(ship.imo, 9134270);
+	EXPECT_EQ(ship.callsign, "3FOF8");
+	EXPECT_EQ(ship.shipname, "EVER DIADEM");
+	EXPECT_EQ(ship.shiptype, AISShipType::CARGO);
+	EXPECT_EQ(ship.to_bow, 225);
+	EXPECT_EQ(ship.to_stern, 70);
+	EXPECT_EQ(ship.to_port, 1);
+	EXPECT_EQ(ship.to_starboard, 31);
+	EXPECT_EQ(ship.epfd, AISEPFDType::GPS);
+	EXPECT_FALSE(ship.fix.isValid());
+
+	ASSERT_EQ(feed(decoder, staticB0, ship), AIVDMResult::DECODED);
+	EXPECT_EQ(decoder.lastType(), AISMsgType::STATIC_DATA_B);
+	EXPECT_EQ(ship.mmsi, 338087471);
+	EXPECT_EQ(ship.shipname, "SEA DOG");
+	ASSERT_EQ(feed(decoder, staticB1, ship), AIVDMResult::DECODED);
+	EXPECT_EQ(ship.shipname, "");
+	EXPECT_EQ(ship.callsign, "WDC1234");
+	EXPECT_EQ(ship.shiptype, AISShipType::PLEASURE);
+	EXPECT_EQ(ship.to_bow, 8);
+	EXPECT_EQ(ship.to_stern, 4);
+	EXPECT_EQ(ship.to_port, 2);
+	EXPECT_EQ(ship.to_starboard, 1);
+}
+
+TEST(AIVDMTest, Fragments) {
+	VLOG(1) << "===AIVDM Test, Fragments===";
+	AIVDMDecoder decoder;
+	AISShip ship;
+
+	// a single sentence message in the middle of a multipart one doesn't disturb it
+	EXPECT_EQ(feed(decoder, staticA1, ship), AIVDMResult::PENDING);
+	EXPECT_EQ(feed(decoder, posnA, ship), AIVDMResult::DECODED);
+	ASSERT_EQ(feed(decoder, staticA2, ship), AIVDMResult::DECODED);
+	EXPECT_EQ(ship.shipname, "EVER DIADEM");
+
+	// a second part with no first is dropped, as is the rest of a message that lost a part
+	EXPECT_EQ(feed(decoder, staticA2, ship), AIVDMResult::BAD_FORMAT);
+	EXPECT_EQ(feed(decoder, staticA1, ship), AIVDMResult::PENDING);
+	EXPECT_EQ(feed(decoder, staticA1, ship), AIVDMResult::PENDING);		// a repeated first part starts over
+	ASSERT_EQ(feed(decoder, staticA2, ship), AIVDMResult::DECODED);
+	EXPECT_EQ(ship.mmsi, 351759000);
+
+	// messages on the two channels are kept apart
+	std::string otherChannel = "!AIVDM,2,1,1,B,55?MbV02;H;s<HtKR20EHE:0@T4@Dn2222222216L961O5Gf0NSQEp6ClRp8,0*1F";
+	EXPECT_EQ(feed(decoder, staticA1, ship), AIVDMResult::PENDING);
+	EXPECT_EQ(feed(decoder, otherChannel.c_str(), ship), AIVDMResult::PENDING);
+	EXPECT_EQ(feed(decoder, staticA2, ship), AIVDMResult::DECODED);
+	EXPECT_EQ(feed(decoder, "!AIVDM,2,2,1,B,88888888880,2*26", ship), AIVDMResult::DECODED);
+	EXPECT_EQ(ship.callsign, "3FOF8");
+	EXPECT_EQ(decoder.errors(), 1u);
+}
+
+TEST(AIVDMTest, Errors) {
+	VLOG(1) << "===AIVDM Test, Errors===";
+	AIVDMDecoder decoder;
+	AISShip ship;
+	EXPECT_TRUE(AIVDMDecoder::checksum(posnA, strlen(posnA)));
+	EXPECT_EQ(feed(decoder, "!AIVDM,1,1,,B,177KQJ5000G?tO`K>RA1wUbN0TKH,0*5D", ship), AIVDMResult::BAD_CHECKSUM);
+	EXPECT_EQ(feed(decoder, "!AIVDM,1,1,,B,177KQJ5000G?tO`K>RA1wUbN0TKH,0", ship), AIVDMResult::BAD_CHECKSUM);
+	EXPECT_EQ(feed(decoder, "!AIVDM,1,1,,B,177KQJ5000G?tO`K>RA1wUbN0TKI,0*5D", ship), AIVDMResult::DECODED);	// the last character changed, with a checksum to match
+	EXPECT_EQ(feed(decoder, "!AIVDM,1,1,,B,177KQJ5000G?tO`K>RA1wUbN0TK,0*14", ship), AIVDMResult::BAD_FORMAT);	// too short for a position report
+	EXPECT_EQ(feed(decoder, "!AIVDM,1,1,,B,177KQJ5000G?tO`K>RA1wUbN0TKX,0*4C", ship), AIVDMResult::BAD_FORMAT);	// not an armoring character
+	EXPECT_EQ(feed(decoder, "!AIVDM,1,1,B,177KQJ5000G?tO`K>RA1wUbN0TKH,0*70", ship), AIVDMResult::BAD_FORMAT);	// a field short
+	EXPECT_EQ(decoder.errors(), 5u);
+
+	// other sentences and message types are passed over without counting as errors
+	EXPECT_EQ(feed(decoder, "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47", ship), AIVDMResult::IGNORED);
+	EXPECT_EQ(feed(decoder, "!AIVDM,1,1,,A,403OviQuMGCqWrRO9>E6fE700@GO,0*4D", ship), AIVDMResult::IGNORED);	// base station report
+	EXPECT_EQ(decoder.errors(), 5u);
+
+	// a tag block and line ending are skipped
+	EXPECT_EQ(feed(decoder, "\\s:2573135,c:1671620143*0A\\!AIVDM,1,1,,B,177KQJ5000G?tO`K>RA1wUbN0TKH,0*5C\r\n", ship), AIVDMResult::DECODED);
+	EXPECT_EQ(ship.mmsi, 477553000);
+}
+
+TEST(AIVDMTest, Store) {
+	VLOG(1) << "===AIVDM Test, Store===";
+	AIVDMDecoder decoder;
+	AISContactStore store;
+	ASSERT_EQ(decoder.decode(posnB, strlen(posnB), testTime, store), AIVDMResult::DECODED);
+	AISShip *ship = store.find(338087471);
+	ASSERT_NE(ship, (AISShip*)NULL);
+	EXPECT_EQ(decoder.lastShip(), ship);
+	EXPECT_NEAR(ship->fix.lat, 47.6, 0.000001);
+	EXPECT_EQ(ship->lastTimeStamp, testTime);
+
+	// static data lands in the same contact, and leaves the position and its time stamp alone
+	EXPECT_EQ(decoder.decode(staticB0, strlen(staticB0), testTime + 10s, store), AIVDMResult::DECODED);
+	EXPECT_EQ(decoder.decode(staticB1, strlen(staticB1), testTime + 10s, store), AIVDMResult::DECODED);
+	EXPECT_EQ(store.size(), 1u);
+	EXPECT_EQ(store.find(338087471), ship);
+	EXPECT_EQ(ship->shipname, "SEA DOG");
+	EXPECT_EQ(ship->callsign, "WDC1234");
+	EXPECT_EQ(ship->shiptype, AISShipType::PLEASURE);
+	EXPECT_NEAR(ship->speed, 12.3, 0.01);
+	EXPECT_NEAR(ship->fix.lat, 47.6, 0.000001);
+	EXPECT_EQ(ship->lastTimeStamp, testTime);
+	EXPECT_EQ(store.find("SEA DOG"), ship);
+
+	// a new contact is stamped when it's first heard, but after that only a position moves the time stamp
+	ASSERT_EQ(decoder.decode(noPosn, strlen(noPosn), testTime, store), AIVDMResult::DECODED);
+	EXPECT_EQ(decoder.decode(noPosn, strlen(noPosn), testTime + 1s, store), AIVDMResult::DECODED);
+	EXPECT_EQ(store.find(367000002)->lastTimeStamp, testTime);
+
+	// our own reports stay out of the store
+	ASSERT_EQ(decoder.decode(ownPosn, strlen(ownPosn), testTime, store), AIVDMResult::DECODED);
+	EXPECT_TRUE(decoder.lastOwn());
+	EXPECT_EQ(decoder.lastShip()->mmsi, 367000001);
+	EXPECT_EQ(store.find(367000001), (AISShip*)NULL);
+	EXPECT_EQ(store.size(), 2u);
+
+	// once every contact is in the store, further reports are written in place without allocating
+	std::vector<std::string> traffic = {posnA, posnA3, staticA1, staticA2, posnB, staticB0, staticB1, noPosn, ownPosn};
+	for (auto& s : traffic) decoder.decode(s.data(), s.length(), testTime, store);
+	EXPECT_NO_ALLOCATIONS(for (auto& s : traffic) decoder.decode(s.data(), s.length(), testTime + 1s, store));
+	EXPECT_EQ(store.size(), 5u);
+	EXPECT_EQ(store.find("EVER DIADEM")->imo, 9134270);
+	EXPECT_EQ(store.find(477553000)->lastTimeStamp, testTime + 1s);
+	EXPECT_EQ(decoder.errors(), 0u);
+}
+
+TEST(AIVDMTest, Unavailable) {
+	VLOG(1) << "===AIVDM Test, Unavailable===";
+	AIVDMDecoder decoder;
+	AISContactStore store;
+	ASSERT_EQ(decoder.decode(fullPosn, strlen(fullPosn), testTime, store), AIVDMResult::DECODED);
+	AISShip *ship = store.find(367000002);
+	ASSERT_NE(ship, (AISShip*)NULL);
+	EXPECT_EQ(ship->status, AISNavStatus::ENGINE);
+	EXPECT_NEAR(ship->speed, 5.0, 0.01);
+	EXPECT_NEAR(ship->course, 90.0, 0.01);
+	EXPECT_EQ(ship->heading, 91);
+	EXPECT_NEAR(ship->turn, pow(20 / 4.733, 2), 0.01);
+
+	// static data leaves the motion alone...
+	ASSERT_EQ(decoder.decode(fullName, strlen(fullName), testTime, store), AIVDMResult::DECODED);
+	EXPECT_EQ(ship->shipname, "TUGBOAT");
+	EXPECT_NEAR(ship->speed, 5.0, 0.01);
+	EXPECT_EQ(ship->status, AISNavStatus::ENGINE);
+
+	// ...but a position report without it clears the old values, keeping the last known position
+	ASSERT_EQ(decoder.decode(noPosn, strlen(noPosn), testTime + 1s, store), AIVDMResult::DECODED);
+	EXPECT_EQ(store.find(367000002), ship);
+	EXPECT_EQ(ship->status, AISNavStatus::ANCHORED);
+	EXPECT_TRUE(std::isnan(ship->speed));
+	EXPECT_TRUE(std::isnan(ship->course));
+	EXPECT_TRUE(std::isnan(ship->heading));
+	EXPECT_TRUE(std::isnan(ship->turn));
+	EXPECT_NEAR(ship->fix.lat, 47.6, 0.000001);
+	EXPECT_EQ(ship->lastTimeStamp, testTime);
+
+	// an undefined status is kept as such, and a fast turn has no rate to give
+	ASSERT_EQ(decoder.decode(fullPosn, strlen(fullPosn), testTime + 2s, store), AIVDMResult::DECODED);
+	ASSERT_EQ(decoder.decode(fastPosn, strlen(fastPosn), testTime + 3s, store), AIVDMResult::DECODED);
+	EXPECT_EQ(ship->status, AISNavStatus::UNDEFINED);
+	EXPECT_TRUE(std::isnan(ship->speed));
+	EXPECT_TRUE(std::isnan(ship->turn));
+	EXPECT_EQ(ship->lastTimeStamp, testTime + 3s);
+	EXPECT_EQ(decoder.errors(), 0u);
+}
+
+TEST(AIVDMTest, DISABLED_Benchmark) {
+	VLOG(1) << "===AIVDM Test, Benchmark===";
+	std::vector<std::string> traffic = {posnA, posnA3, staticA1, staticA2, posnB, staticB0, staticB1, noPosn};
+	AIVDMDecoder decoder;
+	AISShip ship;
+	size_t decoded = 0;
+	auto start = steady_clock::now();
+	for (int i = 0; i < BENCHMARK_PASSES; i++) {
+		for (auto& s : traffic) {
+			if (decoder.decode(s.data(), s.length(), testTime, ship) == AIVDMResult::DECODED) decoded++;
+		}
+	}
+	auto elapsed = steady_clock::now() - start;
+	EXPECT_EQ(decoded, (size_t)BENCHMARK_PASSES * (traffic.size() - 1));
+	EXPECT_EQ(decoder.errors(), 0u);
+
+	double seconds = duration_cast<nanoseconds>(elapsed).count() / 1e9;
+	LOG(INFO) << "AIVDM decoding: " << (decoder.sentences() / seconds) << " sentences/s, "
+			  << (duration_cast<nanoseconds>(elapsed).count() / (double)decoder.sentences()) << " ns per sentence";
+}
@@ -9,6 +9,7 @@
 #include "hal/halTestHarness.hpp"
 #include "easylogging++.h"
 #include "configuration.hpp"
+#include "util.hpp"
 
 #define TOL 0.000001
 
@@ -630,4 +631,136 @@ TEST_F(BoatModeNavTest, Fault) {
 			<< " Last mode: " << me.boatModeNames.get(mode->getLastMode());
 	EXPECT_EQ(mode->getMode(), BoatModeEnum::FAULT);
 	EXPECT_EQ(mode->getLastMode(), BoatModeEnum::NAVIGATION);
-}
\ No newline at end of file
+}
+
+#define CYCLE_WARMUP	(10)		/**< Cycles to run before counting, so that every mode has started and every lookup table is filled */
+#define CYCLE_COUNT		(1000)		/**< Cycles to count allocations over; enough to pass every LOG_EVERY_N(100, ...) several times */
+
+class BoatModeCycleTest : public ::testing::Test {
+	public:
+		BoatModeCycleTest () {
+			me.health = &health;
+			health.setADCdevice(&adc);
+			me.rudder = &rudder;
+			me.throttle = &throttle;
+			me.rc = &rc;
+			me.adc = &adc;
+			me.gps = &gps;
+			me.orient = &orient;
+			me.relays = RelayMap::instance();
+			harness.simulate(&me.disarmInput);
+			harness.simulate(&me.armInput);
+			harness.simulate(&me.servoEnable);
+			harness.simulate(&rudder);
+			harness.simulate(&adc);
+			harness.simulate(&gps);
+			harness.simulate(me.relays);
+			rudder.attach(Conf::get()->rudderPort(), Conf::get()->rudderPin());
+			harness.accessADC(&adc, &adcraw, &adcvalid);
+			harness.accessRC(&rc, NULL, NULL, &rcfailsafe, &rcvalid, &rcchannels, NULL, NULL, NULL);
+			harness.accessGPSd(&gps, &fix, NULL);
+			harness.accessOrientation(&orient, &orientvalue, &orientvalid);
+			#ifdef DISTRIB_IMPLEMENTED
+				me.disarmInput.clear();
+				me.armInput.set();
+			#else
+				me.disarmInput.set();
+				me.armInput.clear();
+			#endif /*DISTRIB_IMPLEMENTED*/
+			fix->fixValid = true;
+			fix->speed = 1.0;
+			fix->track = 90.0;
+			fix->fix.lat = 48.0;
+			fix->fix.lon = -114.0;
+			*orientvalue = Orientation(0, 0, 45.0);
+			rcchannels->assign(Conf::get()->RCchannelCount(), Conf::get()->RClimits().at("middlePosn"));
+			(*adcraw)[Conf::get()->batmonName()] = 3000;
+			*adcvalid = true;
+			*rcvalid = true;
+			*rcfailsafe = false;
+			*orientvalid = true;
+			me.waypointList.loadKML("/home/debian/hackerboat/embedded_software/unified/test_data/waypoint/test_map_1.kml");
+			std::get<0>(me.K) = 1.0;
+			std::get<1>(me.K) = 0.0;
+			std::get<2>(me.K) = 0.0;
+		}
+
+		~BoatModeCycleTest () {
+			REMOVE(mode);
+		}
+
+		void cycle () {								/**< One pass of the master's control loop, less the logging */
+			me.lastFix.copy(me.gps->getFix());
+			me.health->readHealth();
+			BoatModeBase *oldmode = mode;
+			mode = mode->execute();
+			if (mode != oldmode) REMOVE(oldmode);
+			me.getCSV();
+		}
+
+		void cycles (int count) {
+			for (int i = 0; i < count; i++) cycle();
+		}
+
+		// Emitted log records are built on the heap by easylogging, and the debug level is on in the test
+		// configuration, so it's turned off while counting. Anything logged at INFO or above is still counted.
+		void countCycles (int count) {
+			el::Logger *logger = el::Loggers::getLogger("default");
+			el::Configurations saved = *logger->configurations();
+			el::Configurations quiet = saved;
+			quiet.set(el::Level::Debug, el::ConfigurationType::Enabled, "false");
+			el::Loggers::reconfigureLogger(logger, quiet);
+			EXPECT_NO_ALLOCATIONS(cycles(count));
+			el::Loggers::reconfigureLogger(logger, saved);
+		}
+
+		BoatState 			me;
+		BoatModeBase 		*mode = NULL;
+		HealthMonitor 		health;
+		Servo 				rudder;
+		Throttle 			throttle;
+		RCInput 			rc;
+		ADCInput 			adc;
+		GPSdInput 			gps;
+		OrientationInput 	orient;
+		HalTestHarness		harness;
+		bool 				*adcvalid;
+		bool				*rcvalid;
+		bool				*rcfailsafe;
+		bool				*orientvalid;
+		GPSFix				*fix;
+		Orientation			*orientvalue;
+		std::map<std::string, int> 	*adcraw;
+		std::vector<uint16_t>		*rcchannels;
+};
+
+TEST_F(BoatModeCycleTest, WaypointNoAllocations) {
+	VLOG(1) << "===Boat Mode Test, Cycle, Waypoint No Allocations===";
+	(*rcchannels)[Conf::get()->RCchannelMap().at("auto")] = Conf::get()->RClimits().at("min");
+	me.setNavMode(NavModeEnum::AUTONOMOUS);
+	me.setAutoMode(AutoModeEnum::WAYPOINT);
+	mode = BoatModeBase::factory(me, BoatModeEnum::NAVIGATION);
+	cycles(CYCLE_WARMUP);
+	ASSERT_EQ(mode->getMode(), BoatModeEnum::NAVIGATION);
+	ASSERT_EQ(me.getNavMode(), NavModeEnum::AUTONOMOUS);
+	ASSERT_EQ(me.getAutoMode(), AutoModeEnum::WAYPOINT);
+	countCycles(CYCLE_COUNT);
+	EXPECT_EQ(mode->getMode(), BoatModeEnum::NAVIGATION);
+	EXPECT_EQ(me.getAutoMode(), AutoModeEnum::WAYPOINT);
+	EXPECT_EQ(me.faultCount(), 0);
+}
+
+TEST_F(BoatModeCycleTest, RCCourseNoAllocations) {
+	VLOG(1) << "===Boat Mode Test, Cycle, RC Course No Allocations===";
+	(*rcchannels)[Conf::get()->RCchannelMap().at("auto")] = Conf::get()->RClimits().at("max");
+	(*rcchannels)[Conf::get()->RCchannelMap().at("mode")] = Conf::get()->RClimits().at("max");
+	me.setNavMode(NavModeEnum::RC);
+	mode = BoatModeBase::factory(me, BoatModeEnum::NAVIGATION);
+	cycles(CYCLE_WARMUP);
+	ASSERT_EQ(mode->getMode(), BoatModeEnum::NAVIGATION);
+	ASSERT_EQ(me.getNavMode(), NavModeEnum::RC);
+	ASSERT_EQ(rc.getMode(), RCModeEnum::COURSE);
+	countCycles(CYCLE_COUNT);
+	EXPECT_EQ(mode->getMode(), BoatModeEnum::NAVIGATION);
+	EXPECT_EQ(me.faultCount(), 0);
+}
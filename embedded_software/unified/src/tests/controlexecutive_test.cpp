@@ -0,0 +1,64 @@
+#include <stdexcept>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+#include "controlExecutive.hpp"
+#include "enumdefs.hpp"
+#include "test_utilities.hpp"
+#include "easylogging++.h"
+
+using namespace std::chrono;
+
+TEST(ControlExecutive, Pacing) {
+	VLOG(1) << "===Control Executive Pacing Test===";
+	ControlExecutive exec(10ms, OverrunPolicyEnum::SKIP);
+	ASSERT_TRUE(exec.begin());
+	auto start = steady_clock::now();
+	for (int i = 0; i < 20; i++) {
+		exec.wait();
+	}
+	auto elapsed = steady_clock::now() - start;
+	VLOG(2) << "20 cycles took " << duration_cast<milliseconds>(elapsed).count() << " ms; " << exec;
+	EXPECT_EQ(exec.cycles(), 20u);
+	EXPECT_GE(elapsed, 190ms);
+	EXPECT_LT(elapsed, 300ms);
+	EXPECT_GE(exec.maxJitter(), exec.meanJitter());
+}
+
+TEST(ControlExecutive, Skip) {
+	VLOG(1) << "===Control Executive Skip Test===";
+	ControlExecutive exec(10ms, OverrunPolicyEnum::SKIP);
+	ASSERT_TRUE(exec.begin());
+	exec.wait();
+	std::this_thread::sleep_for(35ms);
+	EXPECT_FALSE(exec.wait());
+	VLOG(2) << exec;
+	EXPECT_EQ(exec.cycles(), 2u);
+	EXPECT_EQ(exec.overruns(), 1u);
+	EXPECT_GE(exec.skipped(), 2u);
+	EXPECT_EQ(exec.caughtUp(), 0u);
+	EXPECT_GE(exec.lastExecTime(), 35ms);
+	exec.resetStats();
+	EXPECT_EQ(exec.cycles(), 0u);
+	EXPECT_EQ(exec.overruns(), 0u);
+	EXPECT_EQ(exec.maxExecTime(), 0ns);
+}
+
+TEST(ControlExecutive, CatchUp) {
+	VLOG(1) << "===Control Executive Catch-up Test===";
+	ControlExecutive exec(10ms, OverrunPolicyEnum::CATCHUP);
+	ASSERT_TRUE(exec.begin());
+	exec.wait();
+	std::this_thread::sleep_for(35ms);
+	EXPECT_FALSE(exec.wait());
+	EXPECT_TRUE(exec.timed());
+	auto start = steady_clock::now();
+	EXPECT_FALSE(exec.wait());			// owed cycles run immediately
+	EXPECT_FALSE(exec.timed());			// and have no wakeup jitter to record
+	EXPECT_FALSE(exec.wait());
+	EXPECT_LT(steady_clock::now() - start, 5ms);
+	VLOG(2) << exec;
+	EXPECT_EQ(exec.overruns(), 1u);
+	EXPECT_GE(exec.caughtUp(), 2u);
+	EXPECT_EQ(exec.skipped(), 0u);
+}
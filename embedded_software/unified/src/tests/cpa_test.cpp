@@ -0,0 +1,145 @@
+#include <stdexcept>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "cpa.hpp"
+#include "aisStore.hpp"
+#include "ais.hpp"
+#include "location.hpp"
+#include "twovector.hpp"
+#include "lanes.hpp"
+#include "configuration.hpp"
+#include "test_utilities.hpp"
+#include "easylogging++.h"
+
+#define SEATTLE {47.592597, -122.382938}
+#define KNOT (1852.0 / 3600.0)		// m/s
+#define CPA_DIST_TOL (1.0)			// Meters
+#define CPA_TIME_TOL (0.5)			// Seconds
+#define BENCHMARK_CONTACTS (1000)
+#define BENCHMARK_CYCLES (200)
+
+using namespace std::chrono;
+
+static const sysclock testTime = sysclock(seconds(1491770827));
+
+// A contact at the given bearing and distance from here
+static AISShip makeShip (int mmsi, Location& here, double bearing, double distance, double speed, double course, sysclock stamp = testTime) {
+	AISShip ship;
+	TwoVector offset = TwoVector::getVectorDeg(bearing, distance);
+	ship.mmsi = mmsi;
+	ship.fix = here.project(offset);
+	ship.speed = speed;
+	ship.course = course;
+	ship.lastTimeStamp = stamp;
+	return ship;
+}
+
+TEST(CPATest, Geometry) {
+	VLOG(1) << "===CPA Test, Geometry===";
+	Location seattle SEATTLE;
+	AISContactStore store;
+	CPAEngine engine;
+	store.upsert(makeShip(1, seattle, 0, 2000, 10, 180));		// head on
+	store.upsert(makeShip(2, seattle, 135, 1414.2136, 10, 0));	// crossing ahead, 1000 m to the east
+	store.upsert(makeShip(3, seattle, 270, 500, 10, 270));		// opening
+	store.upsert(makeShip(4, seattle, 45, 3000, NAN, NAN));		// stopped
+	AISShip lost;
+	lost.mmsi = 5;
+	store.upsert(lost);											// no position yet
+	store.upsert(makeShip(7, seattle, 180, 100, 10, 0, testTime - Conf::get()->aisMaxTime()));	// heard from too long ago
+
+	ASSERT_EQ(engine.assess(seattle, 0, 0, store, testTime, 10), 4u);
+	EXPECT_EQ(engine.assessed(), 4u);
+	auto& risks = engine.risks();
+	EXPECT_EQ(risks[0].mmsi, 1);
+	EXPECT_NEAR(risks[0].cpa, 0, CPA_DIST_TOL);
+	EXPECT_NEAR(risks[0].tcpa, 2000 / (10 * KNOT), CPA_TIME_TOL);
+	EXPECT_NEAR(risks[0].range, 2000, CPA_DIST_TOL);
+	EXPECT_NEAR(risks[0].bearing, 0, 0.1);
+	EXPECT_EQ(risks[1].mmsi, 3);
+	EXPECT_NEAR(risks[1].cpa, 500, CPA_DIST_TOL);
+	EXPECT_EQ(risks[1].tcpa, 0);
+	EXPECT_EQ(risks[2].mmsi, 2);
+	EXPECT_NEAR(risks[2].cpa, 1000, CPA_DIST_TOL);
+	EXPECT_NEAR(risks[2].tcpa, 1000 / (10 * KNOT), CPA_TIME_TOL);
+	TwoVector offset = risks[2].offset;
+	EXPECT_NEAR(offset.angleDeg(), 90, 0.1);
+	EXPECT_EQ(risks[3].mmsi, 4);
+	EXPECT_NEAR(risks[3].cpa, 3000, CPA_DIST_TOL);
+
+	// only the nearest are returned
+	ASSERT_EQ(engine.assess(seattle, 0, 0, store, testTime, 2), 2u);
+	EXPECT_EQ(engine.risks()[0].mmsi, 1);
+	EXPECT_EQ(engine.risks()[1].mmsi, 3);
+
+	// our own motion counts; running east at 5 m/s we run into the stopped contact's longitude
+	ASSERT_EQ(engine.assess(seattle, 5, 90, store, testTime, 10), 4u);
+	for (auto& r : engine.risks()) {
+		if (r.mmsi != 4) continue;
+		EXPECT_NEAR(r.cpa, 3000 * cos(M_PI / 4), CPA_DIST_TOL);
+		EXPECT_NEAR(r.tcpa, (3000 * sin(M_PI / 4)) / 5, CPA_TIME_TOL);
+	}
+
+	// contacts are dead reckoned from their last report
+	ASSERT_EQ(engine.assess(seattle, 0, 0, store, testTime + 60s, 1), 1u);
+	EXPECT_NEAR(engine.risks()[0].range, 2000 - (60 * 10 * KNOT), CPA_DIST_TOL);
+	EXPECT_NEAR(engine.risks()[0].tcpa, (2000 / (10 * KNOT)) - 60, CPA_TIME_TOL);
+
+	// an approach beyond the horizon counts as happening at the horizon
+	AISContactStore far;
+	far.upsert(makeShip(6, seattle, 0, 20000, 1, 180));
+	ASSERT_EQ(engine.assess(seattle, 0, 0, far, testTime, 1), 1u);
+	EXPECT_EQ(engine.risks()[0].tcpa, CPA_HORIZON);
+	EXPECT_NEAR(engine.risks()[0].cpa, 20000 - (CPA_HORIZON * KNOT), CPA_DIST_TOL);
+
+	EXPECT_EQ(engine.assess(Location(), 0, 0, store, testTime, 10), 0u);
+	EXPECT_TRUE(engine.risks().empty());
+}
+
+// Contacts scattered at random around the given center, as far out as 10 km
+static void scatter (AISContactStore& store, Location center, int count) {
+	std::mt19937 rng(31);
+	std::uniform_real_distribution<double> bearing(0, 360);
+	std::uniform_real_distribution<double> distance(100, 10000);
+	std::uniform_real_distribution<double> speed(0, 25);
+	for (int i = 0; i < count; i++) {
+		store.upsert(makeShip(1000 + i, center, bearing(rng), distance(rng), speed(rng), bearing(rng)));
+	}
+}
+
+// The ranges agree with measuring each contact separately, and the list is in order
+TEST(CPATest, ManyContacts) {
+	VLOG(1) << "===CPA Test, Many Contacts===";
+	Location seattle SEATTLE;
+	AISContactStore store;
+	CPAEngine engine;
+	scatter(store, seattle, BENCHMARK_CONTACTS);
+	ASSERT_EQ(engine.assess(seattle, 3, 45, store, testTime, 10), 10u);
+	EXPECT_EQ(engine.assessed(), (size_t)BENCHMARK_CONTACTS);
+	double last = 0;
+	for (auto& r : engine.risks()) {
+		EXPECT_NEAR(r.range, seattle.distance(r.fix, CourseTypeEnum::Approximate), CPA_DIST_TOL);
+		EXPECT_GE(r.cpa, last);
+		EXPECT_LE(r.cpa, r.range + CPA_DIST_TOL);
+		last = r.cpa;
+	}
+}
+
+TEST(CPATest, DISABLED_Benchmark) {
+	VLOG(1) << "===CPA Test, Benchmark===";
+	Location seattle SEATTLE;
+	AISContactStore store;
+	CPAEngine engine;
+	scatter(store, seattle, BENCHMARK_CONTACTS);
+	auto start = steady_clock::now();
+	for (int i = 0; i < BENCHMARK_CYCLES; i++) {
+		engine.assess(seattle, 3, 45, store, testTime + seconds(i), 10);
+	}
+	auto elapsed = steady_clock::now() - start;
+
+	LOG(INFO) << "CPA of " << BENCHMARK_CONTACTS << " contacts: " << duration_cast<nanoseconds>(elapsed).count() / (1000.0 * BENCHMARK_CYCLES)
+			  << " us per cycle with " << BATCH_LANES << " lanes";
+}
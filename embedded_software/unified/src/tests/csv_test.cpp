@@ -0,0 +1,149 @@
+#include <stdexcept>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <algorithm>
+#include <string>
+#include <stdio.h>
+#include <stdlib.h>
+#include "csvWriter.hpp"
+#include "boatState.hpp"
+#include "test_utilities.hpp"
+#include "easylogging++.h"
+
+#define ROUND_TRIP_CYCLES (100000)
+#define BENCHMARK_CYCLES (100000)
+
+using namespace std::chrono;
+
+static std::string format (double v, int precision) {
+	char buf[CSV_NUMBER_SIZE];
+	size_t len = formatDouble(v, precision, buf);
+	EXPECT_EQ(len, strlen(buf));
+	return std::string(buf, len);
+}
+
+TEST(CSVTest, Shortest) {
+	VLOG(1) << "===CSV Test, Shortest===";
+	std::mt19937_64 rng(20170409);
+	std::uniform_real_distribution<double> mantissa(-1.0, 1.0);
+	std::uniform_int_distribution<int> exponent(-30, 30);
+	for (int i = 0; i < ROUND_TRIP_CYCLES; i++) {
+		double v = ldexp(mantissa(rng), exponent(rng) * 3);
+		std::string s = format(v, CSV_SHORTEST);
+		EXPECT_EQ(strtod(s.c_str(), NULL), v) << s;
+		EXPECT_LE(s.size(), 25u);
+	}
+	EXPECT_EQ(strtod(format(47.6, CSV_SHORTEST).c_str(), NULL), 47.6);
+	EXPECT_LT(format(47.6, CSV_SHORTEST).size(), 6u);					// not 47.600000000000001
+	EXPECT_EQ(format(NAN, CSV_SHORTEST), "nan");
+	EXPECT_EQ(format(-INFINITY, 2), "-inf");
+}
+
+TEST(CSVTest, Precision) {
+	VLOG(1) << "===CSV Test, Precision===";
+	EXPECT_EQ(format(47.61234567891, 7), "47.6123457");
+	EXPECT_EQ(format(-122.3, 7), "-122.3000000");
+	EXPECT_EQ(format(92.456, 2), "92.46");
+	EXPECT_EQ(format(2.5, 0), "3");
+	EXPECT_EQ(format(-0.004, 2), "0.00");								// no negative zero
+	EXPECT_EQ(format(0.999, 2), "1.00");
+	EXPECT_EQ(format(1e300, 2).substr(0, 4), "1e30");					// too big for the fixed form
+	EXPECT_EQ(format(1.5, 20), "1.500000000");						// capped at CSV_MAX_PRECISION
+}
+
+TEST(CSVTest, Writer) {
+	VLOG(1) << "===CSV Test, Writer===";
+	char buf[64];
+	CSVWriter out(buf, sizeof(buf));
+	out.text("A").integer(-42).number(1.25, 1).text("x,y").text("say \"hi\"");
+	EXPECT_STREQ(out.line(), "A,-42,1.3,\"x,y\",\"say \"\"hi\"\"\"");
+	EXPECT_EQ(out.size(), strlen(buf));
+	EXPECT_FALSE(out.full());
+	out.clear();
+	out.time(sysclock(milliseconds(1491775304428)));
+	EXPECT_STREQ(out.line(), "2017-04-09 22:01:44.428");
+
+	char small[8];
+	CSVWriter tiny(small, sizeof(small));
+	tiny.text("abc").text("defgh").text("i");
+	EXPECT_TRUE(tiny.full());
+	EXPECT_STREQ(tiny.line(), "abc");									// whole fields only
+}
+
+TEST(CSVTest, Reader) {
+	VLOG(1) << "===CSV Test, Reader===";
+	char buf[64];
+	CSVWriter out(buf, sizeof(buf));
+	out.text("A").text("").text("x,y").text("say \"hi\"").integer(7);
+	const char *p = out.line();
+	const char *end = p + out.size();
+	std::vector<std::string> fields;
+	std::string field;
+	while (p < end) {
+		p = readCSVField(p, end, field);
+		fields.push_back(field);
+	}
+	ASSERT_EQ(fields.size(), 5u);
+	EXPECT_EQ(fields[0], "A");
+	EXPECT_EQ(fields[1], "");
+	EXPECT_EQ(fields[2], "x,y");
+	EXPECT_EQ(fields[3], "say \"hi\"");
+	EXPECT_EQ(fields[4], "7");
+}
+
+TEST(CSVTest, Headers) {
+	VLOG(1) << "===CSV Test, Headers===";
+	BoatState me;
+	std::string headers = me.getCSVheaders();
+	size_t columns = 0;
+	for (const CSVColumn<BoatState> *c = BoatState::csvColumns; c->header; c++) columns++;
+	EXPECT_EQ((size_t)std::count(headers.begin(), headers.end(), ','), columns - 1);
+	EXPECT_EQ(headers.substr(0, 20), "Record Time,Lat,Lon,");
+}
+
+TEST(CSVTest, NoAllocations) {
+	VLOG(1) << "===CSV Test, No Allocations===";
+	char buf[CSV_LINE_SIZE];
+	CSVWriter out(buf, sizeof(buf));
+	EXPECT_NO_ALLOCATIONS({
+		out.time(system_clock::now()).number(47.6123, 7).number(-122.3, CSV_SHORTEST).integer(1500).text("NAVIGATION");
+	});
+	EXPECT_FALSE(out.full());
+}
+
+TEST(CSVTest, DISABLED_Benchmark) {
+	VLOG(1) << "===CSV Test, Benchmark===";
+	char buf[CSV_NUMBER_SIZE];
+	size_t check = 0;
+
+	auto start = steady_clock::now();
+	for (int i = 0; i < BENCHMARK_CYCLES; i++) {
+		check += std::to_string(47.6 + (i * 0.0001)).size();
+	}
+	auto toStringTime = steady_clock::now() - start;
+	start = steady_clock::now();
+	for (int i = 0; i < BENCHMARK_CYCLES; i++) {
+		check += snprintf(buf, sizeof(buf), "%f", 47.6 + (i * 0.0001));
+	}
+	auto printfTime = steady_clock::now() - start;
+	start = steady_clock::now();
+	for (int i = 0; i < BENCHMARK_CYCLES; i++) {
+		check += formatDouble(47.6 + (i * 0.0001), 6, buf);
+	}
+	auto fixedTime = steady_clock::now() - start;
+	start = steady_clock::now();
+	for (int i = 0; i < BENCHMARK_CYCLES; i++) {
+		check += formatDouble(47.6 + (i * 0.0001), CSV_SHORTEST, buf);
+	}
+	auto shortestTime = steady_clock::now() - start;
+	EXPECT_GT(check, 0u);
+
+	double toStringNs = duration_cast<nanoseconds>(toStringTime).count() / (double)BENCHMARK_CYCLES;
+	double printfNs = duration_cast<nanoseconds>(printfTime).count() / (double)BENCHMARK_CYCLES;
+	double fixedNs = duration_cast<nanoseconds>(fixedTime).count() / (double)BENCHMARK_CYCLES;
+	double shortestNs = duration_cast<nanoseconds>(shortestTime).count() / (double)BENCHMARK_CYCLES;
+	LOG(INFO) << "Per number: std::to_string() " << toStringNs << " ns, snprintf() " << printfNs << " ns, fixed "
+			  << fixedNs << " ns, shortest " << shortestNs << " ns";
+}
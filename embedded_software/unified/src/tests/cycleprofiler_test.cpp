@@ -0,0 +1,69 @@
+#include <stdexcept>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+#include "cycleProfiler.hpp"
+#include "enumdefs.hpp"
+#include "test_utilities.hpp"
+#include "easylogging++.h"
+
+using namespace std::chrono;
+
+TEST(LatencyHistogram, Percentiles) {
+	VLOG(1) << "===Latency Histogram Percentiles Test===";
+	LatencyHistogram hist;
+	EXPECT_EQ(hist.count(), 0u);
+	EXPECT_EQ(hist.percentile(50.0), 0ns);
+	for (int i = 1; i <= 1000; i++) {
+		hist.record(microseconds(i));
+	}
+	VLOG(2) << hist;
+	EXPECT_EQ(hist.count(), 1000u);
+	EXPECT_EQ(hist.max(), 1000us);
+	EXPECT_TRUE(toleranceEquals(duration_cast<microseconds>(hist.mean()).count(), 500, 1));
+	// bucket resolution is 25%, and percentiles report the top of the bucket
+	EXPECT_GE(hist.percentile(50.0), 500us);
+	EXPECT_LE(hist.percentile(50.0), 625us);
+	EXPECT_GE(hist.percentile(99.0), 990us);
+	EXPECT_LE(hist.percentile(99.0), 1000us);
+	EXPECT_EQ(hist.percentile(100.0), 1000us);
+	hist.reset();
+	EXPECT_EQ(hist.count(), 0u);
+	EXPECT_EQ(hist.max(), 0ns);
+}
+
+TEST(LatencyHistogram, Extremes) {
+	VLOG(1) << "===Latency Histogram Extremes Test===";
+	LatencyHistogram hist;
+	hist.record(nanoseconds(-5));
+	hist.record(nanoseconds(200));
+	hist.record(hours(2));
+	EXPECT_EQ(hist.count(), 3u);
+	EXPECT_EQ(hist.max(), hours(2));
+	EXPECT_LE(hist.percentile(50.0), 1us);
+	EXPECT_EQ(hist.percentile(100.0), hours(2));
+}
+
+TEST(CycleProfiler, StageTimer) {
+	VLOG(1) << "===Cycle Profiler Stage Timer Test===";
+	CycleProfiler::get()->reset();
+	{
+		StageTimer t(CycleStageEnum::HEALTH);
+		std::this_thread::sleep_for(5ms);
+	}
+	LatencyHistogram& hist = CycleProfiler::get()->stage(CycleStageEnum::HEALTH);
+	EXPECT_EQ(hist.count(), 1u);
+	EXPECT_GE(hist.max(), 5ms);
+	EXPECT_EQ(CycleProfiler::get()->stage(CycleStageEnum::CYCLE).count(), 0u);
+	std::string stats = CycleProfiler::get()->report();
+	VLOG(2) << stats;
+	EXPECT_NE(stats.find("Health"), std::string::npos);
+	std::string reply;
+	EXPECT_FALSE(CycleProfiler::get()->takeReply(reply));
+	CycleProfiler::get()->postReply(stats);
+	EXPECT_TRUE(CycleProfiler::get()->takeReply(reply));
+	EXPECT_EQ(reply, stats);
+	EXPECT_FALSE(CycleProfiler::get()->takeReply(reply));
+	CycleProfiler::get()->reset();
+	EXPECT_EQ(hist.count(), 0u);
+}
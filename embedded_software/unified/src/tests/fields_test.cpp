@@ -0,0 +1,209 @@
+#include <stdexcept>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cmath>
+#include <string>
+#include "fields.hpp"
+#include "location.hpp"
+#include "orientation.hpp"
+#include "gps.hpp"
+#include "ais.hpp"
+#include "boatState.hpp"
+#include "enumdefs.hpp"
+#include "test_utilities.hpp"
+#include "rapidjson/rapidjson.h"
+#include "rapidjson/document.h"
+#include "easylogging++.h"
+
+#define TOL (0.000001)
+#define BENCHMARK_CYCLES (10000)
+
+using namespace rapidjson;
+using namespace std::chrono;
+
+TEST(FieldsTest, Location) {
+	VLOG(1) << "===Fields Test, Location===";
+	Location u {47.6, -122.3};
+	Location v;
+	std::string json = toJSON(u);
+	VLOG(2) << "Output JSON: " << json;
+	ASSERT_TRUE(v.readJSON(json.c_str()));
+	EXPECT_TRUE(toleranceEquals(u.lat, v.lat, TOL));
+	EXPECT_TRUE(toleranceEquals(u.lon, v.lon, TOL));
+	Location bad;
+	json = toJSON(bad);
+	EXPECT_EQ(json, "{\"lat\":null,\"lon\":null}");		// NaN is not json
+	v.lat = 1;
+	ASSERT_TRUE(v.readJSON(json.c_str()));
+	EXPECT_FALSE(std::isfinite(v.lat));
+}
+
+TEST(FieldsTest, Orientation) {
+	VLOG(1) << "===Fields Test, Orientation===";
+	Orientation o;
+	EXPECT_TRUE(o.readJSON("{\"pitch\":10,\"roll\":-5.5,\"heading\":370}"));
+	EXPECT_TRUE(toleranceEquals(o.pitch, 10, TOL));
+	EXPECT_TRUE(toleranceEquals(o.roll, -5.5, TOL));
+	EXPECT_TRUE(toleranceEquals(o.heading, 10, TOL));		// normalized, just like parse()
+}
+
+TEST(FieldsTest, GPSFix) {
+	VLOG(1) << "===Fields Test, GPSFix===";
+	GPSFix in = testFix();
+	GPSFix out;
+	std::string json = toJSON(in);
+	VLOG(2) << "Output JSON: " << json;
+	Document packed;
+	packed.Parse(json.c_str());
+	ASSERT_FALSE(packed.HasParseError());
+	EXPECT_TRUE(packed == in.pack());					// same document as the Value path
+	ASSERT_TRUE(out.readJSON(json.c_str()));
+	EXPECT_EQ(toJSON(out.pack()), toJSON(in.pack()));
+	EXPECT_EQ(out.mode, NMEAModeEnum::FIX3D);
+	EXPECT_EQ(out.device, in.device);
+}
+
+TEST(FieldsTest, AISShip) {
+	VLOG(1) << "===Fields Test, AIS Ship===";
+	AISShip in, out;
+	in.mmsi = 367001234;
+	in.recordTime = system_clock::now();
+	in.lastTimeStamp = in.recordTime;
+	in.fix = Location(47.61, -122.35);
+	in.status = AISNavStatus::ENGINE;
+	in.turn = 0;
+	in.speed = 8.5;
+	in.course = 270;
+	in.heading = 268;
+	in.imo = 9074729;
+	in.callsign = "WDC1234";
+	in.shipname = "TEST VESSEL";
+	in.shiptype = AISShipType::PASSENGER;
+	in.to_bow = 10;
+	in.to_stern = 40;
+	in.to_port = 5;
+	in.to_starboard = 5;
+	in.epfd = AISEPFDType::GPS;
+	std::string json = toJSON(in);
+	VLOG(2) << "Output JSON: " << json;
+	ASSERT_TRUE(out.readJSON(json.c_str()));
+	EXPECT_EQ(toJSON(out), json);
+	EXPECT_EQ(out.imo, 9074729);
+	EXPECT_EQ(out.shiptype, AISShipType::PASSENGER);
+}
+
+TEST(FieldsTest, BoatState) {
+	VLOG(1) << "===Fields Test, Boat State===";
+	BoatState in, out;
+	in.recordTime = system_clock::now();
+	in.lastContact = in.recordTime;
+	in.lastRC = in.recordTime;
+	in.lastFix = testFix();
+	in.launchPoint = Location(47.5, -122.4);
+	in.insertFault("Test fault");
+	in.setBoatMode(BoatModeEnum::NAVIGATION);
+	in.setNavMode(NavModeEnum::AUTONOMOUS);
+	in.setAutoMode(AutoModeEnum::WAYPOINT);
+	in.setRCmode(RCModeEnum::IDLE);
+	std::string json = toJSON(in);
+	VLOG(2) << "Output JSON: " << json;
+	EXPECT_EQ(toJSON(in.pack()), json);					// live readings included either way
+	ASSERT_TRUE(out.readJSON(json.c_str()));
+	EXPECT_EQ(toJSON(out), json);
+	EXPECT_EQ(out.getBoatMode(), BoatModeEnum::NAVIGATION);
+	EXPECT_EQ(out.getNavMode(), NavModeEnum::AUTONOMOUS);
+	EXPECT_EQ(out.getAutoMode(), AutoModeEnum::WAYPOINT);
+	EXPECT_TRUE(out.hasFault("Test fault"));
+	EXPECT_TRUE(toleranceEquals(out.lastFix.fix.lat, 47.6, TOL));
+}
+
+TEST(FieldsTest, GpsdPacket) {
+	VLOG(1) << "===Fields Test, gpsd Packet===";
+	const char *tpv = "{\"class\":\"TPV\",\"device\":\"/dev/ttyS4\",\"mode\":3,\"time\":\"2017-04-09T20:47:07.000Z\","
+					  "\"lat\":47.5925970,\"lon\":-122.3829380,\"track\":45.0,\"speed\":1.5}";
+	GPSFix fix, same;
+	ASSERT_TRUE(fix.readGpsdPacket(tpv));
+	EXPECT_EQ(fix.mode, NMEAModeEnum::FIX3D);
+	EXPECT_EQ(fix.device, "/dev/ttyS4");
+	EXPECT_TRUE(toleranceEquals(fix.fix.lat, 47.592597, TOL));
+	EXPECT_TRUE(toleranceEquals(fix.speed, 1.5, TOL));
+	Document d;
+	d.Parse(tpv);
+	ASSERT_TRUE(same.parseGpsdPacket(d));				// same table as the text path
+	same.recordTime = fix.recordTime;
+	EXPECT_EQ(toJSON(same), toJSON(fix));
+	// time, position and mode are required; a report without them leaves the position alone
+	EXPECT_FALSE(fix.readGpsdPacket("{\"class\":\"TPV\",\"mode\":2,\"time\":\"2017-04-09T20:47:08.000Z\",\"lon\":-100}"));
+	EXPECT_TRUE(toleranceEquals(fix.fix.lon, -122.382938, TOL));
+	EXPECT_FALSE(fix.readGpsdPacket("{\"class\":\"TPV\",\"mode\":7,\"time\":\"2017-04-09T20:47:08.000Z\",\"lat\":1,\"lon\":2}"));
+	EXPECT_EQ(fix.mode, NMEAModeEnum::NONE);
+	EXPECT_TRUE(toleranceEquals(fix.fix.lat, 47.592597, TOL));
+
+	AISShip ship;
+	ASSERT_TRUE(ship.readGpsdPacket("{\"class\":\"AIS\",\"type\":1,\"mmsi\":367001234,\"status\":0,\"speed\":8.5,"
+									"\"lon\":-122.35,\"lat\":47.61,\"course\":270,\"heading\":268}"));
+	EXPECT_EQ(ship.mmsi, 367001234);
+	EXPECT_TRUE(toleranceEquals(ship.fix.lon, -122.35, TOL));
+	EXPECT_TRUE(toleranceEquals(ship.course, 270, TOL));
+	AISShip nameOnly;
+	EXPECT_FALSE(nameOnly.readGpsdPacket("{\"class\":\"AIS\",\"type\":5,\"mmsi\":367001234,\"shipname\":\"TEST VESSEL\"}"));
+}
+
+TEST(FieldsTest, Reader) {
+	VLOG(1) << "===Fields Test, Reader===";
+	GPSFix fix;
+	// keys we don't know are passed over, however deep they go
+	EXPECT_TRUE(fix.readJSON("{\"class\":\"TPV\",\"sats\":[{\"prn\":1},[2,3]],\"extra\":{\"a\":{\"b\":1}},\"speed\":2.5}"));
+	EXPECT_TRUE(toleranceEquals(fix.speed, 2.5, TOL));
+	EXPECT_TRUE(fix.readJSON("{\"speed\":3}"));			// integers are fine for doubles
+	EXPECT_TRUE(toleranceEquals(fix.speed, 3, TOL));
+	EXPECT_FALSE(fix.readJSON("{\"speed\":\"fast\"}"));
+	EXPECT_FALSE(fix.readJSON("{\"mode\":\"Sideways\"}"));
+	EXPECT_FALSE(fix.readJSON("{\"fix\":47.5}"));
+	EXPECT_FALSE(fix.readJSON("{\"speed\":[1,2]}"));
+	EXPECT_FALSE(fix.readJSON("[1,2]"));
+	EXPECT_FALSE(fix.readJSON("{\"speed\":"));
+	AISShip ship;
+	EXPECT_FALSE(ship.readJSON("{\"mmsi\":1.5}"));
+	EXPECT_FALSE(ship.readJSON("{\"mmsi\":9999999999}"));	// doesn't fit in an int
+}
+
+TEST(FieldsTest, DISABLED_Benchmark) {
+	VLOG(1) << "===Fields Test, Benchmark===";
+	GPSFix fix = testFix();
+	GPSFix out;
+	std::string json = toJSON(fix);
+	size_t check = 0;
+
+	auto start = steady_clock::now();
+	for (int i = 0; i < BENCHMARK_CYCLES; i++) {
+		check += toJSON(fix.pack()).size();
+	}
+	auto packTime = steady_clock::now() - start;
+	start = steady_clock::now();
+	for (int i = 0; i < BENCHMARK_CYCLES; i++) {
+		check -= toJSON(fix).size();
+	}
+	auto writeTime = steady_clock::now() - start;
+	EXPECT_EQ(check, 0u);
+
+	start = steady_clock::now();
+	for (int i = 0; i < BENCHMARK_CYCLES; i++) {
+		Document d;
+		d.Parse(json.c_str());
+		EXPECT_TRUE(out.parse(d));
+	}
+	auto parseTime = steady_clock::now() - start;
+	start = steady_clock::now();
+	for (int i = 0; i < BENCHMARK_CYCLES; i++) {
+		EXPECT_TRUE(out.readJSON(json.c_str()));
+	}
+	auto readTime = steady_clock::now() - start;
+
+	double packUs = duration_cast<nanoseconds>(packTime).count() / (1000.0 * BENCHMARK_CYCLES);
+	double writeUs = duration_cast<nanoseconds>(writeTime).count() / (1000.0 * BENCHMARK_CYCLES);
+	double parseUs = duration_cast<nanoseconds>(parseTime).count() / (1000.0 * BENCHMARK_CYCLES);
+	double readUs = duration_cast<nanoseconds>(readTime).count() / (1000.0 * BENCHMARK_CYCLES);
+	LOG(INFO) << "GPSFix pack(): " << packUs << " us, writeJSON(): " << writeUs << " us, speedup " << (packUs / writeUs);
+	LOG(INFO) << "GPSFix parse(): " << parseUs << " us, readJSON(): " << readUs << " us, speedup " << (parseUs / readUs);
+}
@@ -0,0 +1,282 @@
+#include <stdexcept>
+#include <gtest/gtest.h>
+#include <string.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <chrono>
+#include <thread>
+#include <string>
+#include <vector>
+#include <set>
+#include "gpsdSim.hpp"
+#include "aivdm.hpp"
+#include "ais.hpp"
+#include "gps.hpp"
+#include "location.hpp"
+#include "configuration.hpp"
+#include "hal/gpsdInput.hpp"
+#include "test_utilities.hpp"
+#include "easylogging++.h"
+
+#define SEATTLE {47.592597, -122.382938}
+#define KNOT (1852.0 / 3600.0)		// m/s
+
+using namespace std;
+using namespace std::chrono;
+
+static const sysclock testTime = sysclock(seconds(1491770827));
+
+static vector<string> splitLines (const string& text) {
+	vector<string> lines;
+	size_t start = 0, end;
+	while ((end = text.find("\r\n", start)) != string::npos) {
+		lines.push_back(text.substr(start, end - start));
+		start = end + 2;
+	}
+	EXPECT_EQ(start, text.size());		// every line is terminated
+	return lines;
+}
+
+// Run the input by hand until done() or the time runs out
+template <typename F>
+static void pump (GPSdInput& gps, milliseconds limit, F done) {
+	auto end = steady_clock::now() + limit;
+	while (!done() && (steady_clock::now() < end)) {
+		gps.execute();
+		std::this_thread::sleep_for(5ms);
+	}
+}
+
+TEST(GPSdSimTest, Generator) {
+	VLOG(1) << "===GPSd Sim Test, Generator===";
+	GPSdSimConfig config;
+	config.tpvRate = 4;
+	config.contacts = 8;
+	config.contactRadius = 5000;
+	config.reportPeriod = 1;
+	config.staticPeriod = 1;
+	GPSdTrafficGenerator gen(config, testTime);
+	string json, nmea;
+	size_t made = gen.generate(testTime + 1s, json, nmea);
+	vector<string> fixes = splitLines(json);
+	vector<string> ais = splitLines(nmea);
+	EXPECT_EQ(made, fixes.size() + ais.size());
+	EXPECT_EQ(gen.lines(), made);
+	EXPECT_EQ(gen.damaged(), 0u);
+
+	// four a second, counting both ends, each stamped with when it was made
+	EXPECT_EQ(fixes.size(), 5u);
+	EXPECT_EQ(gen.fixes(), 5u);
+	Location seattle SEATTLE;
+	for (auto& line : fixes) {
+		GPSFix fix;
+		ASSERT_TRUE(fix.readGpsdPacket(line.c_str())) << line;
+		EXPECT_EQ(fix.gpsTime, testTime + 1s);
+		EXPECT_EQ(fix.mode, NMEAModeEnum::FIX3D);
+		EXPECT_NEAR(fix.fix.lat, seattle.lat, 1e-6);
+		EXPECT_NEAR(fix.fix.lon, seattle.lon, 1e-6);
+	}
+
+	// every contact reports and sends its static data, class A and class B alike
+	AIVDMDecoder decoder;
+	set<int> reported, named;
+	for (auto& line : ais) {
+		AISShip ship;
+		AIVDMResult r = decoder.decode(line.data(), line.size(), testTime, ship);
+		ASSERT_TRUE((r == AIVDMResult::DECODED) || (r == AIVDMResult::PENDING)) << line;
+		if (r != AIVDMResult::DECODED) continue;
+		EXPECT_GE(ship.mmsi, 366000000);
+		EXPECT_LT(ship.mmsi, 366000008);
+		if (ship.fix.isValid()) {
+			reported.insert(ship.mmsi);
+			EXPECT_LT(seattle.distance(ship.fix, CourseTypeEnum::Approximate), 5000 + (20 * KNOT) + 1);
+			EXPECT_GE(ship.speed, 0);
+			EXPECT_LE(ship.speed, 20.05);
+		}
+		if (ship.shipname != "") {
+			named.insert(ship.mmsi);
+			EXPECT_EQ(ship.shipname, "SIM " + to_string(ship.mmsi - 366000000));
+		}
+		if (ship.callsign != "") {
+			EXPECT_EQ(ship.callsign, "S" + to_string(ship.mmsi - 366000000));
+		}
+	}
+	EXPECT_EQ(reported.size(), 8u);
+	EXPECT_EQ(named.size(), 8u);
+	EXPECT_EQ(decoder.messages(), gen.aisMessages());
+	EXPECT_EQ(decoder.errors(), 0u);
+
+	// nothing more is due until time moves on
+	json.clear();
+	nmea.clear();
+	EXPECT_EQ(gen.generate(testTime + 1s, json, nmea), 0u);
+	EXPECT_TRUE(json.empty() && nmea.empty());
+}
+
+TEST(GPSdSimTest, Damage) {
+	VLOG(1) << "===GPSd Sim Test, Damage===";
+	GPSdSimConfig config;
+	config.tpvRate = 5;
+	config.contacts = 20;
+	config.reportPeriod = 2;
+	config.staticPeriod = 4;
+	config.errorRate = 0.1;
+	config.seed = 7;
+	GPSdTrafficGenerator gen(config, testTime);
+	AIVDMDecoder decoder;
+	uint64_t fixes = 0;
+	for (int i = 1; i <= 20; i++) {
+		string json, nmea;
+		gen.generate(testTime + seconds(i), json, nmea);
+		for (auto& line : splitLines(json)) {
+			GPSFix fix;
+			if (fix.readGpsdPacket(line.c_str())) fixes++;
+		}
+		for (auto& line : splitLines(nmea)) {
+			AISShip ship;
+			decoder.decode(line.data(), line.size(), testTime, ship);
+		}
+	}
+	EXPECT_GT(gen.damaged(), 0u);
+	EXPECT_LT(gen.damaged(), gen.lines() / 5);
+
+	// the intact counts are exactly what gets through
+	EXPECT_EQ(fixes, gen.fixes());
+	EXPECT_EQ(decoder.messages(), gen.aisMessages());
+	EXPECT_GT(decoder.errors(), 0u);
+}
+
+TEST(GPSdSimTest, Server) {
+	VLOG(1) << "===GPSd Sim Test, Server===";
+	GPSdSimConfig config;
+	config.tpvRate = 20;
+	config.contacts = 100;
+	config.reportPeriod = 1;
+	GPSdSimServer server(config);
+	ASSERT_TRUE(server.start(0));
+	ASSERT_GT(server.port(), 0);
+
+	int fd = socket(AF_INET, SOCK_STREAM, 0);
+	ASSERT_GE(fd, 0);
+	struct sockaddr_in addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	addr.sin_port = htons(server.port());
+	ASSERT_EQ(connect(fd, (struct sockaddr *)&addr, sizeof(addr)), 0);
+	const char *watch = "?WATCH={\"enable\":true,\"json\":true,\"nmea\":true};\n";
+	ASSERT_EQ(send(fd, watch, strlen(watch), 0), (ssize_t)strlen(watch));
+
+	string text;
+	char buf[4096];
+	auto end = steady_clock::now() + 500ms;
+	while (steady_clock::now() < end) {
+		struct pollfd pfd = {fd, POLLIN, 0};
+		if (poll(&pfd, 1, 50) <= 0) continue;
+		ssize_t r = recv(fd, buf, sizeof(buf), 0);
+		ASSERT_GT(r, 0);
+		text.append(buf, r);
+	}
+	close(fd);
+	text.erase(text.rfind("\r\n") + 2);			// a line may have been cut off
+
+	vector<string> lines = splitLines(text);
+	ASSERT_GT(lines.size(), 3u);
+	EXPECT_EQ(lines[0].find("{\"class\":\"VERSION\""), 0u);
+	EXPECT_EQ(lines[1].find("{\"class\":\"DEVICES\""), 0u);
+	EXPECT_EQ(lines[2].find("{\"class\":\"WATCH\",\"enable\":true,\"json\":true,\"nmea\":true"), 0u);
+	AIVDMDecoder decoder;
+	size_t fixes = 0;
+	for (size_t i = 3; i < lines.size(); i++) {
+		GPSFix fix;
+		AISShip ship;
+		if (lines[i][0] == '{') {
+			EXPECT_TRUE(fix.readGpsdPacket(lines[i].c_str())) << lines[i];
+			fixes++;
+		} else {
+			AIVDMResult r = decoder.decode(lines[i].data(), lines[i].size(), testTime, ship);
+			EXPECT_TRUE((r == AIVDMResult::DECODED) || (r == AIVDMResult::PENDING)) << lines[i];
+		}
+	}
+	EXPECT_GT(fixes, 5u);
+	EXPECT_GT(decoder.messages(), 20u);
+	EXPECT_GE(server.aisMessages(), decoder.messages());
+	EXPECT_GE(server.lines(), lines.size() - 3);
+	sysclock sent;
+	EXPECT_TRUE(server.aisSentAt(0, sent));
+	EXPECT_FALSE(server.aisSentAt(server.aisMessages(), sent));
+
+	// a second server can't have the same port
+	GPSdSimServer other(config);
+	EXPECT_FALSE(other.start(server.port()));
+	server.stop();
+	EXPECT_FALSE(server.isRunning());
+}
+
+TEST(GPSdSimTest, Input) {
+	VLOG(1) << "===GPSd Sim Test, Input===";
+	GPSdSimConfig config;
+	config.tpvRate = 20;
+	config.contacts = 20;
+	config.reportPeriod = 1;
+	config.staticPeriod = 1;
+	GPSdSimServer server(config);
+	ASSERT_TRUE(server.start(0));
+	int port = server.port();
+	GPSdInput gps("127.0.0.1", port);
+	ASSERT_TRUE(gps.connect());
+	EXPECT_GE(gps.getFD(), 0);
+	pump(gps, 500ms, [&gps] () {return gps.isConnected();});		// the connection is finished by execute()
+	EXPECT_TRUE(gps.isConnected());
+	EXPECT_FALSE(gps.isConnecting());
+
+	// everything sent is taken in, whole; reports are spread over a second, so wait for all of them
+	bool raw = Conf::get()->aisRawNMEA();
+	CPAReport report;
+	pump(gps, 1500ms, [&] () {
+		gps.getRisks(report);
+		return raw && (gps.getData()->size() == 20) && gps.getData("SIM 3") && (report.assessed == 20);
+	});
+	EXPECT_GT(gps.getFixSequence(), 5u);
+	EXPECT_GT(gps.getLines(), gps.getFixSequence());
+	EXPECT_EQ(gps.getParseErrors(), 0u);
+	Location seattle SEATTLE;
+	EXPECT_NEAR(gps.getFix().fix.lat, seattle.lat, 1e-6);
+	if (raw) {
+		EXPECT_EQ(gps.getData()->size(), 20u);
+		EXPECT_NE(gps.getData("SIM 3"), (AISShip*)NULL);
+		// the fixes come with an assessment of every contact, nearest approach first
+		EXPECT_EQ(report.assessed, 20u);
+		ASSERT_EQ(report.risks.size(), (size_t)CPA_REPORT_CONTACTS);
+		for (size_t i = 0; i < report.risks.size(); i++) {
+			EXPECT_NE(gps.getData(report.risks[i].mmsi), (AISShip*)NULL);
+			if (i > 0) EXPECT_GE(report.risks[i].cpa, report.risks[i - 1].cpa);
+		}
+	}
+
+	// when gpsd goes away, the input lets go of the socket, and picks up again once gpsd is back
+	server.stop();
+	pump(gps, 500ms, [&gps] () {return !gps.isConnected();});
+	EXPECT_FALSE(gps.isConnected());
+	EXPECT_EQ(gps.getFD(), -1);
+	GPSdSimServer again(config);
+	ASSERT_TRUE(again.start(port));
+	uint64_t fixes = gps.getFixSequence();
+	pump(gps, 2000ms, [&] () {return gps.getFixSequence() > fixes;});
+	EXPECT_TRUE(gps.isConnected());
+	EXPECT_GT(gps.getFixSequence(), fixes);
+	EXPECT_EQ(gps.getParseErrors(), 0u);
+
+	// pointed somewhere else, the next reconnection looks the new port up
+	GPSdSimServer moved(config);
+	ASSERT_TRUE(moved.start(0));
+	ASSERT_TRUE(gps.setPort(moved.port()));
+	again.stop();
+	fixes = gps.getFixSequence();
+	pump(gps, 2000ms, [&] () {return gps.getFixSequence() > fixes;});
+	EXPECT_TRUE(gps.isConnected());
+	EXPECT_GT(gps.getFixSequence(), fixes);
+}
@@ -0,0 +1,47 @@
+#include <stdexcept>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+#include <string>
+#include "heartbeat.hpp"
+#include "enumdefs.hpp"
+#include "test_utilities.hpp"
+#include "easylogging++.h"
+extern "C" {
+	#include <sys/mman.h>
+	#include <unistd.h>
+}
+
+using namespace std::chrono;
+
+TEST(Heartbeat, BeatAndCheck) {
+	VLOG(1) << "===Heartbeat Beat and Check Test===";
+	std::string name = "/hackerboat-heartbeat-test-" + std::to_string(getpid());
+	Heartbeat master(name);
+	Heartbeat watchdog(name);
+	ASSERT_TRUE(watchdog.open());		// the watchdog may come up before the master
+	ASSERT_TRUE(master.open());
+	EXPECT_EQ(watchdog.getPid(), 0);
+	EXPECT_EQ(watchdog.getMode(), BoatModeEnum::NONE);
+	EXPECT_TRUE(watchdog.check(50ms));
+	master.beat(BoatModeEnum::NAVIGATION);
+	EXPECT_EQ(watchdog.getCounter(), 1u);
+	EXPECT_EQ(watchdog.getMode(), BoatModeEnum::NAVIGATION);
+	EXPECT_EQ(watchdog.getPid(), getpid());
+	for (int i = 0; i < 5; i++) {
+		std::this_thread::sleep_for(20ms);
+		master.beat(BoatModeEnum::NAVIGATION);
+		EXPECT_TRUE(watchdog.check(50ms));
+	}
+	VLOG(2) << "Stopping the heartbeat";
+	std::this_thread::sleep_for(80ms);
+	EXPECT_FALSE(watchdog.check(50ms));
+	EXPECT_GE(watchdog.sinceLastBeat(), 80ms);
+	master.beat(BoatModeEnum::DISARMED);
+	EXPECT_TRUE(watchdog.check(50ms));
+	EXPECT_EQ(watchdog.getMode(), BoatModeEnum::DISARMED);
+	master.close();
+	watchdog.close();
+	EXPECT_FALSE(watchdog.isOpen());
+	shm_unlink(name.c_str());
+}
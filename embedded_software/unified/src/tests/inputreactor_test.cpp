@@ -0,0 +1,298 @@
+#include <stdexcept>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <cstring>
+#include "hal/inputThread.hpp"
+#include "hal/inputReactor.hpp"
+#include "enumdefs.hpp"
+#include "test_utilities.hpp"
+#include "easylogging++.h"
+extern "C" {
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <sys/socket.h>
+}
+
+using namespace std::chrono;
+
+class ReactorPipeInput : public InputThread {
+	public:
+		ReactorPipeInput () {
+			if (pipe2(fds, O_NONBLOCK) != 0) throw std::runtime_error("pipe2 failed");
+			setInputMode(InputModeEnum::REACTOR);
+			period = 1s;
+		}
+		~ReactorPipeInput () {
+			kill();
+			close(fds[0]);
+			close(fds[1]);
+		}
+		bool begin () {return launch();};
+		bool execute () {
+			char buf[64];
+			ssize_t len;
+			while ((len = read(fds[0], buf, sizeof(buf))) > 0) received += len;
+			return true;
+		}
+		int getFD () {return fds[0];};
+		void send (const char *msg) {
+			if (write(fds[1], msg, strlen(msg)) < 0) throw std::runtime_error("write failed");
+		}
+		std::atomic<int> received { 0 };
+		int fds[2];
+};
+
+class ReactorTimedInput : public InputThread {
+	public:
+		ReactorTimedInput () {
+			setInputMode(InputModeEnum::REACTOR);
+			period = 10ms;
+		}
+		bool begin () {return launch();};
+		bool execute () {
+			executions++;
+			return true;
+		}
+		std::atomic<int> executions { 0 };
+};
+
+// Hangs up when it reads an 'x', and opens a new pipe on the next execute(), as an input reconnecting would
+class ReactorReconnectInput : public InputThread {
+	public:
+		ReactorReconnectInput () {
+			open();
+			setInputMode(InputModeEnum::REACTOR);
+			period = 10ms;
+		}
+		~ReactorReconnectInput () {
+			kill();
+			shut();
+		}
+		bool begin () {return launch();};
+		bool execute () {
+			char buf[64];
+			ssize_t len;
+			if (rfd < 0) {
+				open();
+				return true;
+			}
+			while ((len = read(rfd, buf, sizeof(buf))) > 0) {
+				received += len;
+				if (memchr(buf, 'x', len)) {
+					shut();
+					break;
+				}
+			}
+			return true;
+		}
+		int getFD () {return rfd;};
+		void send (const char *msg) {
+			if (write(wfd, msg, strlen(msg)) < 0) throw std::runtime_error("write failed");
+		}
+		std::atomic<int> received { 0 };
+		std::atomic<int> opens { 0 };
+		std::atomic<int> rfd { -1 };
+		std::atomic<int> wfd { -1 };
+
+	private:
+		void open () {
+			int fds[2];
+			if (pipe2(fds, O_NONBLOCK) != 0) throw std::runtime_error("pipe2 failed");
+			wfd = fds[1];
+			rfd = fds[0];
+			opens++;
+		}
+		void shut () {
+			if (rfd >= 0) close(rfd);
+			if (wfd >= 0) close(wfd);
+			rfd = -1;
+			wfd = -1;
+		}
+};
+
+// Starts out connecting on one end of a socket pair, which is writable straight away, then reads from it as connected
+class ReactorConnectInput : public InputThread {
+	public:
+		ReactorConnectInput () {
+			if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds) != 0) throw std::runtime_error("socketpair failed");
+			setInputMode(InputModeEnum::REACTOR);
+			period = 1s;
+		}
+		~ReactorConnectInput () {
+			kill();
+			close(fds[0]);
+			close(fds[1]);
+		}
+		bool begin () {return launch();};
+		bool execute () {
+			char buf[64];
+			ssize_t len;
+			if (connecting) {
+				connecting = false;
+				connects++;
+				return true;
+			}
+			while ((len = read(fds[0], buf, sizeof(buf))) > 0) received += len;
+			return true;
+		}
+		int getFD () {return fds[0];};
+		bool isConnecting () {return connecting;};
+		void send (const char *msg) {
+			if (write(fds[1], msg, strlen(msg)) < 0) throw std::runtime_error("write failed");
+		}
+		std::atomic<int> received { 0 };
+		std::atomic<int> connects { 0 };
+		std::atomic_bool connecting { true };
+		int fds[2];
+};
+
+// Takes a long time over each execute(), and keeps count where it can be seen after it's gone
+static std::atomic<int> slowRuns { 0 };
+static std::atomic_bool slowInside { false };
+
+class ReactorSlowInput : public InputThread {
+	public:
+		ReactorSlowInput () {
+			setInputMode(InputModeEnum::REACTOR);
+			period = 10ms;
+		}
+		~ReactorSlowInput () {kill();};
+		bool begin () {return launch();};
+		bool execute () {
+			slowInside = true;
+			std::this_thread::sleep_for(50ms);
+			slowRuns++;
+			slowInside = false;
+			return true;
+		}
+};
+
+TEST(InputReactor, MixedSources) {
+	VLOG(1) << "===Input Reactor Mixed Sources Test===";
+	ReactorPipeInput piped;
+	ReactorTimedInput timed;
+	ASSERT_TRUE(piped.begin());
+	ASSERT_TRUE(timed.begin());
+	EXPECT_TRUE(InputReactor::get()->isRunning());
+	EXPECT_EQ(InputReactor::get()->getSourceCount(), 2);
+
+	// the timed input runs on its period
+	std::this_thread::sleep_for(105ms);
+	VLOG(2) << timed.executions << " timed executions, " << piped.getWakeups() << " piped wakeups";
+	EXPECT_GE(timed.executions, 8);
+	EXPECT_LE(timed.executions, 12);
+	EXPECT_EQ(piped.getWakeups(), 0u);				// no data and the event timeout has not passed
+
+	// the piped input runs when data arrives
+	auto start = steady_clock::now();
+	piped.send("abcdef");
+	while ((piped.received < 6) && ((steady_clock::now() - start) < 200ms)) {
+		std::this_thread::sleep_for(1ms);
+	}
+	EXPECT_EQ(piped.received, 6);
+	EXPECT_LT(steady_clock::now() - start, 50ms);
+
+	// killed inputs are dropped
+	timed.kill();
+	std::this_thread::sleep_for(30ms);
+	int executions = timed.executions;
+	EXPECT_EQ(InputReactor::get()->getSourceCount(), 1);
+	std::this_thread::sleep_for(30ms);
+	EXPECT_EQ(timed.executions, executions);
+
+	InputReactor::get()->stop();
+	EXPECT_FALSE(InputReactor::get()->isRunning());
+	EXPECT_FALSE(piped.isRunning());
+}
+
+TEST(InputReactor, Reconnect) {
+	VLOG(1) << "===Input Reactor Reconnect Test===";
+	ReactorReconnectInput input;
+	ASSERT_TRUE(input.begin());
+
+	// once it hangs up, it's run on its period until it has a descriptor again
+	input.send("x");
+	auto start = steady_clock::now();
+	while ((input.opens < 2) && ((steady_clock::now() - start) < 200ms)) {
+		std::this_thread::sleep_for(1ms);
+	}
+	ASSERT_EQ(input.opens, 2);
+
+	// and the new descriptor is watched, even though it most likely has the same number as the old one
+	start = steady_clock::now();
+	input.send("abc");
+	while ((input.received < 4) && ((steady_clock::now() - start) < 200ms)) {
+		std::this_thread::sleep_for(1ms);
+	}
+	EXPECT_EQ(input.received, 4);
+	EXPECT_LT(steady_clock::now() - start, 50ms);
+
+	input.kill();
+	InputReactor::get()->stop();
+	EXPECT_FALSE(InputReactor::get()->isRunning());
+}
+
+TEST(InputReactor, Connecting) {
+	VLOG(1) << "===Input Reactor Connecting Test===";
+	ReactorConnectInput input;
+	ASSERT_TRUE(input.begin());
+
+	// a connecting descriptor is run as soon as it's writable, rather than on the period
+	auto start = steady_clock::now();
+	while ((input.connects < 1) && ((steady_clock::now() - start) < 200ms)) {
+		std::this_thread::sleep_for(1ms);
+	}
+	EXPECT_EQ(input.connects, 1);
+	EXPECT_LT(steady_clock::now() - start, 50ms);
+
+	// after that the same descriptor is watched for input, and isn't run again just because it's still writable
+	std::this_thread::sleep_for(50ms);
+	EXPECT_EQ(input.getWakeups(), 1u);
+	start = steady_clock::now();
+	input.send("abc");
+	while ((input.received < 3) && ((steady_clock::now() - start) < 200ms)) {
+		std::this_thread::sleep_for(1ms);
+	}
+	EXPECT_EQ(input.received, 3);
+	EXPECT_LT(steady_clock::now() - start, 50ms);
+
+	input.kill();
+	InputReactor::get()->stop();
+	EXPECT_FALSE(InputReactor::get()->isRunning());
+}
+
+TEST(InputReactor, Remove) {
+	VLOG(1) << "===Input Reactor Remove Test===";
+	ReactorTimedInput timed;
+	ASSERT_TRUE(timed.begin());
+	{
+		ReactorSlowInput slow;
+		ASSERT_TRUE(slow.begin());
+		auto start = steady_clock::now();
+		while (!slowInside && ((steady_clock::now() - start) < 200ms)) {
+			std::this_thread::sleep_for(1ms);
+		}
+		ASSERT_TRUE(slowInside);
+
+		// the reactor's lock isn't held while an input executes
+		start = steady_clock::now();
+		EXPECT_EQ(InputReactor::get()->getSourceCount(), 2);
+		EXPECT_LT(steady_clock::now() - start, 20ms);
+	}
+
+	// destroying the input waited for it to finish, and it isn't run again
+	EXPECT_FALSE(slowInside);
+	int runs = slowRuns;
+	EXPECT_EQ(InputReactor::get()->getSourceCount(), 1);
+	int executions = timed.executions;
+	std::this_thread::sleep_for(100ms);
+	EXPECT_EQ(slowRuns, runs);
+	EXPECT_GT(timed.executions, executions);
+
+	timed.kill();
+	EXPECT_EQ(InputReactor::get()->getSourceCount(), 0);
+	InputReactor::get()->stop();
+	EXPECT_FALSE(InputReactor::get()->isRunning());
+}
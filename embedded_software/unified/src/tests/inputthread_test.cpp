@@ -0,0 +1,79 @@
+#include <stdexcept>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <cstring>
+#include "hal/inputThread.hpp"
+#include "enumdefs.hpp"
+#include "test_utilities.hpp"
+#include "easylogging++.h"
+extern "C" {
+	#include <fcntl.h>
+	#include <unistd.h>
+}
+
+using namespace std::chrono;
+
+class PipeInput : public InputThread {
+	public:
+		PipeInput (InputModeEnum mode, system_clock::duration readPeriod) {
+			if (pipe2(fds, O_NONBLOCK) != 0) throw std::runtime_error("pipe2 failed");
+			setInputMode(mode);
+			period = readPeriod;
+		}
+		~PipeInput () {
+			close(fds[0]);
+			close(fds[1]);
+		}
+		bool begin () {return true;};
+		bool execute () {
+			char buf[64];
+			ssize_t len;
+			while ((len = read(fds[0], buf, sizeof(buf))) > 0) {
+				received += len;
+				setLastInputTime();
+			}
+			return true;
+		}
+		int getFD () {return fds[0];};
+		void send (const char *msg) {
+			if (write(fds[1], msg, strlen(msg)) < 0) throw std::runtime_error("write failed");
+		}
+		std::atomic<int> received { 0 };
+		int fds[2];
+};
+
+TEST(InputThread, EventModeWakesOnData) {
+	VLOG(1) << "===Input Thread Event Mode Test===";
+	PipeInput input(InputModeEnum::EVENT, 1s);
+	std::thread runner { InputThread::InputThreadRunner(&input) };
+	std::this_thread::sleep_for(50ms);
+	EXPECT_LE(input.getWakeups(), 1u);			// nothing to read, so nothing to do
+	auto start = steady_clock::now();
+	input.send("hello, ");
+	input.send("world");
+	while ((input.received < 12) && ((steady_clock::now() - start) < 200ms)) {
+		std::this_thread::sleep_for(1ms);
+	}
+	auto latency = steady_clock::now() - start;
+	VLOG(2) << "Data consumed after " << duration_cast<microseconds>(latency).count() << " us, "
+			<< input.getWakeups() << " wakeups";
+	EXPECT_EQ(input.received, 12);
+	EXPECT_LT(latency, 50ms);					// much less than the period
+	input.kill();
+	input.send("!");							// wake the runner so it sees the kill
+	runner.join();
+}
+
+TEST(InputThread, PeriodicMode) {
+	VLOG(1) << "===Input Thread Periodic Mode Test===";
+	PipeInput input(InputModeEnum::PERIODIC, 10ms);
+	std::thread runner { InputThread::InputThreadRunner(&input) };
+	std::this_thread::sleep_for(105ms);
+	input.kill();
+	runner.join();
+	VLOG(2) << input.getWakeups() << " wakeups in 105ms";
+	EXPECT_GE(input.getWakeups(), 8u);
+	EXPECT_LE(input.getWakeups(), 13u);
+}
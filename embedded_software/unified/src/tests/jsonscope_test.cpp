@@ -0,0 +1,108 @@
+#include <stdexcept>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <fstream>
+#include "jsonScope.hpp"
+#include "location.hpp"
+#include "gps.hpp"
+#include "ais.hpp"
+#include "boatState.hpp"
+#include "enumdefs.hpp"
+#include "test_utilities.hpp"
+#include "rapidjson/rapidjson.h"
+#include "easylogging++.h"
+extern "C" {
+	#include <unistd.h>
+}
+
+#define SOAK_CYCLES (6000)			// ten minutes of 100 ms control cycles
+#define LONG_SOAK_CYCLES (108000)	// three hours, a whole mission
+#define SOAK_WARMUP (1000)
+#define SOAK_RSS_SLOP (1024 * 1024)	// bytes of resident growth allowed for the heap's own bookkeeping
+
+using namespace rapidjson;
+using namespace std::chrono;
+
+static size_t residentBytes () {
+	size_t total = 0, resident = 0;
+	std::ifstream statm("/proc/self/statm");
+	statm >> total >> resident;
+	return resident * sysconf(_SC_PAGESIZE);
+}
+
+TEST(JSONScopeTest, Nesting) {
+	VLOG(1) << "===JSON Scope Test, Nesting===";
+	Location loc {47.6, -122.3};
+	{
+		JSONScope outer;
+		Value v = loc.pack();
+		size_t used = JSONScope::used();
+		EXPECT_GT(used, 0u);
+		{
+			JSONScope inner;
+			Value w = loc.pack();
+		}
+		EXPECT_GT(JSONScope::used(), used);				// an inner scope doesn't free anything
+		EXPECT_TRUE(v.IsObject());
+	}
+	EXPECT_EQ(JSONScope::used(), 0u);
+}
+
+TEST(JSONScopeTest, Spill) {
+	VLOG(1) << "===JSON Scope Test, Spill===";
+	uint64_t spills = JSONScope::spills();
+	{
+		JSONScope scope;
+		EXPECT_NE(JSONScope::allocator().Malloc(JSON_ARENA_SIZE * 2), (void*)NULL);	// too big for the block, so it goes to the heap
+	}
+	EXPECT_EQ(JSONScope::spills(), spills + 1);
+	EXPECT_EQ(JSONScope::used(), 0u);
+	EXPECT_LE(JSONScope::allocator().Capacity(), (size_t)JSON_ARENA_SIZE);		// and the heap chunk was given back
+}
+
+static void soak (int cycles) {
+	BoatState me;
+	AISShip ship;
+	me.lastFix.recordTime = system_clock::now();
+	me.lastFix.fix = Location(47.6, -122.3);
+	me.lastFix.device = "/dev/ttyS4";
+	me.launchPoint = Location(47.5, -122.4);
+	me.insertFault("Soak");
+	ship.mmsi = 367001234;
+	ship.fix = Location(47.61, -122.35);
+	ship.shipname = "TEST VESSEL";
+	uint64_t spills = JSONScope::spills();
+	size_t before = 0;
+	size_t peak = 0;
+
+	for (int i = 0; i < cycles; i++) {
+		JSONScope scope;
+		std::ostringstream out;
+		me.recordTime = system_clock::now();
+		me.lastFix.speed = i * 0.001;
+		out << me.pack() << ship.pack() << me.lastFix.pack();
+		EXPECT_GT(out.str().size(), 0u);
+		if (JSONScope::used() > peak) peak = JSONScope::used();
+		if (i == SOAK_WARMUP) before = residentBytes();
+	}
+	size_t after = residentBytes();
+	LOG(INFO) << "Soak resident memory: " << before << " bytes after warmup, " << after << " bytes after "
+			  << cycles << " cycles, " << peak << " json bytes per cycle";
+	EXPECT_EQ(JSONScope::used(), 0u);
+	EXPECT_EQ(JSONScope::spills(), spills);
+	EXPECT_LE(peak, (size_t)JSON_ARENA_SIZE);
+	EXPECT_LT(after, before + SOAK_RSS_SLOP);
+}
+
+TEST(JSONScopeTest, Soak) {
+	VLOG(1) << "===JSON Scope Test, Soak===";
+	soak(SOAK_CYCLES);
+}
+
+// Run with --gtest_also_run_disabled_tests --gtest_filter=JSONScopeTest.DISABLED_LongSoak
+TEST(JSONScopeTest, DISABLED_LongSoak) {
+	VLOG(1) << "===JSON Scope Test, Long Soak===";
+	soak(LONG_SOAK_CYCLES);
+}
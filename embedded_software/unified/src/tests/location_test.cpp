@@ -2,17 +2,41 @@
 #include <gtest/gtest.h>
 #include "rapidjson/rapidjson.h"
 #include <cmath>
+#include <chrono>
+#include <vector>
 #include "location.hpp"
 #include "twovector.hpp"
 #include "test_utilities.hpp"
 #include "easylogging++.h"
 
 using namespace rapidjson;
+using namespace std::chrono;
 
 #define TOL (0.00001)	// Tolerance for floating point comparisons
 #define NMTOM (1852)
 #define JFK {(40 + (38/60)), -(73 + (47/60))}
 #define LAX {(33 + (57/60)), -(118 + (24/60))}
+#define SEATTLE {47.592597, -122.382938}
+#define APPROX_DIST_TOL (0.05)			// Meters; the approximation is within 3 cm of the great circle out to 10 km
+#define APPROX_BEARING_TOL (0.0002)		// Degrees
+#define BENCHMARK_CYCLES (100000)
+#define BATCH_DIST_TOL (0.01)			// Meters; the batch works in single precision
+#define BATCH_TARGETS (1000)
+
+// Check the approximation against the great circle in every direction, out to where it hands over
+static void checkApproximate (Location start) {
+	for (int azi = -180; azi < 180; azi += 15) {
+		for (double dist : {1.0, 50.0, 500.0, 5000.0, 9900.0}) {
+			TwoVector vec = TwoVector::getVectorDeg(azi, dist);
+			Location end = start.project(vec);
+			Location approx = start.project(vec, CourseTypeEnum::Approximate);
+			double bearingError = remainder(start.bearing(end, CourseTypeEnum::Approximate) - start.bearing(end), 360.0);
+			EXPECT_TRUE(toleranceEquals(start.distance(end, CourseTypeEnum::Approximate), dist, APPROX_DIST_TOL));
+			EXPECT_TRUE(toleranceEquals(bearingError, 0, APPROX_BEARING_TOL));
+			EXPECT_TRUE(toleranceEquals(approx.distance(end), 0, APPROX_DIST_TOL));
+		}
+	}
+}
 
 TEST (Location, Creation) {
 	VLOG(1) << "===Location Test, Creation===";
@@ -164,4 +188,130 @@ TEST (Location, RhumbLineProject) {
 	EXPECT_TRUE(toleranceEquals(loc.lat, 32.1341, 0.1));
 	EXPECT_TRUE(toleranceEquals(loc.lon, -74.0216, 0.1));
 	
-}
\ No newline at end of file
+}
+
+TEST (Location, ApproximateError) {
+	VLOG(1) << "===Location Test, Approximate Error===";
+	checkApproximate(Location SEATTLE);
+	checkApproximate(Location {0, 0});
+	checkApproximate(Location {-70, 100});
+	checkApproximate(Location {10, 179.99});			// across the antimeridian
+	Location east {10, 179.999};
+	Location west {10, -179.999};
+	EXPECT_TRUE(toleranceEquals(east.bearing(west, CourseTypeEnum::Approximate), east.bearing(west), APPROX_BEARING_TOL));
+	EXPECT_TRUE(toleranceEquals(east.distance(west, CourseTypeEnum::Approximate), east.distance(west), APPROX_DIST_TOL));
+}
+
+// Past the switch over distance, or near the poles, the approximation gives the great circle answers
+TEST (Location, ApproximateFallback) {
+	VLOG(1) << "===Location Test, Approximate Fallback===";
+	Location lax LAX;
+	Location jfk JFK;
+	EXPECT_EQ(lax.distance(jfk, CourseTypeEnum::Approximate), lax.distance(jfk));
+	EXPECT_EQ(lax.bearing(jfk, CourseTypeEnum::Approximate), lax.bearing(jfk));
+	EXPECT_EQ((int)round(lax.target(jfk, CourseTypeEnum::Approximate).angleDeg()), 66);
+	TwoVector vec = TwoVector::getVectorDeg(66, (100 * NMTOM));
+	Location loc = lax.project(vec, CourseTypeEnum::Approximate);
+	EXPECT_TRUE(toleranceEquals(loc.lat, 33.666, 0.01));
+	EXPECT_TRUE(toleranceEquals(loc.lon, -116.176, 0.01));
+	Location polar {85, 10};
+	Location nearby {85.01, 10.01};
+	EXPECT_EQ(polar.distance(nearby, CourseTypeEnum::Approximate), polar.distance(nearby));
+	Location bad;
+	EXPECT_TRUE(std::isnan(bad.distance(jfk, CourseTypeEnum::Approximate)));
+}
+
+TEST (Location, DISABLED_ApproximateBenchmark) {
+	VLOG(1) << "===Location Test, Approximate Benchmark===";
+	Location start SEATTLE;
+	Location end {47.6, -122.39};
+	double check = 0;
+
+	auto begin = steady_clock::now();
+	for (int i = 0; i < BENCHMARK_CYCLES; i++) {
+		end.lat += 0.0000001;
+		check += start.distance(end) + start.bearing(end);
+	}
+	auto geodesicTime = steady_clock::now() - begin;
+	begin = steady_clock::now();
+	for (int i = 0; i < BENCHMARK_CYCLES; i++) {
+		end.lat -= 0.0000001;
+		check += start.distance(end, CourseTypeEnum::Approximate) + start.bearing(end, CourseTypeEnum::Approximate);
+	}
+	auto approxTime = steady_clock::now() - begin;
+	EXPECT_TRUE(std::isfinite(check));
+
+	double geodesicNs = duration_cast<nanoseconds>(geodesicTime).count() / (double)BENCHMARK_CYCLES;
+	double approxNs = duration_cast<nanoseconds>(approxTime).count() / (double)BENCHMARK_CYCLES;
+	LOG(INFO) << "Distance and bearing: great circle " << geodesicNs << " ns, approximate " << approxNs << " ns";
+}
+// Batches give the same answers as one target at a time, including the ones they hand over to the great circle
+TEST (Location, Batch) {
+	VLOG(1) << "===Location Test, Batch===";
+	Location start SEATTLE;
+	std::vector<Location> dests;
+	for (int azi = -180; azi < 180; azi += 10) {
+		for (double dist : {0.0, 10.0, 900.0, 9000.0}) {
+			dests.push_back(start.project(TwoVector::getVectorDeg(azi, dist)));
+		}
+	}
+	dests.push_back(Location JFK);
+	dests.push_back(Location());
+	std::vector<double> lats, lons;
+	for (auto& d : dests) {
+		lats.push_back(d.lat);
+		lons.push_back(d.lon);
+	}
+	std::vector<double> dist(dests.size()), azi(dests.size());
+	EXPECT_EQ(start.targets(lats.data(), lons.data(), dests.size(), dist.data(), azi.data()), 2u);
+	for (size_t i = 0; i < (dests.size() - 1); i++) {
+		EXPECT_TRUE(toleranceEquals(dist[i], start.distance(dests[i], CourseTypeEnum::Approximate), BATCH_DIST_TOL));
+		if (dist[i] > 0) {
+			EXPECT_TRUE(toleranceEquals(remainder(azi[i] - start.bearing(dests[i], CourseTypeEnum::Approximate), 360.0), 0, APPROX_BEARING_TOL));
+		}
+	}
+	EXPECT_TRUE(std::isnan(dist.back()));
+	EXPECT_TRUE(std::isnan(azi.back()));
+
+	std::vector<double> exact(dests.size());
+	EXPECT_EQ(start.targets(dests, exact.data(), NULL, CourseTypeEnum::GreatCircle), dests.size());
+	for (size_t i = 0; i < (dests.size() - 1); i++) {
+		EXPECT_TRUE(toleranceEquals(exact[i], start.distance(dests[i]), TOL));
+	}
+	Location bad;
+	EXPECT_EQ(bad.targets(dests, dist.data()), dests.size());
+	EXPECT_TRUE(std::isnan(dist.front()));
+}
+
+TEST (Location, DISABLED_BatchBenchmark) {
+	VLOG(1) << "===Location Test, Batch Benchmark===";
+	Location start SEATTLE;
+	std::vector<double> lats, lons, dist(BATCH_TARGETS), azi(BATCH_TARGETS);
+	for (int i = 0; i < BATCH_TARGETS; i++) {
+		Location dest = start.project(TwoVector::getVectorDeg(i * 7, 10 + (i * 9)));
+		lats.push_back(dest.lat);
+		lons.push_back(dest.lon);
+	}
+	double check = 0;
+	int cycles = BENCHMARK_CYCLES / BATCH_TARGETS;
+
+	auto begin = steady_clock::now();
+	for (int i = 0; i < cycles; i++) {
+		for (int j = 0; j < BATCH_TARGETS; j++) {
+			Location dest {lats[j], lons[j]};
+			check += start.distance(dest, CourseTypeEnum::Approximate) + start.bearing(dest, CourseTypeEnum::Approximate);
+		}
+	}
+	auto singleTime = steady_clock::now() - begin;
+	begin = steady_clock::now();
+	for (int i = 0; i < cycles; i++) {
+		EXPECT_EQ(start.targets(lats.data(), lons.data(), BATCH_TARGETS, dist.data(), azi.data()), 0u);
+		check += dist[i] + azi[i];
+	}
+	auto batchTime = steady_clock::now() - begin;
+	EXPECT_TRUE(std::isfinite(check));
+
+	double singleNs = duration_cast<nanoseconds>(singleTime).count() / (double)BENCHMARK_CYCLES;
+	double batchNs = duration_cast<nanoseconds>(batchTime).count() / (double)BENCHMARK_CYCLES;
+	LOG(INFO) << "Distance and bearing per target: one at a time " << singleNs << " ns, batched " << batchNs << " ns";
+}
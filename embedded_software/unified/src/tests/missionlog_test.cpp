@@ -0,0 +1,253 @@
+#include <stdexcept>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <stdio.h>
+#include "missionLog.hpp"
+#include "csvWriter.hpp"
+#include "hackerboatRoot.hpp"
+#include "test_utilities.hpp"
+#include "easylogging++.h"
+extern "C" {
+	#include <unistd.h>
+}
+
+#define TEST_LINES (20000)
+#define BENCHMARK_QUERIES (1000)
+
+using namespace std::chrono;
+
+static const sysclock testStart = sysclock(seconds(1491770827));
+
+static std::string testPath (const char *suffix = ".log") {
+	return "/tmp/hackerboat-missionlog-test-" + std::to_string(getpid()) + suffix;
+}
+
+static void removeLog (const std::string& path) {
+	unlink(path.c_str());
+	unlink((path + MISSIONLOG_INDEX_SUFFIX).c_str());
+}
+
+// The old header, with the commented out columns, then lines at 100 ms intervals; halfway through, the
+// master restarts with the current header
+static void writeLog (const std::string& path, int from, int to, bool truncate = true) {
+	std::ofstream out(path, truncate ? std::ios::trunc : std::ios::app);
+	out.precision(10);
+	for (int i = from; i < to; i++) {
+		sysclock t = testStart + (i * 100ms);
+		std::string stamp = HackerboatState::packTime(t);
+		if (i == 0) {
+			out << "2017Apr09-20:46:22:419 | INFO  | Creating new RCInput object\n";
+			out << "2017Apr09-20:46:30:688 | INFO  | ,CSV,RecordTime,CurrentWaypoint,WaypointStrength,"
+				   "/*LastContactTime,LastRCTime,*/Lat,Lon,Track,Speed,FixValid\n";
+		} else if (i == (TEST_LINES / 2)) {
+			out << "2017Apr09-21:00:00:000 | INFO  | Starting the master\n";
+			out << "2017Apr09-21:00:00:001 | INFO  | ,CSV,Record Time,Lat,Lon,Speed (m/s),Boat Mode\n";
+		}
+		if (i < (TEST_LINES / 2)) {
+			out << "2017Apr09-20:47:07:358 | INFO  | ,CSV," << stamp << ",-1,0.000000,"
+				<< (47.5 + (i * 0.00001)) << ",-122.25," << (i % 360) << "," << ((i % 10) / 10.0) << ",1\n";
+		} else {
+			out << "2017Apr09-21:00:07:358 | INFO  | ,CSV," << stamp << ","
+				<< (47.5 + (i * 0.00001)) << ",-122.25," << ((i % 10) / 10.0) << "," << ((i % 2) ? "Navigation" : "Disarmed") << "\n";
+		}
+	}
+}
+
+TEST(MissionLogTest, Filter) {
+	VLOG(1) << "===Mission Log Test, Filter===";
+	LogFilter filter;
+	ASSERT_TRUE(LogFilter::parse("Speed (m/s)>=0.5", filter));
+	EXPECT_EQ(filter.column, "Speed (m/s)");
+	EXPECT_EQ(filter.op, LogFilter::Op::GE);
+	EXPECT_TRUE(filter.numeric);
+	EXPECT_TRUE(filter.match("0.5"));
+	EXPECT_TRUE(filter.match("12"));
+	EXPECT_FALSE(filter.match("0.4"));
+	EXPECT_FALSE(filter.match(""));
+	ASSERT_TRUE(LogFilter::parse("Boat Mode!=Navigation", filter));
+	EXPECT_EQ(filter.op, LogFilter::Op::NE);
+	EXPECT_FALSE(filter.numeric);
+	EXPECT_TRUE(filter.match("Disarmed"));
+	EXPECT_FALSE(filter.match("Navigation"));
+	EXPECT_FALSE(LogFilter::parse("=3", filter));
+	EXPECT_FALSE(LogFilter::parse("Lat", filter));
+
+	std::vector<std::string> names;
+	std::string header = "RecordTime,CurrentWaypoint,/*LastContactTime,LastRCTime,*/Lat,Lon";
+	MissionLog::columns(header.c_str(), header.size(), names);
+	ASSERT_EQ(names.size(), 4u);
+	EXPECT_EQ(MissionLog::column(names, "Lat"), 2);
+	EXPECT_EQ(MissionLog::column(names, "LastRCTime"), -1);
+
+	// the header from before the column table, which had the target course and throttle names swapped
+	header = "Record Time, Lat, Lon, GPS Track (deg true), Speed (m/s),Fix Type, Waypoint #,Waypoint Lat,Waypoint Lon, Target Course, "
+		"Throttle Position,Rudder Command (ms)";
+	MissionLog::columns(header.c_str(), header.size(), names);
+	ASSERT_EQ(names.size(), 12u);
+	EXPECT_EQ(MissionLog::column(names, "Lat"), 1);
+	EXPECT_EQ(MissionLog::column(names, "Throttle Position"), 9);
+	EXPECT_EQ(MissionLog::column(names, "Target Course"), 10);
+}
+
+TEST(MissionLogTest, Query) {
+	VLOG(1) << "===Mission Log Test, Query===";
+	std::string path = testPath();
+	removeLog(path);
+	writeLog(path, 0, TEST_LINES);
+	MissionLog log;
+	ASSERT_TRUE(log.open(path));
+	EXPECT_FALSE(log.fromCache());
+	EXPECT_TRUE(log.tagged());
+	EXPECT_EQ(log.lines(), (uint64_t)TEST_LINES);
+	EXPECT_GT(log.blocks(), 1u);
+	EXPECT_EQ(log.start(), testStart);
+	EXPECT_EQ(log.end(), testStart + ((TEST_LINES - 1) * 100ms));
+
+	// a second across the restart, so both headers are used
+	std::vector<LogFilter> none;
+	sysclock from = testStart + ((TEST_LINES / 2) * 100ms) - 500ms;
+	std::vector<sysclock> times;
+	std::vector<std::string> lats;
+	size_t count = log.query(from, from + 999ms, none, [&] (const MissionLog::Line& line) {
+		std::vector<std::string> names;
+		MissionLog::columns(line.header, line.headerLen, names);
+		int lat = MissionLog::column(names, "Lat");
+		EXPECT_GE(lat, 0);
+		const char *p = line.data;
+		std::string field;
+		for (int i = 0; i <= lat; i++) p = readCSVField(p, line.data + line.len, field);
+		times.push_back(line.time);
+		lats.push_back(field);
+		return true;
+	});
+	EXPECT_EQ(count, 10u);
+	ASSERT_EQ(times.size(), 10u);
+	EXPECT_EQ(times.front(), from);
+	EXPECT_EQ(times.back(), from + 900ms);
+	EXPECT_NEAR(atof(lats.front().c_str()), 47.5 + (((TEST_LINES / 2) - 5) * 0.00001), 0.000001);
+	EXPECT_NEAR(atof(lats.back().c_str()), 47.5 + (((TEST_LINES / 2) + 4) * 0.00001), 0.000001);
+
+	// filters on columns that only one of the headers has
+	std::vector<LogFilter> filters(1);
+	ASSERT_TRUE(LogFilter::parse("Boat Mode=Navigation", filters[0]));
+	EXPECT_EQ(log.query(sysclock::min(), sysclock::max(), filters, [] (const MissionLog::Line&) {return true;}), (size_t)TEST_LINES / 4);
+	ASSERT_TRUE(LogFilter::parse("FixValid=1", filters[0]));
+	EXPECT_EQ(log.query(sysclock::min(), sysclock::max(), filters, [] (const MissionLog::Line&) {return true;}), (size_t)TEST_LINES / 2);
+	filters.resize(2);
+	ASSERT_TRUE(LogFilter::parse("Speed>=0.5", filters[1]));
+	EXPECT_EQ(log.query(sysclock::min(), sysclock::max(), filters, [] (const MissionLog::Line&) {return true;}), (size_t)TEST_LINES / 4);
+
+	// stopping early
+	EXPECT_EQ(log.query(sysclock::min(), sysclock::max(), none, [] (const MissionLog::Line&) {return false;}), 1u);
+	log.close();
+	removeLog(path);
+}
+
+TEST(MissionLogTest, Cache) {
+	VLOG(1) << "===Mission Log Test, Cache===";
+	std::string path = testPath();
+	removeLog(path);
+	writeLog(path, 0, TEST_LINES / 2);
+	MissionLog log;
+	ASSERT_TRUE(log.open(path));
+	EXPECT_FALSE(log.fromCache());
+	size_t blocks = log.blocks();
+	log.close();
+
+	ASSERT_TRUE(log.open(path));
+	EXPECT_TRUE(log.fromCache());
+	EXPECT_EQ(log.blocks(), blocks);
+	EXPECT_EQ(log.lines(), (uint64_t)TEST_LINES / 2);
+	log.close();
+
+	// the master writes some more, ending part way through a line
+	writeLog(path, TEST_LINES / 2, TEST_LINES, false);
+	{
+		std::ofstream out(path, std::ios::app);
+		out << "2017Apr09-21:30:00:000 | INFO  | ,CSV,2017-04-09";
+	}
+	ASSERT_TRUE(log.open(path));
+	EXPECT_TRUE(log.fromCache());
+	EXPECT_EQ(log.lines(), (uint64_t)TEST_LINES);
+	std::vector<LogFilter> filters(1);
+	ASSERT_TRUE(LogFilter::parse("Boat Mode=Disarmed", filters[0]));
+	EXPECT_EQ(log.query(sysclock::min(), sysclock::max(), filters, [] (const MissionLog::Line&) {return true;}), (size_t)TEST_LINES / 4);
+	log.close();
+
+	// the same as built from scratch
+	MissionLog fresh;
+	ASSERT_TRUE(fresh.open(path, false));
+	EXPECT_FALSE(fresh.fromCache());
+	EXPECT_EQ(fresh.lines(), (uint64_t)TEST_LINES);
+	EXPECT_EQ(fresh.end(), testStart + ((TEST_LINES - 1) * 100ms));
+	fresh.close();
+
+	// a different log of the same name
+	writeLog(path, 0, 100);
+	ASSERT_TRUE(log.open(path));
+	EXPECT_FALSE(log.fromCache());
+	EXPECT_EQ(log.lines(), 100u);
+	log.close();
+	removeLog(path);
+}
+
+TEST(MissionLogTest, BareCSV) {
+	VLOG(1) << "===Mission Log Test, Bare CSV===";
+	std::string path = testPath(".csv");
+	removeLog(path);
+	{
+		std::ofstream out(path);
+		out << "Record Time,Lat,Lon\r\n";
+		for (int i = 0; i < 100; i++) {
+			out << HackerboatState::packTime(testStart + (i * 1s)) << ",47.5,-122.25\r\n";
+		}
+	}
+	MissionLog log;
+	ASSERT_TRUE(log.open(path));
+	EXPECT_FALSE(log.tagged());
+	EXPECT_EQ(log.lines(), 100u);
+	std::vector<LogFilter> filters(1);
+	ASSERT_TRUE(LogFilter::parse("Lon=-122.25", filters[0]));
+	size_t count = log.query(testStart + 10s, testStart + 19s, filters, [] (const MissionLog::Line& line) {
+		EXPECT_EQ(std::string(line.header, line.headerLen), "Record Time,Lat,Lon");
+		EXPECT_NE(line.data[line.len - 1], '\r');
+		return true;
+	});
+	EXPECT_EQ(count, 10u);
+	log.close();
+	removeLog(path);
+}
+
+TEST(MissionLogTest, DISABLED_Benchmark) {
+	VLOG(1) << "===Mission Log Test, Benchmark===";
+	std::string path = testPath();
+	removeLog(path);
+	writeLog(path, 0, TEST_LINES);
+	MissionLog log;
+	auto start = steady_clock::now();
+	ASSERT_TRUE(log.open(path));
+	auto buildTime = steady_clock::now() - start;
+	log.close();
+	start = steady_clock::now();
+	ASSERT_TRUE(log.open(path));
+	auto loadTime = steady_clock::now() - start;
+
+	std::vector<LogFilter> none;
+	size_t count = 0;
+	start = steady_clock::now();
+	for (int i = 0; i < BENCHMARK_QUERIES; i++) {
+		sysclock from = testStart + ((i * 17 % TEST_LINES) * 100ms);
+		count += log.query(from, from + 10s, none, [] (const MissionLog::Line&) {return true;});
+	}
+	auto queryTime = steady_clock::now() - start;
+	EXPECT_GT(count, 0u);
+	log.close();
+	removeLog(path);
+
+	LOG(INFO) << "Mission log index build: " << duration_cast<microseconds>(buildTime).count() << " us, load: "
+			  << duration_cast<microseconds>(loadTime).count() << " us";
+	LOG(INFO) << "Mission log 10 s query: " << duration_cast<nanoseconds>(queryTime).count() / (1000.0 * BENCHMARK_QUERIES) << " us";
+}
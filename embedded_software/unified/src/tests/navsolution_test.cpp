@@ -0,0 +1,87 @@
+#include <stdexcept>
+#include <gtest/gtest.h>
+#include <cmath>
+#include "navSolution.hpp"
+#include "location.hpp"
+#include "twovector.hpp"
+#include "test_utilities.hpp"
+#include "easylogging++.h"
+
+#define SEATTLE {47.592597, -122.382938}
+#define TRACK_TOL (0.1)			// Meters
+#define BEARING_TOL (0.0002)	// Degrees
+
+TEST (NavSolution, Geometry) {
+	VLOG(1) << "===Navigation Solution Test, Geometry===";
+	Location start SEATTLE;
+	TwoVector leg = TwoVector::getVectorDeg(0, 1000);
+	Location target = start.project(leg);
+	TwoVector along = TwoVector::getVectorDeg(0, 500);
+	TwoVector across = TwoVector::getVectorDeg(90, 20);
+	Location fix = start.project(along).project(across);
+	NavSolution nav;
+	EXPECT_FALSE(nav.isValid());
+	EXPECT_TRUE(nav.update(1, fix, target, start));
+	EXPECT_TRUE(nav.isValid());
+	EXPECT_TRUE(toleranceEquals(nav.distance(), fix.distance(target), TRACK_TOL));
+	EXPECT_TRUE(toleranceEquals(nav.bearing(), fix.bearing(target), BEARING_TOL));
+	EXPECT_TRUE(toleranceEquals(nav.crossTrack(), 20, TRACK_TOL));
+	EXPECT_TRUE(toleranceEquals(nav.alongTrack(), 500, TRACK_TOL));
+
+	// off to the left and behind the start of the leg
+	TwoVector back = TwoVector::getVectorDeg(180, 100);
+	TwoVector left = TwoVector::getVectorDeg(-90, 30);
+	fix = start.project(back).project(left);
+	EXPECT_TRUE(nav.update(2, fix, target, start));
+	EXPECT_TRUE(toleranceEquals(nav.crossTrack(), -30, TRACK_TOL));
+	EXPECT_TRUE(toleranceEquals(nav.alongTrack(), -100, TRACK_TOL));
+
+	// no leg, so only the course to the target
+	EXPECT_TRUE(nav.update(3, fix, target));
+	EXPECT_TRUE(nav.isValid());
+	EXPECT_TRUE(toleranceEquals(nav.distance(), fix.distance(target), TRACK_TOL));
+	EXPECT_TRUE(std::isnan(nav.crossTrack()));
+	EXPECT_TRUE(std::isnan(nav.alongTrack()));
+
+	// no fix
+	EXPECT_TRUE(nav.update(4, Location(), target));
+	EXPECT_FALSE(nav.isValid());
+	EXPECT_TRUE(std::isnan(nav.distance()));
+	EXPECT_TRUE(std::isnan(nav.bearing()));
+}
+
+TEST (NavSolution, Cache) {
+	VLOG(1) << "===Navigation Solution Test, Cache===";
+	Location start SEATTLE;
+	Location target {47.6, -122.39};
+	Location fix {47.595, -122.385};
+	NavSolution nav;
+	EXPECT_TRUE(nav.update(7, fix, target, start));
+	EXPECT_FALSE(nav.update(7, fix, target, start));
+	EXPECT_FALSE(nav.update(7, fix, target, start));
+	EXPECT_EQ(nav.computations(), 1u);
+	EXPECT_EQ(nav.sequence(), 7u);
+
+	// a new fix, even in the same place
+	EXPECT_TRUE(nav.update(8, fix, target, start));
+	EXPECT_EQ(nav.computations(), 2u);
+
+	// the fix written directly, without a new sequence number
+	fix.lat += 0.001;
+	EXPECT_TRUE(nav.update(8, fix, target, start));
+	EXPECT_TRUE(toleranceEquals(nav.distance(), fix.distance(target), TRACK_TOL));
+
+	// a new target or leg
+	target.lon += 0.001;
+	EXPECT_TRUE(nav.update(8, fix, target, start));
+	EXPECT_TRUE(nav.update(8, fix, target));
+	EXPECT_EQ(nav.computations(), 5u);
+
+	// invalid locations compare equal, so they don't defeat the cache
+	EXPECT_FALSE(nav.update(8, fix, target, Location()));
+	nav.update(9, Location(), target);
+	EXPECT_FALSE(nav.update(9, Location(), target));
+	nav.invalidate();
+	EXPECT_TRUE(nav.update(9, Location(), target));
+	EXPECT_EQ(nav.computations(), 7u);
+}
@@ -0,0 +1,124 @@
+#include <stdexcept>
+#include <gtest/gtest.h>
+#include <cstring>
+#include "pool.hpp"
+#include "scratchArena.hpp"
+#include "boatState.hpp"
+#include "boatModes.hpp"
+#include "navModes.hpp"
+#include "autoModes.hpp"
+#include "rcModes.hpp"
+#include "enumdefs.hpp"
+#include "test_utilities.hpp"
+#include "rapidjson/rapidjson.h"
+#include "rapidjson/document.h"
+#include "easylogging++.h"
+
+using namespace rapidjson;
+
+static FixedPool<24, 3> testPool;
+
+TEST(PoolTest, FixedPool) {
+	VLOG(1) << "===Pool Test, Fixed Pool===";
+	void *a, *b, *c;
+	EXPECT_NO_ALLOCATIONS({
+		a = testPool.allocate(24);
+		b = testPool.allocate(8);
+		c = testPool.allocate(16);
+	});
+	ASSERT_NE(a, (void*)NULL);
+	ASSERT_NE(b, (void*)NULL);
+	ASSERT_NE(c, (void*)NULL);
+	EXPECT_EQ(testPool.inUse(), 3u);
+	EXPECT_EQ(testPool.allocate(8), (void*)NULL);		// empty
+	EXPECT_EQ(testPool.misses(), 1u);
+	EXPECT_TRUE(testPool.release(b));
+	EXPECT_EQ(testPool.allocate(8), b);					// slot is reused
+	EXPECT_EQ(testPool.allocate(32), (void*)NULL);		// too big
+	EXPECT_EQ(testPool.misses(), 2u);
+	int local;
+	EXPECT_FALSE(testPool.release(&local));
+	testPool.release(a);
+	testPool.release(b);
+	testPool.release(c);
+	EXPECT_EQ(testPool.inUse(), 0u);
+}
+
+TEST(PoolTest, FixedQueue) {
+	VLOG(1) << "===Pool Test, Fixed Queue===";
+	FixedQueue<int, 4> q;
+	EXPECT_TRUE(q.empty());
+	EXPECT_NO_ALLOCATIONS({
+		for (int i = 0; i < 4; i++) q.push_back(i);
+	});
+	EXPECT_TRUE(q.full());
+	EXPECT_FALSE(q.push_back(4));
+	EXPECT_EQ(q.front(), 0);
+	q.pop_front();
+	q.pop_front();
+	EXPECT_TRUE(q.push_back(4));
+	EXPECT_TRUE(q.push_back(5));						// wraps around
+	EXPECT_EQ(q.size(), 4u);
+	for (size_t i = 0; i < q.size(); i++) {
+		EXPECT_EQ(q[i], (int)i + 2);
+	}
+	q.clear();
+	EXPECT_EQ(q.size(), 0u);
+}
+
+TEST(PoolTest, ScratchArena) {
+	VLOG(1) << "===Pool Test, Scratch Arena===";
+	ScratchArena arena(64);
+	char *line = NULL;
+	double *d = NULL;
+	EXPECT_NO_ALLOCATIONS({
+		line = arena.print("%s,%d,%f", "abc", 42, 1.5);
+		d = static_cast<double*>(arena.allocate(sizeof(double), alignof(double)));
+	});
+	ASSERT_NE(line, (char*)NULL);
+	ASSERT_NE(d, (double*)NULL);
+	EXPECT_STREQ(line, "abc,42,1.500000");
+	EXPECT_EQ((uintptr_t)d % alignof(double), 0u);
+	EXPECT_EQ(arena.allocate(64), (void*)NULL);
+	EXPECT_EQ(arena.print("%060d", 1), (char*)NULL);
+	EXPECT_EQ(arena.overflows(), 2u);
+	EXPECT_STREQ(line, "abc,42,1.500000");			// a failed print doesn't clobber what's already there
+	size_t high = arena.highWater();
+	arena.reset();
+	EXPECT_EQ(arena.used(), 0u);
+	EXPECT_EQ(arena.highWater(), high);
+	EXPECT_NE(arena.allocate(64), (void*)NULL);
+}
+
+TEST(PoolTest, Commands) {
+	VLOG(1) << "===Pool Test, Commands===";
+	Document args;
+	args.Parse("{\"mode\":\"Disarmed\"}");
+	size_t start = Command::poolInUse();
+	Command *cmd = NULL;
+	EXPECT_NO_ALLOCATIONS(cmd = new Command(NULL, "SetMode", args));
+	ASSERT_NE(cmd, (Command*)NULL);
+	EXPECT_EQ(Command::poolInUse(), start + 1);
+	EXPECT_EQ(cmd->getArgs(), args);
+	EXPECT_NO_ALLOCATIONS(delete cmd);
+	EXPECT_EQ(Command::poolInUse(), start);
+	EXPECT_THROW(new Command(NULL, "NotACommand", args), std::out_of_range);
+	EXPECT_EQ(Command::poolInUse(), start);				// a failed construction gives the slot back
+}
+
+TEST(PoolTest, Modes) {
+	VLOG(1) << "===Pool Test, Modes===";
+	BoatState me;
+	EXPECT_NO_ALLOCATIONS({
+		for (int i = 0; i < 100; i++) {
+			BoatModeBase *boat = new BoatDisarmedMode(me);
+			NavModeBase *nav = new NavIdleMode(me);
+			AutoModeBase *autoMode = new AutoIdleMode(me);
+			RCModeBase *rc = new RCIdleMode(me);
+			REMOVE(boat);
+			REMOVE(nav);
+			REMOVE(autoMode);
+			REMOVE(rc);
+		}
+	});
+}
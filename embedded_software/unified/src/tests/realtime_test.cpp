@@ -0,0 +1,108 @@
+#include <stdexcept>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <string>
+#include <cstring>
+#include "realtime.hpp"
+#include "configuration.hpp"
+#include "cycleProfiler.hpp"
+#include "hal/inputThread.hpp"
+#include "enumdefs.hpp"
+#include "test_utilities.hpp"
+#include "easylogging++.h"
+extern "C" {
+	#include <pthread.h>
+	#include <sched.h>
+	#include <stdlib.h>
+	#include <unistd.h>
+}
+
+using namespace std::chrono;
+
+class TickInput : public InputThread {
+	public:
+		TickInput () {
+			setInputMode(InputModeEnum::PERIODIC);
+			period = 5ms;
+		}
+		bool begin () {return true;};
+		bool execute () {return true;};
+		const char* getThreadName () {return "TestTick";};
+};
+
+TEST(RealTime, UnscheduledThread) {
+	VLOG(1) << "===Real Time Unscheduled Thread Test===";
+	int policy = -1;
+	char name[16] = {0};
+	std::thread t([&] () {
+		struct sched_param param;
+		EXPECT_TRUE(RealTime::get()->configureThread("TestUnscheduled"));
+		pthread_getschedparam(pthread_self(), &policy, &param);
+		pthread_getname_np(pthread_self(), name, sizeof(name));
+	});
+	t.join();
+	EXPECT_EQ(policy, SCHED_OTHER);
+	EXPECT_STREQ(name, "TestUnscheduled");
+}
+
+TEST(RealTime, ScheduledThread) {
+	VLOG(1) << "===Real Time Scheduled Thread Test===";
+	int policy = -1;
+	int priority = -1;
+	bool result = false;
+
+	// real-time scheduling only comes from the configuration file, so give the test thread an entry there
+	char path[] = "/tmp/realtime_testXXXXXX";
+	int fd = mkstemp(path);
+	ASSERT_GE(fd, 0);
+	const char *conf = "{\"Thread Schedule\": {\"TestScheduled\": {\"Policy\": \"FIFO\", \"Priority\": 50}}}";
+	ASSERT_EQ(write(fd, conf, strlen(conf)), (ssize_t)strlen(conf));
+	close(fd);
+	EXPECT_GT(Conf::get()->load(path), 0);
+	unlink(path);
+	ASSERT_EQ(Conf::get()->threadSchedule().count("TestScheduled"), 1u);
+
+	std::thread t([&] () {
+		struct sched_param param;
+		result = RealTime::get()->configureThread("TestScheduled");
+		pthread_getschedparam(pthread_self(), &policy, &param);
+		priority = param.sched_priority;
+	});
+	t.join();
+	if (result) {
+		EXPECT_EQ(policy, SCHED_FIFO);
+		EXPECT_EQ(priority, 50);
+	} else {
+		VLOG(1) << "Not permitted to use real-time scheduling here";
+		EXPECT_EQ(policy, SCHED_OTHER);
+	}
+}
+
+TEST(RealTime, WakeupHistograms) {
+	VLOG(1) << "===Real Time Wakeup Histogram Test===";
+	LatencyHistogram& first = RealTime::get()->wakeup("TestHistogram");
+	LatencyHistogram& second = RealTime::get()->wakeup("TestHistogram");
+	EXPECT_EQ(&first, &second);
+	first.record(250us);
+	EXPECT_EQ(second.count(), 1u);
+	Value d = RealTime::get()->pack();
+	ASSERT_TRUE(d.IsObject());
+	EXPECT_TRUE(d.HasMember("TestHistogram"));
+	RealTime::get()->reset();
+	EXPECT_EQ(first.count(), 0u);
+}
+
+TEST(RealTime, InputThreadWakeups) {
+	VLOG(1) << "===Real Time Input Thread Wakeup Test===";
+	TickInput input;
+	InputThread::InputThreadRunner runner(&input);
+	std::thread t{runner};
+	std::this_thread::sleep_for(60ms);
+	input.kill();
+	t.join();
+	LatencyHistogram& latency = RealTime::get()->wakeup("TestTick");
+	EXPECT_GE(latency.count(), 5u);
+	EXPECT_LT(latency.percentile(50.0), 5ms);
+}
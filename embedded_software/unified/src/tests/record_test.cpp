@@ -0,0 +1,231 @@
+#include <stdexcept>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cmath>
+#include <string>
+#include "telemetryRecord.hpp"
+#include "location.hpp"
+#include "orientation.hpp"
+#include "gps.hpp"
+#include "ais.hpp"
+#include "healthMonitor.hpp"
+#include "boatState.hpp"
+#include "enumdefs.hpp"
+#include "test_utilities.hpp"
+#include "easylogging++.h"
+
+#define TOL (0.000001)
+#define BENCHMARK_CYCLES (10000)
+
+using namespace rapidjson;
+using namespace std::chrono;
+
+static std::string recordJSON (const uint8_t *buf, size_t len) {
+	StringBuffer out;
+	JSONWriter writer(out);
+	EXPECT_TRUE(recordToJSON(buf, len, writer));
+	return out.GetString();
+}
+
+static void testState (BoatState& me) {
+	me.recordTime = system_clock::now();
+	me.lastContact = me.recordTime - seconds(2);
+	me.lastRC = me.recordTime - milliseconds(150);
+	me.lastFix = testFix();
+	me.launchPoint = Location(47.5, -122.4);
+	me.insertFault("Record");
+	me.setBoatMode(BoatModeEnum::NAVIGATION);
+}
+
+TEST(RecordTest, GPSFix) {
+	VLOG(1) << "===Record Test, GPSFix===";
+	uint8_t buf[RECORD_MAX_SIZE];
+	GPSFix fix = testFix();
+	GPSFix out;
+	size_t len = fix.writeRecord(buf, sizeof(buf));
+	ASSERT_GT(len, 0u);
+	EXPECT_EQ(recordSize(buf, sizeof(buf)), len);
+	ASSERT_TRUE(out.readRecord(buf, len));
+	EXPECT_TRUE(toleranceEquals(out.fix.lat, 47.6, TOL));
+	EXPECT_TRUE(toleranceEquals(out.speed, 1.25, TOL));
+	EXPECT_TRUE(std::isnan(out.climb));
+	EXPECT_EQ(out.mode, NMEAModeEnum::FIX3D);
+	EXPECT_EQ(out.device, "/dev/ttyS4");
+	EXPECT_TRUE(out.fixValid);
+	EXPECT_EQ(toJSON(out), toJSON(fix));
+	EXPECT_EQ(recordJSON(buf, len), toJSON(fix));
+}
+
+TEST(RecordTest, Defaults) {
+	VLOG(1) << "===Record Test, Defaults===";
+	uint8_t buf[RECORD_MAX_SIZE];
+	Location empty;
+	Location out {47.5, -122.4};
+	size_t len = empty.writeRecord(buf, sizeof(buf));
+	EXPECT_EQ(len, sizeof(RecordHeader) + 1);					// nothing but the bitmap
+	ASSERT_TRUE(out.readRecord(buf, len));
+	EXPECT_TRUE(std::isnan(out.lat));
+	EXPECT_TRUE(std::isnan(out.lon));
+	EXPECT_EQ(recordJSON(buf, len), toJSON(empty));
+	AISShip ship;
+	len = ship.writeRecord(buf, sizeof(buf));
+	ASSERT_GT(len, 0u);
+	EXPECT_EQ(recordJSON(buf, len), toJSON(ship));
+}
+
+TEST(RecordTest, AllTypes) {
+	VLOG(1) << "===Record Test, All Types===";
+	uint8_t buf[RECORD_MAX_SIZE];
+	AISShip ship;
+	ship.mmsi = 367001234;
+	ship.recordTime = system_clock::now();
+	ship.fix = Location(47.61, -122.35);
+	ship.status = AISNavStatus::FISHING;
+	ship.speed = 4.5;
+	ship.shipname = "TEST VESSEL";
+	ship.to_bow = 12;
+	HealthMonitor health;
+	health.recordTime = system_clock::now();
+	health.servoCurrent = 0.5;
+	health.batteryMon = 12.6;
+	health.mainVoltage = 12.4;
+	health.mainCurrent = 3.2;
+	health.chargeVoltage = 14.1;
+	health.chargeCurrent = -0.1;
+	health.motorVoltage = 12.2;
+	health.motorCurrent = 2.8;
+	health.rcRssi = -60;
+	health.cellRssi = -85;
+	health.wifiRssi = 0;
+	Orientation orient {1.5, -2.5, 275};
+	BoatState me;
+	testState(me);
+	const HackerboatState *states[] = { &ship, &health, &orient, &me };
+
+	for (auto s : states) {
+		size_t len = s->writeRecord(buf, sizeof(buf));
+		ASSERT_GT(len, 0u);
+		EXPECT_EQ(recordJSON(buf, len), toJSON(*s));
+	}
+	size_t len = ship.writeRecord(buf, sizeof(buf));
+	AISShip shipOut;
+	ASSERT_TRUE(shipOut.readRecord(buf, len));
+	EXPECT_EQ(shipOut.mmsi, 367001234);
+	EXPECT_EQ(shipOut.status, AISNavStatus::FISHING);
+	EXPECT_EQ(shipOut.to_bow, 12);
+	EXPECT_EQ(shipOut.to_stern, -1);
+	EXPECT_EQ(shipOut.shipname, "TEST VESSEL");
+	len = health.writeRecord(buf, sizeof(buf));
+	HealthMonitor healthOut;
+	ASSERT_TRUE(healthOut.readRecord(buf, len));
+	EXPECT_EQ(healthOut.cellRssi, -85);
+	EXPECT_EQ(healthOut.wifiRssi, 0);
+	EXPECT_TRUE(toleranceEquals(healthOut.chargeCurrent, -0.1, TOL));
+	len = me.writeRecord(buf, sizeof(buf));
+	BoatState meOut;
+	ASSERT_TRUE(meOut.readRecord(buf, len));
+	EXPECT_EQ(meOut.getBoatMode(), BoatModeEnum::NAVIGATION);
+	EXPECT_EQ(meOut.getFaultString(), me.getFaultString());
+	EXPECT_EQ(toJSON(meOut), toJSON(me));
+}
+
+TEST(RecordTest, Malformed) {
+	VLOG(1) << "===Record Test, Malformed===";
+	uint8_t buf[RECORD_MAX_SIZE];
+	GPSFix fix = testFix();
+	GPSFix out;
+	AISShip ship;
+	size_t len = fix.writeRecord(buf, sizeof(buf));
+	ASSERT_GT(len, 0u);
+	for (size_t i = 0; i < len; i++) {
+		EXPECT_FALSE(out.readRecord(buf, i)) << i;					// every truncation is caught
+	}
+	EXPECT_FALSE(ship.readRecord(buf, len));						// wrong type
+	EXPECT_EQ(fix.writeRecord(buf, len - 1), 0u);					// doesn't fit
+	EXPECT_EQ(recordFields(recordSchema(GPSFix::fields)), GPSFix::fields);
+	EXPECT_NE(recordSchema(GPSFix::fields), recordSchema(AISShip::fields));
+	buf[1] = RECORD_VERSION + 1;
+	EXPECT_FALSE(out.readRecord(buf, len));
+	EXPECT_EQ(recordSize(buf, len), 0u);
+}
+
+TEST(RecordTest, Infinity) {
+	VLOG(1) << "===Record Test, Infinity===";
+	uint8_t buf[RECORD_MAX_SIZE];
+	GPSFix fix = testFix();
+	fix.speed = INFINITY;
+	fix.track = -INFINITY;
+	fix.alt = NAN;
+	size_t len = fix.writeRecord(buf, sizeof(buf));
+	ASSERT_GT(len, 0u);
+	GPSFix out;
+	ASSERT_TRUE(out.readRecord(buf, len));
+	EXPECT_TRUE(std::isinf(out.speed) && (out.speed > 0));			// infinities survive the trip
+	EXPECT_TRUE(std::isinf(out.track) && (out.track < 0));
+	EXPECT_TRUE(std::isnan(out.alt));								// NaN is what an absent double reads back as
+	EXPECT_EQ(out.mode, fix.mode);
+}
+
+TEST(RecordTest, NoAllocations) {
+	VLOG(1) << "===Record Test, No Allocations===";
+	uint8_t buf[RECORD_MAX_SIZE];
+	BoatState me;
+	testState(me);
+	size_t len = 0;
+	EXPECT_NO_ALLOCATIONS({
+		len = me.writeRecord(buf, sizeof(buf));
+	});
+	EXPECT_GT(len, 0u);
+}
+
+TEST(RecordTest, Size) {
+	VLOG(1) << "===Record Test, Size===";
+	uint8_t buf[RECORD_MAX_SIZE];
+	BoatState me;
+	testState(me);
+	size_t len = me.writeRecord(buf, sizeof(buf));
+	ASSERT_GT(len, 0u);
+	EXPECT_LT(len * 2, toJSON(me).size());
+}
+
+TEST(RecordTest, DISABLED_Benchmark) {
+	VLOG(1) << "===Record Test, Benchmark===";
+	uint8_t buf[RECORD_MAX_SIZE];
+	BoatState me;
+	BoatState out;
+	testState(me);
+	std::string json = toJSON(me);
+	size_t len = me.writeRecord(buf, sizeof(buf));
+	size_t check = 0;
+
+	auto start = steady_clock::now();
+	for (int i = 0; i < BENCHMARK_CYCLES; i++) {
+		check += toJSON(me).size();
+	}
+	auto writeJSONTime = steady_clock::now() - start;
+	start = steady_clock::now();
+	for (int i = 0; i < BENCHMARK_CYCLES; i++) {
+		check += me.writeRecord(buf, sizeof(buf));
+	}
+	auto writeRecordTime = steady_clock::now() - start;
+	EXPECT_EQ(check, (json.size() + len) * BENCHMARK_CYCLES);
+
+	start = steady_clock::now();
+	for (int i = 0; i < BENCHMARK_CYCLES; i++) {
+		EXPECT_TRUE(out.readJSON(json.c_str()));
+	}
+	auto readJSONTime = steady_clock::now() - start;
+	start = steady_clock::now();
+	for (int i = 0; i < BENCHMARK_CYCLES; i++) {
+		EXPECT_TRUE(out.readRecord(buf, len));
+	}
+	auto readRecordTime = steady_clock::now() - start;
+
+	double writeJSONUs = duration_cast<nanoseconds>(writeJSONTime).count() / (1000.0 * BENCHMARK_CYCLES);
+	double writeRecordUs = duration_cast<nanoseconds>(writeRecordTime).count() / (1000.0 * BENCHMARK_CYCLES);
+	double readJSONUs = duration_cast<nanoseconds>(readJSONTime).count() / (1000.0 * BENCHMARK_CYCLES);
+	double readRecordUs = duration_cast<nanoseconds>(readRecordTime).count() / (1000.0 * BENCHMARK_CYCLES);
+	LOG(INFO) << "BoatState json: " << json.size() << " bytes, record: " << len << " bytes";
+	LOG(INFO) << "BoatState writeJSON(): " << writeJSONUs << " us, writeRecord(): " << writeRecordUs << " us, speedup " << (writeJSONUs / writeRecordUs);
+	LOG(INFO) << "BoatState readJSON(): " << readJSONUs << " us, readRecord(): " << readRecordUs << " us, speedup " << (readJSONUs / readRecordUs);
+}
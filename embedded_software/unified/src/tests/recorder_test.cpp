@@ -0,0 +1,254 @@
+#include <stdexcept>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cmath>
+#include <string>
+#include "flightRecorder.hpp"
+#include "telemetryRecord.hpp"
+#include "orientation.hpp"
+#include "healthMonitor.hpp"
+#include "boatState.hpp"
+#include "test_utilities.hpp"
+#include "easylogging++.h"
+extern "C" {
+	#include <fcntl.h>
+	#include <unistd.h>
+}
+
+#define TEST_SLOTS (16)
+#define BENCHMARK_CYCLES (10000)
+
+using namespace std::chrono;
+
+static std::string testPath () {
+	return "/tmp/hackerboat-recorder-test-" + std::to_string(getpid()) + ".rec";
+}
+
+static CycleSample testSample (int64_t cycle) {
+	CycleSample sample;
+	sample.cycle = cycle;
+	sample.rudder = 1500 + cycle;
+	sample.throttle = 3;
+	sample.rcRudder = -12.5;
+	sample.orientation = Orientation(1.5, -2.5, 275);
+	sample.motorCurrentRaw = 812;
+	return sample;
+}
+
+TEST(RecorderTest, RoundTrip) {
+	VLOG(1) << "===Recorder Test, Round Trip===";
+	std::string path = testPath();
+	unlink(path.c_str());
+	FlightRecorder recorder;
+	FlightRecorderReader reader;
+	ASSERT_TRUE(recorder.open(path, TEST_SLOTS, 10ms));
+	ASSERT_TRUE(reader.open(path));
+	EXPECT_EQ(reader.next(), 1u);
+	EXPECT_EQ(reader.oldest(), 1u);
+
+	HealthMonitor health;
+	health.batteryMon = 12.6;
+	ASSERT_TRUE(recorder.begin());
+	EXPECT_TRUE(recorder.append(testSample(7)));
+	EXPECT_TRUE(recorder.append(health));
+
+	uint8_t buf[RECORDER_FRAME_SIZE];
+	size_t used = 0;
+	sysclock time;
+	EXPECT_EQ(reader.read(1, buf, sizeof(buf), used, time), FlightRecorderReader::Result::NOT_YET);	// not committed
+	ASSERT_TRUE(recorder.commit());
+	ASSERT_TRUE(recorder.sync());
+	EXPECT_EQ(reader.next(), 2u);
+	ASSERT_EQ(reader.read(1, buf, sizeof(buf), used, time), FlightRecorderReader::Result::OK);
+	EXPECT_LE(system_clock::now() - time, seconds(1));
+
+	size_t first = recordSize(buf, used);
+	ASSERT_GT(first, 0u);
+	CycleSample sample;
+	ASSERT_TRUE(sample.readRecord(buf, first));
+	EXPECT_EQ(sample.cycle, 7);
+	EXPECT_EQ(sample.rudder, 1507);
+	EXPECT_EQ(sample.orientation.heading, 275);
+	EXPECT_TRUE(std::isnan(sample.rcCourse));
+	HealthMonitor healthOut;
+	ASSERT_TRUE(healthOut.readRecord(buf + first, used - first));
+	EXPECT_EQ(healthOut.batteryMon, 12.6);
+	recorder.close();
+	reader.close();
+	unlink(path.c_str());
+}
+
+TEST(RecorderTest, Wrap) {
+	VLOG(1) << "===Recorder Test, Wrap===";
+	std::string path = testPath();
+	unlink(path.c_str());
+	FlightRecorder recorder;
+	FlightRecorderReader reader;
+	ASSERT_TRUE(recorder.open(path, TEST_SLOTS, 10ms));
+	ASSERT_TRUE(reader.open(path));
+	for (int i = 1; i <= (TEST_SLOTS * 2) + 3; i++) {
+		ASSERT_TRUE(recorder.begin());
+		EXPECT_TRUE(recorder.append(testSample(i)));
+		ASSERT_TRUE(recorder.commit());
+	}
+	ASSERT_TRUE(recorder.sync());
+	EXPECT_EQ(recorder.lost(), 0u);
+	EXPECT_EQ(reader.next(), (uint64_t)(TEST_SLOTS * 2) + 4);
+	EXPECT_EQ(reader.oldest(), (uint64_t)TEST_SLOTS + 4);
+
+	uint8_t buf[RECORDER_FRAME_SIZE];
+	size_t used = 0;
+	sysclock time;
+	CycleSample sample;
+	EXPECT_EQ(reader.read(reader.oldest() - 1, buf, sizeof(buf), used, time), FlightRecorderReader::Result::OVERWRITTEN);
+	for (uint64_t seq = reader.oldest(); seq < reader.next(); seq++) {
+		ASSERT_EQ(reader.read(seq, buf, sizeof(buf), used, time), FlightRecorderReader::Result::OK) << seq;
+		ASSERT_TRUE(sample.readRecord(buf, used));
+		EXPECT_EQ(sample.cycle, (int64_t)seq);
+	}
+
+	// the file isn't touched until a frame is committed and copied, and then the oldest frame is gone
+	uint64_t oldest = reader.oldest();
+	ASSERT_TRUE(recorder.begin());
+	EXPECT_EQ(reader.read(oldest, buf, sizeof(buf), used, time), FlightRecorderReader::Result::OK);
+	ASSERT_TRUE(recorder.commit());
+	ASSERT_TRUE(recorder.sync());
+	EXPECT_EQ(reader.read(oldest, buf, sizeof(buf), used, time), FlightRecorderReader::Result::OVERWRITTEN);
+	recorder.close();
+	reader.close();
+	unlink(path.c_str());
+}
+
+TEST(RecorderTest, Reopen) {
+	VLOG(1) << "===Recorder Test, Reopen===";
+	std::string path = testPath();
+	unlink(path.c_str());
+	{
+		FlightRecorder recorder;
+		ASSERT_TRUE(recorder.open(path, TEST_SLOTS, 10ms));
+		for (int i = 0; i < 5; i++) {
+			ASSERT_TRUE(recorder.begin());
+			EXPECT_TRUE(recorder.append(testSample(i)));
+			ASSERT_TRUE(recorder.commit());
+		}
+		ASSERT_TRUE(recorder.begin());					// dies partway through a frame
+		EXPECT_TRUE(recorder.append(testSample(5)));
+	}
+	FlightRecorder recorder;
+	ASSERT_TRUE(recorder.open(path, TEST_SLOTS, 10ms));
+	EXPECT_EQ(recorder.next(), 6u);						// the torn frame is never published
+	recorder.close();
+
+	// a different geometry starts a new file and keeps the old one
+	ASSERT_TRUE(recorder.open(path, TEST_SLOTS * 2, 10ms));
+	EXPECT_EQ(recorder.next(), 1u);
+	recorder.close();
+	std::string kept = path + ".1";
+	FlightRecorderReader reader;
+	ASSERT_TRUE(reader.open(kept));
+	EXPECT_EQ(reader.next(), 6u);
+	reader.close();
+	unlink(kept.c_str());
+	unlink(path.c_str());
+}
+
+TEST(RecorderTest, Corrupt) {
+	VLOG(1) << "===Recorder Test, Corrupt===";
+	std::string path = testPath();
+	unlink(path.c_str());
+	FlightRecorder recorder;
+	ASSERT_TRUE(recorder.open(path, TEST_SLOTS, 10ms));
+	for (int i = 0; i < 3; i++) {
+		ASSERT_TRUE(recorder.begin());
+		EXPECT_TRUE(recorder.append(testSample(i)));
+		ASSERT_TRUE(recorder.commit());
+	}
+	recorder.close();
+
+	// flip a byte in the records of the second frame
+	int fd = open(path.c_str(), O_RDWR);
+	ASSERT_GE(fd, 0);
+	uint8_t byte;
+	off_t where = RECORDER_HEADER_SIZE + RECORDER_SLOT_SIZE + sizeof(RecorderSlotHeader) + 10;
+	ASSERT_EQ(pread(fd, &byte, 1, where), 1);
+	byte ^= 0x55;
+	ASSERT_EQ(pwrite(fd, &byte, 1, where), 1);
+	close(fd);
+
+	FlightRecorderReader reader;
+	ASSERT_TRUE(reader.open(path));
+	uint8_t buf[RECORDER_FRAME_SIZE];
+	size_t used = 0;
+	sysclock time;
+	EXPECT_EQ(reader.read(1, buf, sizeof(buf), used, time), FlightRecorderReader::Result::OK);
+	EXPECT_EQ(reader.read(2, buf, sizeof(buf), used, time), FlightRecorderReader::Result::CORRUPT);
+	EXPECT_EQ(reader.read(3, buf, sizeof(buf), used, time), FlightRecorderReader::Result::OK);
+	EXPECT_EQ(recorderCRC(0, "123456789", 9), 0xCBF43926u);			// the standard check value
+	reader.close();
+	unlink(path.c_str());
+}
+
+TEST(RecorderTest, Truncated) {
+	VLOG(1) << "===Recorder Test, Truncated===";
+	std::string path = testPath();
+	unlink(path.c_str());
+	FlightRecorder recorder;
+	ASSERT_TRUE(recorder.open(path, TEST_SLOTS, 10ms));
+	CycleSample sample = testSample(1);
+	ASSERT_TRUE(recorder.begin());
+	int fit = 0;
+	while (recorder.append(sample)) fit++;
+	EXPECT_GT(fit, 1);
+	EXPECT_EQ(recorder.truncated(), 1u);
+	ASSERT_TRUE(recorder.commit());
+	recorder.close();
+	unlink(path.c_str());
+}
+
+TEST(RecorderTest, NoAllocations) {
+	VLOG(1) << "===Recorder Test, No Allocations===";
+	std::string path = testPath();
+	unlink(path.c_str());
+	FlightRecorder recorder;
+	ASSERT_TRUE(recorder.open(path, TEST_SLOTS, 10ms));
+	CycleSample sample = testSample(1);
+	BoatState me;
+	HealthMonitor health;
+	EXPECT_NO_ALLOCATIONS({
+		recorder.begin();
+		recorder.append(sample);
+		recorder.append(me);
+		recorder.append(health);
+		recorder.commit();
+	});
+	EXPECT_EQ(recorder.truncated(), 0u);
+	recorder.close();
+	unlink(path.c_str());
+}
+
+TEST(RecorderTest, DISABLED_Benchmark) {
+	VLOG(1) << "===Recorder Test, Benchmark===";
+	std::string path = testPath();
+	unlink(path.c_str());
+	FlightRecorder recorder;
+	ASSERT_TRUE(recorder.open(path, 1024, 10ms));
+	CycleSample sample = testSample(1);
+	BoatState me;
+	HealthMonitor health;
+
+	auto start = steady_clock::now();
+	for (int i = 0; i < BENCHMARK_CYCLES; i++) {
+		recorder.begin();
+		recorder.append(sample);
+		recorder.append(me);
+		recorder.append(health);
+		recorder.commit();
+	}
+	auto frameTime = steady_clock::now() - start;
+	EXPECT_EQ(recorder.next(), (uint64_t)BENCHMARK_CYCLES + 1);
+	recorder.close();
+	unlink(path.c_str());
+
+	double frameUs = duration_cast<nanoseconds>(frameTime).count() / (1000.0 * BENCHMARK_CYCLES);
+	LOG(INFO) << "Recorder frame: " << frameUs << " us";
+}
@@ -0,0 +1,235 @@
+#include <stdexcept>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <utility>
+#include "replay.hpp"
+#include "boatClock.hpp"
+#include "boatState.hpp"
+#include "enumdefs.hpp"
+#include "test_utilities.hpp"
+#include "easylogging++.h"
+
+#define TOL 0.000001
+#define REPLAY_TEST_FRAMES (600)
+#define MISSION_LOG "/home/debian/hackerboat/mission_logs/2017Apr09/main-22_46.log"
+#define MISSION_LOG_FRAMES (1454)				/**< Data lines in MISSION_LOG */
+#define MISSION_LOG_COMMANDS (1405)			/**< Data lines long enough to have the throttle and rudder */
+
+using namespace std::chrono;
+
+// lines from mission_logs/2017Apr09/main-20_46.log
+static const std::string oldHeader = "2017Apr09-20:46:30:688 | INFO  | ,CSV,RecordTime,CurrentWaypoint,WaypointStrength,"
+	"/*LastContactTime,LastRCTime,*/Lat,Lon,Track,Speed,FixValid,StopButtonState,ArmButtonState,ServoEnableState,"
+	"ThrottlePosition,RudderCommand,CurrentHeading,ThrottleInput,CourseInput,RCFailSafe,RCMode,RawMotorCurrent,RawBatteryVoltage";
+static const std::string oldLine = "2017Apr09-20:47:07:358 | INFO  | ,CSV,2017-04-09 20:47:07.357,-1228750296,0.000000,"
+	"47.592597,-122.382938,36.260000,0.237000,0,1,1,\x01,0,1500,225.504926,-6,-37.536585,";
+static const std::string oldFailsafe = "2017Apr09-20:49:27:416 | INFO  | ,CSV,2017-04-09 20:49:27.411,-1228750296,0.000000,"
+	"47.592770,-122.382908,311.830000,0.093000,0,1,1,\x01,0,1500,232.968715,0,175.829268,\x01,Failsafe";
+
+// A short RC mission: arm, then steer back and forth with the throttle coming up at the end
+static std::vector<ReplayFrame> testMission () {
+	std::vector<ReplayFrame> frames;
+	sysclock start = sysclock(seconds(1491770827));
+	for (int i = 0; i < REPLAY_TEST_FRAMES; i++) {
+		ReplayFrame f;
+		f.time = start + (i * 100ms);
+		f.fix.fix.lat = 47.592597 + (i * 0.000001);
+		f.fix.fix.lon = -122.382938;
+		f.fix.track = 36.26;
+		f.fix.speed = 0.2;
+		f.fixLogged = true;
+		f.heading = 225.5 + (i % 10);
+		f.boatMode = BoatModeEnum::NAVIGATION;
+		f.navMode = NavModeEnum::RC;
+		f.rcMode = RCModeEnum::RUDDER;
+		f.rcRudder = 50.0 * sin(i / 10.0);
+		f.rcThrottle = (i >= 500) ? 3 : 0;
+		frames.push_back(f);
+	}
+	return frames;
+}
+
+TEST(ReplayTest, Clock) {
+	VLOG(1) << "===Replay Test, Clock===";
+	sysclock then = sysclock(seconds(1491770827)) + 357ms;
+	BoatClock::set(then);
+	EXPECT_TRUE(BoatClock::isSet());
+	EXPECT_EQ(BoatClock::now(), then);
+	auto steady = BoatClock::steadyNow();
+	BoatClock::set(then + 250ms);
+	EXPECT_EQ(BoatClock::steadyNow() - steady, steady_clock::duration(250ms));
+	BoatClock::release();
+	EXPECT_FALSE(BoatClock::isSet());
+	EXPECT_LE(abs(duration_cast<milliseconds>(BoatClock::now() - system_clock::now()).count()), 1000);
+}
+
+TEST(ReplayTest, OldLog) {
+	VLOG(1) << "===Replay Test, Old Log===";
+	CSVLogReplay csv;
+	ReplayFrame frame;
+	EXPECT_FALSE(csv.line(oldHeader.c_str(), oldHeader.size(), frame));
+	EXPECT_EQ(csv.columns(), 20u);				// the commented out columns aren't there
+	ASSERT_TRUE(csv.line(oldLine.c_str(), oldLine.size(), frame));
+	sysclock when;
+	ASSERT_TRUE(HackerboatState::parseTime("2017-04-09 20:47:07.357", when));
+	EXPECT_EQ(frame.time, when);
+	EXPECT_TRUE(frame.fixLogged);
+	EXPECT_NEAR(frame.fix.fix.lat, 47.592597, TOL);
+	EXPECT_NEAR(frame.fix.fix.lon, -122.382938, TOL);
+	EXPECT_NEAR(frame.fix.track, 36.26, TOL);
+	EXPECT_EQ(frame.stopButton, 1);
+	EXPECT_EQ(frame.armButton, 1);
+	EXPECT_EQ(frame.throttle, 0);
+	EXPECT_EQ(frame.rudder, 1500);
+	EXPECT_NEAR(frame.heading, 225.504926, TOL);
+	EXPECT_EQ(frame.rcThrottle, -6);
+	EXPECT_NEAR(frame.rcCourse, -37.536585, TOL);
+	EXPECT_EQ(frame.rcMode, RCModeEnum::NONE);
+	EXPECT_EQ(frame.batteryRaw, REPLAY_NOT_LOGGED);	// the line stops short
+	EXPECT_EQ(frame.boatMode, BoatModeEnum::NONE);
+	ASSERT_TRUE(csv.line(oldFailsafe.c_str(), oldFailsafe.size(), frame));
+	EXPECT_EQ(frame.rcMode, RCModeEnum::FAILSAFE);
+	EXPECT_EQ(csv.skipped(), 0u);
+}
+
+TEST(ReplayTest, SwappedLog) {
+	VLOG(1) << "===Replay Test, Swapped Log===";
+	std::string header = ",CSV,Record Time, Lat, Lon, GPS Track (deg true), Speed (m/s),Fix Type, Waypoint #,Waypoint Lat,"
+		"Waypoint Lon, Target Course, Throttle Position,Rudder Command (ms),Current Heading (deg mag),Boat Mode, Nav Mode, "
+		"Auto Mode, RC Mode, Raw Motor Current, Raw Battery Voltage";
+	std::string line = ",CSV,2017-06-10 18:02:11.500,47.592597,-122.382938,36.260000,0.237000,Fix3D,0,47.6,-122.4,"
+		"3,271.500000,1600,225.504926,Navigation,Autonomous,Waypoint,Idle,512,3010";
+	CSVLogReplay csv;
+	ReplayFrame frame;
+	EXPECT_FALSE(csv.line(header.c_str(), header.size(), frame));
+	ASSERT_TRUE(csv.line(line.c_str(), line.size(), frame));
+	EXPECT_NEAR(frame.fix.fix.lat, 47.592597, TOL);
+	EXPECT_EQ(frame.throttle, 3);				// logged under the target course name
+	EXPECT_EQ(frame.rudder, 1600);
+	EXPECT_EQ(frame.navMode, NavModeEnum::AUTONOMOUS);
+	EXPECT_EQ(csv.skipped(), 0u);
+}
+
+TEST(ReplayTest, CurrentLog) {
+	VLOG(1) << "===Replay Test, Current Log===";
+	ReplayDriver driver;
+	BoatState& me = driver.state();
+	me.recordTime = sysclock(seconds(1491770827)) + 357ms;
+	me.lastFix.fix.lat = 47.5;
+	me.lastFix.fix.lon = -122.25;
+	me.setBoatMode(BoatModeEnum::NAVIGATION);
+	me.setNavMode(NavModeEnum::AUTONOMOUS);
+	me.setAutoMode(AutoModeEnum::ANCHOR);
+	me.throttle->setThrottle(-2);
+	std::string header = ",CSV," + me.getCSVheaders();
+	std::string line = std::string(",CSV,") + me.getCSV();
+
+	CSVLogReplay csv;
+	ReplayFrame frame;
+	EXPECT_FALSE(csv.line(header.c_str(), header.size(), frame));
+	ASSERT_TRUE(csv.line(line.c_str(), line.size(), frame));
+	EXPECT_EQ(frame.time, me.recordTime);
+	EXPECT_NEAR(frame.fix.fix.lat, 47.5, TOL);
+	EXPECT_NEAR(frame.fix.fix.lon, -122.25, TOL);
+	EXPECT_EQ(frame.boatMode, BoatModeEnum::NAVIGATION);
+	EXPECT_EQ(frame.navMode, NavModeEnum::AUTONOMOUS);
+	EXPECT_EQ(frame.autoMode, AutoModeEnum::ANCHOR);
+	EXPECT_EQ(frame.throttle, -2);
+	EXPECT_EQ(frame.rudder, (int)me.rudder->readMicroseconds());
+	EXPECT_EQ(frame.armButton, REPLAY_NOT_LOGGED);
+}
+
+TEST(ReplayTest, Deterministic) {
+	VLOG(1) << "===Replay Test, Deterministic===";
+	std::vector<ReplayFrame> mission = testMission();
+	std::vector<std::pair<int, int>> first, second;
+	{
+		ReplayDriver driver;
+		driver.begin();
+		for (auto& f : mission) {
+			driver.step(f);
+			first.push_back({driver.rudder(), driver.throttle()});
+		}
+		EXPECT_EQ(driver.stats().frames, (uint64_t)REPLAY_TEST_FRAMES);
+		EXPECT_EQ(driver.stats().compared, 0u);		// nothing logged to compare with
+		EXPECT_EQ(driver.state().getBoatMode(), BoatModeEnum::NAVIGATION);
+		EXPECT_EQ(driver.state().getNavMode(), NavModeEnum::RC);
+		EXPECT_EQ(driver.throttle(), 3);
+	}
+	EXPECT_FALSE(BoatClock::isSet());
+	{
+		ReplayDriver driver;
+		driver.begin();
+		for (auto& f : mission) {
+			driver.step(f);
+			second.push_back({driver.rudder(), driver.throttle()});
+		}
+	}
+	EXPECT_EQ(first, second);
+}
+
+TEST(ReplayTest, Compare) {
+	VLOG(1) << "===Replay Test, Compare===";
+	std::vector<ReplayFrame> mission = testMission();
+	std::vector<std::pair<int, int>> outputs;
+	{
+		ReplayDriver driver;
+		driver.begin();
+		for (auto& f : mission) {
+			driver.step(f);
+			outputs.push_back({driver.rudder(), driver.throttle()});
+		}
+	}
+
+	// log what the boat did, then change one frame
+	for (size_t i = 0; i < mission.size(); i++) {
+		mission[i].rudder = outputs[i].first;
+		mission[i].throttle = outputs[i].second;
+	}
+	mission[550].throttle = 5;
+	ReplayDriver driver;
+	driver.begin();
+	int failed = -1;
+	for (size_t i = 0; i < mission.size(); i++) {
+		if (!driver.step(mission[i])) failed = i;
+	}
+	EXPECT_EQ(failed, 550);
+	EXPECT_EQ(driver.stats().compared, (uint64_t)REPLAY_TEST_FRAMES);
+	EXPECT_EQ(driver.stats().mismatches, 1u);
+	EXPECT_EQ(driver.stats().throttleMismatches, 1u);
+	EXPECT_EQ(driver.stats().rudderMismatches, 0u);
+	EXPECT_EQ(driver.stats().maxRudderError, 0);
+	EXPECT_EQ(driver.stats().firstMismatch, mission[550].time);
+}
+
+// Replays a whole mission log, as hackerboatReplay does. The boat has changed since April 2017, so the
+// commands aren't expected to match the log, only to come out the same every time.
+static ReplayStats replayMission () {
+	CSVLogReplay csv;
+	ReplayDriver driver;
+	EXPECT_TRUE(csv.open(MISSION_LOG));
+	driver.begin();
+	driver.run(csv);
+	EXPECT_EQ(csv.skipped(), 0u);
+	return driver.stats();
+}
+
+TEST(ReplayTest, MissionLog) {
+	VLOG(1) << "===Replay Test, Mission Log===";
+	ReplayStats first = replayMission();
+	EXPECT_FALSE(BoatClock::isSet());
+	EXPECT_EQ(first.frames, (uint64_t)MISSION_LOG_FRAMES);
+	EXPECT_EQ(first.compared, (uint64_t)MISSION_LOG_COMMANDS);
+	EXPECT_GE(first.cycles, first.frames);
+	EXPECT_LE(first.mismatches, first.compared);
+	ReplayStats second = replayMission();
+	EXPECT_EQ(second.cycles, first.cycles);
+	EXPECT_EQ(second.mismatches, first.mismatches);
+	EXPECT_EQ(second.rudderMismatches, first.rudderMismatches);
+	EXPECT_EQ(second.throttleMismatches, first.throttleMismatches);
+	EXPECT_EQ(second.maxRudderError, first.maxRudderError);
+	EXPECT_EQ(second.firstMismatch, first.firstMismatch);
+}
@@ -0,0 +1,78 @@
+#include <stdexcept>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <inttypes.h>
+#include "hal/inputThread.hpp"
+#include "test_utilities.hpp"
+#include "easylogging++.h"
+
+TEST(Snapshot, PublishAndRead) {
+	VLOG(1) << "===Snapshot Publish and Read Test===";
+	Snapshot<std::vector<int> > snap;
+	std::vector<int> out;
+	EXPECT_EQ(snap.sequence(), 0u);
+	snap.read(out);
+	EXPECT_TRUE(out.empty());
+	snap.publish(std::vector<int>{1, 2, 3});
+	EXPECT_EQ(snap.sequence(), 1u);
+	snap.read(out);
+	EXPECT_EQ(out, (std::vector<int>{1, 2, 3}));
+	snap.publish(std::vector<int>{4, 5});
+	EXPECT_EQ(snap.get(), (std::vector<int>{4, 5}));
+	EXPECT_EQ(snap.contention(), 0u);
+}
+
+TEST(Snapshot, DropWhenAllSlotsBusy) {
+	VLOG(1) << "===Snapshot Drop Test===";
+	Snapshot<int, 3> snap;
+	snap.publish(1);
+	snap.visit([&snap] (const int& a) {
+		EXPECT_EQ(a, 1);
+		snap.publish(2);
+		snap.visit([&snap] (const int& b) {
+			EXPECT_EQ(b, 2);
+			snap.publish(3);				// the only slot left
+			snap.publish(4);				// nowhere to put it
+			EXPECT_EQ(b, 2);
+		});
+		EXPECT_EQ(a, 1);
+	});
+	EXPECT_EQ(snap.dropped(), 1u);
+	EXPECT_EQ(snap.get(), 3);
+	snap.publish(5);
+	EXPECT_EQ(snap.get(), 5);
+}
+
+TEST(Snapshot, NoTornReads) {
+	VLOG(1) << "===Snapshot Torn Read Test===";
+	const int len = 64;
+	const int count = 200000;
+	Snapshot<std::vector<int> > snap(std::vector<int>(len, 0));
+	std::atomic_bool done { false };
+	std::thread writer([&] () {
+		std::vector<int> work(len, 0);
+		for (int i = 1; i <= count; i++) {
+			for (auto &v : work) v = i;
+			snap.publish(work);
+		}
+		done = true;
+	});
+	std::vector<int> out;
+	int last = 0;
+	uint64_t torn = 0, backwards = 0, reads = 0;
+	while (!done) {
+		snap.read(out);
+		reads++;
+		for (auto v : out) if (v != out.front()) torn++;
+		if (out.front() < last) backwards++;
+		last = out.front();
+	}
+	writer.join();
+	VLOG(2) << reads << " reads, " << snap.retries() << " retries, " << snap.dropped() << " dropped";
+	EXPECT_EQ(torn, 0u);
+	EXPECT_EQ(backwards, 0u);
+	EXPECT_EQ(snap.get().front(), count);
+	EXPECT_EQ(snap.sequence() + snap.dropped(), (uint64_t)count);
+}
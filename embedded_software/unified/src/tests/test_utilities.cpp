@@ -4,9 +4,14 @@ extern "C" {
 }
 #include <gtest/gtest.h>
 #include <list>
+#include <new>
+#include <cstdlib>
+#include <chrono>
 #include "rapidjson/rapidjson.h"
+#include "test_utilities.hpp"
 
 using namespace rapidjson;
+using namespace std::chrono;
 
 /*std::ostream& operator<< (std::ostream& os, pathelt *p)
 {
@@ -40,3 +45,65 @@ testing::AssertionResult assertJSONEqual(const char *expected_expr, const char *
 	return result;
 }*/
 
+
+std::string toJSON (const HackerboatState& state) {
+	StringBuffer buf;
+	JSONWriter writer(buf);
+	EXPECT_TRUE(state.writeJSON(writer));
+	return buf.GetString();
+}
+
+std::string toJSON (const Value& v) {
+	StringBuffer buf;
+	Writer<StringBuffer> writer(buf);
+	v.Accept(writer);
+	return buf.GetString();
+}
+
+GPSFix testFix () {
+	GPSFix fix;
+	fix.recordTime = system_clock::now();
+	fix.gpsTime = fix.recordTime - seconds(1);
+	fix.mode = NMEAModeEnum::FIX3D;
+	fix.device = "/dev/ttyS4";
+	fix.fix.lat = 47.6;
+	fix.fix.lon = -122.3;
+	fix.track = 92.5;
+	fix.speed = 1.25;
+	fix.alt = 3;
+	fix.epx = 4.5;
+	fix.epy = 5.5;
+	fix.fixValid = true;
+	return fix;
+}
+
+static thread_local bool countingAllocations = false;
+static thread_local uint64_t allocationCount = 0;
+
+void AllocationCounter::start () {
+	allocationCount = 0;
+	countingAllocations = true;
+}
+
+uint64_t AllocationCounter::stop () {
+	countingAllocations = false;
+	return allocationCount;
+}
+
+// Replacements for the global allocation functions, so that AllocationCounter can see every heap allocation.
+// libstdc++ implements the array forms in terms of these.
+
+void* operator new (size_t size) {
+	if (countingAllocations) allocationCount++;
+	void *p = malloc(size ? size : 1);
+	if (!p) throw std::bad_alloc();
+	return p;
+}
+
+void operator delete (void *p) noexcept {
+	free(p);
+}
+
+void operator delete (void *p, size_t size) noexcept {
+	free(p);
+}
@@ -0,0 +1,155 @@
+#include <stdexcept>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <sstream>
+#include <string>
+#include "hackerboatRoot.hpp"
+#include "date.h"
+#include "test_utilities.hpp"
+#include "easylogging++.h"
+
+#define BENCHMARK_CYCLES (100000)
+
+using namespace date;
+using namespace std::chrono;
+
+// Timestamps taken from the 2017Apr09 mission logs
+static const char *recorded[] = {
+	"2017-04-09 20:47:07.357",
+	"2017-04-09 20:50:28.906",
+	"2017-04-09 20:53:50.285",
+	"2017-04-09 20:57:11.475",
+	"2017-04-09 21:00:32.857",
+	"2017-04-09 21:03:53.978",
+	"2017-04-09 21:07:15.132",
+	"2017-04-09 21:10:36.402",
+	"2017-04-09 21:13:58.347",
+	"2017-04-09 21:17:20.333",
+	"2017-04-09 21:20:43.284",
+	"2017-04-09 21:24:04.711",
+	"2017-04-09 22:01:44.428",
+	"2017-04-09 22:04:15.455",
+	"2017-04-09 22:06:46.660",
+	"2017-04-09 22:09:17.711",
+	"2017-04-09 22:11:48.685",
+	"2017-04-09 22:14:19.940",
+	"2017-04-09 22:16:51.059",
+	"2017-04-09 22:19:22.040"
+};
+
+// The way packTime() used to do it, for comparison
+static std::string streamPackTime (sysclock t) {
+	std::ostringstream output;
+	sys_time<milliseconds> tp = floor<milliseconds>(t);
+	output << tp;
+	return output.str();
+}
+
+static bool streamParseTime (const std::string& in, sysclock& t) {
+	std::istringstream input {in};
+	date::parse(input, "%F %T", t);
+	return !input.fail();
+}
+
+TEST(TimeTest, RecordedRoundTrip) {
+	VLOG(1) << "===Time Test, Recorded Round Trip===";
+	for (auto r : recorded) {
+		sysclock t, reference;
+		char buf[TIME_STRING_SIZE];
+		ASSERT_TRUE(HackerboatState::parseTime(r, t)) << r;
+		ASSERT_TRUE(streamParseTime(r, reference)) << r;
+		EXPECT_TRUE(t == reference) << r;
+		EXPECT_EQ(HackerboatState::packTime(t, buf, sizeof(buf)), strlen(r));
+		EXPECT_STREQ(buf, r);
+		EXPECT_EQ(streamPackTime(t), r);				// same text as before
+	}
+}
+
+TEST(TimeTest, Formats) {
+	VLOG(1) << "===Time Test, Formats===";
+	sysclock utc, t;
+	ASSERT_TRUE(HackerboatState::parseTime("2017-04-09T22:01:44.428Z", utc));
+	EXPECT_EQ(HackerboatState::packTime(utc), "2017-04-09 22:01:44.428");
+	ASSERT_TRUE(HackerboatState::parseTime("2017-04-09 15:01:44.428-07:00", t));
+	EXPECT_TRUE(t == utc);
+	ASSERT_TRUE(HackerboatState::parseTime("2017-04-10T00:31:44.428+0230", t));
+	EXPECT_TRUE(t == utc);
+	ASSERT_TRUE(HackerboatState::parseTime("2017-04-09T22:01:44Z", t));
+	EXPECT_TRUE((utc - t) == milliseconds(428));
+	ASSERT_TRUE(HackerboatState::parseTime("2017-04-09T22:01:44.428123Z", t));		// gpsd sometimes gives microseconds
+	EXPECT_TRUE((t - utc) == microseconds(123));
+	ASSERT_TRUE(HackerboatState::parseTime("2016-02-29 23:59:59.999", t));
+	EXPECT_EQ(HackerboatState::packTime(t), "2016-02-29 23:59:59.999");
+	EXPECT_EQ(HackerboatState::packTime(sysclock(milliseconds(-1))), "1969-12-31 23:59:59.999");
+}
+
+TEST(TimeTest, Malformed) {
+	VLOG(1) << "===Time Test, Malformed===";
+	const char *bad[] = {
+		"",
+		"2017-04-09",
+		"2017-04-31 00:00:00",
+		"2017-13-01 00:00:00",
+		"2017-04-09X22:01:44",
+		"2017-04-09 24:00:00",
+		"2017-04-09 22:01:44.",
+		"2017-04-09 22:01:44Zjunk",
+		"2017-04-09 22:01:44+1"
+	};
+	sysclock t = sysclock(milliseconds(42));
+	for (auto b : bad) {
+		EXPECT_FALSE(HackerboatState::parseTime(b, t)) << b;
+	}
+	EXPECT_TRUE(t == sysclock(milliseconds(42)));		// left alone on failure
+	char small[TIME_STRING_SIZE - 1];
+	EXPECT_EQ(HackerboatState::packTime(t, small, sizeof(small)), 0u);
+}
+
+TEST(TimeTest, NoAllocations) {
+	VLOG(1) << "===Time Test, No Allocations===";
+	char buf[TIME_STRING_SIZE];
+	sysclock t;
+	EXPECT_NO_ALLOCATIONS({
+		HackerboatState::packTime(system_clock::now(), buf, sizeof(buf));
+		HackerboatState::parseTime(buf, t);
+	});
+}
+
+TEST(TimeTest, DISABLED_Benchmark) {
+	VLOG(1) << "===Time Test, Benchmark===";
+	char buf[TIME_STRING_SIZE];
+	sysclock t = system_clock::now();
+	sysclock out;
+	size_t check = 0;
+	std::string text = HackerboatState::packTime(t);
+
+	auto start = steady_clock::now();
+	for (int i = 0; i < BENCHMARK_CYCLES; i++) {
+		check += streamPackTime(t + milliseconds(i)).size();
+	}
+	auto streamPack = steady_clock::now() - start;
+	start = steady_clock::now();
+	for (int i = 0; i < BENCHMARK_CYCLES; i++) {
+		check -= HackerboatState::packTime(t + milliseconds(i), buf, sizeof(buf));
+	}
+	auto fastPack = steady_clock::now() - start;
+	EXPECT_EQ(check, 0u);
+
+	start = steady_clock::now();
+	for (int i = 0; i < BENCHMARK_CYCLES; i++) {
+		EXPECT_TRUE(streamParseTime(text, out));
+	}
+	auto streamParse = steady_clock::now() - start;
+	start = steady_clock::now();
+	for (int i = 0; i < BENCHMARK_CYCLES; i++) {
+		EXPECT_TRUE(HackerboatState::parseTime(text.c_str(), text.size(), out));
+	}
+	auto fastParse = steady_clock::now() - start;
+
+	double streamPackNs = duration_cast<nanoseconds>(streamPack).count() / (double)BENCHMARK_CYCLES;
+	double fastPackNs = duration_cast<nanoseconds>(fastPack).count() / (double)BENCHMARK_CYCLES;
+	double streamParseNs = duration_cast<nanoseconds>(streamParse).count() / (double)BENCHMARK_CYCLES;
+	double fastParseNs = duration_cast<nanoseconds>(fastParse).count() / (double)BENCHMARK_CYCLES;
+	LOG(INFO) << "packTime: stream " << streamPackNs << " ns, direct " << fastPackNs << " ns, speedup " << (streamPackNs / fastPackNs);
+	LOG(INFO) << "parseTime: stream " << streamParseNs << " ns, direct " << fastParseNs << " ns, speedup " << (streamParseNs / fastParseNs);
+}